@@ -41,6 +41,7 @@ DancingBars::DancingBars( QWidget *parent, const QString &title, SharedSettings
   mBars = 0;
   mFlags = QBitArray( 100 );
   mFlags.fill( false );
+  setStreamingEnabled( true );
 
   QLayout *layout = new QHBoxLayout(this);
   mPlotter = new BarGraph( this );
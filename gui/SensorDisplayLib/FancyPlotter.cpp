@@ -31,6 +31,7 @@
 #include <QResizeEvent>
 #include <QStandardPaths>
 #include <QRegExp>
+#include <QVector>
 
 #include <KMessageBox>
 #include <ksignalplotter.h>
@@ -47,6 +48,10 @@
 // that the font used to draw the tooltip won't have it.  So we fall back to a 
 // "#" instead.
 static constexpr const int BLACK_CIRCLE = 0x25CF;
+/* How far back a new display is filled with the values kept by ksysguardd */
+static constexpr const int HistorySeconds = 600;
+/* How many live samples a display waits for the history */
+static constexpr const int MaxSamplesDropped = 5;
 static inline QChar circleCharacter(const QFontMetrics& fm)
 {
     return fm.inFont(QChar(BLACK_CIRCLE)) ? QChar(BLACK_CIRCLE) : QLatin1Char('#');
@@ -167,7 +172,11 @@ FancyPlotter::FancyPlotter( QWidget* parent,
     mSensorManualMax = mSensorManualMin = 0;
     mUseManualRange = false;
     mNumAnswers = 0;
+    mHistoryPending = 0;
+    mSamplesDropped = 0;
+    mPlotted = false;
     mLabelsWidget = nullptr;
+    setStreamingEnabled(true);
 
     mIndicatorSymbol = circleCharacter(QFontMetrics(QToolTip::font()));
 
@@ -435,6 +444,14 @@ bool FancyPlotter::addSensor( const QString &hostName, const QString &name,
      * requests we add 100 to the beam index for info requests. */
     sendRequest( hostName, name + QLatin1Char('?'), sensors().size() - 1 + 100 );
 
+    /* Fill a new display with the recent values, if ksysguardd has kept
+     * them. History answers have an id of 300 plus the sensor index. */
+    if ( !mPlotted ) {
+        ++mHistoryPending;
+        sendRequest( hostName, QStringLiteral( "history %1 %2" ).arg( name ).arg( HistorySeconds ),
+                     sensors().size() - 1 + 300 );
+    }
+
     if((int)mBeams == beamId) {
         mPlotter->addBeam( color );
         /* Add a label for this beam */
@@ -463,6 +480,11 @@ bool FancyPlotter::removeBeam( uint beamId )
     mLabelLayout->removeWidget(label);
     delete label;
 
+    /* The sensor indexes of the pending history answers change */
+    mHistory.clear();
+    mHistoryPending = 0;
+    mPlotted = true;
+
     mSensorReportedMax = 0;
     mSensorReportedMin = 0;
     for ( int i = sensors().count()-1; i >= 0; --i ) {
@@ -579,6 +601,16 @@ void FancyPlotter::setTooltip()
 
 void FancyPlotter::sendDataToPlotter( )
 {
+    if(mHistoryPending > 0 && !mSampleBuf.isEmpty()) {
+        /* The history goes first. Give up on it if it takes too long,
+         * e.g. because a host is not connected. */
+        if(++mSamplesDropped <= MaxSamplesDropped) {
+            mSampleBuf.clear();
+            return;
+        }
+        mHistory.clear();
+        mHistoryPending = 0;
+    }
     if(!mSampleBuf.isEmpty() && mBeams != 0) {  
         if((uint)mSampleBuf.count() > mBeams) {
             mSampleBuf.clear();
@@ -587,6 +619,7 @@ void FancyPlotter::sendDataToPlotter( )
         while((uint)mSampleBuf.count() < mBeams)
             mSampleBuf.append(mPlotter->lastValue(mSampleBuf.count())); //we might have sensors missing so set their values to the previously known value
         mPlotter->addSample( mSampleBuf );
+        mPlotted = true;
         if(isVisible()) {
             if(QToolTip::isVisible() && (qApp->topLevelAt(QCursor::pos()) == window()) && mPlotter->geometry().contains(mPlotter->mapFromGlobal( QCursor::pos() ))) {
                 setTooltip();
@@ -632,11 +665,88 @@ void FancyPlotter::sendDataToPlotter( )
 }
 void FancyPlotter::timerTick() //virtual
 {
-    if(mNumAnswers < sensors().count())
-        sendDataToPlotter(); //we haven't received enough answers yet, but plot what we do have
-    mNumAnswers = 0;
+    //While the values are pushed, every frame is plotted as it arrives
+    if(!isStreaming()) {
+        if(mNumAnswers < sensors().count())
+            sendDataToPlotter(); //we haven't received enough answers yet, but plot what we do have
+        mNumAnswers = 0;
+    }
     SensorDisplay::timerTick();
 }
+void FancyPlotter::streamValues( const QList<QByteArray> &values ) //virtual
+{
+    //A frame contains the values of all sensors, so it completes a sample
+    mNumAnswers = 0;
+    SensorDisplay::streamValues(values);
+}
+void FancyPlotter::sensorLost( int reqId ) //virtual
+{
+    if ( reqId >= 300 && reqId < 400 )
+        historyReceived( reqId - 300, QList<QByteArray>() ); //an old ksysguardd without history
+    else
+        SensorDisplay::sensorLost( reqId );
+}
+void FancyPlotter::historyReceived( int sensorId, const QList<QByteArray> &answerlist )
+{
+    if ( mHistoryPending <= 0 )
+        return;
+
+    if ( sensorId < sensors().count() ) {
+        QList<QPair<qint64, double> > &values = mHistory[ sensorId ];
+        foreach ( const QByteArray &line, answerlist ) {
+            const QList<QByteArray> fields = line.split( '\t' );
+            bool timeOk, valueOk;
+            if ( fields.count() != 2 )
+                continue;
+            const qint64 time = fields[ 0 ].toLongLong( &timeOk );
+            const double value = fields[ 1 ].toDouble( &valueOk );
+            if ( timeOk && valueOk )
+                values.append( qMakePair( time, value ) );
+        }
+    }
+
+    if ( --mHistoryPending == 0 )
+        plotHistory();
+}
+void FancyPlotter::plotHistory()
+{
+    const int step = mSharedSettings ? mSharedSettings->updateInterval : 0;
+    qint64 start = 0, end = 0;
+
+    /* Plot the time span that all sensors have values for, one sample
+     * per update interval, the latest value at that time of each sensor */
+    for ( int i = 0; i < sensors().count(); ++i ) {
+        const QList<QPair<qint64, double> > values = mHistory.value( i );
+        if ( values.isEmpty() ) {
+            start = end = 0;
+            break;
+        }
+        start = ( i == 0 ) ? values.first().first : qMax( start, values.first().first );
+        end = qMax( end, values.last().first );
+    }
+
+    if ( step > 0 && end > start && !mPlotted ) {
+        QVector<int> next( sensors().count(), 0 );
+        const qint64 count = qMin( ( end - start ) / step, qint64( HistorySeconds ) * 1000 / step );
+        for ( qint64 time = end - count * step; time <= end; time += step ) {
+            QList<qreal> sample;
+            for ( uint beam = 0; beam < mBeams; ++beam )
+                sample.append( 0 );
+            for ( int i = 0; i < sensors().count(); ++i ) {
+                const QList<QPair<qint64, double> > &values = mHistory[ i ];
+                while ( next[ i ] + 1 < values.count() && values[ next[ i ] + 1 ].first <= time )
+                    ++next[ i ];
+                const int beamId = static_cast<FPSensorProperties *>( sensors().at( i ) )->beamId;
+                if ( beamId >= 0 && beamId < sample.count() )
+                    sample[ beamId ] += values[ next[ i ] ].second;
+            }
+            mPlotter->addSample( sample );
+        }
+        mPlotted = true;
+    }
+
+    mHistory.clear();
+}
 void FancyPlotter::plotterAxisScaleChanged()
 {
     //Prevent this being called recursively
@@ -753,6 +863,8 @@ void FancyPlotter::answerReceived( int id, const QList<QByteArray> &answerlist )
         if(summationName.isEmpty())
             static_cast<FancyPlotterLabel *>((static_cast<QWidgetItem *>(mLabelLayout->itemAt(beamId)))->widget())->setLabel(info.name(), mPlotter->beamColor(beamId));
 
+    } else if( id >= 300 && id < 400 ) {
+        historyReceived( id - 300, answerlist );
     } else if( id == 200) {
         /* FIXME This doesn't check the host!  */
         if(!mSensorsToAdd.isEmpty())  {
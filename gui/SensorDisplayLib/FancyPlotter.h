@@ -24,7 +24,9 @@
 #define KSG_FANCYPLOTTER_H
 
 #include <SensorDisplay.h>
+#include <QHash>
 #include <QList>
+#include <QPair>
 #include <KLocalizedString>
 
 #include "SharedSettings.h"
@@ -80,6 +82,8 @@ class FancyPlotter : public KSGRD::SensorDisplay
     void setTitle( const QString &title ) override;
 
     void answerReceived( int id, const QList<QByteArray> &answerlist ) override;
+    void streamValues( const QList<QByteArray> &values ) override;
+    void sensorLost( int reqId ) override;
 
     bool restoreSettings( QDomElement &element ) override;
     bool saveSettings( QDomDocument &doc, QDomElement &element ) override;
@@ -104,6 +108,8 @@ class FancyPlotter : public KSGRD::SensorDisplay
 
   private:
     void sendDataToPlotter();
+    void historyReceived( int sensorId, const QList<QByteArray> &answerlist );
+    void plotHistory();
     uint mBeams;
     
     int mNumAnswers;
@@ -128,6 +134,16 @@ class FancyPlotter : public KSGRD::SensorDisplay
      */
     QList<qreal> mSampleBuf;
 
+    /** The values that ksysguardd has kept for each sensor, by sensor
+     *  index, as pairs of time in ms and value. A display that has not
+     *  plotted anything yet asks for them, so it does not start empty.
+     *  The live samples are dropped until all have arrived. */
+    QHash<int, QList<QPair<qint64, double> > > mHistory;
+    int mHistoryPending;
+    int mSamplesDropped;
+    /** Once a sample has been plotted there is no room for history */
+    bool mPlotted;
+
     FancyPlotterSettings* mSettingsDialog;
     QLabel *mHeading;
 
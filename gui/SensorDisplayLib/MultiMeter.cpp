@@ -42,6 +42,7 @@ MultiMeter::MultiMeter(QWidget* parent, const QString& title, SharedSettings *wo
   mLowerLimitActive = mUpperLimitActive = false;
 
   mIsFloat = false;
+  setStreamingEnabled( true );
 
   mNormalDigitColor = KSGRD::Style->firstForegroundColor();
   mAlarmDigitColor = KSGRD::Style->alarmColor();
@@ -26,6 +26,7 @@
 #include <QCheckBox>
 #include <QHeaderView>
 #include <QStackedLayout>
+#include <QStringList>
 
 #include "ProcessController.h"
 #include "processui/ksysguardprocesslist.h"
@@ -40,6 +41,8 @@ ProcessController::ProcessController(QWidget* parent,  SharedSettings *workSheet
 {
     mProcessList = nullptr;
     mProcesses = nullptr;
+    mPsRequestId = -1;
+    mPsGeneration = 0;
 }
 
 void
@@ -129,8 +132,96 @@ void ProcessController::timerTick()  {
 
 }
 void ProcessController::answerReceived( int id, const QList<QByteArray>& answer ) {
-    if(mProcesses)
-        mProcesses->answerReceived(id, answer);
+    if(!mProcesses)
+        return;
+
+    /* Daemons that do not know 'ps delta' ignore the arguments and send the whole table */
+    if(id == mPsRequestId && !answer.isEmpty() && answer.first().startsWith("delta\t") &&
+       answer.first().count('\t') == 3) {
+        QList<QByteArray> table;
+        if(applyProcessDelta(answer, table)) {
+            mProcesses->answerReceived(id, table);
+        } else if(answer.first().split('\t').at(2) != "1") {
+            /* The table would have blank or stale rows, so ask for all of
+             * them again. A broken answer that started over is dropped,
+             * the next update tries again */
+            requestProcesses();
+        }
+        return;
+    }
+
+    mProcesses->answerReceived(id, answer);
+}
+
+bool ProcessController::applyProcessDelta(const QList<QByteArray>& answer, QList<QByteArray>& table)
+{
+    /* The PID column identifies the rows */
+    static const int keyColumn = 1;
+
+    const QList<QByteArray> header = answer.first().split('\t');
+    if(header.at(2) == "1") {
+        mPsRows.clear();
+        mPsStrings.clear();
+    }
+    mPsGeneration = header.at(1).toULongLong();
+
+    QList<int> dictionaryColumns;
+    const QList<QByteArray> columns = header.at(3).split(',');
+    for(const QByteArray &column : columns)
+        dictionaryColumns.append(column.toInt());
+
+    bool complete = true;
+    auto decode = [&](int column, const QByteArray &cell) {
+        if(!dictionaryColumns.contains(column))
+            return cell;
+        const auto string = mPsStrings.constFind(cell.toUInt());
+        if(string == mPsStrings.constEnd()) {
+            complete = false;
+            return QByteArray();
+        }
+        return *string;
+    };
+
+    for(int i = 1; i < answer.size(); ++i) {
+        if(answer.at(i).isEmpty())
+            continue;
+
+        QList<QByteArray> cells = answer.at(i).split('\t');
+        const QByteArray tag = cells.takeFirst();
+        if(tag == "S" && cells.size() == 2) {
+            mPsStrings.insert(cells.at(0).toUInt(), cells.at(1));
+        } else if(tag == "N" && cells.size() > keyColumn) {
+            for(int column = 0; column < cells.size(); ++column)
+                cells[column] = decode(column, cells.at(column));
+            mPsRows.insert(cells.at(keyColumn), cells);
+        } else if(tag == "C" && !cells.isEmpty()) {
+            auto row = mPsRows.find(cells.at(0));
+            if(row == mPsRows.end()) {
+                complete = false;
+                continue;
+            }
+            for(int j = 1; j + 1 < cells.size(); j += 2) {
+                const int column = cells.at(j).toInt();
+                if(column >= 0 && column < row->size())
+                    (*row)[column] = decode(column, cells.at(j + 1));
+            }
+        } else if(tag == "X" && cells.size() == 1) {
+            mPsRows.remove(cells.at(0));
+        }
+    }
+
+    /* Something is missing, so let the daemon start over with the next request */
+    if(!complete) {
+        mPsRows.clear();
+        mPsStrings.clear();
+        mPsGeneration = 0;
+        return false;
+    }
+
+    table.reserve(mPsRows.size());
+    for(auto row = mPsRows.constBegin(); row != mPsRows.constEnd(); ++row)
+        table.append(row->join('\t'));
+    return true;
 }
 
 bool ProcessController::addSensor(const QString& hostName,
@@ -180,7 +271,48 @@ bool ProcessController::addSensor(const QString& hostName,
     return true;
 }
 
+QString ProcessController::psColumns() const {
+    /* The process model always needs these, for the tree, the user filter and the CPU usage */
+    QStringList columns{QStringLiteral("name"), QStringLiteral("pid"), QStringLiteral("ppid"),
+                        QStringLiteral("uid"), QStringLiteral("gid"), QStringLiteral("status"),
+                        QStringLiteral("utime"), QStringLiteral("stime"), QStringLiteral("vmsize"),
+                        QStringLiteral("rss"), QStringLiteral("tracerpid")};
+    const QHeaderView *header = mProcessList->treeView()->header();
+    const auto visible = [header](int heading) { return !header->isSectionHidden(heading); };
+
+    if(visible(ProcessModel::HeadingUser))
+        columns << QStringLiteral("login");
+    if(visible(ProcessModel::HeadingTty))
+        columns << QStringLiteral("tty");
+    if(visible(ProcessModel::HeadingCommand))
+        columns << QStringLiteral("cmdline");
+    if(visible(ProcessModel::HeadingMemory) || visible(ProcessModel::HeadingSharedMemory))
+        columns << QStringLiteral("urss");
+    if(visible(ProcessModel::HeadingNiceness))
+        columns << QStringLiteral("nice") << QStringLiteral("ioclass") << QStringLiteral("ioprio");
+    if(visible(ProcessModel::HeadingNoNewPrivileges))
+        columns << QStringLiteral("nnp");
+    if(visible(ProcessModel::HeadingCGroup))
+        columns << QStringLiteral("cgroup");
+    if(visible(ProcessModel::HeadingMACContext))
+        columns << QStringLiteral("mac");
+
+    return columns.join(QLatin1Char(','));
+}
+
 void ProcessController::runCommand(const QString &command, int id) {
+    /* Only ask for the changes since the last table that has arrived,
+     * and only for the columns that are shown */
+    if(command == QLatin1String("ps")) {
+        mPsRequestId = id;
+        requestProcesses();
+        return;
+    }
+
     sendRequest(sensors().at(0)->hostName(), command, id);
 }
 
+void ProcessController::requestProcesses() {
+    sendRequest(sensors().at(0)->hostName(), QStringLiteral("ps delta %1 cols=%2").arg(mPsGeneration).arg(psColumns()), mPsRequestId);
+}
+
@@ -25,6 +25,8 @@
 #ifndef _ProcessController_h_
 #define _ProcessController_h_
 
+#include <QByteArray>
+#include <QHash>
 #include <QList>
 #include <QWidget>
 
@@ -82,8 +84,34 @@ private Q_SLOTS:
     void runCommand(const QString &command, int id);
 
 private:
+    /**
+     * Applies an answer to 'ps delta' (see ksysguardd/TableDelta.h) to
+     * the rows received so far and puts the whole table as 'ps' would
+     * have sent it into @p table. Returns false if the answer refers to
+     * rows or strings that are not known, the rows are dropped then.
+     */
+    bool applyProcessDelta(const QList<QByteArray>& answer, QList<QByteArray>& table);
+
+    /** Sends the 'ps delta' request for the remote process list */
+    void requestProcesses();
+
+    /**
+     * Returns the 'cols=' list of the 'ps' request: the columns that
+     * the process model needs plus those of the visible headings.
+     */
+    QString psColumns() const;
+
     KSysGuardProcessList *mProcessList;
     KSysGuard::Processes *mProcesses;
+
+    /** The id of the remote process list's 'ps' requests, -1 until the first one */
+    int mPsRequestId;
+    /** The generation of the last delta that has been applied */
+    qulonglong mPsGeneration;
+    /** The rows of the remote process table by PID, strings decoded */
+    QHash<QByteArray, QList<QByteArray> > mPsRows;
+    /** The dictionary of the delta answers */
+    QHash<uint, QByteArray> mPsStrings;
 };
 
 #endif
@@ -0,0 +1,113 @@
+/*
+    KSysGuard, the KDE System Guard
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation; either version 2 of
+ the License or (at your option) version 3 or any later version
+ accepted by the membership of KDE e.V. (or its successor approved
+ by the membership of KDE e.V.), which shall act as a proxy
+ defined in Section 14 of version 3 of the license.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ksgrd/SensorManager.h"
+#include "SensorDisplay.h"
+
+#include "SensorBatch.h"
+
+using namespace KSGRD;
+
+SensorBatch::SensorBatch( SensorDisplay *display, const QString &hostName )
+  : mDisplay( display ), mHostName( hostName ),
+    mGeneration( 0 ), mDefined( false ), mSupported( true )
+{
+  /* Sets are per connection, but all displays share the connection to
+   * a host, so every batch needs a name of its own. */
+  static int setCount = 0;
+  mSetName = QStringLiteral( "ksg%1" ).arg( ++setCount );
+}
+
+SensorBatch::~SensorBatch()
+{
+  if ( SensorMgr != nullptr )
+    SensorMgr->disconnectClient( this );
+}
+
+void SensorBatch::sendRequest( const QList<int> &ids, const QStringList &names )
+{
+  if ( names != mNames ) {
+    mIds = ids;
+    mNames = names;
+    mDefined = false;
+    /* Give a daemon that did not know sets before another chance, it
+     * may have been updated in the meantime. */
+    mSupported = true;
+  }
+
+  if ( !mSupported ) {
+    sendSingleRequests();
+    return;
+  }
+
+  if ( !mDefined ) {
+    ++mGeneration;
+    if ( !SensorMgr->sendRequest( mHostName, QStringLiteral( "defineset %1 %2" ).arg( mSetName, mNames.join( QLatin1Char( ' ' ) ) ),
+                                  this, mGeneration * 2 ) ) {
+      sendSingleRequests();
+      return;
+    }
+    mDefined = true;
+  }
+
+  if ( !SensorMgr->sendRequest( mHostName, QStringLiteral( "getset %1" ).arg( mSetName ), this, mGeneration * 2 + 1 ) )
+    sendSingleRequests();
+}
+
+void SensorBatch::answerReceived( int id, const QList<QByteArray> &answer )
+{
+  /* The answer to 'defineset' needs no handling and answers to an
+   * outdated set are dropped. */
+  if ( id != mGeneration * 2 + 1 )
+    return;
+
+  const int count = qMin( answer.count(), mIds.count() );
+  for ( int i = 0; i < count; ++i ) {
+    if ( answer[ i ] == "UNKNOWN SENSOR" )
+      mDisplay->sensorLost( mIds[ i ] );
+    else
+      static_cast<SensorClient*>( mDisplay )->answerReceived( mIds[ i ], QList<QByteArray>() << answer[ i ] );
+  }
+}
+
+void SensorBatch::sensorLost( int id )
+{
+  if ( id / 2 != mGeneration )
+    return;
+
+  if ( id % 2 == 0 ) {
+    /* This daemon does not know 'defineset' */
+    mSupported = false;
+    mDefined = false;
+    return;
+  }
+
+  /* Either the daemon does not support sets or it has forgotten ours,
+   * e.g. after a restart. Redefine it on the next tick and fetch the
+   * values one by one this time. */
+  mDefined = false;
+  sendSingleRequests();
+}
+
+void SensorBatch::sendSingleRequests()
+{
+  for ( int i = 0; i < mIds.count(); ++i )
+    mDisplay->sendRequest( mHostName, mNames[ i ], mIds[ i ] );
+}
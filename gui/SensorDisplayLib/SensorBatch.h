@@ -0,0 +1,77 @@
+/*
+    KSysGuard, the KDE System Guard
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation; either version 2 of
+ the License or (at your option) version 3 or any later version
+ accepted by the membership of KDE e.V. (or its successor approved
+ by the membership of KDE e.V.), which shall act as a proxy
+ defined in Section 14 of version 3 of the license.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KSG_SENSORBATCH_H
+#define KSG_SENSORBATCH_H
+
+#include <QList>
+#include <QStringList>
+
+#include <ksgrd/SensorClient.h>
+
+namespace KSGRD {
+
+class SensorDisplay;
+
+/**
+  Fetches the values of several sensors of one host with a single
+  request. The sensors are registered with ksysguardd as a named set
+  once and then requested with 'getset' on every tick. The answers are
+  passed on to the display as if each sensor had been requested on
+  its own, with the sensor index as id.
+
+  If the daemon does not support sets, the batch falls back to sending
+  one request per sensor.
+ */
+class SensorBatch : public SensorClient
+{
+  public:
+    SensorBatch( SensorDisplay *display, const QString &hostName );
+    ~SensorBatch() override;
+
+    /**
+      Requests the sensors @ref names. @ref ids are the indexes of the
+      sensors in the display and are used as ids for the answers.
+     */
+    void sendRequest( const QList<int> &ids, const QStringList &names );
+
+    void answerReceived( int id, const QList<QByteArray> &answer ) override;
+    void sensorLost( int id ) override;
+
+  private:
+    void sendSingleRequests();
+
+    SensorDisplay *mDisplay;
+    QString mHostName;
+    QString mSetName;
+
+    QList<int> mIds;
+    QStringList mNames;
+
+    /* Incremented whenever the set is redefined, so that answers to an
+     * outdated set can be told apart. */
+    int mGeneration;
+    bool mDefined;
+    bool mSupported;
+};
+
+}
+
+#endif
@@ -37,7 +37,9 @@
 #include <KService>
 
 #include "ksgrd/SensorManager.h"
+#include "SensorBatch.h"
 #include "SensorDisplay.h"
+#include "SensorStream.h"
 
 #define NONE -1
 
@@ -62,6 +64,9 @@ SensorDisplay::SensorDisplay( QWidget *parent, const QString &title, SharedSetti
   mTimerId = NONE;
   mErrorIndicator = nullptr;
   mPlotterWdg = nullptr;
+  mStreamingEnabled = false;
+  mStreamState = StreamOff;
+  mStreamInterval = 0;
 
   this->setWhatsThis( QStringLiteral("dummy") );
 
@@ -79,6 +84,8 @@ SensorDisplay::~SensorDisplay()
 {
   if ( SensorMgr != nullptr )
     SensorMgr->disconnectClient( this );
+  qDeleteAll( mBatches );
+  stopStream();
 
   if ( mTimerId > 0 )
     killTimer( mTimerId );
@@ -98,11 +105,39 @@ void SensorDisplay::unregisterSensor( uint pos )
 
 void SensorDisplay::timerTick()
 {
+  QHash<QString, QList<int> > values;
   int i = 0;
 
+  /* Nothing to request while the values are pushed */
+  if ( mStreamingEnabled && updateStream() )
+    return;
+
   foreach( SensorProperties *s, mSensors) {
-    sendRequest( s->hostName(), s->name(), i++ );
- }
+    if ( s->type() == QLatin1String("integer") || s->type() == QLatin1String("float") )
+      values[ s->hostName() ].append( i );
+    else
+      sendRequest( s->hostName(), s->name(), i );
+    ++i;
+  }
+
+  /* Instead of a round trip per sensor, fetch all values of a host at
+   * once */
+  for ( QHash<QString, QList<int> >::ConstIterator it = values.constBegin(); it != values.constEnd(); ++it ) {
+    const QList<int> &ids = it.value();
+    if ( ids.count() == 1 ) {
+      sendRequest( it.key(), mSensors.at( ids.first() )->name(), ids.first() );
+      continue;
+    }
+
+    QStringList names;
+    foreach( int id, ids )
+      names.append( mSensors.at( id )->name() );
+
+    SensorBatch *&batch = mBatches[ it.key() ];
+    if ( !batch )
+      batch = new SensorBatch( this, it.key() );
+    batch->sendRequest( ids, names );
+  }
 }
 
 void SensorDisplay::showContextMenu(const QPoint &pos)
@@ -266,6 +301,92 @@ void SensorDisplay::sensorLost( int reqId )
   sensorError( reqId, true );
 }
 
+void SensorDisplay::streamSubscribed( bool ok )
+{
+  if ( mStreamState == StreamPending )
+    mStreamState = ok ? StreamActive : StreamFailed;
+}
+
+void SensorDisplay::streamValues( const QList<QByteArray> &values )
+{
+  const int count = qMin( values.count(), mSensors.count() );
+  for ( int i = 0; i < count; ++i ) {
+    if ( values[ i ] == "UNKNOWN SENSOR" )
+      sensorLost( i );
+    else
+      answerReceived( i, QList<QByteArray>() << values[ i ] );
+  }
+}
+
+void SensorDisplay::setStreamingEnabled( bool enabled )
+{
+  mStreamingEnabled = enabled;
+  if ( !enabled )
+    stopStream();
+}
+
+void SensorDisplay::updateIntervalChanged()
+{
+  if ( mStreamState != StreamOff )
+    updateStream();
+}
+
+bool SensorDisplay::isStreaming() const
+{
+  return mStreamState == StreamActive;
+}
+
+/**
+  Subscribes to the sensors if they can be streamed and the
+  subscription is not up to date.
+  @return true if the values are pushed.
+ */
+bool SensorDisplay::updateStream()
+{
+  const int interval = mSharedSettings ? mSharedSettings->updateInterval : 0;
+  QStringList names;
+
+  foreach( SensorProperties *s, mSensors ) {
+    if ( ( s->type() != QLatin1String("integer") && s->type() != QLatin1String("float") ) ||
+         s->hostName() != mSensors.first()->hostName() ) {
+      stopStream();
+      return false;
+    }
+    names.append( s->name() );
+  }
+
+  if ( names.isEmpty() || interval <= 0 ) {
+    stopStream();
+    return false;
+  }
+
+  /* Only subscribe again if something has changed, a failed
+   * subscription is not retried over and over */
+  if ( names != mStreamNames || interval != mStreamInterval ) {
+    SensorProperties *first = mSensors.first();
+
+    stopStream();
+    mStreamNames = names;
+    mStreamInterval = interval;
+    mStreamState = StreamPending;
+    mStream = SensorStream::stream( first->hostName(), first->isLocalhost() );
+    mStream->subscribe( this, names, interval );
+  }
+
+  return mStreamState == StreamActive;
+}
+
+void SensorDisplay::stopStream()
+{
+  if ( mStream )
+    mStream->unsubscribe( this );
+
+  mStream = nullptr;
+  mStreamState = StreamOff;
+  mStreamNames.clear();
+  mStreamInterval = 0;
+}
+
 void SensorDisplay::setDeleteNotifier( QObject *object )
 {
   mDeleteNotifier = object;
@@ -24,7 +24,9 @@
 #define KSG_SENSORDISPLAY_H
 
 #include <QEvent>
+#include <QHash>
 #include <QPointer>
+#include <QStringList>
 #include <QWidget>
 
 #include <ksgrd/SensorClient.h>
@@ -35,7 +37,9 @@ class QDomElement;
 
 namespace KSGRD {
 
+class SensorBatch;
 class SensorProperties;
+class SensorStream;
 
 /**
   This class is the base class for all displays for sensors. A
@@ -176,6 +180,25 @@ class SensorDisplay : public QWidget, public SensorClient
      */
     void sensorLost( int reqId ) override;
 
+    /**
+      Called by the SensorStream when the subscription of the display
+      has been accepted or has failed.
+     */
+    void streamSubscribed( bool ok );
+
+    /**
+      Called by the SensorStream with the pushed values, one per sensor.
+      The default implementation passes them on to answerReceived().
+     */
+    virtual void streamValues( const QList<QByteArray> &values );
+
+    /**
+      Called when the update interval of the shared settings has
+      changed. A subscription is renewed with the new interval, or
+      dropped if the display is refreshed manually now.
+     */
+    void updateIntervalChanged();
+
     /**
      * Sets the object where the delete events will be sent to.
      */
@@ -204,7 +227,8 @@ class SensorDisplay : public QWidget, public SensorClient
 
     /**
      * This is called when the display should request more information
-     * and update itself
+     * and update itself. The integer and float sensors of a host are
+     * fetched with a single request.
      */
     virtual void timerTick();
 
@@ -233,6 +257,18 @@ class SensorDisplay : public QWidget, public SensorClient
 
     void setSensorOk( bool ok );
 
+    /**
+      Displays that only show integer and float sensors of one host can
+      let ksysguardd push the values instead of polling them on every
+      tick. See SensorStream.
+     */
+    void setStreamingEnabled( bool enabled );
+
+    /**
+      Returns whether the values are pushed at the moment.
+     */
+    bool isStreaming() const;
+
 
     QList<SensorProperties *> &sensors();
 
@@ -240,6 +276,8 @@ class SensorDisplay : public QWidget, public SensorClient
 
   private:
     void updateWhatsThis();
+    bool updateStream();
+    void stopStream();
 
     bool mShowUnit;
     bool mUseGlobalUpdateInterval;
@@ -249,6 +287,16 @@ class SensorDisplay : public QWidget, public SensorClient
 
     QList<SensorProperties *> mSensors;
 
+    /* One batch request per host, see timerTick() */
+    QHash<QString, SensorBatch *> mBatches;
+
+    enum StreamState { StreamOff, StreamPending, StreamActive, StreamFailed };
+    bool mStreamingEnabled;
+    StreamState mStreamState;
+    QPointer<SensorStream> mStream;
+    QStringList mStreamNames;
+    int mStreamInterval;
+
     QString mTitle;
     QString mTranslatedTitle;
     QString mUnit;
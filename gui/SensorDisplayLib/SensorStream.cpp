@@ -0,0 +1,405 @@
+/*
+    KSysGuard, the KDE System Guard
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation; either version 2 of
+ the License or (at your option) version 3 or any later version
+ accepted by the membership of KDE e.V. (or its successor approved
+ by the membership of KDE e.V.), which shall act as a proxy
+ defined in Section 14 of version 3 of the license.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QCoreApplication>
+#include <QLocalSocket>
+#include <QProcess>
+#include <QTcpSocket>
+#include <QtEndian>
+
+#include <cstring>
+
+#include "SensorDisplay.h"
+
+#include "SensorStream.h"
+
+/* The official ksysguardd port */
+#define PORT_NUMBER 3112
+
+/* Where a system wide ksysguardd listens for local clients, see
+ * LocalSocket in ksysguardd/example/ksysguarddrc */
+#define LOCAL_SOCKET_PATH "/run/ksysguardd.sock"
+
+using namespace KSGRD;
+
+static const QByteArray Prompt( "ksysguardd> " );
+
+/* Frame and value types of the binary protocol, see
+ * ksysguardd/BinaryProtocol.h */
+enum { FrameText = 1, FrameError, FrameValues, FrameTable, FramePush };
+enum { ValueInteger = 0, ValueDouble, ValueString, ValueUnknown };
+
+/**
+  Reads a varint at @p pos of @p data and advances @p pos.
+  @return false if the data ends before the varint does.
+ */
+static bool readVarint( const QByteArray &data, int &pos, quint64 &value )
+{
+  value = 0;
+  for ( int shift = 0; pos < data.size() && shift < 64; shift += 7 ) {
+    const uchar byte = data.at( pos++ );
+    value |= quint64( byte & 0x7f ) << shift;
+    if ( !( byte & 0x80 ) )
+      return true;
+  }
+  return false;
+}
+
+/**
+  Decodes the values of a values or push frame. The displays expect
+  text, so the values are handed on as such.
+ */
+static bool readValues( const QByteArray &data, int &pos, QList<QByteArray> &values )
+{
+  quint64 count, number;
+
+  if ( !readVarint( data, pos, count ) )
+    return false;
+
+  for ( quint64 i = 0; i < count; ++i ) {
+    if ( pos >= data.size() )
+      return false;
+
+    switch ( data.at( pos++ ) ) {
+      case ValueInteger:
+        if ( !readVarint( data, pos, number ) )
+          return false;
+        values.append( QByteArray::number( qint64( number >> 1 ) ^ -qint64( number & 1 ) ) );
+        break;
+      case ValueDouble: {
+        if ( pos + 8 > data.size() )
+          return false;
+        const quint64 bits = qFromLittleEndian<quint64>( data.constData() + pos );
+        double value;
+        memcpy( &value, &bits, sizeof( value ) );
+        values.append( QByteArray::number( value, 'f', 6 ) );
+        pos += 8;
+        break;
+      }
+      case ValueString:
+        if ( !readVarint( data, pos, number ) || pos + number > quint64( data.size() ) )
+          return false;
+        values.append( data.mid( pos, number ) );
+        pos += number;
+        break;
+      default:
+        values.append( QByteArray( "UNKNOWN SENSOR" ) );
+        break;
+    }
+  }
+
+  return true;
+}
+
+SensorStream *SensorStream::stream( const QString &hostName, bool isLocalhost )
+{
+  static QHash<QString, SensorStream *> streams;
+
+  SensorStream *&stream = streams[ hostName ];
+  if ( !stream )
+    stream = new SensorStream( hostName, isLocalhost );
+
+  return stream;
+}
+
+SensorStream::SensorStream( const QString &hostName, bool isLocalhost )
+  : QObject( QCoreApplication::instance() ),
+    mConnected( false ), mFailed( false ), mBinary( false ), mFrameError( false ),
+    mSerial( 0 )
+{
+  if ( isLocalhost ) {
+    /* Prefer a running daemon, it saves us a second set of collectors */
+    QLocalSocket *socket = new QLocalSocket( this );
+    connect( socket, &QLocalSocket::readyRead, this, &SensorStream::readData );
+    connect( socket, &QLocalSocket::errorOccurred, this, &SensorStream::localConnectionLost );
+    connect( socket, &QLocalSocket::disconnected, this, &SensorStream::localConnectionLost );
+    socket->connectToServer( QStringLiteral( LOCAL_SOCKET_PATH ) );
+    mDevice = socket;
+  } else {
+    QTcpSocket *socket = new QTcpSocket( this );
+    connect( socket, &QTcpSocket::readyRead, this, &SensorStream::readData );
+    connect( socket, &QTcpSocket::errorOccurred, this, &SensorStream::connectionLost );
+    connect( socket, &QTcpSocket::disconnected, this, &SensorStream::connectionLost );
+    socket->connectToHost( hostName, PORT_NUMBER );
+    mDevice = socket;
+  }
+}
+
+void SensorStream::startProcess()
+{
+  QProcess *process = new QProcess( this );
+  connect( process, &QProcess::readyReadStandardOutput, this, &SensorStream::readData );
+  connect( process, &QProcess::errorOccurred, this, &SensorStream::connectionLost );
+  connect( process, QOverload<int, QProcess::ExitStatus>::of( &QProcess::finished ),
+           this, &SensorStream::connectionLost );
+  process->start( QStringLiteral( "ksysguardd" ), QStringList() );
+  mDevice = process;
+}
+
+void SensorStream::subscribe( SensorDisplay *display, const QStringList &names, int interval )
+{
+  unsubscribe( display );
+
+  if ( mFailed ) {
+    display->streamSubscribed( false );
+    return;
+  }
+
+  Request request;
+  request.type = Subscribe;
+  request.display = display;
+  request.serial = ++mSerial;
+  mPending.enqueue( request );
+  mSerials.insert( display, request.serial );
+
+  sendCommand( "subscribe " + names.join( QLatin1Char( ' ' ) ).toUtf8() + ' ' + QByteArray::number( interval ) );
+}
+
+void SensorStream::unsubscribe( SensorDisplay *display )
+{
+  mSerials.remove( display );
+
+  if ( !mIds.contains( display ) )
+    return;
+
+  const int id = mIds.take( display );
+  mSubscriptions.remove( id );
+
+  Request request;
+  request.type = Unsubscribe;
+  request.serial = 0;
+  mPending.enqueue( request );
+  sendCommand( "unsubscribe " + QByteArray::number( id ) );
+}
+
+void SensorStream::sendCommand( const QByteArray &command )
+{
+  if ( mConnected )
+    mDevice->write( command + '\n' );
+  else
+    mOutgoing.append( command + '\n' );
+}
+
+void SensorStream::readData()
+{
+  mBuffer += mDevice->readAll();
+
+  /* The protocol may change after any answer */
+  for ( ;; ) {
+    if ( mBinary ) {
+      if ( !readFrame() )
+        break;
+      continue;
+    }
+
+    const int end = mBuffer.indexOf( Prompt );
+    if ( end < 0 )
+      break;
+    const QByteArray text = mBuffer.left( end );
+    mBuffer.remove( 0, end + Prompt.size() );
+    processText( text );
+  }
+}
+
+/**
+  Processes the next frame of the binary protocol.
+  @return false if the frame is incomplete.
+ */
+bool SensorStream::readFrame()
+{
+  int pos = 0;
+  quint64 length;
+
+  if ( !readVarint( mBuffer, pos, length ) || pos + length > quint64( mBuffer.size() ) )
+    return false;
+
+  const QByteArray frame = mBuffer.mid( pos + 1, length - 1 );
+  const int type = length > 0 ? uchar( mBuffer.at( pos ) ) : 0;
+  mBuffer.remove( 0, pos + length );
+
+  QList<QByteArray> values;
+  quint64 id, timeStamp;
+  pos = 0;
+
+  switch ( type ) {
+    case FrameError:
+      if ( frame != "RECONFIGURE" )
+        mFrameError = true;
+      break;
+    case FramePush:
+      if ( readVarint( frame, pos, id ) && readVarint( frame, pos, timeStamp ) &&
+           readValues( frame, pos, values ) )
+        processValues( values, id );
+      break;
+    case FrameValues:
+      readValues( frame, pos, values );
+      processAnswer( values.isEmpty() ? QByteArray() : values.first(), mFrameError );
+      mFrameError = false;
+      break;
+    default:
+      /* This stream sends no commands that answer with a table */
+      processAnswer( frame, mFrameError );
+      mFrameError = false;
+      break;
+  }
+
+  return true;
+}
+
+void SensorStream::processText( const QByteArray &text )
+{
+  /* Drop error messages, they are enclosed in ESC characters */
+  QByteArray answer;
+  bool error = false;
+  int start = 0, escape;
+  while ( ( escape = text.indexOf( '\033', start ) ) >= 0 ) {
+    answer += text.mid( start, escape - start );
+    const int close = text.indexOf( '\033', escape + 1 );
+    if ( close < 0 ) {
+      start = text.size();
+      break;
+    }
+    if ( text.mid( escape + 1, close - escape - 1 ) != "RECONFIGURE" )
+      error = true;
+    start = close + 1;
+  }
+  answer += text.mid( start );
+
+  if ( !mConnected ) {
+    /* This was the welcome message */
+    mConnected = true;
+    if ( answer.contains( "\nProtocols: text binary" ) ) {
+      Request request;
+      request.type = Protocol;
+      request.serial = 0;
+      mPending.prepend( request );
+      mDevice->write( "protocol binary\n" );
+    }
+    foreach ( const QByteArray &command, mOutgoing )
+      mDevice->write( command );
+    mOutgoing.clear();
+    return;
+  }
+
+  if ( answer.startsWith( '@' ) ) {
+    /* Pushed values: "@<id> <time>" followed by one line per sensor */
+    QList<QByteArray> lines = answer.split( '\n' );
+    if ( lines.last().isEmpty() )
+      lines.removeLast();
+    const int id = lines.takeFirst().mid( 1 ).split( ' ' ).value( 0 ).toInt();
+    processValues( lines, id );
+    return;
+  }
+
+  processAnswer( answer, error );
+}
+
+void SensorStream::processValues( const QList<QByteArray> &values, int id )
+{
+  SensorDisplay *display = mSubscriptions.value( id );
+  if ( display )
+    display->streamValues( values );
+}
+
+void SensorStream::processAnswer( const QByteArray &answer, bool error )
+{
+  if ( mPending.isEmpty() )
+    return;
+
+  const Request request = mPending.dequeue();
+  if ( request.type == Protocol ) {
+    mBinary = !error && answer.startsWith( "binary" );
+    return;
+  }
+  if ( request.type != Subscribe )
+    return;
+
+  bool ok = false;
+  const int id = answer.split( '\n' ).value( 0 ).toInt( &ok );
+  if ( error || !ok ) {
+    /* An old ksysguardd, don't try again */
+    if ( answer.startsWith( "UNKNOWN COMMAND" ) )
+      mFailed = true;
+    if ( request.display && mSerials.value( request.display ) == request.serial ) {
+      mSerials.remove( request.display );
+      request.display->streamSubscribed( false );
+    }
+    return;
+  }
+
+  if ( !request.display || mSerials.value( request.display ) != request.serial ) {
+    /* The display has gone or changed its mind in the meantime */
+    Request cancel;
+    cancel.type = Unsubscribe;
+    cancel.serial = 0;
+    mPending.enqueue( cancel );
+    sendCommand( "unsubscribe " + QByteArray::number( id ) );
+    return;
+  }
+
+  mSerials.remove( request.display );
+  mSubscriptions.insert( id, request.display );
+  mIds.insert( request.display, id );
+  request.display->streamSubscribed( true );
+}
+
+/**
+  The local socket does not exist, we are not allowed to use it or the
+  daemon went away. Unless the daemon has already been talking to us,
+  start a private one instead.
+ */
+void SensorStream::localConnectionLost()
+{
+  /* The socket reports both the error and the disconnect */
+  if ( sender() != mDevice )
+    return;
+
+  if ( mConnected ) {
+    connectionLost();
+    return;
+  }
+
+  mDevice->disconnect( this );
+  mDevice->deleteLater();
+  mBuffer.clear();
+  startProcess();
+}
+
+void SensorStream::connectionLost()
+{
+  if ( mFailed )
+    return;
+  mFailed = true;
+
+  /* Let the displays fall back to polling */
+  QList<QPointer<SensorDisplay> > displays = mSubscriptions.values();
+  foreach ( const Request &request, mPending )
+    if ( request.display && mSerials.value( request.display ) == request.serial )
+      displays.append( request.display );
+
+  mPending.clear();
+  mSerials.clear();
+  mSubscriptions.clear();
+  mIds.clear();
+
+  foreach ( const QPointer<SensorDisplay> &display, displays )
+    if ( display )
+      display->streamSubscribed( false );
+}
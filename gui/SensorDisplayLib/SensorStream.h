@@ -0,0 +1,125 @@
+/*
+    KSysGuard, the KDE System Guard
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation; either version 2 of
+ the License or (at your option) version 3 or any later version
+ accepted by the membership of KDE e.V. (or its successor approved
+ by the membership of KDE e.V.), which shall act as a proxy
+ defined in Section 14 of version 3 of the license.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KSG_SENSORSTREAM_H
+#define KSG_SENSORSTREAM_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+#include <QStringList>
+
+class QIODevice;
+
+namespace KSGRD {
+
+class SensorDisplay;
+
+/**
+  A connection to ksysguardd that receives the values of subscribed
+  sensors without polling. ksysguardd pushes the values on its own
+  schedule, see 'subscribe' in ksysguardd/Porting-HOWTO.
+
+  The request/answer connections of the SensorManager cannot carry
+  unsolicited answers, so the stream uses a connection of its own. For
+  the local host it uses the Unix domain socket of a system wide
+  ksysguardd or, if there is none, starts a ksysguardd. Other hosts are
+  contacted on the ksysguardd port. All displays share one stream per
+  host. If the connection fails or the daemon does not know 'subscribe',
+  the displays are told so and keep polling.
+
+  If the daemon offers it, the stream switches to the binary protocol,
+  see ksysguardd/BinaryProtocol.h, so the pushed values need not be
+  parsed from text.
+ */
+class SensorStream : public QObject
+{
+  Q_OBJECT
+
+  public:
+    /**
+      Returns the stream to @p hostName, it is created on first use.
+     */
+    static SensorStream *stream( const QString &hostName, bool isLocalhost );
+
+    /**
+      Subscribes @p display to the sensors @p names, to be sent every
+      @p interval milliseconds. The display is told the outcome with
+      SensorDisplay::streamSubscribed() and receives the values with
+      SensorDisplay::streamValues(). A display has at most one
+      subscription, an older one is cancelled.
+     */
+    void subscribe( SensorDisplay *display, const QStringList &names, int interval );
+
+    /**
+      Cancels the subscription of @p display.
+     */
+    void unsubscribe( SensorDisplay *display );
+
+  private:
+    SensorStream( const QString &hostName, bool isLocalhost );
+
+    void readData();
+    bool readFrame();
+    void processText( const QByteArray &text );
+    void processAnswer( const QByteArray &answer, bool error );
+    void processValues( const QList<QByteArray> &values, int id );
+    void startProcess();
+    void localConnectionLost();
+    void connectionLost();
+    void sendCommand( const QByteArray &command );
+
+    QIODevice *mDevice;
+    QByteArray mBuffer;
+    bool mConnected;
+    bool mFailed;
+    bool mBinary;
+
+    /* Set by an error frame, it belongs to the next answer */
+    bool mFrameError;
+
+    /* Commands that are waiting to be sent until the welcome message of
+     * ksysguardd has been received */
+    QList<QByteArray> mOutgoing;
+
+    /* The commands that have not been answered yet, in order */
+    enum RequestType { Subscribe, Unsubscribe, Protocol };
+    struct Request {
+      RequestType type;
+      QPointer<SensorDisplay> display;
+      int serial;
+    };
+    QQueue<Request> mPending;
+    int mSerial;
+
+    /* The serial of the latest 'subscribe' of each display. Answers to
+     * older ones are cancelled right away. */
+    QHash<SensorDisplay *, int> mSerials;
+
+    QHash<int, QPointer<SensorDisplay> > mSubscriptions;
+    QHash<SensorDisplay *, int> mIds;
+};
+
+}
+
+#endif
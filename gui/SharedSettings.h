@@ -27,9 +27,12 @@
 class SharedSettings 
 {
   public:
-	SharedSettings() { locked = false; modified = false; }
+	SharedSettings() { locked = false; modified = false; updateInterval = 0; }
 	bool locked;
 	bool modified;
+	/* The update interval of the work sheet in milliseconds, 0 if the
+	 * displays are only updated on request */
+	int updateInterval;
 };
 
 #endif
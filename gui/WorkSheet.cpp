@@ -796,12 +796,19 @@ void WorkSheet::changeEvent( QEvent * event ) {
 
 void WorkSheet::setUpdateInterval( float secs)
 {
+    mSharedSettings.updateInterval = secs * 1000;
     if(secs == 0)
         mTimer.stop();
     else {
         mTimer.setInterval(secs*1000);
         mTimer.start();
     }
+
+    /* Subscriptions are only renewed on a tick, which may not come any more */
+    if (mGridLayout) {
+        for (int i = 0; i < mGridLayout->count(); i++)
+            static_cast<KSGRD::SensorDisplay*>(mGridLayout->itemAt(i)->widget())->updateIntervalChanged();
+    }
 }
 float WorkSheet::updateInterval() const
 {
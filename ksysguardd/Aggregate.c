@@ -0,0 +1,281 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Command.h"
+
+#include "Aggregate.h"
+
+/* The bucket bounds grow by GAMMA = ( 1 + a ) / ( 1 - a ) for a relative
+ * accuracy a of 1% */
+#define GAMMA		( 1.01 / 0.99 )
+
+/* Values closer to 0 than this share the bucket of 0 */
+#define SMALLEST	1e-9
+
+/* Buckets of positive values have keys above 0, those of negative
+ * values the same keys negated, so the keys are ordered like the
+ * values. The lowest bucket index is that of SMALLEST. */
+#define KEY_BIAS	2048
+
+typedef struct Bin {
+  int key;
+  unsigned int count;
+} Bin;
+
+typedef struct Summary {
+  unsigned int count;
+  double min;
+  double max;
+  double mean;
+  /* The sum of the squared differences from the mean */
+  double m2;
+  int bins;
+  Bin bin[ AGGREGATE_BINS ];
+} Summary;
+
+typedef struct Slot {
+  /* The start of the slot divided by the resolution, -1 if unused */
+  long long number;
+  Summary summary;
+} Slot;
+
+struct Aggregator {
+  unsigned int resolution;
+  int size;
+  long long latest;
+  Slot slots[];
+};
+
+static int valueKey( double value )
+{
+  double magnitude = fabs( value );
+  int index;
+
+  if ( magnitude < SMALLEST )
+    return 0;
+
+  index = (int)ceil( log( magnitude ) / log( GAMMA ) );
+  if ( index <= -KEY_BIAS )
+    index = -KEY_BIAS + 1;
+  else if ( index > 1000000 )
+    index = 1000000;
+
+  return value < 0 ? -( index + KEY_BIAS ) : index + KEY_BIAS;
+}
+
+/**
+  @return the value in the middle of the bucket @ref key.
+ */
+static double keyValue( int key )
+{
+  double value;
+
+  if ( key == 0 )
+    return 0;
+
+  value = 2 * pow( GAMMA, abs( key ) - KEY_BIAS ) / ( GAMMA + 1 );
+  return key < 0 ? -value : value;
+}
+
+/**
+  Adds @ref count values to the bucket @ref key. If all bins are in use
+  the two lowest buckets are merged first.
+ */
+static void addToBin( Summary* summary, int key, unsigned int count )
+{
+  Bin* bin = summary->bin;
+  int i;
+
+  for ( i = 0; i < summary->bins && bin[ i ].key < key; ++i )
+    ;
+
+  if ( i < summary->bins && bin[ i ].key == key ) {
+    bin[ i ].count += count;
+    return;
+  }
+
+  if ( summary->bins == AGGREGATE_BINS ) {
+    if ( i == 0 ) {
+      bin[ 0 ].count += count;
+      return;
+    }
+    bin[ 1 ].count += bin[ 0 ].count;
+    memmove( bin, bin + 1, ( summary->bins - 1 ) * sizeof( Bin ) );
+    summary->bins--;
+    i--;
+  }
+
+  memmove( bin + i + 1, bin + i, ( summary->bins - i ) * sizeof( Bin ) );
+  bin[ i ].key = key;
+  bin[ i ].count = count;
+  summary->bins++;
+}
+
+/**
+  Adds the values of @ref from to @ref to. The mean and the variance
+  are combined as described by Chan et al.
+ */
+static void mergeSummary( Summary* to, const Summary* from )
+{
+  unsigned int count = to->count + from->count;
+  double delta;
+  int i;
+
+  if ( from->count == 0 )
+    return;
+
+  if ( to->count == 0 ) {
+    *to = *from;
+    return;
+  }
+
+  delta = from->mean - to->mean;
+  to->m2 += from->m2 + delta * delta * to->count * from->count / count;
+  to->mean += delta * from->count / count;
+  to->count = count;
+  if ( from->min < to->min )
+    to->min = from->min;
+  if ( from->max > to->max )
+    to->max = from->max;
+
+  for ( i = 0; i < from->bins; ++i )
+    addToBin( to, from->bin[ i ].key, from->bin[ i ].count );
+}
+
+static double percentile( const Summary* summary, double p )
+{
+  double rank = p / 100 * ( summary->count - 1 );
+  double seen = 0, value;
+  int i;
+
+  for ( i = 0; i < summary->bins; ++i ) {
+    seen += summary->bin[ i ].count;
+    if ( seen > rank )
+      break;
+  }
+  if ( i == summary->bins )
+    i--;
+
+  /* The bounds are exact, the buckets are not */
+  value = keyValue( summary->bin[ i ].key );
+  if ( value < summary->min )
+    return summary->min;
+  if ( value > summary->max )
+    return summary->max;
+  return value;
+}
+
+Aggregator* newAggregator( unsigned int window, unsigned int resolution )
+{
+  Aggregator* aggregator;
+  unsigned long long size;
+  int i;
+
+  if ( resolution == 0 )
+    resolution = 1;
+
+  /* The current slot is only partly within the window */
+  size = ( (unsigned long long)window * 1000 + resolution - 1 ) / resolution + 1;
+  if ( size > 100000 )
+    size = 100000;
+
+  if ( ( aggregator = (Aggregator*)malloc( sizeof( Aggregator ) + size * sizeof( Slot ) ) ) == NULL )
+    return NULL;
+
+  aggregator->resolution = resolution;
+  aggregator->size = size;
+  aggregator->latest = -1;
+  for ( i = 0; i < aggregator->size; ++i )
+    aggregator->slots[ i ].number = -1;
+
+  return aggregator;
+}
+
+void freeAggregator( Aggregator* aggregator )
+{
+  free( aggregator );
+}
+
+void addAggregatorSample( Aggregator* aggregator, long long time, double value )
+{
+  long long number = time / aggregator->resolution;
+  Slot* slot = &aggregator->slots[ number % aggregator->size ];
+  Summary* summary = &slot->summary;
+  double delta;
+
+  if ( number < aggregator->latest || value != value )
+    return;
+  aggregator->latest = number;
+
+  if ( slot->number != number ) {
+    slot->number = number;
+    summary->count = 0;
+    summary->bins = 0;
+    summary->mean = summary->m2 = 0;
+    summary->min = summary->max = value;
+  }
+
+  /* Welford's update of the mean and the variance */
+  summary->count++;
+  delta = value - summary->mean;
+  summary->mean += delta / summary->count;
+  summary->m2 += delta * ( value - summary->mean );
+  if ( value < summary->min )
+    summary->min = value;
+  if ( value > summary->max )
+    summary->max = value;
+
+  addToBin( summary, valueKey( value ), 1 );
+}
+
+void printAggregate( const Aggregator* aggregator, long long now, unsigned int seconds,
+                     const double* percentiles, int count )
+{
+  long long last = now / aggregator->resolution;
+  long long first = last - ( (long long)seconds * 1000 + aggregator->resolution - 1 ) / aggregator->resolution + 1;
+  Summary total;
+  int i;
+
+  if ( first <= last - aggregator->size )
+    first = last - aggregator->size + 1;
+
+  memset( &total, 0, sizeof( total ) );
+  for ( i = 0; i < aggregator->size; ++i ) {
+    const Slot* slot = &aggregator->slots[ i ];
+    if ( slot->number >= first && slot->number <= last )
+      mergeSummary( &total, &slot->summary );
+  }
+
+  if ( total.count == 0 ) {
+    output( "0\t0\t0\t0\t0" );
+    for ( i = 0; i < count; ++i )
+      output( "\t0" );
+    output( "\n" );
+    return;
+  }
+
+  output( "%u\t%f\t%f\t%f\t%f", total.count, total.min, total.max, total.mean,
+          sqrt( total.m2 / total.count ) );
+  for ( i = 0; i < count; ++i )
+    output( "\t%f", percentile( &total, percentiles[ i ] ) );
+  output( "\n" );
+}
@@ -0,0 +1,67 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#ifndef KSG_AGGREGATE_H
+#define KSG_AGGREGATE_H
+
+/**
+  Summaries of the values of a numeric sensor over sliding windows.
+
+  The time is split into slots of @ref resolution ms. Every slot keeps
+  the count, minimum, maximum, mean and variance of its values and a
+  sketch of their distribution, so the memory does not depend on how
+  often the sensor is sampled. A window is made up of the slots it
+  covers, the current one included, so its length is rounded up to the
+  resolution.
+
+  The sketch puts every value into a bucket whose bounds grow by about
+  2% each, so percentiles are off by at most 1% of the value. A slot
+  holds at most AGGREGATE_BINS buckets. If there are more, the lowest
+  are merged, which only makes the lower percentiles less accurate.
+ */
+typedef struct Aggregator Aggregator;
+
+#define AGGREGATE_BINS	32
+
+/* The number of percentiles that can be asked for at once */
+#define AGGREGATE_MAX_PERCENTILES	16
+
+/**
+  @return an aggregator for windows of up to @ref window seconds with
+  slots of @ref resolution ms or 0 if there is no memory.
+ */
+Aggregator* newAggregator( unsigned int window, unsigned int resolution );
+
+void freeAggregator( Aggregator* aggregator );
+
+/**
+  Adds @ref value, taken at @ref time ms since the epoch. Values older
+  than the latest slot are ignored.
+ */
+void addAggregatorSample( Aggregator* aggregator, long long time, double value );
+
+/**
+  Prints the summary of the last @ref seconds before @ref now (ms since
+  the epoch) as one line: the number of values, the minimum, the
+  maximum, the mean, the standard deviation and the @ref count
+  percentiles in @ref percentiles, separated by tabs.
+ */
+void printAggregate( const Aggregator* aggregator, long long now, unsigned int seconds,
+                     const double* percentiles, int count );
+
+#endif
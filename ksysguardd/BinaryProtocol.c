@@ -0,0 +1,415 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Command.h"
+#include "OutputSink.h"
+
+#include "BinaryProtocol.h"
+
+/* Longest number that is recognized as integer or double */
+#define MAX_NUMBER_LENGTH	64
+
+/**
+  A growable byte buffer for the payload of a frame.
+ */
+typedef struct {
+  unsigned char* data;
+  size_t length;
+  size_t size;
+  int failed;
+} Buffer;
+
+/* The buffers are reused for all frames to avoid reallocations */
+static Buffer Payload = { 0, 0, 0, 0 };
+static Buffer Answer = { 0, 0, 0, 0 };
+
+static void putBytes( Buffer* buffer, const void* data, size_t length )
+{
+  if ( length == 0 )
+    return;
+
+  if ( buffer->length + length > buffer->size ) {
+    size_t newSize = buffer->size ? buffer->size : 4096;
+    unsigned char* newData;
+
+    while ( newSize < buffer->length + length )
+      newSize *= 2;
+
+    if ( ( newData = (unsigned char*)realloc( buffer->data, newSize ) ) == NULL ) {
+      buffer->failed = 1;
+      return;
+    }
+    buffer->data = newData;
+    buffer->size = newSize;
+  }
+
+  memcpy( buffer->data + buffer->length, data, length );
+  buffer->length += length;
+}
+
+static void putByte( Buffer* buffer, unsigned char byte )
+{
+  putBytes( buffer, &byte, 1 );
+}
+
+static size_t encodeVarint( unsigned char* data, unsigned long long value )
+{
+  size_t length = 0;
+
+  while ( value >= 0x80 ) {
+    data[ length++ ] = (unsigned char)( value | 0x80 );
+    value >>= 7;
+  }
+  data[ length++ ] = (unsigned char)value;
+
+  return length;
+}
+
+static void putVarint( Buffer* buffer, unsigned long long value )
+{
+  unsigned char data[ 10 ];
+
+  putBytes( buffer, data, encodeVarint( data, value ) );
+}
+
+static void putInteger( Buffer* buffer, long long value )
+{
+  putVarint( buffer, ( (unsigned long long)value << 1 ) ^ (unsigned long long)( value >> 63 ) );
+}
+
+static void putDouble( Buffer* buffer, double value )
+{
+  unsigned char data[ 8 ];
+  uint64_t bits;
+  int i;
+
+  memcpy( &bits, &value, sizeof( bits ) );
+  for ( i = 0; i < 8; ++i, bits >>= 8 )
+    data[ i ] = (unsigned char)bits;
+
+  putBytes( buffer, data, 8 );
+}
+
+static void putString( Buffer* buffer, const char* text, size_t length )
+{
+  putVarint( buffer, length );
+  putBytes( buffer, text, length );
+}
+
+static void writeFrame( OutputSink* out, int type, const Buffer* payload )
+{
+  unsigned char header[ 11 ];
+  size_t length = encodeVarint( header, payload->length + 1 );
+
+  header[ length++ ] = (unsigned char)type;
+  sinkWrite( out, (const char*)header, length );
+  sinkWrite( out, (const char*)payload->data, payload->length );
+}
+
+/**
+  Recognizes integers the way the modules print them, so that they
+  survive a round trip unchanged. Leading zeros or a '+' make a string.
+ */
+static int parseInteger( const char* text, size_t length, long long* value )
+{
+  char number[ MAX_NUMBER_LENGTH ];
+  const char* digits = text;
+  char* end;
+
+  if ( length > 0 && *digits == '-' )
+    ++digits;
+  if ( digits == text + length || length >= MAX_NUMBER_LENGTH ||
+       ( *digits == '0' && digits + 1 != text + length ) )
+    return 0;
+
+  for ( ; digits < text + length; ++digits )
+    if ( *digits < '0' || *digits > '9' )
+      return 0;
+
+  memcpy( number, text, length );
+  number[ length ] = '\0';
+  errno = 0;
+  *value = strtoll( number, &end, 10 );
+
+  return errno == 0;
+}
+
+/**
+  Recognizes numbers printed with %f.
+ */
+static int parseDouble( const char* text, size_t length, double* value )
+{
+  char number[ MAX_NUMBER_LENGTH ];
+  const char* p = text;
+  int digits = 0, dots = 0;
+
+  if ( length >= MAX_NUMBER_LENGTH )
+    return 0;
+
+  if ( length > 0 && *p == '-' )
+    ++p;
+  for ( ; p < text + length; ++p ) {
+    if ( *p == '.' )
+      ++dots;
+    else if ( *p >= '0' && *p <= '9' )
+      ++digits;
+    else
+      return 0;
+  }
+  if ( digits == 0 || dots != 1 )
+    return 0;
+
+  memcpy( number, text, length );
+  number[ length ] = '\0';
+  *value = strtod( number, NULL );
+
+  return 1;
+}
+
+static void putValue( Buffer* buffer, const char* text, size_t length )
+{
+  long long integer;
+  double real;
+
+  if ( length == strlen( "UNKNOWN SENSOR" ) && !memcmp( text, "UNKNOWN SENSOR", length ) )
+    putByte( buffer, VALUE_UNKNOWN );
+  else if ( parseInteger( text, length, &integer ) ) {
+    putByte( buffer, VALUE_INTEGER );
+    putInteger( buffer, integer );
+  } else if ( parseDouble( text, length, &real ) ) {
+    putByte( buffer, VALUE_DOUBLE );
+    putDouble( buffer, real );
+  } else {
+    putByte( buffer, VALUE_STRING );
+    putString( buffer, text, length );
+  }
+}
+
+/**
+  Appends the count and the values of the lines of @ref text.
+ */
+static void putValues( Buffer* buffer, const char* text, size_t length )
+{
+  const char* end = text + length;
+  const char* line;
+  const char* newline;
+  unsigned long count = 0;
+
+  for ( line = text; line < end; line = newline + 1 ) {
+    if ( ( newline = memchr( line, '\n', end - line ) ) == NULL )
+      newline = end;
+    ++count;
+  }
+
+  putVarint( buffer, count );
+
+  for ( line = text; line < end; line = newline + 1 ) {
+    if ( ( newline = memchr( line, '\n', end - line ) ) == NULL )
+      newline = end;
+    putValue( buffer, line, newline - line );
+  }
+}
+
+/**
+  Returns the type of the cell, VALUE_INTEGER for integers, VALUE_DOUBLE
+  for doubles and VALUE_STRING for everything else.
+ */
+static int cellType( const char* text, size_t length )
+{
+  long long integer;
+  double real;
+
+  if ( parseInteger( text, length, &integer ) )
+    return VALUE_INTEGER;
+  if ( parseDouble( text, length, &real ) )
+    return VALUE_DOUBLE;
+  return VALUE_STRING;
+}
+
+/**
+  Encodes the tab separated table @ref text. A column is only sent as
+  numbers if every cell of it is a number, so the rows are scanned twice.
+ */
+static void putTable( Buffer* buffer, const char* text, size_t length )
+{
+  const char* end = text + length;
+  const char* line;
+  const char* newline;
+  unsigned char* types = NULL;
+  unsigned long columns = 0, rows = 0, i;
+
+  for ( line = text; line < end; line = newline + 1 ) {
+    const char* cell = line;
+    unsigned long column = 0;
+
+    if ( ( newline = memchr( line, '\n', end - line ) ) == NULL )
+      newline = end;
+    if ( newline == line )
+      continue;
+    ++rows;
+
+    for ( ;; ) {
+      const char* tab = memchr( cell, '\t', newline - cell );
+      int type = cellType( cell, ( tab ? tab : newline ) - cell );
+
+      if ( column == columns ) {
+        unsigned char* newTypes = (unsigned char*)realloc( types, columns + 1 );
+        if ( !newTypes ) {
+          free( types );
+          buffer->failed = 1;
+          return;
+        }
+        types = newTypes;
+        /* Earlier rows did not have this column */
+        types[ columns++ ] = rows > 1 ? VALUE_STRING : type;
+      } else if ( type > types[ column ] )
+        types[ column ] = type;
+
+      ++column;
+      if ( !tab )
+        break;
+      cell = tab + 1;
+    }
+
+    /* Cells missing in this row are sent as empty strings */
+    for ( i = column; i < columns; ++i )
+      types[ i ] = VALUE_STRING;
+  }
+
+  putVarint( buffer, columns );
+  putBytes( buffer, types, columns );
+  putVarint( buffer, rows );
+
+  for ( line = text; line < end; line = newline + 1 ) {
+    const char* cell = line;
+
+    if ( ( newline = memchr( line, '\n', end - line ) ) == NULL )
+      newline = end;
+    if ( newline == line )
+      continue;
+
+    for ( i = 0; i < columns; ++i ) {
+      const char* tab = cell ? memchr( cell, '\t', newline - cell ) : NULL;
+      size_t cellLength = cell ? (size_t)( ( tab ? tab : newline ) - cell ) : 0;
+      long long integer = 0;
+      double real = 0;
+
+      switch ( types[ i ] ) {
+        case VALUE_INTEGER:
+          parseInteger( cell, cellLength, &integer );
+          putInteger( buffer, integer );
+          break;
+        case VALUE_DOUBLE:
+          /* Integers are valid doubles as well */
+          if ( parseInteger( cell, cellLength, &integer ) )
+            real = (double)integer;
+          else
+            parseDouble( cell, cellLength, &real );
+          putDouble( buffer, real );
+          break;
+        default:
+          putString( buffer, cell ? cell : "", cellLength );
+          break;
+      }
+
+      cell = tab ? tab + 1 : NULL;
+    }
+  }
+
+  free( types );
+}
+
+/**
+  Sends the error messages in @ref text as frames and copies the rest of
+  the text to Answer.
+ */
+static void splitErrors( OutputSink* out, const char* text, size_t length )
+{
+  const char* end = text + length;
+  const char* escape;
+
+  Answer.length = 0;
+  while ( ( escape = memchr( text, '\033', end - text ) ) != NULL ) {
+    const char* close = memchr( escape + 1, '\033', end - escape - 1 );
+
+    putBytes( &Answer, text, escape - text );
+    if ( !close ) {
+      text = end;
+      break;
+    }
+
+    Payload.length = 0;
+    putBytes( &Payload, escape + 1, close - escape - 1 );
+    writeFrame( out, FRAME_ERROR, &Payload );
+    text = close + 1;
+  }
+  putBytes( &Answer, text, end - text );
+}
+
+void writeBinaryAnswer( OutputSink* out, int answerType, const char* text, size_t length )
+{
+  const char* answer;
+
+  splitErrors( out, text, length );
+  answer = (const char*)Answer.data;
+  length = Answer.length;
+
+  Payload.length = 0;
+  switch ( answerType ) {
+    case ANSWER_VALUES:
+      putValues( &Payload, answer, length );
+      writeFrame( out, FRAME_VALUES, &Payload );
+      break;
+    case ANSWER_TABLE:
+      putTable( &Payload, answer, length );
+      writeFrame( out, FRAME_TABLE, &Payload );
+      break;
+    default:
+      putBytes( &Payload, answer, length );
+      writeFrame( out, FRAME_TEXT, &Payload );
+      break;
+  }
+
+  if ( Payload.failed || Answer.failed ) {
+    Payload.failed = Answer.failed = 0;
+    out->failed = 1;
+  }
+}
+
+void writeBinaryPush( OutputSink* out, unsigned int id, unsigned long long timeStamp,
+                      const char* text, size_t length )
+{
+  splitErrors( out, text, length );
+
+  Payload.length = 0;
+  putVarint( &Payload, id );
+  putVarint( &Payload, timeStamp );
+  putValues( &Payload, (const char*)Answer.data, Answer.length );
+  writeFrame( out, FRAME_PUSH, &Payload );
+
+  if ( Payload.failed || Answer.failed ) {
+    Payload.failed = Answer.failed = 0;
+    out->failed = 1;
+  }
+}
@@ -0,0 +1,79 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+
+#ifndef KSG_BINARYPROTOCOL_H
+#define KSG_BINARYPROTOCOL_H
+
+#include <stddef.h>
+
+struct OutputSink;
+
+/**
+  After 'protocol binary' all answers to a client are sent as frames
+  instead of text followed by the prompt. A frame is
+
+    length (varint) type (1 byte) payload (length - 1 bytes)
+
+  Varints are unsigned LEB128, signed integers are zigzag encoded
+  before, doubles are 8 bytes IEEE 754 in little endian order and
+  strings are a varint length followed by the UTF-8 bytes.
+
+  FRAME_TEXT    The answer as it would have been sent in text mode.
+  FRAME_ERROR   An error message, e.g. "RECONFIGURE". Errors belong to
+                the answer frame that follows them.
+  FRAME_VALUES  count (varint) followed by count values. Each value is
+                a tag byte and the value: VALUE_INTEGER, VALUE_DOUBLE,
+                VALUE_STRING or VALUE_UNKNOWN without data.
+  FRAME_TABLE   columns (varint), the type of each column (1 byte,
+                VALUE_INTEGER, VALUE_DOUBLE or VALUE_STRING), rows
+                (varint) and the cells row by row without tags.
+  FRAME_PUSH    Pushed values of a subscription: id (varint), time
+                stamp in ms (varint) and the payload of FRAME_VALUES.
+
+  Each command is answered with any number of FRAME_ERROR frames and
+  exactly one answer frame. The welcome message announces the binary
+  protocol with a "Protocols: text binary" line.
+ */
+
+#define FRAME_TEXT	1
+#define FRAME_ERROR	2
+#define FRAME_VALUES	3
+#define FRAME_TABLE	4
+#define FRAME_PUSH	5
+
+#define VALUE_INTEGER	0
+#define VALUE_DOUBLE	1
+#define VALUE_STRING	2
+#define VALUE_UNKNOWN	3
+
+/**
+  Encodes the text answer @ref text of a command as frames. @ref
+  answerType is one of the ANSWER_* constants from Command.h.
+ */
+void writeBinaryAnswer( struct OutputSink* out, int answerType,
+                        const char* text, size_t length );
+
+/**
+  Encodes the text of a pushed sample as FRAME_PUSH.
+ */
+void writeBinaryPush( struct OutputSink* out, unsigned int id,
+                      unsigned long long timeStamp, const char* text,
+                      size_t length );
+
+#endif
@@ -356,7 +356,7 @@ void bsort_ctnr(CONTAINER rootNode, COMPARE_FUNC compare_func)
 					/* q is empty; e must come from p. */
 					e = p; p = p->next; psize--;
 					if (p == oldhead) p = NULL;
-				} else if (compare_func(p,q) <= 0) {
+				} else if (compare_func(p->data, q->data) <= 0) {
 					/* First element of p is lower (or same);
 					 * e must come from p. */
 					e = p; p = p->next; psize--;
@@ -31,6 +31,14 @@
 
 #define destr_ctnr(x, y) zero_destr_ctnr(x, y); x=0
 
+/**
+ * A doubly linked list of object pointers with an internal iterator.
+ *
+ * Every node is a separate allocation and access by index is O(n). New
+ * code should use the vector of vector.h, the hash table of htbl.h or
+ * the intrusive list of ilist.h instead. The container is kept for the
+ * ports that still use it.
+ */
 struct container {
 	struct container* next;
 	struct container* prev;
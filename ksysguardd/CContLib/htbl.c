@@ -0,0 +1,263 @@
+/*
+    Lightweight C Container Library
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public License
+    along with this library; see the file COPYING.LIB.  If not, write to
+    the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+    Boston, MA 02110-1301, USA.
+
+*/
+
+#include "htbl.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* A removed entry. Lookups have to probe past it, inserts may reuse it. */
+#define TOMBSTONE ((void*) &tombstone)
+static char tombstone;
+
+#define MIN_SIZE 16
+
+struct htbl_slot {
+	const void* key;
+	size_t keyLen;
+	unsigned long hash;
+	void* data;
+};
+
+struct htbl {
+	struct htbl_slot* slots;
+	INDEX size;	/* always a power of two */
+	INDEX count;	/* live entries */
+	INDEX used;	/* live entries and tombstones */
+};
+
+#define rpterr(x) fprintf(stderr, "%s\n", x)
+
+/* FNV-1a */
+static unsigned long hash_key(const void* key, size_t keyLen)
+{
+	const unsigned char* p = key;
+	unsigned long hash = 2166136261UL;
+	size_t i;
+
+	for (i = 0; i < keyLen; ++i) {
+		hash ^= p[i];
+		hash *= 16777619UL;
+	}
+
+	return hash;
+}
+
+/* O(1) on average. Returns the slot holding key or the first free one. */
+static struct htbl_slot* find_slot(HTBL htbl, const void* key, size_t keyLen,
+				   unsigned long hash)
+{
+	INDEX mask = htbl->size - 1;
+	INDEX i = hash & mask;
+	struct htbl_slot* reuse = NIL;
+
+	for (;;) {
+		struct htbl_slot* slot = &htbl->slots[i];
+
+		if (slot->data == NIL)
+			return reuse ? reuse : slot;
+
+		if (slot->data == TOMBSTONE) {
+			if (!reuse)
+				reuse = slot;
+		} else if (slot->hash == hash && slot->keyLen == keyLen &&
+			   memcmp(slot->key, key, keyLen) == 0)
+			return slot;
+
+		i = (i + 1) & mask;
+	}
+}
+
+/* O(n) */
+static int resize_htbl(HTBL htbl, INDEX size)
+{
+	struct htbl_slot* old = htbl->slots;
+	INDEX oldSize = htbl->size;
+	INDEX i;
+
+	htbl->slots = (struct htbl_slot*)calloc(size, sizeof(struct htbl_slot));
+	if (htbl->slots == NIL) {
+		htbl->slots = old;
+		return -1;
+	}
+
+	htbl->size = size;
+	htbl->used = htbl->count;
+
+	for (i = 0; i < oldSize; ++i) {
+		if (old[i].data != NIL && old[i].data != TOMBSTONE)
+			*find_slot(htbl, old[i].key, old[i].keyLen, old[i].hash) = old[i];
+	}
+
+	free(old);
+
+	return 0;
+}
+
+HTBL new_htbl(void)
+{
+	HTBL htbl;
+
+	if ((htbl = (HTBL)malloc(sizeof(struct htbl))) == NIL)
+		return NIL;
+
+	htbl->slots = (struct htbl_slot*)calloc(MIN_SIZE, sizeof(struct htbl_slot));
+	if (htbl->slots == NIL) {
+		free(htbl);
+		return NIL;
+	}
+
+	htbl->size = MIN_SIZE;
+	htbl->count = 0;
+	htbl->used = 0;
+
+	return htbl;
+}
+
+/* O(n) */
+void zero_destr_htbl(HTBL htbl, DESTR_FUNC destr_func)
+{
+	INDEX i;
+
+	if (htbl == NIL) {
+		rpterr("destr_htbl: NIL argument");
+		return;
+	}
+
+	if (destr_func) {
+		for (i = 0; i < htbl->size; ++i) {
+			if (htbl->slots[i].data != NIL && htbl->slots[i].data != TOMBSTONE)
+				destr_func(htbl->slots[i].data);
+		}
+	}
+
+	free(htbl->slots);
+	free(htbl);
+}
+
+/* O(1) */
+INDEX level_htbl(HTBL htbl)
+{
+	if (htbl == NIL) {
+		rpterr("level_htbl: NIL argument");
+		return -1;
+	}
+
+	return htbl->count;
+}
+
+/* O(1) on average */
+int put_htbl(HTBL htbl, const void* key, size_t keyLen, void* object)
+{
+	struct htbl_slot* slot;
+	unsigned long hash;
+
+	if (htbl == NIL || key == NIL || object == NIL) {
+		rpterr("put_htbl: NIL argument");
+		return -1;
+	}
+
+	/* Keep the load factor including tombstones below 3/4 */
+	if ((htbl->used + 1) * 4 > htbl->size * 3) {
+		INDEX size = htbl->size;
+
+		/* Only grow if the table is really filled with live entries,
+		   otherwise just get rid of the tombstones. */
+		if ((htbl->count + 1) * 2 > size)
+			size *= 2;
+		if (resize_htbl(htbl, size) < 0)
+			return -1;
+	}
+
+	hash = hash_key(key, keyLen);
+	slot = find_slot(htbl, key, keyLen, hash);
+
+	if (slot->data == NIL) {
+		htbl->used++;
+		htbl->count++;
+	} else if (slot->data == TOMBSTONE)
+		htbl->count++;
+
+	slot->key = key;
+	slot->keyLen = keyLen;
+	slot->hash = hash;
+	slot->data = object;
+
+	return 0;
+}
+
+/* O(1) on average */
+void* get_htbl(HTBL htbl, const void* key, size_t keyLen)
+{
+	struct htbl_slot* slot;
+
+	if (htbl == NIL || key == NIL) {
+		rpterr("get_htbl: NIL argument");
+		return NIL;
+	}
+
+	slot = find_slot(htbl, key, keyLen, hash_key(key, keyLen));
+	if (slot->data == TOMBSTONE)
+		return NIL;
+
+	return slot->data;
+}
+
+/* O(1) on average */
+void* remove_htbl(HTBL htbl, const void* key, size_t keyLen)
+{
+	struct htbl_slot* slot;
+	void* retval;
+
+	if (htbl == NIL || key == NIL) {
+		rpterr("remove_htbl: NIL argument");
+		return NIL;
+	}
+
+	slot = find_slot(htbl, key, keyLen, hash_key(key, keyLen));
+	if (slot->data == NIL || slot->data == TOMBSTONE)
+		return NIL;
+
+	retval = slot->data;
+	slot->data = TOMBSTONE;
+	slot->key = NIL;
+	htbl->count--;
+
+	return retval;
+}
+
+/* O(1) amortized */
+void* iter_htbl(HTBL htbl, INDEX* pos)
+{
+	if (htbl == NIL || pos == NIL) {
+		rpterr("iter_htbl: NIL argument");
+		return NIL;
+	}
+
+	while (*pos < htbl->size) {
+		void* data = htbl->slots[(*pos)++].data;
+
+		if (data != NIL && data != TOMBSTONE)
+			return data;
+	}
+
+	return NIL;
+}
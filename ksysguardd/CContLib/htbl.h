@@ -0,0 +1,94 @@
+/*
+    Lightweight C Container Library
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public License
+    along with this library; see the file COPYING.LIB.  If not, write to
+    the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+    Boston, MA 02110-1301, USA.
+
+*/
+
+#ifndef _HTBL_H
+#define _HTBL_H
+
+#include <stddef.h>
+
+#include "ccont.h"
+
+#define destr_htbl(x, y) zero_destr_htbl(x, y); x=0
+
+/**
+ * An open addressing hash table that maps byte string keys to objects.
+ *
+ * The table does not copy the keys. The memory a key points to must stay
+ * valid as long as the entry is in the table, so usually the key is part
+ * of the object itself.
+ */
+typedef struct htbl* HTBL;
+
+/**
+ * Create an empty hash table.
+ */
+HTBL new_htbl(void);
+
+/**
+ * Remove all entries from @p htbl and free the table.
+ *
+ * Note: use the 'destr_htbl' macro to get zeroed pointer
+ *       automatically.
+ *
+ * @param destr_func The function that is called to free the
+ *                   single entries, may be @p 0.
+ */
+void zero_destr_htbl(HTBL htbl, DESTR_FUNC destr_func);
+
+/**
+ * @return the number of entries in @p htbl.
+ */
+INDEX level_htbl(HTBL htbl);
+
+/**
+ * Add @p object under @p key. An existing entry with the same key is
+ * replaced.
+ *
+ * @return 0 on success or -1 if no memory is available.
+ */
+int put_htbl(HTBL htbl, const void* key, size_t keyLen, void* object);
+
+/**
+ * @return the object stored under @p key or @p 0L if there is none.
+ */
+void* get_htbl(HTBL htbl, const void* key, size_t keyLen);
+
+/**
+ * Remove the entry with @p key.
+ *
+ * @return A pointer to the removed object or @p 0L if it doesn't exist.
+ */
+void* remove_htbl(HTBL htbl, const void* key, size_t keyLen);
+
+/**
+ * Use this function to iterate over the table. The order is arbitrary.
+ * The iteration state is kept in @p pos, so nested iterations are fine.
+ * Do not add entries while iterating.
+ *
+ * INDEX pos = 0;
+ * while ((ptr = iter_htbl(htbl, &pos))) {
+ * 	do_anything(ptr);
+ * }
+ *
+ * @return A pointer to the next object or @p 0L at the end.
+ */
+void* iter_htbl(HTBL htbl, INDEX* pos);
+
+#endif
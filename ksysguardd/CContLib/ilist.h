@@ -0,0 +1,117 @@
+/*
+    Lightweight C Container Library
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public License
+    along with this library; see the file COPYING.LIB.  If not, write to
+    the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+    Boston, MA 02110-1301, USA.
+
+*/
+
+#ifndef _ILIST_H
+#define _ILIST_H
+
+#include <stddef.h>
+
+#include "ccont.h"
+
+/**
+ * An intrusive doubly linked list. The links are part of the objects,
+ * so adding and removing an object needs no memory allocation and an
+ * object can remove itself in O(1). Iterators are plain node pointers,
+ * so nested iterations are fine. To remove the current node while
+ * iterating, fetch the next one first:
+ *
+ * for (node = first_ilist(&list); node; node = next) {
+ * 	next = next_ilist(&list, node);
+ * 	obj = ILIST_ENTRY(node, struct obj, link);
+ * 	if (obsolete(obj)) {
+ * 		remove_ilist(&list, node);
+ * 		free(obj);
+ * 	}
+ * }
+ */
+struct ilist_node {
+	struct ilist_node* next;
+	struct ilist_node* prev;
+};
+
+typedef struct ilist {
+	struct ilist_node head;
+	INDEX count;
+} ILIST;
+
+/**
+ * @return the object of type @p type that contains @p node as @p member.
+ */
+#define ILIST_ENTRY(node, type, member) \
+	((type*)((char*)(node) - offsetof(type, member)))
+
+/**
+ * Initialize @p list as empty list.
+ */
+static inline void init_ilist(ILIST* list)
+{
+	list->head.next = &list->head;
+	list->head.prev = &list->head;
+	list->count = 0;
+}
+
+/**
+ * @return the number of nodes in @p list.
+ */
+static inline INDEX level_ilist(const ILIST* list)
+{
+	return list->count;
+}
+
+/**
+ * Add @p node at the end of @p list.
+ */
+static inline void push_ilist(ILIST* list, struct ilist_node* node)
+{
+	node->next = &list->head;
+	node->prev = list->head.prev;
+	list->head.prev->next = node;
+	list->head.prev = node;
+	list->count++;
+}
+
+/**
+ * Remove @p node from @p list. O(1)
+ */
+static inline void remove_ilist(ILIST* list, struct ilist_node* node)
+{
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+	node->next = node->prev = 0;
+	list->count--;
+}
+
+/**
+ * @return the first node of @p list or @p 0L if it is empty.
+ */
+static inline struct ilist_node* first_ilist(const ILIST* list)
+{
+	return (list->head.next != &list->head) ? list->head.next : 0;
+}
+
+/**
+ * @return the node after @p node or @p 0L at the end of @p list.
+ */
+static inline struct ilist_node* next_ilist(const ILIST* list, const struct ilist_node* node)
+{
+	return (node->next != &list->head) ? node->next : 0;
+}
+
+#endif
@@ -0,0 +1,220 @@
+/*
+    Lightweight C Container Library
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public License
+    along with this library; see the file COPYING.LIB.  If not, write to
+    the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+    Boston, MA 02110-1301, USA.
+
+*/
+
+#include "vector.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MIN_SIZE 16
+
+#define rpterr(x) fprintf(stderr, "%s\n", x)
+
+static int grow_vctr(VECTOR vctr)
+{
+	INDEX size = vctr->size ? vctr->size * 2 : MIN_SIZE;
+	void** data = (void**)realloc(vctr->data, size * sizeof(void*));
+
+	if (data == NIL)
+		return -1;
+
+	vctr->data = data;
+	vctr->size = size;
+	return 0;
+}
+
+/* Merges the sorted runs [from, middle) and [middle, to) of data */
+static void merge(void** data, void** tmp, INDEX from, INDEX middle, INDEX to,
+                  COMPARE_FUNC compare_func)
+{
+	INDEX i = from, j = middle, k = 0;
+
+	/* The runs are already in order */
+	if (compare_func(data[middle - 1], data[middle]) <= 0)
+		return;
+
+	while (i < middle && j < to)
+		tmp[k++] = (compare_func(data[j], data[i]) < 0) ? data[j++] : data[i++];
+	while (i < middle)
+		tmp[k++] = data[i++];
+
+	/* The rest of the second run is already in place */
+	memcpy(data + from, tmp, k * sizeof(void*));
+}
+
+VECTOR new_vctr(void)
+{
+	VECTOR vctr = (VECTOR)calloc(1, sizeof(struct vctr));
+
+	if (vctr == NIL)
+		rpterr("new_vctr: no memory");
+
+	return vctr;
+}
+
+/* O(n) */
+void zero_destr_vctr(VECTOR vctr, DESTR_FUNC destr_func)
+{
+	if (vctr == NIL)
+		return;
+
+	empty_vctr(vctr, destr_func);
+	free(vctr->data);
+	free(vctr);
+}
+
+/* O(n) */
+void empty_vctr(VECTOR vctr, DESTR_FUNC destr_func)
+{
+	INDEX i;
+
+	if (vctr == NIL) {
+		rpterr("empty_vctr: NIL argument");
+		return;
+	}
+
+	if (destr_func)
+		for (i = 0; i < vctr->count; i++)
+			destr_func(vctr->data[i]);
+
+	vctr->count = 0;
+}
+
+/* amortized O(1) */
+int push_vctr(VECTOR vctr, void* object)
+{
+	if (vctr == NIL) {
+		rpterr("push_vctr: NIL argument");
+		return -1;
+	}
+
+	if (vctr->count == vctr->size && grow_vctr(vctr) < 0)
+		return -1;
+
+	vctr->data[vctr->count++] = object;
+	return 0;
+}
+
+/* O(n) */
+int insert_vctr(VECTOR vctr, void* object, INDEX pos)
+{
+	if (vctr == NIL || pos < 0 || pos > vctr->count) {
+		rpterr("insert_vctr: invalid argument");
+		return -1;
+	}
+
+	if (vctr->count == vctr->size && grow_vctr(vctr) < 0)
+		return -1;
+
+	memmove(vctr->data + pos + 1, vctr->data + pos, (vctr->count - pos) * sizeof(void*));
+	vctr->data[pos] = object;
+	vctr->count++;
+	return 0;
+}
+
+/* O(n) */
+void* remove_at_vctr(VECTOR vctr, INDEX pos)
+{
+	void* retval;
+
+	if (vctr == NIL || pos < 0 || pos >= vctr->count)
+		return NIL;
+
+	retval = vctr->data[pos];
+	memmove(vctr->data + pos, vctr->data + pos + 1, (vctr->count - pos - 1) * sizeof(void*));
+	vctr->count--;
+
+	return retval;
+}
+
+/* O(n) */
+INDEX search_vctr(VECTOR vctr, COMPARE_FUNC compare_func, void* pattern)
+{
+	INDEX i;
+
+	if (vctr == NIL || compare_func == NIL) {
+		rpterr("search_vctr: NIL argument");
+		return -1;
+	}
+
+	for (i = 0; i < vctr->count; i++)
+		if (compare_func(pattern, vctr->data[i]) == 0)
+			return i;
+
+	return -1;
+}
+
+/* O(log n) */
+INDEX bsearch_vctr(VECTOR vctr, COMPARE_FUNC compare_func, void* pattern)
+{
+	INDEX low = 0, high;
+
+	if (vctr == NIL || compare_func == NIL) {
+		rpterr("bsearch_vctr: NIL argument");
+		return -1;
+	}
+
+	high = vctr->count;
+	while (low < high) {
+		INDEX middle = low + (high - low) / 2;
+		int result = compare_func(pattern, vctr->data[middle]);
+
+		if (result == 0)
+			return middle;
+		if (result < 0)
+			high = middle;
+		else
+			low = middle + 1;
+	}
+
+	return -1;
+}
+
+/* O(n log n), bottom up merge sort */
+void sort_vctr(VECTOR vctr, COMPARE_FUNC compare_func)
+{
+	void** tmp;
+	INDEX width, from;
+
+	if (vctr == NIL || compare_func == NIL) {
+		rpterr("sort_vctr: NIL argument");
+		return;
+	}
+
+	if (vctr->count < 2)
+		return;
+
+	if ((tmp = (void**)malloc(vctr->count * sizeof(void*))) == NIL) {
+		rpterr("sort_vctr: no memory");
+		return;
+	}
+
+	for (width = 1; width < vctr->count; width *= 2) {
+		for (from = 0; from + width < vctr->count; from += 2 * width) {
+			INDEX to = from + 2 * width;
+			if (to > vctr->count)
+				to = vctr->count;
+			merge(vctr->data, tmp, from, from + width, to, compare_func);
+		}
+	}
+
+	free(tmp);
+}
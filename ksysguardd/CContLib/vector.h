@@ -0,0 +1,131 @@
+/*
+    Lightweight C Container Library
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Library General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Library General Public License for more details.
+
+    You should have received a copy of the GNU Library General Public License
+    along with this library; see the file COPYING.LIB.  If not, write to
+    the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+    Boston, MA 02110-1301, USA.
+
+*/
+
+#ifndef _VECTOR_H
+#define _VECTOR_H
+
+#include "ccont.h"
+
+#define destr_vctr(x, y) zero_destr_vctr(x, y); x=0
+
+/**
+ * A growable array of object pointers.
+ *
+ * Unlike the container in ccont.h the objects are stored in one block of
+ * memory and accessed by index, so there is no iteration state and
+ * nested loops over the same vector are fine:
+ *
+ * for (i = 0; i < level_vctr(vctr); i++) {
+ * 	do_anything(get_vctr(vctr, i));
+ * }
+ */
+struct vctr {
+	void** data;
+	INDEX count;
+	INDEX size;
+};
+
+typedef struct vctr* VECTOR;
+
+/**
+ * Create an empty vector.
+ */
+VECTOR new_vctr(void);
+
+/**
+ * Remove all entries from @p vctr and free the vector.
+ *
+ * Note: use the 'destr_vctr' macro to get zeroed pointer
+ *       automatically.
+ *
+ * @param destr_func The function that is called to free the
+ *                   single entries, may be @p 0.
+ */
+void zero_destr_vctr(VECTOR vctr, DESTR_FUNC destr_func);
+
+/**
+ * Remove all entries from @p vctr, the memory is kept for reuse.
+ *
+ * @param destr_func The function that is called to free the
+ *                   single entries, may be @p 0.
+ */
+void empty_vctr(VECTOR vctr, DESTR_FUNC destr_func);
+
+/**
+ * @return the number of entries in @p vctr.
+ */
+static inline INDEX level_vctr(VECTOR vctr)
+{
+	return vctr->count;
+}
+
+/**
+ * @return A pointer to the object at position @a pos
+ *         or @p 0L if it doesn't exist.
+ */
+static inline void* get_vctr(VECTOR vctr, INDEX pos)
+{
+	return (pos >= 0 && pos < vctr->count) ? vctr->data[pos] : 0;
+}
+
+/**
+ * Add a new entry at the end of @p vctr.
+ *
+ * @return 0 on success or -1 if no memory is available.
+ */
+int push_vctr(VECTOR vctr, void* object);
+
+/**
+ * Insert a new entry before position @p pos, @p pos may be the number of
+ * entries.
+ *
+ * @return 0 on success or -1 if no memory is available or @p pos is out
+ *         of range.
+ */
+int insert_vctr(VECTOR vctr, void* object, INDEX pos);
+
+/**
+ * Remove the entry at position @p pos, the following entries move up.
+ *
+ * @return A pointer to the removed object or @p 0L if it doesn't exist.
+ */
+void* remove_at_vctr(VECTOR vctr, INDEX pos);
+
+/**
+ * @return The position of the first entry for which @p compare_func
+ *         returns 0 or -1 if there is none.
+ *
+ * @param compare_func Called with @p pattern and an entry.
+ */
+INDEX search_vctr(VECTOR vctr, COMPARE_FUNC compare_func, void* pattern);
+
+/**
+ * Like search_vctr() but for a vector that is sorted with the same
+ * @p compare_func. O(log n)
+ */
+INDEX bsearch_vctr(VECTOR vctr, COMPARE_FUNC compare_func, void* pattern);
+
+/**
+ * Sort all entries of @p vctr. The sort is stable and does not use
+ * global state, so it may be called by several threads at once.
+ */
+void sort_vctr(VECTOR vctr, COMPARE_FUNC compare_func);
+
+#endif
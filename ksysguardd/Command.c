@@ -20,6 +20,7 @@
 */
 
 #define _XOPEN_SOURCE 700 /* gettimeofday, and implies POSIX.1-2008's sig.*set */
+#include <fcntl.h>
 #include <signal.h>
 #include <stdarg.h>
 #include <stdio.h>
@@ -27,24 +28,145 @@
 #include <string.h>
 #include <syslog.h>
 #include <sys/time.h>
+#include <unistd.h>
 
-#include "ccont.h"
+#include "htbl.h"
+#include "Aggregate.h"
+#include "History.h"
+#include "Latency.h"
+#include "OutputSink.h"
 #include "ksysguardd.h"
 
 #include "Command.h"
 
-typedef struct {
+typedef struct Command {
   char* command;
   cmdExecutor ex;
   char* type;
   int isMonitor;
   int isLegacy;
+  /* ANSWER_* type for the binary protocol */
+  int answer;
+  /* Requests with arguments bypass the snapshot, see acceptArguments() */
+  int takesArguments;
   struct SensorModul* sm;
+
+  /* The answer from the latest sample, for modules that are sampled in
+   * the background. It is replaced, never modified. */
+  char* snapshot;
+  size_t snapshotLength;
+
+  /* The values of the snapshots of a numeric monitor, if enabled */
+  History* history;
+
+  /* Summaries of the values of the snapshots, created by the first
+   * 'aggregate' request for the monitor */
+  Aggregator* aggregator;
+
+  /* Durations of the requests, see 'ksysguardd/stats'. Allocated by the
+   * first request. */
+  LatencyHistogram* latency;
+
+  /* All commands in the order of registration, used by 'monitors' */
+  struct Command* prev;
+  struct Command* next;
+
+  /* Commands registered later under the same name. Only the first one
+   * is in the CommandTable and gets executed. */
+  struct Command* alias;
 } Command;
 
-static CONTAINER CommandList;
+/* Maps the command name to the Command, so that dispatching a request
+ * does not depend on the number of registered monitors. */
+static HTBL CommandTable;
+static Command* FirstCommand = 0;
+static Command* LastCommand = 0;
 static sigset_t SignalSet;
 
+/* Seconds of history to keep for numeric monitors, 0 to keep none, and
+ * the ms between two samples of the history */
+static unsigned int HistoryLength = 0;
+static unsigned int HistoryStep = 0;
+
+/* The longest window in seconds for 'aggregate' and the ms per slot */
+static unsigned int AggregationWindow = 0;
+static unsigned int AggregationStep = 0;
+
+/* The generation of the monitors that belong to no module, like the
+ * ksysguardd/ self monitors, see sensorsGeneration() */
+static unsigned long ModulelessGeneration = 0;
+
+/**
+  An object that a module keeps for a client, see setClientData().
+ */
+typedef struct ClientData {
+  struct ClientData* next;
+  const void* key;
+  void* data;
+  void (*destroy)( void* data );
+} ClientData;
+
+/**
+  A named list of sensors that a client can fetch with 'getset'. The
+  sensor names point into @ref buffer.
+ */
+typedef struct SensorSet {
+  struct SensorSet* next;
+  char* name;
+  int count;
+  char** sensors;
+  char* buffer;
+} SensorSet;
+
+/**
+  A change of the command table by a module that is being sampled on a
+  worker thread. The table belongs to the main loop, so the change is
+  applied when the sample is published.
+ */
+typedef struct CommandChange {
+  struct CommandChange* next;
+  int remove;
+  char* command;
+  char* type;
+  cmdExecutor ex;
+  cmdExecutor iq;
+  int isMonitor;
+  int isLegacy;
+} CommandChange;
+
+/**
+  A command whose answer is part of the snapshot of a module. @ref cmd
+  is 0 for monitors that were registered during the sample.
+ */
+typedef struct Rendering {
+  Command* cmd;
+  char* command;
+  cmdExecutor ex;
+  char* text;
+  size_t length;
+} Rendering;
+
+typedef struct CollectorTask {
+  struct SensorModul* sm;
+  int check;
+
+  int count;
+  int size;
+  Rendering* renderings;
+
+  CommandChange* firstChange;
+  CommandChange** lastChange;
+
+  OutputSink sink;
+
+  /* The cost of the sample, recorded when the task is finished */
+  unsigned long long updateMicros;
+  unsigned long long updateBytes;
+} CollectorTask;
+
+/* The task that the current thread works on, if any */
+static _Thread_local CollectorTask* CurrentTask = 0;
+
 void command_cleanup( void* v );
 
 void command_cleanup( void* v )
@@ -53,10 +175,349 @@ void command_cleanup( void* v )
     Command* c = v;
     free ( c->command );
     free ( c->type );
+    free ( c->snapshot );
+    if ( c->history )
+      freeHistory( c->history );
+    if ( c->aggregator )
+      freeAggregator( c->aggregator );
+    free ( c->latency );
   }
   free ( v );
 }
 
+/**
+  Allocates a command with the name @ref command followed by
+  @ref suffix.
+ */
+static Command* newCommand( const char* command, const char* suffix )
+{
+  size_t len = strlen( command );
+  Command* cmd = (Command*)calloc( 1, sizeof( Command ) );
+
+  if ( !cmd || !(cmd->command = (char*)malloc( len + strlen( suffix ) + 1 )) ) {
+    print_error( "Out of memory" );
+    free( cmd );
+    return 0;
+  }
+
+  memcpy( cmd->command, command, len );
+  strcpy( cmd->command + len, suffix );
+
+  return cmd;
+}
+
+static void addCommand( Command* cmd )
+{
+  Command* first = get_htbl( CommandTable, cmd->command, strlen( cmd->command ) );
+
+  if ( first ) {
+    while ( first->alias )
+      first = first->alias;
+    first->alias = cmd;
+  } else if ( put_htbl( CommandTable, cmd->command, strlen( cmd->command ), cmd ) < 0 ) {
+    print_error( "Out of memory" );
+    command_cleanup( cmd );
+    return;
+  }
+
+  cmd->prev = LastCommand;
+  if ( LastCommand )
+    LastCommand->next = cmd;
+  else
+    FirstCommand = cmd;
+  LastCommand = cmd;
+}
+
+/**
+  Returns the number of bytes the calling thread has read so far and
+  stores the bytes that this call adds to it in @ref cost. Returns 0
+  if /proc/thread-self/io cannot be read, e.g. because the daemon has
+  dropped its privileges.
+ */
+static unsigned long long threadBytesRead( size_t* cost )
+{
+#ifdef OSTYPE_Linux
+  static _Thread_local int fd = -2;
+  char buffer[ 256 ];
+  ssize_t length;
+
+  if ( fd == -2 )
+    fd = open( "/proc/thread-self/io", O_RDONLY | O_CLOEXEC );
+  if ( fd < 0 || ( length = pread( fd, buffer, sizeof( buffer ) - 1, 0 ) ) <= 0 )
+    return 0;
+
+  buffer[ length ] = '\0';
+  *cost = length;
+
+  /* The first line is "rchar: <bytes>" */
+  return strncmp( buffer, "rchar:", 6 ) ? 0 : strtoull( buffer + 6, NULL, 10 );
+#else
+  (void)cost;
+  return 0;
+#endif
+}
+
+/**
+  Measures how long the calling thread takes for an update and how many
+  bytes it reads meanwhile.
+ */
+typedef struct {
+  unsigned long long start;
+  unsigned long long bytes;
+  size_t cost;
+} Measurement;
+
+static void startMeasurement( Measurement* m )
+{
+  m->cost = 0;
+  m->bytes = threadBytesRead( &m->cost );
+  m->start = monotonicMicros();
+}
+
+static void stopMeasurement( const Measurement* m, unsigned long long* micros,
+                             unsigned long long* bytes )
+{
+  unsigned long long after;
+  size_t ignored;
+
+  *micros = monotonicMicros() - m->start;
+  after = threadBytesRead( &ignored );
+  *bytes = after > m->bytes + m->cost ? after - m->bytes - m->cost : 0;
+}
+
+/**
+  Adds an update of @ref sm to its statistics. Must be called by the
+  main loop.
+ */
+static void recordUpdate( struct SensorModul* sm, unsigned long long micros,
+                          unsigned long long bytes )
+{
+  if ( sm->updateLatency == NULL &&
+       ( sm->updateLatency = (LatencyHistogram*)calloc( 1, sizeof( LatencyHistogram ) ) ) == NULL )
+    return;
+
+  addLatency( sm->updateLatency, micros );
+  sm->updateBytes += bytes;
+}
+
+/**
+  Runs the updateCommand of @ref sm unless it has been run within the
+  last UPDATEINTERVAL. Modules that are sampled in the background are
+  left alone, their latest sample is used.
+ */
+static void updateModule( struct SensorModul* sm )
+{
+  struct timeval currentTime;
+  unsigned long long timeCentiSeconds;
+
+  /* Monitors without a module read their values on every request */
+  if ( sm == NULL ) {
+    ++ModulelessGeneration;
+    return;
+  }
+
+  if ( sm->sampleInterval )
+    return;
+
+  /* Modules without an update command read their values on every
+   * request, so every request is a new sample */
+  if ( sm->updateCommand == NULL ) {
+    ++sm->generation;
+    return;
+  }
+
+  gettimeofday( &currentTime, NULL );
+  timeCentiSeconds = (unsigned long long)currentTime.tv_sec * 10 + currentTime.tv_usec / 100000;
+  if ( timeCentiSeconds - sm->timeCentiSeconds >= UPDATEINTERVAL ) {
+    unsigned long long micros, bytes;
+    Measurement measurement;
+
+    sm->timeCentiSeconds = timeCentiSeconds;
+    startMeasurement( &measurement );
+    sm->updateCommand();
+    stopMeasurement( &measurement, &micros, &bytes );
+    recordUpdate( sm, micros, bytes );
+    ++sm->generation;
+  }
+}
+
+/**
+  Only monitors that answer with a single line can be part of a batch.
+ */
+static int isValueMonitor( const Command* cmd )
+{
+  return cmd && cmd->isMonitor && ( !strcmp( cmd->type, "integer" ) ||
+         !strcmp( cmd->type, "float" ) || !strcmp( cmd->type, "string" ) );
+}
+
+static int isNumericMonitor( const Command* cmd )
+{
+  return cmd && cmd->isMonitor && ( !strcmp( cmd->type, "integer" ) ||
+         !strcmp( cmd->type, "float" ) );
+}
+
+/**
+  Adds the value of the snapshot of @ref cmd to its history and its
+  aggregates. Snapshots that hold an error instead of a value are
+  skipped.
+ */
+static void recordValue( Command* cmd, long long time )
+{
+  char* end;
+  double value;
+
+  if ( !isNumericMonitor( cmd ) || ( HistoryLength == 0 && cmd->aggregator == NULL ) )
+    return;
+
+  value = strtod( cmd->snapshot, &end );
+  if ( end == cmd->snapshot )
+    return;
+
+  if ( cmd->aggregator )
+    addAggregatorSample( cmd->aggregator, time, value );
+
+  if ( HistoryLength == 0 )
+    return;
+
+  if ( cmd->history == NULL &&
+       ( cmd->history = newHistory( HistoryLength, HistoryStep ) ) == NULL ) {
+    log_error( "Out of memory" );
+    return;
+  }
+
+  addHistorySample( cmd->history, time, value );
+}
+
+static void addReplayedSample( void* aggregator, long long time, double value )
+{
+  addAggregatorSample( (Aggregator*)aggregator, time, value );
+}
+
+static SensorSet** findSensorSet( const char* name )
+{
+  SensorSet** set;
+
+  for ( set = &CurrentContext->sensorSets; *set; set = &(*set)->next )
+    if ( !strcmp( (*set)->name, name ) )
+      break;
+
+  return set;
+}
+
+static void freeSensorSet( SensorSet* set )
+{
+  free( set->sensors );
+  free( set->buffer );
+  free( set );
+}
+
+static void freeCommand( Command* cmd )
+{
+  if ( cmd->prev )
+    cmd->prev->next = cmd->next;
+  else
+    FirstCommand = cmd->next;
+
+  if ( cmd->next )
+    cmd->next->prev = cmd->prev;
+  else
+    LastCommand = cmd->prev;
+
+  command_cleanup( cmd );
+}
+
+static int addRendering( CollectorTask* task, Command* cmd, const char* command, cmdExecutor ex )
+{
+  Rendering* rendering;
+
+  if ( task->count == task->size ) {
+    int size = task->size ? task->size * 2 : 16;
+    Rendering* renderings = (Rendering*)realloc( task->renderings, size * sizeof( Rendering ) );
+    if ( renderings == NULL )
+      return -1;
+    task->renderings = renderings;
+    task->size = size;
+  }
+
+  rendering = &task->renderings[ task->count ];
+  memset( rendering, 0, sizeof( Rendering ) );
+  rendering->cmd = cmd;
+  rendering->ex = ex;
+  if ( cmd )
+    rendering->command = cmd->command;
+  else if ( ( rendering->command = strdup( command ) ) == NULL )
+    return -1;
+
+  task->count++;
+  return 0;
+}
+
+/**
+  Records a change of the command table by the module of the current
+  task. Monitors that are added are part of the snapshot right away.
+ */
+static void deferChange( int remove, const char* command, const char* type,
+                         cmdExecutor ex, cmdExecutor iq, int isMonitor, int isLegacy )
+{
+  CollectorTask* task = CurrentTask;
+  CommandChange* change;
+  int i;
+
+  if ( ( change = (CommandChange*)calloc( 1, sizeof( CommandChange ) ) ) == NULL ||
+       ( change->command = strdup( command ) ) == NULL ||
+       ( type && ( change->type = strdup( type ) ) == NULL ) ) {
+    log_error( "Out of memory" );
+    if ( change )
+      free( change->command );
+    free( change );
+    return;
+  }
+
+  change->remove = remove;
+  change->ex = ex;
+  change->iq = iq;
+  change->isMonitor = isMonitor;
+  change->isLegacy = isLegacy;
+  *task->lastChange = change;
+  task->lastChange = &change->next;
+
+  if ( remove ) {
+    for ( i = 0; i < task->count; ++i )
+      if ( !strcmp( task->renderings[ i ].command, command ) )
+        task->renderings[ i ].ex = NULL;
+  } else if ( isMonitor ) {
+    char* info = (char*)malloc( strlen( command ) + 2 );
+    if ( info == NULL ) {
+      log_error( "Out of memory" );
+      return;
+    }
+    strcpy( info, command );
+    strcat( info, "?" );
+    if ( addRendering( task, NULL, command, ex ) < 0 || addRendering( task, NULL, info, iq ) < 0 )
+      log_error( "Out of memory" );
+    free( info );
+  }
+}
+
+/**
+  Monitors of modules that are sampled in the background answer from
+  the latest snapshot, the state of such a module may be changed by a
+  worker thread at any time.
+ */
+static void runCommand( Command* cmd, const char* command )
+{
+  if ( cmd->sm == NULL || !cmd->sm->sampleInterval ||
+       ( cmd->takesArguments && command[ strlen( cmd->command ) ] != '\0' ) ) {
+    (*(cmd->ex))( command );
+    return;
+  }
+
+  if ( cmd->snapshot == NULL )
+    print_error( "Sensor '%s' has not been sampled yet", cmd->command );
+  else if ( CurrentSink )
+    sinkWrite( CurrentSink, cmd->snapshot, cmd->snapshotLength );
+}
+
 /*
 ================================ public part =================================
 */
@@ -65,14 +526,11 @@ int ReconfigureFlag = 0;
 int CheckSetupFlag = 0;
 void output( const char *fmt, ...)
 {
-  if( !CurrentClient )
+  if( !CurrentSink )
     return;
   va_list az;
   va_start( az, fmt );
-  if(vfprintf(CurrentClient, fmt, az) < 0) {
-    fprintf(stderr, "Error talking to client.  Exiting\n.");
-    exit(EXIT_FAILURE);
-  }
+  sinkVPrintf( CurrentSink, fmt, az );
   va_end( az );
 }
 void print_error( const char *fmt, ... )
@@ -85,7 +543,7 @@ void print_error( const char *fmt, ... )
   errmsg[ sizeof( errmsg ) - 1 ] = '\0';
   va_end( az );
 
-  if ( CurrentClient )
+  if ( CurrentSink )
     output( "\033%s\033", errmsg );
 }
 
@@ -110,35 +568,64 @@ void log_error( const char *fmt, ... )
 
 void initCommand( void )
 {
-  CommandList = new_ctnr();
+  CommandTable = new_htbl();
   sigemptyset( &SignalSet );
   sigaddset( &SignalSet, SIGALRM );
 
   registerCommand( "monitors", printMonitors );
+  registerCommand( "get", printBatch );
+  registerCommand( "defineset", defineSensorSet );
+  registerCommand( "getset", printSensorSet );
+  registerCommand( "protocol", setProtocol );
+  registerCommand( "history", printHistory );
+  registerCommand( "aggregate", printAggregation );
+  /* These answer with one value per line like the value monitors */
+  setAnswerType( "get", ANSWER_VALUES );
+  setAnswerType( "getset", ANSWER_VALUES );
+  setAnswerType( "history", ANSWER_TABLE );
+  setAnswerType( "aggregate", ANSWER_TABLE );
   /* registerCommand( "test", printTest ); */
 
   if ( RunAsDaemon == 0 )
     registerCommand( "quit", exQuit );
 }
 
+void enableHistory( unsigned int duration, unsigned int resolution )
+{
+  HistoryLength = duration;
+  HistoryStep = resolution;
+}
+
+void enableAggregation( unsigned int window, unsigned int resolution )
+{
+  AggregationWindow = window;
+  AggregationStep = resolution;
+}
+
 void exitCommand( void )
 {
-  destr_ctnr( CommandList, command_cleanup );
+  while ( FirstCommand )
+    freeCommand( FirstCommand );
+
+  destr_htbl( CommandTable, 0 );
 }
 
 void registerCommand( const char* command, cmdExecutor ex )
 {
-  Command* cmd = (Command*)malloc( sizeof( Command ) );
-  if(!cmd || !(cmd->command = (char*)malloc( strlen( command ) + 1 ))) {
-    print_error("Out of memory");
-    free(cmd);
+  Command* cmd;
+
+  if ( CurrentTask ) {
+    deferChange( 0, command, NULL, ex, NULL, 0, 0 );
     return;
   }
-  strcpy( cmd->command, command );
-  cmd->type = 0;
+
+  cmd = newCommand( command, "" );
+  if ( !cmd )
+    return;
+
   cmd->ex = ex;
   cmd->isMonitor = 0;
-  push_ctnr( CommandList, cmd );
+  addCommand( cmd );
   ReconfigureFlag = 1;
 }
 
@@ -146,13 +633,17 @@ void removeCommand( const char* command )
 {
   Command* cmd;
 
-  for ( cmd = first_ctnr( CommandList ); cmd; cmd = next_ctnr( CommandList ) ) {
-    if ( cmd->command && strcmp( cmd->command, command ) == 0 ) {
-      remove_ctnr( CommandList );
-      free( cmd->command );
-      free( cmd->type );
-      free( cmd );
-    }
+  if ( CurrentTask ) {
+    deferChange( 1, command, NULL, NULL, NULL, 0, 0 );
+    return;
+  }
+
+  cmd = remove_htbl( CommandTable, command, strlen( command ) );
+
+  while ( cmd ) {
+    Command* alias = cmd->alias;
+    freeCommand( cmd );
+    cmd = alias;
   }
 
   ReconfigureFlag = 1;
@@ -168,49 +659,39 @@ void registerAnyMonitor( const char* command, const char* type, cmdExecutor ex,
    * command prints a single value. The info request command prints
    * a description of the monitor, the minimum value, the maximum value
    * and the unit. */
-  Command* cmd = (Command*)malloc( sizeof( Command ) );
-  if(!cmd || !(cmd->command = (char*)malloc( strlen( command ) + 1 ))) {
-      print_error("Out of memory");
-      free(cmd);
-      return;
+  Command* cmd;
+
+  if ( CurrentTask ) {
+    deferChange( 0, command, type, ex, iq, 1, isLegacy );
+    return;
   }
 
-  strcpy( cmd->command, command );
-  cmd->ex = ex;
-  cmd->type = (char*)malloc( strlen( type ) + 1 );
-  if(!cmd->type ) {
-      print_error("Out of memory");
-      free(cmd);
-      return;
+  if ( !(cmd = newCommand( command, "" )) )
+    return;
+
+  if ( !(cmd->type = strdup( type )) ) {
+    print_error( "Out of memory" );
+    command_cleanup( cmd );
+    return;
   }
 
-  strcpy( cmd->type, type );
+  cmd->ex = ex;
   cmd->isMonitor = 1;
   cmd->isLegacy = isLegacy;
   cmd->sm = sm;
-  push_ctnr( CommandList, cmd );
-
-  cmd = (Command*)malloc( sizeof( Command ) );
-  if(!cmd ) {
-      print_error("Out of memory");
-      return;
-  }
+  if ( isValueMonitor( cmd ) )
+    cmd->answer = ANSWER_VALUES;
+  else if ( !strcmp( type, "table" ) || !strcmp( type, "listview" ) )
+    cmd->answer = ANSWER_TABLE;
+  addCommand( cmd );
 
-  cmd->command = (char*)malloc( strlen( command ) + 2 );
-  if(!cmd->command ) {
-      print_error("Out of memory");
-      free(cmd);
-      return;
-  }
+  if ( !(cmd = newCommand( command, "?" )) )
+    return;
 
-  strcpy( cmd->command, command );
-  cmd->command[ strlen( command ) ] = '?';
-  cmd->command[ strlen( command ) + 1 ] = '\0';
   cmd->ex = iq;
   cmd->isMonitor = 0;
   cmd->sm = sm;
-  cmd->type = 0;
-  push_ctnr( CommandList, cmd );
+  addCommand( cmd );
 }
 
 void registerMonitor( const char* command, const char* type, cmdExecutor ex,
@@ -256,33 +737,155 @@ void executeCommand( const char* command )
       return; /* No command give at all */
   int lengthOfCommand = i;
 
-  for ( cmd = first_ctnr( CommandList ); cmd; cmd = next_ctnr( CommandList ) ) {
-    if ( strncmp( cmd->command, command, lengthOfCommand ) == 0 && cmd->command[lengthOfCommand] == 0) {
-      if ( cmd->isMonitor && cmd->sm->updateCommand != NULL) {
-        struct timeval currentTime;
-        gettimeofday(&currentTime,NULL);
-        unsigned long long timeCentiSeconds = (unsigned long long)currentTime.tv_sec * 10 + currentTime.tv_usec / 100000;
-        if ( timeCentiSeconds - cmd->sm->timeCentiSeconds >= UPDATEINTERVAL ) {
-          cmd->sm->timeCentiSeconds = timeCentiSeconds;
-          cmd->sm->updateCommand();
-        }
-      }
-
-      (*(cmd->ex))( command );
-
-      if ( ReconfigureFlag ) {
-        ReconfigureFlag = 0;
-        print_error( "RECONFIGURE" );
-      }
-
-      fflush( CurrentClient );
-      return;
+  if ( ( cmd = get_htbl( CommandTable, command, lengthOfCommand ) ) != NULL ) {
+    unsigned long long start = monotonicMicros();
+
+    if ( cmd->isMonitor )
+      updateModule( cmd->sm );
+
+    runCommand( cmd, command );
+
+    /* The command may have removed itself */
+    if ( ( cmd = get_htbl( CommandTable, command, lengthOfCommand ) ) != NULL &&
+         ( cmd->latency || ( cmd->latency = (LatencyHistogram*)calloc( 1, sizeof( LatencyHistogram ) ) ) ) )
+      addLatency( cmd->latency, monotonicMicros() - start );
+
+    if ( ReconfigureFlag ) {
+      ReconfigureFlag = 0;
+      print_error( "RECONFIGURE" );
     }
+
+    return;
   }
 
-  if ( CurrentClient ) {
+  if ( CurrentSink )
     output( "UNKNOWN COMMAND\n" );
-    fflush( CurrentClient );
+}
+
+void setAnswerType( const char* command, int type )
+{
+  Command* cmd;
+
+  if ( ( cmd = get_htbl( CommandTable, command, strlen( command ) ) ) != NULL )
+    cmd->answer = type;
+}
+
+int answerType( const char* command )
+{
+  Command* cmd;
+  int i = 0;
+
+  while ( command[ i ] != 0 && command[ i ] != ' ' && command[ i ] != '\t' )
+    i++;
+
+  if ( ( cmd = get_htbl( CommandTable, command, i ) ) == NULL )
+    return ANSWER_TEXT;
+
+  return cmd->answer;
+}
+
+void acceptArguments( const char* command )
+{
+  Command* cmd;
+
+  if ( ( cmd = get_htbl( CommandTable, command, strlen( command ) ) ) != NULL )
+    cmd->takesArguments = 1;
+}
+
+int splitWords( char* line, char** words )
+{
+  int count = 0;
+
+  for ( ;; ) {
+    while ( *line == ' ' || *line == '\t' )
+      *line++ = '\0';
+    if ( *line == '\0' )
+      return count;
+
+    words[ count++ ] = line;
+    while ( *line != '\0' && *line != ' ' && *line != '\t' )
+      ++line;
+  }
+}
+
+void updateSensors( char** names, int count )
+{
+  struct SensorModul** modules;
+  int moduleCount = 0;
+  int i, j;
+
+  if ( count == 0 )
+    return;
+
+  if ( ( modules = (struct SensorModul**)malloc( count * sizeof( struct SensorModul* ) ) ) == NULL ) {
+    print_error( "Out of memory" );
+    return;
+  }
+
+  for ( i = 0; i < count; ++i ) {
+    Command* cmd = get_htbl( CommandTable, names[ i ], strlen( names[ i ] ) );
+    if ( !isValueMonitor( cmd ) )
+      continue;
+
+    for ( j = 0; j < moduleCount && modules[ j ] != cmd->sm; ++j )
+      ;
+    if ( j == moduleCount )
+      modules[ moduleCount++ ] = cmd->sm;
+  }
+
+  for ( j = 0; j < moduleCount; ++j )
+    updateModule( modules[ j ] );
+
+  free( modules );
+}
+
+unsigned long sensorsGeneration( char** names, int count )
+{
+  unsigned long generation = 0;
+  int i;
+
+  for ( i = 0; i < count; ++i ) {
+    Command* cmd = get_htbl( CommandTable, names[ i ], strlen( names[ i ] ) );
+    if ( isValueMonitor( cmd ) )
+      generation += cmd->sm ? cmd->sm->generation : ModulelessGeneration;
+  }
+
+  return generation;
+}
+
+void printSensorValues( char** names, int count )
+{
+  size_t pending;
+  int i;
+
+  for ( i = 0; i < count; ++i ) {
+    Command* cmd = get_htbl( CommandTable, names[ i ], strlen( names[ i ] ) );
+    if ( !isValueMonitor( cmd ) ) {
+      output( "UNKNOWN SENSOR\n" );
+      continue;
+    }
+
+    pending = CurrentSink ? CurrentSink->pending : 0;
+    runCommand( cmd, names[ i ] );
+
+    /* Keep the answer aligned even if a monitor failed to print a line */
+    if ( CurrentSink && ( CurrentSink->pending == pending ||
+                          sinkLastChar( CurrentSink ) != '\n' ) )
+      output( "\n" );
+  }
+}
+
+void printCommandStats( void )
+{
+  Command* cmd;
+
+  for ( cmd = FirstCommand; cmd; cmd = cmd->next ) {
+    if ( cmd->latency == NULL )
+      continue;
+
+    output( "command\t%s", cmd->command );
+    printLatency( cmd->latency );
+    output( "\n" );
   }
 }
 
@@ -293,28 +896,321 @@ void printMonitors( const char *c )
 
   (void)c;
 
-  for ( cmd = first_ctnr( CommandList ); cmd; cmd = next_ctnr( CommandList ) ) {
+  for ( cmd = FirstCommand; cmd; cmd = cmd->next ) {
     if ( cmd->isMonitor && !cmd->isLegacy )
       output( "%s\t%s\n", cmd->command, cmd->type);
   }
+}
+
+void printBatch( const char* c )
+{
+  char* line = strdup( c );
+  char** names = (char**)malloc( ( strlen( c ) / 2 + 1 ) * sizeof( char* ) );
+  int count;
 
-  fflush( CurrentClient );
+  if ( !line || !names ) {
+    free( line );
+    free( names );
+    print_error( "Out of memory" );
+    return;
+  }
+
+  /* The first word is 'get' itself */
+  count = splitWords( line, names );
+  updateSensors( names + 1, count - 1 );
+  printSensorValues( names + 1, count - 1 );
+
+  free( names );
+  free( line );
 }
 
-void printTest( const char* c )
+void defineSensorSet( const char* c )
+{
+  SensorSet* set;
+  SensorSet** old;
+  char** words;
+  int count;
+
+  if ( !CurrentContext )
+    return;
+
+  if ( ( set = (SensorSet*)calloc( 1, sizeof( SensorSet ) ) ) == NULL ||
+       ( set->buffer = strdup( c ) ) == NULL ||
+       ( words = (char**)malloc( ( strlen( c ) / 2 + 1 ) * sizeof( char* ) ) ) == NULL ) {
+    if ( set )
+      free( set->buffer );
+    free( set );
+    print_error( "Out of memory" );
+    return;
+  }
+
+  /* defineset <name> <sensor>... */
+  count = splitWords( set->buffer, words );
+  if ( count < 2 ) {
+    free( words );
+    freeSensorSet( set );
+    print_error( "Usage: defineset <name> [<sensor>...]" );
+    return;
+  }
+
+  set->name = words[ 1 ];
+  set->sensors = words;
+  set->count = count - 2;
+  memmove( words, words + 2, set->count * sizeof( char* ) );
+
+  /* Replace a set of the same name. A set without sensors is just
+   * removed. */
+  old = findSensorSet( set->name );
+  if ( *old ) {
+    SensorSet* next = (*old)->next;
+    freeSensorSet( *old );
+    *old = next;
+  }
+
+  output( "%d\n", set->count );
+
+  if ( set->count == 0 ) {
+    freeSensorSet( set );
+    return;
+  }
+
+  set->next = CurrentContext->sensorSets;
+  CurrentContext->sensorSets = set;
+}
+
+void printSensorSet( const char* c )
+{
+  char* name = strdup( c + strlen( "getset" ) );
+  char* words[ 1 ];
+  SensorSet* set;
+
+  if ( !name ) {
+    print_error( "Out of memory" );
+    return;
+  }
+
+  /* Trailing white space is not part of the name */
+  if ( !CurrentContext || splitWords( name, words ) != 1 ||
+       ( set = *findSensorSet( words[ 0 ] ) ) == NULL ) {
+    free( name );
+    output( "UNKNOWN COMMAND\n" );
+    return;
+  }
+
+  free( name );
+  updateSensors( set->sensors, set->count );
+  printSensorValues( set->sensors, set->count );
+}
+
+void clearClientContext( ClientContext* context )
+{
+  while ( context->sensorSets ) {
+    SensorSet* next = context->sensorSets->next;
+    freeSensorSet( context->sensorSets );
+    context->sensorSets = next;
+  }
+
+  while ( context->data ) {
+    ClientData* next = context->data->next;
+    if ( context->data->destroy )
+      context->data->destroy( context->data->data );
+    free( context->data );
+    context->data = next;
+  }
+}
+
+void* clientData( const void* key )
+{
+  ClientData* entry;
+
+  if ( !CurrentContext )
+    return NULL;
+
+  for ( entry = CurrentContext->data; entry; entry = entry->next ) {
+    if ( entry->key == key )
+      return entry->data;
+  }
+
+  return NULL;
+}
+
+int setClientData( const void* key, void* data, void (*destroy)( void* data ) )
+{
+  ClientData* entry;
+
+  if ( !CurrentContext )
+    return -1;
+
+  for ( entry = CurrentContext->data; entry && entry->key != key; entry = entry->next )
+    ;
+
+  if ( entry == NULL ) {
+    if ( ( entry = (ClientData*)calloc( 1, sizeof( ClientData ) ) ) == NULL )
+      return -1;
+    entry->key = key;
+    entry->next = CurrentContext->data;
+    CurrentContext->data = entry;
+  } else if ( entry->destroy )
+    entry->destroy( entry->data );
+
+  entry->data = data;
+  entry->destroy = destroy;
+
+  return 0;
+}
+
+void setProtocol( const char* c )
 {
+  const char* name = c + strlen( "protocol" );
+
+  while ( *name == ' ' || *name == '\t' )
+    ++name;
+
+  if ( !CurrentContext )
+    return;
+
+  /* The answer is still sent in the old protocol */
+  if ( !strcmp( name, "binary" ) )
+    CurrentContext->binary = 1;
+  else if ( !strcmp( name, "text" ) )
+    CurrentContext->binary = 0;
+  else {
+    print_error( "Usage: protocol text|binary" );
+    return;
+  }
+
+  output( "%s\n", name );
+}
+
+void printHistory( const char* c )
+{
+  char* line = strdup( c );
+  char** words = (char**)malloc( ( strlen( c ) / 2 + 1 ) * sizeof( char* ) );
   Command* cmd;
+  struct timeval now;
+  long seconds;
+
+  if ( !line || !words ) {
+    free( line );
+    free( words );
+    print_error( "Out of memory" );
+    return;
+  }
+
+  /* history <sensor> <seconds> */
+  if ( splitWords( line, words ) != 3 || ( seconds = atol( words[ 2 ] ) ) <= 0 ) {
+    free( words );
+    free( line );
+    print_error( "Usage: history <sensor> <seconds>" );
+    return;
+  }
+
+  cmd = get_htbl( CommandTable, words[ 1 ], strlen( words[ 1 ] ) );
+  if ( !isNumericMonitor( cmd ) ) {
+    free( words );
+    free( line );
+    output( "UNKNOWN SENSOR\n" );
+    return;
+  }
 
-  for ( cmd = first_ctnr( CommandList ); cmd; cmd = next_ctnr( CommandList ) ) {
-    if ( strcmp( cmd->command, c + strlen( "test " ) ) == 0 ) {
-      output( "1\n" );
-      fflush( CurrentClient );
+  /* Sensors that are not sampled in the background have no history */
+  if ( cmd->history ) {
+    gettimeofday( &now, NULL );
+    printHistorySamples( cmd->history,
+                         (long long)now.tv_sec * 1000 + now.tv_usec / 1000 - seconds * 1000LL,
+                         !strcmp( cmd->type, "integer" ) );
+  }
+
+  free( words );
+  free( line );
+}
+
+void printAggregation( const char* c )
+{
+  static const double defaultPercentiles[] = { 50, 90, 99 };
+  double percentiles[ AGGREGATE_MAX_PERCENTILES ];
+  char* line = strdup( c );
+  char** words = (char**)malloc( ( strlen( c ) / 2 + 1 ) * sizeof( char* ) );
+  Command* cmd = NULL;
+  struct timeval now;
+  long seconds = 0;
+  int count, i;
+
+  if ( !line || !words ) {
+    free( line );
+    free( words );
+    print_error( "Out of memory" );
+    return;
+  }
+
+  /* aggregate <sensor> <seconds> [<percentile>...] */
+  count = splitWords( line, words );
+  if ( count >= 3 && count - 3 <= AGGREGATE_MAX_PERCENTILES )
+    seconds = atol( words[ 2 ] );
+  for ( i = 3; i < count && seconds > 0; ++i ) {
+    char* end;
+    percentiles[ i - 3 ] = strtod( words[ i ], &end );
+    if ( *end != '\0' || !( percentiles[ i - 3 ] >= 0 && percentiles[ i - 3 ] <= 100 ) )
+      seconds = 0;
+  }
+
+  if ( seconds <= 0 || (unsigned long)seconds > AggregationWindow ) {
+    free( words );
+    free( line );
+    print_error( "Usage: aggregate <sensor> <seconds up to %u> [<percentile>...]", AggregationWindow );
+    return;
+  }
+
+  cmd = get_htbl( CommandTable, words[ 1 ], strlen( words[ 1 ] ) );
+  if ( !isNumericMonitor( cmd ) ) {
+    free( words );
+    free( line );
+    output( "UNKNOWN SENSOR\n" );
+    return;
+  }
+
+  /* Only the sampler takes values without a request */
+  if ( cmd->sm == NULL || !cmd->sm->sampleInterval ) {
+    free( words );
+    free( line );
+    print_error( "Sensor '%s' is not sampled in the background", cmd->command );
+    return;
+  }
+
+  if ( cmd->aggregator == NULL ) {
+    if ( ( cmd->aggregator = newAggregator( AggregationWindow, AggregationStep ) ) == NULL ) {
+      free( words );
+      free( line );
+      print_error( "Out of memory" );
       return;
     }
+    /* Start with what has been kept so far, at a lower rate */
+    if ( cmd->history )
+      replayHistory( cmd->history, addReplayedSample, cmd->aggregator );
+  }
+
+  gettimeofday( &now, NULL );
+  if ( count > 3 )
+    printAggregate( cmd->aggregator, (long long)now.tv_sec * 1000 + now.tv_usec / 1000,
+                    seconds, percentiles, count - 3 );
+  else
+    printAggregate( cmd->aggregator, (long long)now.tv_sec * 1000 + now.tv_usec / 1000,
+                    seconds, defaultPercentiles, 3 );
+
+  free( words );
+  free( line );
+}
+
+void printTest( const char* c )
+{
+  const char* name = c + strlen( "test " );
+
+  if ( get_htbl( CommandTable, name, strlen( name ) ) ) {
+    output( "1\n" );
+    return;
   }
 
   output( "0\n" );
-  fflush( CurrentClient );
 }
 
 void exQuit( const char* cmd )
@@ -323,3 +1219,139 @@ void exQuit( const char* cmd )
 
   QuitApp = 1;
 }
+
+struct CollectorTask* newCollectorTask( struct SensorModul* sm, int check )
+{
+  CollectorTask* task;
+  Command* cmd;
+
+  if ( ( task = (CollectorTask*)calloc( 1, sizeof( CollectorTask ) ) ) == NULL ) {
+    log_error( "Out of memory" );
+    return NULL;
+  }
+
+  task->sm = sm;
+  task->check = check;
+  task->lastChange = &task->firstChange;
+  initSink( &task->sink, -1, 0, 0 );
+
+  /* Aliases are never executed, so they need no answer */
+  for ( cmd = FirstCommand; cmd; cmd = cmd->next ) {
+    if ( cmd->sm != sm || get_htbl( CommandTable, cmd->command, strlen( cmd->command ) ) != cmd )
+      continue;
+    if ( addRendering( task, cmd, NULL, cmd->ex ) < 0 ) {
+      log_error( "Out of memory" );
+      freeCollectorTask( task );
+      return NULL;
+    }
+  }
+
+  return task;
+}
+
+void runCollectorTask( struct CollectorTask* task )
+{
+  struct SensorModul* sm = task->sm;
+  OutputSink* oldSink = CurrentSink;
+  Measurement measurement;
+  int i;
+
+  CurrentTask = task;
+
+  /* Modules may parse their data lazily when it is printed, so the
+   * renderings are part of the cost of the sample */
+  startMeasurement( &measurement );
+
+  /* Errors of the update itself have no client to go to */
+  CurrentSink = NULL;
+  if ( task->check && sm->checkCommand )
+    sm->checkCommand();
+  if ( sm->updateCommand )
+    sm->updateCommand();
+
+  CurrentSink = &task->sink;
+  for ( i = 0; i < task->count; ++i ) {
+    Rendering* rendering = &task->renderings[ i ];
+    if ( rendering->ex == NULL )
+      continue;
+
+    (*rendering->ex)( rendering->command );
+    rendering->text = sinkToString( &task->sink, &rendering->length );
+    clearSink( &task->sink );
+  }
+
+  stopMeasurement( &measurement, &task->updateMicros, &task->updateBytes );
+
+  CurrentSink = oldSink;
+  CurrentTask = NULL;
+}
+
+void finishCollectorTask( struct CollectorTask* task )
+{
+  struct SensorModul* sm = task->sm;
+  CommandChange* change;
+  struct timeval now;
+  long long time;
+  int i;
+
+  gettimeofday( &now, NULL );
+  time = (long long)now.tv_sec * 1000 + now.tv_usec / 1000;
+
+  for ( change = task->firstChange; change; change = change->next ) {
+    if ( change->remove )
+      removeCommand( change->command );
+    else if ( change->isMonitor )
+      registerAnyMonitor( change->command, change->type, change->ex, change->iq, sm, change->isLegacy );
+    else
+      registerCommand( change->command, change->ex );
+  }
+
+  for ( i = 0; i < task->count; ++i ) {
+    Rendering* rendering = &task->renderings[ i ];
+    Command* cmd = rendering->cmd;
+
+    if ( rendering->ex == NULL || rendering->text == NULL )
+      continue;
+    if ( cmd == NULL &&
+         ( cmd = get_htbl( CommandTable, rendering->command, strlen( rendering->command ) ) ) == NULL )
+      continue;
+    if ( cmd->sm != sm )
+      continue;
+
+    free( cmd->snapshot );
+    cmd->snapshot = rendering->text;
+    cmd->snapshotLength = rendering->length;
+    rendering->text = NULL;
+    recordValue( cmd, time );
+  }
+
+  recordUpdate( sm, task->updateMicros, task->updateBytes );
+
+  sm->timeCentiSeconds = (unsigned long long)now.tv_sec * 10 + now.tv_usec / 100000;
+  ++sm->generation;
+
+  freeCollectorTask( task );
+}
+
+void freeCollectorTask( struct CollectorTask* task )
+{
+  int i;
+
+  while ( task->firstChange ) {
+    CommandChange* next = task->firstChange->next;
+    free( task->firstChange->command );
+    free( task->firstChange->type );
+    free( task->firstChange );
+    task->firstChange = next;
+  }
+
+  for ( i = 0; i < task->count; ++i ) {
+    if ( task->renderings[ i ].cmd == NULL )
+      free( task->renderings[ i ].command );
+    free( task->renderings[ i ].text );
+  }
+
+  clearSink( &task->sink );
+  free( task->renderings );
+  free( task );
+}
@@ -26,6 +26,11 @@
 
 typedef void (*cmdExecutor)(const char*);
 
+/* How the answer of a command is encoded in the binary protocol */
+#define ANSWER_TEXT	0
+#define ANSWER_VALUES	1
+#define ANSWER_TABLE	2
+
 /**
   Set this flag to '1' to request a rescan of the available sensors
   in the front end.
@@ -128,11 +133,137 @@ void removeMonitor( const char* monitor );
  */
 void executeCommand( const char* command );
 
+/**
+  Sets the ANSWER_* type of the answer to the registered @ref command.
+  Commands answer with text unless told otherwise.
+ */
+void setAnswerType( const char* command, int type );
+
+/**
+  @return the ANSWER_* type of the answer to @ref command.
+ */
+int answerType( const char* command );
+
+/**
+  Lets the monitor @ref command take arguments, e.g. 'ps delta 12'.
+  Requests with arguments are executed even if the module is sampled in
+  the background, so the executor has to guard the module state against
+  the collector thread itself. Requests without arguments are answered
+  from the sample as usual.
+ */
+void acceptArguments( const char* command );
+
+/**
+  Splits @ref line at white space. The words are stored in @ref words,
+  which must have room for strlen( line ) / 2 + 1 entries.
+  @return the number of words.
+ */
+int splitWords( char* line, char** words );
+
+/**
+  Runs the update function of every module that one of the @ref count
+  sensors in @ref names belongs to. Each module is updated only once,
+  so all values printed afterwards stem from the same sample.
+ */
+void updateSensors( char** names, int count );
+
+/**
+  Returns a number that changes whenever a module that one of the
+  @ref count sensors in @ref names belongs to takes a new sample.
+  Sensors without a module, like the ksysguardd/ self monitors, take
+  one whenever they are updated.
+ */
+unsigned long sensorsGeneration( char** names, int count );
+
+/**
+  A sample of a module that is taken on a worker thread. The commands
+  of the module are executed right after the update and their answers
+  make up the snapshot that is published by finishCollectorTask(). All
+  requests are then answered from the snapshot, so the module state is
+  only ever touched by the thread that runs the task. Changes of the
+  command table during the task are applied when it is finished.
+ */
+struct CollectorTask;
+
+/**
+  Prepares a sample of @ref sm, running its checkCommand first if
+  @ref check is set. Must be called by the main loop.
+ */
+struct CollectorTask* newCollectorTask( struct SensorModul* sm, int check );
+
+/**
+  Takes the sample. May be called by any thread, but only one task of
+  a module may run at a time.
+ */
+void runCollectorTask( struct CollectorTask* task );
+
+/**
+  Publishes the snapshot and frees the task. Must be called by the main
+  loop.
+ */
+void finishCollectorTask( struct CollectorTask* task );
+
+void freeCollectorTask( struct CollectorTask* task );
+
+/**
+  Prints the values of the sensors in @ref names, one line per sensor.
+  Only integer, float and string sensors can be printed this way, for
+  all others the line reads "UNKNOWN SENSOR".
+ */
+void printSensorValues( char** names, int count );
+
+/**
+  Keeps the values of the numeric monitors of modules that are sampled
+  in the background for @ref duration seconds at one value per
+  @ref resolution ms, see 'history'. Nothing is kept if @ref duration
+  is 0, which is the default.
+ */
+void enableHistory( unsigned int duration, unsigned int resolution );
+
+/**
+  Lets 'aggregate' summarize windows of up to @ref window seconds, in
+  slots of @ref resolution ms. 'aggregate' is refused if @ref window is
+  0, which is the default.
+ */
+void enableAggregation( unsigned int window, unsigned int resolution );
+
+/**
+  Prints a line for every command that has been requested: "command",
+  the name and the statistics of printLatency(). See 'ksysguardd/stats'.
+ */
+void printCommandStats( void );
+
 void initCommand( void );
 void exitCommand( void );
 
+/**
+  Frees everything the commands have stored in @ref context.
+ */
+void clearClientContext( ClientContext* context );
+
+/**
+  @return what has been stored under @ref key for the client of the
+  current request, NULL if nothing has been or there is no client.
+ */
+void* clientData( const void* key );
+
+/**
+  Stores @ref data under @ref key for the client of the current request.
+  Modules use the address of a static variable as the key. @ref destroy
+  is called with the data when the client disconnects or other data is
+  stored under the same key.
+  @return 0 on success, -1 if there is no client or no memory.
+ */
+int setClientData( const void* key, void* data, void (*destroy)( void* data ) );
+
 void printMonitors( const char* cmd );
+void printBatch( const char* cmd );
+void defineSensorSet( const char* cmd );
+void printSensorSet( const char* cmd );
 void printTest( const char* cmd );
+void setProtocol( const char* cmd );
+void printHistory( const char* cmd );
+void printAggregation( const char* cmd );
 
 void exQuit( const char* cmd );
 
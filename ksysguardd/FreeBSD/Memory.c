@@ -174,122 +174,122 @@ int updateMemory(void)
 
 void printMActive(const char* cmd)
 {
-    fprintf(CurrentClient, "%lu\n", memory_stats[MEM_ACTIVE]);
+    output("%lu\n", memory_stats[MEM_ACTIVE]);
 }
 
 void printMActiveInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "Active Memory\t0\t%lu\tKB\n", memory_stats[MEM_TOTAL]);
+    output("Active Memory\t0\t%lu\tKB\n", memory_stats[MEM_TOTAL]);
 }
 
 void printMInactive(const char* cmd)
 {
-    fprintf(CurrentClient, "%lu\n", memory_stats[MEM_INACTIVE]);
+    output("%lu\n", memory_stats[MEM_INACTIVE]);
 }
 
 void printMInactiveInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "Inactive Memory\t0\t%lu\tKB\n", memory_stats[MEM_TOTAL]);
+    output("Inactive Memory\t0\t%lu\tKB\n", memory_stats[MEM_TOTAL]);
 }
 
 void printMApplication(const char* cmd)
 {
-    fprintf(CurrentClient, "%lu\n", memory_stats[MEM_ACTIVE] + memory_stats[MEM_INACTIVE]);
+    output("%lu\n", memory_stats[MEM_ACTIVE] + memory_stats[MEM_INACTIVE]);
 }
 
 void printMApplicationInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "Application (Active and Inactive) Memory\t0\t%ld\tKB\n", memory_stats[MEM_TOTAL]);
+    output("Application (Active and Inactive) Memory\t0\t%ld\tKB\n", memory_stats[MEM_TOTAL]);
 }
 
 void printMWired(const char* cmd)
 {
-    fprintf(CurrentClient, "%lu\n", memory_stats[MEM_WIRED]);
+    output("%lu\n", memory_stats[MEM_WIRED]);
 }
 
 void printMWiredInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "Wired Memory\t0\t%lu\tKB\n", memory_stats[MEM_TOTAL]);
+    output("Wired Memory\t0\t%lu\tKB\n", memory_stats[MEM_TOTAL]);
 }
 
 void printMCached(const char* cmd)
 {
-    fprintf(CurrentClient, "%lu\n", memory_stats[MEM_CACHED]);
+    output("%lu\n", memory_stats[MEM_CACHED]);
 }
 
 void printMCachedInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "Cached Memory\t0\t%lu\tKB\n", memory_stats[MEM_TOTAL]);
+    output("Cached Memory\t0\t%lu\tKB\n", memory_stats[MEM_TOTAL]);
 }
 
 void printMBuffers(const char* cmd)
 {
-    fprintf(CurrentClient, "%lu\n", memory_stats[MEM_BUFFERED]);
+    output("%lu\n", memory_stats[MEM_BUFFERED]);
 }
 
 void printMBuffersInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "Buffer Memory\t0\t%lu\tKB\n", memory_stats[MEM_TOTAL]);
+    output("Buffer Memory\t0\t%lu\tKB\n", memory_stats[MEM_TOTAL]);
 }
 
 void printMFree(const char* cmd)
 {
-    fprintf(CurrentClient, "%lu\n", memory_stats[MEM_FREE]);
+    output("%lu\n", memory_stats[MEM_FREE]);
 }
 
 void printMFreeInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "Free Memory\t0\t%lu\tKB\n", memory_stats[MEM_TOTAL]);
+    output("Free Memory\t0\t%lu\tKB\n", memory_stats[MEM_TOTAL]);
 }
 
 void printMUsed(const char* cmd)
 {
-    fprintf(CurrentClient, "%lu\n", memory_stats[MEM_TOTAL] - memory_stats[MEM_FREE]);
+    output("%lu\n", memory_stats[MEM_TOTAL] - memory_stats[MEM_FREE]);
 }
 
 void printMUsedInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "Used Memory\t0\t%lu\tKB\n", memory_stats[MEM_TOTAL]);
+    output("Used Memory\t0\t%lu\tKB\n", memory_stats[MEM_TOTAL]);
 }
 
 void printSwapUsed(const char* cmd)
 {
-    fprintf(CurrentClient, "%lu\n", swap_stats[SWAP_USED]);
+    output("%lu\n", swap_stats[SWAP_USED]);
 }
 
 void printSwapUsedInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "Used Swap Memory\t0\t%lu\tKB\n", swap_stats[SWAP_TOTAL]);
+    output("Used Swap Memory\t0\t%lu\tKB\n", swap_stats[SWAP_TOTAL]);
 }
 
 void printSwapFree(const char* cmd)
 {
-    fprintf(CurrentClient, "%lu\n", swap_stats[SWAP_FREE]);
+    output("%lu\n", swap_stats[SWAP_FREE]);
 }
 
 void printSwapFreeInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "Free Swap Memory\t0\t%lu\tKB\n", swap_stats[SWAP_TOTAL]);
+    output("Free Swap Memory\t0\t%lu\tKB\n", swap_stats[SWAP_TOTAL]);
 }
 
 void printSwapIn(const char* cmd)
 {
-    fprintf(CurrentClient, "%lu\n", swap_stats[SWAP_IN]);
+    output("%lu\n", swap_stats[SWAP_IN]);
 }
 
 void printSwapInInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "Swapped In Memory\t0\t0\tKB/s\n");
+    output("Swapped In Memory\t0\t0\tKB/s\n");
 }
 
 void printSwapOut(const char* cmd)
 {
-    fprintf(CurrentClient, "%lu\n", swap_stats[SWAP_OUT]);
+    output("%lu\n", swap_stats[SWAP_OUT]);
 }
 
 void printSwapOutInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "Swapped Out Memory\t0\t0\tKB/s\n");
+    output("Swapped Out Memory\t0\t0\tKB/s\n");
 }
 
 /* Adapted from src/lib/libkvm/kvm_getswapinfo.c */
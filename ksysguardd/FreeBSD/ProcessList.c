@@ -309,7 +309,7 @@ void printProcessList(const char* cmd)
             /* XXX: TODO: add support for displaying kernel process */
             continue;
 
-        fprintf(CurrentClient, "%s\t%ld\t%ld\t%ld\t%ld\t%s\t%.2f\t%.2f\t%d\t%ld\t%ld\t%s\t%s\n",
+        output("%s\t%ld\t%ld\t%ld\t%ld\t%s\t%.2f\t%.2f\t%d\t%ld\t%ld\t%s\t%s\n",
                name, (long)ps->ki_pid, (long)ps->ki_ppid,
                (long)ps->ki_uid, (long)ps->ki_pgid, state,
                ps->ki_runtime / 1000000.0, load, ps->ki_nice,
@@ -319,16 +319,16 @@ void printProcessList(const char* cmd)
 
 void printProcessListInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "Name\tPID\tPPID\tUID\tGID\tStatus\tUser%%\tSystem%%\tNice\tVmSize\tVmRss\tLogin\tCommand\n");
-    fprintf(CurrentClient, "s\td\td\td\td\tS\tf\tf\td\tD\tD\ts\ts\n");
+    output("Name\tPID\tPPID\tUID\tGID\tStatus\tUser%%\tSystem%%\tNice\tVmSize\tVmRss\tLogin\tCommand\n");
+    output("s\td\td\td\td\tS\tf\tf\td\tD\tD\ts\ts\n");
 }
 
 void printProcessCount(const char *cmd) {
-    fprintf(CurrentClient, "%d\n", nproc);
+    output("%d\n", nproc);
 }
 
 void printProcessCountInfo(const char *cmd) {
-    fprintf(CurrentClient, "Number of Processes\t0\t0\t\n");
+    output("Number of Processes\t0\t0\t\n");
 }
 
 void printProcessxCount(const char *cmd) {
@@ -338,7 +338,7 @@ void printProcessxCount(const char *cmd) {
         if (strncasecmp(cmd + 12, statuses[idx], strlen(cmd + 12) - 1) == 0)
             break;
 
-    fprintf(CurrentClient, "%d\n", statcnt[idx]);
+    output("%d\n", statcnt[idx]);
 }
 
 void printProcessxCountInfo(const char *cmd) {
@@ -350,23 +350,23 @@ void printProcessxCountInfo(const char *cmd) {
             break;
     }
 
-    fprintf(CurrentClient, "%s Processes\t0\t0\t\n", statnames[idx]);
+    output("%s Processes\t0\t0\t\n", statnames[idx]);
 }
 
 void printProcSpawn(const char *cmd) {
-    fprintf(CurrentClient, "%u\n", procspawn);
+    output("%u\n", procspawn);
 }
 
 void printProcSpawnInfo(const char *cmd) {
-    fprintf(CurrentClient, "Number of processes spawned\t0\t0\t1/s\n");
+    output("Number of processes spawned\t0\t0\t1/s\n");
 }
 
 void printLastPID(const char *cmd) {
-    fprintf(CurrentClient, "%u\n", lastpid);
+    output("%u\n", lastpid);
 }
 
 void printLastPIDInfo(const char *cmd) {
-    fprintf(CurrentClient, "Last used Process ID\t1\t65535\t\n");
+    output("Last used Process ID\t1\t65535\t\n");
 }
 
 void killProcess(const char *cmd)
@@ -439,22 +439,22 @@ void killProcess(const char *cmd)
         switch(errno)
         {
         case EINVAL:
-            fprintf(CurrentClient, "4\t%d\n", pid);
+            output("4\t%d\n", pid);
             break;
         case ESRCH:
-            fprintf(CurrentClient, "3\t%d\n", pid);
+            output("3\t%d\n", pid);
             break;
         case EPERM:
-            fprintf(CurrentClient, "2\t%d\n", pid);
+            output("2\t%d\n", pid);
             break;
         default:
-            fprintf(CurrentClient, "1\t%d\n", pid);    /* unknown error */
+            output("1\t%d\n", pid);    /* unknown error */
             break;
         }
 
     }
     else
-        fprintf(CurrentClient, "0\t%d\n", pid);
+        output("0\t%d\n", pid);
 }
 
 void setPriority(const char *cmd)
@@ -467,22 +467,22 @@ void setPriority(const char *cmd)
         switch(errno)
         {
         case EINVAL:
-            fprintf(CurrentClient, "4\t%d\t%d\n", pid, prio);
+            output("4\t%d\t%d\n", pid, prio);
             break;
         case ESRCH:
-            fprintf(CurrentClient, "3\t%d\t%d\n", pid, prio);
+            output("3\t%d\t%d\n", pid, prio);
             break;
         case EPERM:
         case EACCES:
-            fprintf(CurrentClient, "2\t%d\t%d\n", pid, prio);
+            output("2\t%d\t%d\n", pid, prio);
             break;
         default:
-            fprintf(CurrentClient, "1\t%d\t%d\n", pid, prio);    /* unknown error */
+            output("1\t%d\t%d\n", pid, prio);    /* unknown error */
             break;
         }
     }
     else
-        fprintf(CurrentClient, "0\n");
+        output("0\n");
 }
 
 int cmp_pid(const void *first_idx, const void *last_idx) {
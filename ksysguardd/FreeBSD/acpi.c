@@ -151,14 +151,14 @@ void printThermal(const char *cmd) {
     int tz;
 
     sscanf(cmd + 22, "%i", &tz);
-    fprintf(CurrentClient, "%f\n", (tz_temp[tz - 1] - 2732) / 10.0);
+    output("%f\n", (tz_temp[tz - 1] - 2732) / 10.0);
 }
 
 void printThermalInfo(const char *cmd) {
     int tz;
 
     sscanf(cmd + 22, "%i", &tz);
-    fprintf(CurrentClient, "ACPI Thermal Zone %i\t0\t0\tC\n", tz);
+    output("ACPI Thermal Zone %i\t0\t0\tC\n", tz);
 }
 
 /*
@@ -166,7 +166,7 @@ void printBat(const char *cmd) {
     int bat;
 
     sscanf(cmd + 17, "%i", &bat);
-    fprintf(CurrentClient, "");
+    output("");
 }
 */
 
@@ -174,68 +174,68 @@ void printBatCharge(const char *cmd) {
     int bat;
 
     sscanf(cmd + 17, "%i", &bat);
-    fprintf(CurrentClient, "%i\n", bat_bst[bat - 1].bst.cap);
+    output("%i\n", bat_bst[bat - 1].bst.cap);
 }
 
 void printBatChargeInfo(const char *cmd) {
     int bat;
 
     sscanf(cmd + 17, "%i", &bat);
-    fprintf(CurrentClient, "Battery %i charge\t0\t%i\t%sh\n", bat, bat_bif[bat - 1].bif.dcap, BAT_UNIT(bat - 1));
+    output("Battery %i charge\t0\t%i\t%sh\n", bat, bat_bif[bat - 1].bif.dcap, BAT_UNIT(bat - 1));
 }
 
 void printBatCapacity(const char *cmd) {
     int bat;
 
     sscanf(cmd + 17, "%i", &bat);
-    fprintf(CurrentClient, "%i\n", bat_battinfo[bat - 1].battinfo.cap);
+    output("%i\n", bat_battinfo[bat - 1].battinfo.cap);
 }
 
 void printBatCapacityInfo(const char *cmd) {
     int bat;
 
     sscanf(cmd + 17, "%i", &bat);
-    fprintf(CurrentClient, "Battery %i capacity\t0\t100\t%%\n", bat);
+    output("Battery %i capacity\t0\t100\t%%\n", bat);
 }
 
 void printBatRemaining(const char *cmd) {
     int bat;
 
     sscanf(cmd + 17, "%i", &bat);
-    fprintf(CurrentClient, "%i\n", bat_battinfo[bat - 1].battinfo.min);
+    output("%i\n", bat_battinfo[bat - 1].battinfo.min);
 }
 
 void printBatRemainingInfo(const char *cmd) {
     int bat;
 
     sscanf(cmd + 17, "%i", &bat);
-    fprintf(CurrentClient, "Battery %i remaining time\t0\t0\tmin\n", bat);
+    output("Battery %i remaining time\t0\t0\tmin\n", bat);
 }
 
 void printBatVoltage(const char *cmd) {
     int bat;
 
     sscanf(cmd + 17, "%i", &bat);
-    fprintf(CurrentClient, "%i\n", bat_bst[bat - 1].bst.volt);
+    output("%i\n", bat_bst[bat - 1].bst.volt);
 }
 
 void printBatVoltageInfo(const char *cmd) {
     int bat;
 
     sscanf(cmd + 17, "%i", &bat);
-    fprintf(CurrentClient, "Battery %i voltage\t0\t%i\tmV\n", bat, bat_bif[bat - 1].bif.dvol);
+    output("Battery %i voltage\t0\t%i\tmV\n", bat, bat_bif[bat - 1].bif.dvol);
 }
 
 void printBatRate(const char *cmd) {
     int bat;
 
     sscanf(cmd + 17, "%i", &bat);
-    fprintf(CurrentClient, "%i\n", bat_bst[bat - 1].bst.rate);
+    output("%i\n", bat_bst[bat - 1].bst.rate);
 }
 
 void printBatRateInfo(const char *cmd) {
     int bat;
 
     sscanf(cmd + 17, "%i", &bat);
-    fprintf(CurrentClient, "Battery %i discharge rate\t0\t0\t%s\n", bat, BAT_UNIT(bat - 1));
+    output("Battery %i discharge rate\t0\t0\t%s\n", bat, BAT_UNIT(bat - 1));
 }
@@ -79,25 +79,25 @@ updateApm(void)
 void
 printApmBatFill(const char* c)
 {
-	fprintf(CurrentClient, "%d\n", BattFill);
+	output("%d\n", BattFill);
 }
 
 void
 printApmBatFillInfo(const char* c)
 {
-	fprintf(CurrentClient, "Battery charge\t0\t100\t%%\n");
+	output("Battery charge\t0\t100\t%%\n");
 }
 
 void
 printApmBatTime(const char* c)
 {
-	fprintf(CurrentClient, "%d\n", BattTime);
+	output("%d\n", BattTime);
 }
 
 void
 printApmBatTimeInfo(const char* c)
 {
-	fprintf(CurrentClient, "Remaining battery time\t0\t0\tmin\n");
+	output("Remaining battery time\t0\t0\tmin\n");
 }
 
 #endif
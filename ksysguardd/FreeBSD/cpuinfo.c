@@ -296,74 +296,74 @@ updateCpuInfo(void)
 void
 printCPUUser(const char* cmd)
 {
-    fprintf(CurrentClient, "%f\n", cpu_states[cores][CP_USER] / 10.0 / cores);
+    output("%f\n", cpu_states[cores][CP_USER] / 10.0 / cores);
 }
 
 void
 printCPUUserInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "CPU User Load\t0\t100\t%%\n");
+    output("CPU User Load\t0\t100\t%%\n");
 }
 
 void
 printCPUNice(const char* cmd)
 {
-    fprintf(CurrentClient, "%f\n", cpu_states[cores][CP_NICE] / 10.0 / cores);
+    output("%f\n", cpu_states[cores][CP_NICE] / 10.0 / cores);
 }
 
 void
 printCPUNiceInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "CPU Nice Load\t0\t100\t%%\n");
+    output("CPU Nice Load\t0\t100\t%%\n");
 }
 
 void
 printCPUSys(const char* cmd)
 {
-    fprintf(CurrentClient, "%f\n", cpu_states[cores][CP_SYS] / 10.0 / cores);
+    output("%f\n", cpu_states[cores][CP_SYS] / 10.0 / cores);
 }
 
 void
 printCPUSysInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "CPU System Load\t0\t100\t%%\n");
+    output("CPU System Load\t0\t100\t%%\n");
 }
 
 void
 printCPUTotalLoad(const char* cmd)
 {
-    fprintf(CurrentClient, "%f\n", (cpu_states[cores][CP_SYS] + cpu_states[cores][CP_USER] +
+    output("%f\n", (cpu_states[cores][CP_SYS] + cpu_states[cores][CP_USER] +
         cpu_states[cores][CP_NICE] + cpu_states[cores][CP_INTR]) / 10.0 / cores);
 }
 
 void
 printCPUTotalLoadInfo(const char* cmd)
 {
-        fprintf(CurrentClient, "CPU Total Load\t0\t100\t%%\n");
+        output("CPU Total Load\t0\t100\t%%\n");
 }
 
 void
 printCPUIntr(const char* cmd)
 {
-        fprintf(CurrentClient, "%f\n", cpu_states[cores][CP_INTR] / 10.0 / cores);
+        output("%f\n", cpu_states[cores][CP_INTR] / 10.0 / cores);
 }
 
 void
 printCPUIntrInfo(const char* cmd)
 {
-        fprintf(CurrentClient, "CPU Interrupt Load\t0\t100\t%%\n");
+        output("CPU Interrupt Load\t0\t100\t%%\n");
 }
 
 void
 printCPUIdle(const char* cmd)
 {
-    fprintf(CurrentClient, "%f\n", cpu_states[cores][CP_IDLE] / 10.0 / cores);
+    output("%f\n", cpu_states[cores][CP_IDLE] / 10.0 / cores);
 }
 
 void
 printCPUIdleInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "CPU Idle Load\t0\t100\t%%\n");
+    output("CPU Idle Load\t0\t100\t%%\n");
 }
 
 void
@@ -372,7 +372,7 @@ printCPUxUser(const char* cmd)
     int id;
 
     sscanf(cmd + 7, "%d", &id);
-    fprintf(CurrentClient, "%0.1f\n", cpu_states[id][CP_USER] / 10.0);
+    output("%0.1f\n", cpu_states[id][CP_USER] / 10.0);
 }
 
 void
@@ -381,7 +381,7 @@ printCPUxUserInfo(const char* cmd)
     int id;
 
     sscanf(cmd + 7, "%d", &id);
-    fprintf(CurrentClient, "CPU%d User Load\t0\t100\t%%\n", id + 1);
+    output("CPU%d User Load\t0\t100\t%%\n", id + 1);
 }
 
 void
@@ -390,7 +390,7 @@ printCPUxNice(const char* cmd)
     int id;
 
     sscanf(cmd + 7, "%d", &id);
-    fprintf(CurrentClient, "%0.1f\n", cpu_states[id][CP_NICE] / 10.0);
+    output("%0.1f\n", cpu_states[id][CP_NICE] / 10.0);
 }
 
 void
@@ -399,7 +399,7 @@ printCPUxNiceInfo(const char* cmd)
     int id;
 
     sscanf(cmd + 7, "%d", &id);
-    fprintf(CurrentClient, "CPU%d Nice Load\t0\t100\t%%\n", id + 1);
+    output("CPU%d Nice Load\t0\t100\t%%\n", id + 1);
 }
 
 void
@@ -408,7 +408,7 @@ printCPUxSys(const char* cmd)
     int id;
 
     sscanf(cmd + 7, "%d", &id);
-    fprintf(CurrentClient, "%0.1f\n", cpu_states[id][CP_SYS] / 10.0);
+    output("%0.1f\n", cpu_states[id][CP_SYS] / 10.0);
 }
 
 void
@@ -417,7 +417,7 @@ printCPUxSysInfo(const char* cmd)
     int id;
 
     sscanf(cmd + 7, "%d", &id);
-    fprintf(CurrentClient, "CPU%d System Load\t0\t100\t%%\n", id + 1);
+    output("CPU%d System Load\t0\t100\t%%\n", id + 1);
 }
 
 void
@@ -426,7 +426,7 @@ printCPUxTotalLoad(const char* cmd)
     int id;
 
     sscanf(cmd + 7, "%d", &id);
-    fprintf(CurrentClient, "%f\n", (cpu_states[id][CP_SYS] + cpu_states[id][CP_USER] +
+    output("%f\n", (cpu_states[id][CP_SYS] + cpu_states[id][CP_USER] +
         cpu_states[id][CP_NICE] + cpu_states[id][CP_INTR]) / 10.0);
 }
 
@@ -436,7 +436,7 @@ printCPUxTotalLoadInfo(const char* cmd)
     int id;
 
     sscanf(cmd + 7, "%d", &id);
-    fprintf(CurrentClient, "CPU%d Total Load\t0\t100\t%%\n", id + 1);
+    output("CPU%d Total Load\t0\t100\t%%\n", id + 1);
 }
 
 void
@@ -445,7 +445,7 @@ printCPUxIntr(const char* cmd)
     int id;
 
     sscanf(cmd + 7, "%d", &id);
-        fprintf(CurrentClient, "%0.1f\n", cpu_states[id][CP_INTR] / 10.0);
+        output("%0.1f\n", cpu_states[id][CP_INTR] / 10.0);
 }
 
 void
@@ -454,7 +454,7 @@ printCPUxIntrInfo(const char* cmd)
     int id;
 
     sscanf(cmd + 7, "%d", &id);
-    fprintf(CurrentClient, "CPU%d Interrupt Load\t0\t100\t%%\n", id + 1);
+    output("CPU%d Interrupt Load\t0\t100\t%%\n", id + 1);
 }
 
 void
@@ -463,7 +463,7 @@ printCPUxIdle(const char* cmd)
     int id;
 
     sscanf(cmd + 7, "%d", &id);
-    fprintf(CurrentClient, "%0.1f\n", cpu_states[id][CP_IDLE] / 10.0);
+    output("%0.1f\n", cpu_states[id][CP_IDLE] / 10.0);
 }
 
 void
@@ -472,7 +472,7 @@ printCPUxIdleInfo(const char* cmd)
     int id;
 
     sscanf(cmd + 7, "%d", &id);
-    fprintf(CurrentClient, "CPU%d Idle Load\t0\t100\t%%\n", id + 1);
+    output("CPU%d Idle Load\t0\t100\t%%\n", id + 1);
 }
 
 void printCPUxClock(const char* cmd)
@@ -480,7 +480,7 @@ void printCPUxClock(const char* cmd)
     int id;
 
     sscanf(cmd + 7, "%d", &id);
-    fprintf(CurrentClient, "%d\n", freq[id][0]);
+    output("%d\n", freq[id][0]);
 }
 
 void printCPUxClockInfo(const char* cmd)
@@ -488,18 +488,18 @@ void printCPUxClockInfo(const char* cmd)
     int id;
 
     sscanf(cmd + 7, "%d", &id);
-    fprintf(CurrentClient, "CPU%d Clock Frequency\t%d\t%d\tMHz\n", id + 1,
+    output("CPU%d Clock Frequency\t%d\t%d\tMHz\n", id + 1,
         freq[id][1], freq[id][2]);
 }
 
 void printCPUClock(const char* cmd)
 {
-    fprintf(CurrentClient, "%f\n", freq[cores][0] / 100.0);
+    output("%f\n", freq[cores][0] / 100.0);
 }
 
 void printCPUClockInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "CPU Clock Frequency\t%d\t%d\tMHz\n", freq[cores][1], freq[cores][2]);
+    output("CPU Clock Frequency\t%d\t%d\tMHz\n", freq[cores][1], freq[cores][2]);
 }
 
 void printCPUxTemperature(const char* cmd)
@@ -507,7 +507,7 @@ void printCPUxTemperature(const char* cmd)
     int id;
 
     sscanf(cmd + 7, "%d", &id);
-    fprintf(CurrentClient, "%0.1f\n", (temp[id] - 2732) / 10.0);
+    output("%0.1f\n", (temp[id] - 2732) / 10.0);
 }
 
 void printCPUxTemperatureInfo(const char* cmd)
@@ -515,37 +515,37 @@ void printCPUxTemperatureInfo(const char* cmd)
     int id;
 
     sscanf(cmd + 7, "%d", &id);
-    fprintf(CurrentClient, "CPU%d Temperature\t0\t0\tC\n", id + 1);
+    output("CPU%d Temperature\t0\t0\tC\n", id + 1);
 }
 
 void printCPUTemperature(const char* cmd)
 {
-    fprintf(CurrentClient, "%0.3f\n", (temp[cores] - 273200) / 1000.0);
+    output("%0.3f\n", (temp[cores] - 273200) / 1000.0);
 }
 
 void printCPUTemperatureInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "CPU Temperature\t0\t0\tC\n");
+    output("CPU Temperature\t0\t0\tC\n");
 }
 
 void printNumCpus(const char* cmd)
 {
-    fprintf(CurrentClient, "%d\n", cpus);
+    output("%d\n", cpus);
 }
 
 void printNumCpusInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "Number of physical CPUs\t0\t%d\t\n", maxcpus);
+    output("Number of physical CPUs\t0\t%d\t\n", maxcpus);
 }
 
 void printNumCores(const char* cmd)
 {
-    fprintf(CurrentClient, "%d\n", cores);
+    output("%d\n", cores);
 }
 
 void printNumCoresInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "Total number of processor cores\t0\t%d\t\n", maxcpus);
+    output("Total number of processor cores\t0\t%d\t\n", maxcpus);
 }
 
 void get_mmfreq(int id, int* minfreq, int* maxfreq)
@@ -203,7 +203,7 @@ void printDiskStat(const char* cmd)
     DiskInfo* disk_info;
 
     for (disk_info = first_ctnr(DiskStatList); disk_info; disk_info = next_ctnr(DiskStatList)) {
-        fprintf(CurrentClient, "%s\t%ld\t%ld\t%ld\t%d\t%ld\t%ld\t%ld\t%d\t%s\n",
+        output("%s\t%ld\t%ld\t%ld\t%d\t%ld\t%ld\t%ld\t%d\t%s\n",
             disk_info->device,
             BLK2KB(disk_info, blocks),
             BLK2KB(disk_info, bused),
@@ -216,12 +216,12 @@ void printDiskStat(const char* cmd)
             MNTPNT_NAME(disk_info));
     }
 
-    fprintf(CurrentClient, "\n");
+    output("\n");
 }
 
 void printDiskStatInfo(const char* cmd)
 {
-    fprintf(CurrentClient, "Device\tCapacity\tUsed\tAvailable\tUsed %%\tInodes\tUsed Inodes\tFree Inodes\tInodes %%\tMountPoint\nM\tKB\tKB\tKB\t%%\td\td\td\t%%\ts\n");
+    output("Device\tCapacity\tUsed\tAvailable\tUsed %%\tInodes\tUsed Inodes\tFree Inodes\tInodes %%\tMountPoint\nM\tKB\tKB\tKB\t%%\td\td\td\t%%\ts\n");
 }
 
 void printDiskStatUsed(const char* cmd)
@@ -231,12 +231,12 @@ void printDiskStatUsed(const char* cmd)
 
     for (disk_info = first_ctnr(DiskStatList); disk_info; disk_info = next_ctnr(DiskStatList)) {
         if (!strcmp(mntpnt, disk_info->mntpnt)) {
-            fprintf(CurrentClient, "%ld\n", BLK2KB(disk_info, bused));
+            output("%ld\n", BLK2KB(disk_info, bused));
             return;
         }
     }
 
-    fprintf(CurrentClient, "\n");
+    output("\n");
 }
 
 void printDiskStatUsedInfo(const char* cmd)
@@ -246,11 +246,11 @@ void printDiskStatUsedInfo(const char* cmd)
 
     for (disk_info = first_ctnr(DiskStatList); disk_info; disk_info = next_ctnr(DiskStatList)) {
         if (!strcmp(mntpnt, disk_info->mntpnt)) {
-            fprintf(CurrentClient, "Used Space (%s)\t0\t%ld\tKB\n", MNTPNT_NAME(disk_info), BLK2KB(disk_info, blocks));
+            output("Used Space (%s)\t0\t%ld\tKB\n", MNTPNT_NAME(disk_info), BLK2KB(disk_info, blocks));
             return;
         }
     }
-    fprintf(CurrentClient, "Used Space (%s)\t0\t-\tKB\n", mntpnt);
+    output("Used Space (%s)\t0\t-\tKB\n", mntpnt);
 }
 
 void printDiskStatFree(const char* cmd)
@@ -260,12 +260,12 @@ void printDiskStatFree(const char* cmd)
 
     for (disk_info = first_ctnr(DiskStatList); disk_info; disk_info = next_ctnr(DiskStatList)) {
         if (!strcmp(mntpnt, disk_info->mntpnt)) {
-            fprintf(CurrentClient, "%ld\n", BLK2KB(disk_info, bfree));
+            output("%ld\n", BLK2KB(disk_info, bfree));
             return;
         }
     }
 
-    fprintf(CurrentClient, "\n");
+    output("\n");
 }
 
 void printDiskStatFreeInfo(const char* cmd)
@@ -275,11 +275,11 @@ void printDiskStatFreeInfo(const char* cmd)
 
     for (disk_info = first_ctnr(DiskStatList); disk_info; disk_info = next_ctnr(DiskStatList)) {
         if (!strcmp(mntpnt, disk_info->mntpnt)) {
-            fprintf(CurrentClient, "Free Space (%s)\t0\t%ld\tKB\n", MNTPNT_NAME(disk_info), BLK2KB(disk_info, blocks));
+            output("Free Space (%s)\t0\t%ld\tKB\n", MNTPNT_NAME(disk_info), BLK2KB(disk_info, blocks));
             return;
         }
     }
-    fprintf(CurrentClient, "Free Space (%s)\t0\t-\tKB\n", mntpnt);
+    output("Free Space (%s)\t0\t-\tKB\n", mntpnt);
 }
 
 void printDiskStatPercent(const char* cmd)
@@ -289,19 +289,19 @@ void printDiskStatPercent(const char* cmd)
 
     for (disk_info = first_ctnr(DiskStatList); disk_info; disk_info = next_ctnr(DiskStatList)) {
         if (!strcmp(mntpnt, disk_info->mntpnt)) {
-            fprintf(CurrentClient, "%d\n", disk_info->bused_percent);
+            output("%d\n", disk_info->bused_percent);
             return;
         }
     }
 
-    fprintf(CurrentClient, "\n");
+    output("\n");
 }
 
 void printDiskStatPercentInfo(const char* cmd)
 {
     char *mntpnt = (char *)getMntPnt(cmd);
 
-    fprintf(CurrentClient, "Used Space (%s)\t0\t100\t%%\n", mntpnt);
+    output("Used Space (%s)\t0\t100\t%%\n", mntpnt);
 }
 
 void printDiskStatIUsed(const char* cmd)
@@ -311,12 +311,12 @@ void printDiskStatIUsed(const char* cmd)
 
     for (disk_info = first_ctnr(DiskStatList); disk_info; disk_info = next_ctnr(DiskStatList)) {
         if (!strcmp(mntpnt, disk_info->mntpnt)) {
-            fprintf(CurrentClient, "%ld\n", disk_info->fused);
+            output("%ld\n", disk_info->fused);
             return;
         }
     }
 
-    fprintf(CurrentClient, "\n");
+    output("\n");
 }
 
 void printDiskStatIUsedInfo(const char* cmd)
@@ -326,11 +326,11 @@ void printDiskStatIUsedInfo(const char* cmd)
 
     for (disk_info = first_ctnr(DiskStatList); disk_info; disk_info = next_ctnr(DiskStatList)) {
         if (!strcmp(mntpnt, disk_info->mntpnt)) {
-            fprintf(CurrentClient, "Used Inodes (%s)\t0\t%ld\tKB\n", MNTPNT_NAME(disk_info), disk_info->files);
+            output("Used Inodes (%s)\t0\t%ld\tKB\n", MNTPNT_NAME(disk_info), disk_info->files);
             return;
         }
     }
-    fprintf(CurrentClient, "Used Inodes(%s)\t0\t-\tKB\n", mntpnt);
+    output("Used Inodes(%s)\t0\t-\tKB\n", mntpnt);
 }
 
 void printDiskStatIFree(const char* cmd)
@@ -340,12 +340,12 @@ void printDiskStatIFree(const char* cmd)
 
     for (disk_info = first_ctnr(DiskStatList); disk_info; disk_info = next_ctnr(DiskStatList)) {
         if (!strcmp(mntpnt, disk_info->mntpnt)) {
-            fprintf(CurrentClient, "%ld\n", disk_info->ffree);
+            output("%ld\n", disk_info->ffree);
             return;
         }
     }
 
-    fprintf(CurrentClient, "\n");
+    output("\n");
 }
 
 void printDiskStatIFreeInfo(const char* cmd)
@@ -355,11 +355,11 @@ void printDiskStatIFreeInfo(const char* cmd)
 
     for (disk_info = first_ctnr(DiskStatList); disk_info; disk_info = next_ctnr(DiskStatList)) {
         if (!strcmp(mntpnt, disk_info->mntpnt)) {
-            fprintf(CurrentClient, "Free Inodes (%s)\t0\t%ld\tKB\n", MNTPNT_NAME(disk_info), disk_info->files);
+            output("Free Inodes (%s)\t0\t%ld\tKB\n", MNTPNT_NAME(disk_info), disk_info->files);
             return;
         }
     }
-    fprintf(CurrentClient, "Free Inodes (%s)\t0\t-\tKB\n", mntpnt);
+    output("Free Inodes (%s)\t0\t-\tKB\n", mntpnt);
 }
 
 void printDiskStatIPercent(const char* cmd)
@@ -369,18 +369,18 @@ void printDiskStatIPercent(const char* cmd)
 
     for (disk_info = first_ctnr(DiskStatList); disk_info; disk_info = next_ctnr(DiskStatList)) {
         if (!strcmp(mntpnt, disk_info->mntpnt)) {
-            fprintf(CurrentClient, "%d\n", disk_info->fused_percent);
+            output("%d\n", disk_info->fused_percent);
             return;
         }
     }
 
-    fprintf(CurrentClient, "\n");
+    output("\n");
 }
 
 void printDiskStatIPercentInfo(const char* cmd)
 {
     char *mntpnt = (char *)getMntPnt(cmd);
 
-    fprintf(CurrentClient, "Used Inodes (%s)\t0\t100\t%%\n", mntpnt);
+    output("Used Inodes (%s)\t0\t100\t%%\n", mntpnt);
 }
 
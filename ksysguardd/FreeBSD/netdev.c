@@ -251,22 +251,22 @@ void printNetDevRecBytes(const char *cmd)
     for (i = 0; i < NetDevCnt; i++) {
         if (!strcmp(NetDevs[i].name, retval[0])) {
             if (!strncmp(retval[1], "data", 4))
-                fprintf(CurrentClient, "%lu", (u_long)((NetDevs[i].recBytes - NetDevsOld[i].recBytes) / (1024 * elapsed)));
+                output("%lu", (u_long)((NetDevs[i].recBytes - NetDevsOld[i].recBytes) / (1024 * elapsed)));
             if (!strncmp(retval[1], "packets", 7))
-                fprintf(CurrentClient, "%lu", (u_long)((NetDevs[i].recPacks - NetDevsOld[i].recPacks) / elapsed));
+                output("%lu", (u_long)((NetDevs[i].recPacks - NetDevsOld[i].recPacks) / elapsed));
             if (!strncmp(retval[1], "errors", 6))
-                fprintf(CurrentClient, "%lu", (u_long)((NetDevs[i].recErrs - NetDevsOld[i].recErrs) / elapsed));
+                output("%lu", (u_long)((NetDevs[i].recErrs - NetDevsOld[i].recErrs) / elapsed));
             if (!strncmp(retval[1], "drops", 5))
-                fprintf(CurrentClient, "%lu", (u_long)((NetDevs[i].recDrop - NetDevsOld[i].recDrop) / elapsed));
+                output("%lu", (u_long)((NetDevs[i].recDrop - NetDevsOld[i].recDrop) / elapsed));
             if (!strncmp(retval[1], "multicast", 9))
-                fprintf(CurrentClient, "%lu", (u_long)((NetDevs[i].recMulticast - NetDevsOld[i].recMulticast) / elapsed));
+                output("%lu", (u_long)((NetDevs[i].recMulticast - NetDevsOld[i].recMulticast) / elapsed));
         }
     }
     free(retval[0]);
     free(retval[1]);
     free(retval);
 
-    fprintf(CurrentClient, "\n");
+    output("\n");
 }
 
 void printNetDevRecBytesInfo(const char *cmd)
@@ -279,15 +279,15 @@ void printNetDevRecBytesInfo(const char *cmd)
         return;
 
     if (!strncmp(retval[1], "data", 4))
-        fprintf(CurrentClient, "Received Data\t0\t0\tKB/s\n");
+        output("Received Data\t0\t0\tKB/s\n");
     if (!strncmp(retval[1], "packets", 7))
-        fprintf(CurrentClient, "Received Packets\t0\t0\t1/s\n");
+        output("Received Packets\t0\t0\t1/s\n");
     if (!strncmp(retval[1], "errors", 6))
-        fprintf(CurrentClient, "Receiver Errors\t0\t0\t1/s\n");
+        output("Receiver Errors\t0\t0\t1/s\n");
     if (!strncmp(retval[1], "drops", 5))
-        fprintf(CurrentClient, "Receiver Drops\t0\t0\t1/s\n");
+        output("Receiver Drops\t0\t0\t1/s\n");
     if (!strncmp(retval[1], "multicast", 9))
-        fprintf(CurrentClient, "Received Multicast Packets\t0\t0\t1/s\n");
+        output("Received Multicast Packets\t0\t0\t1/s\n");
     
     free(retval[0]);
     free(retval[1]);
@@ -307,22 +307,22 @@ void printNetDevSentBytes(const char *cmd)
     for (i = 0; i < NetDevCnt; i++) {
         if (!strcmp(NetDevs[i].name, retval[0])) {
             if (!strncmp(retval[1], "data", 4))
-                fprintf(CurrentClient, "%lu", (u_long)((NetDevs[i].sentBytes - NetDevsOld[i].sentBytes) / (1024 * elapsed)));
+                output("%lu", (u_long)((NetDevs[i].sentBytes - NetDevsOld[i].sentBytes) / (1024 * elapsed)));
             if (!strncmp(retval[1], "packets", 7))
-                fprintf(CurrentClient, "%lu", (u_long)((NetDevs[i].sentPacks - NetDevsOld[i].sentPacks) / elapsed));
+                output("%lu", (u_long)((NetDevs[i].sentPacks - NetDevsOld[i].sentPacks) / elapsed));
             if (!strncmp(retval[1], "errors", 6))
-                fprintf(CurrentClient, "%lu", (u_long)((NetDevs[i].sentErrs - NetDevsOld[i].sentErrs) / elapsed));
+                output("%lu", (u_long)((NetDevs[i].sentErrs - NetDevsOld[i].sentErrs) / elapsed));
             if (!strncmp(retval[1], "multicast", 9))
-                fprintf(CurrentClient, "%lu", (u_long)((NetDevs[i].sentMulticast - NetDevsOld[i].sentMulticast) / elapsed));
+                output("%lu", (u_long)((NetDevs[i].sentMulticast - NetDevsOld[i].sentMulticast) / elapsed));
             if (!strncmp(retval[1], "collisions", 10))
-                fprintf(CurrentClient, "%lu", (u_long)((NetDevs[i].sentColls - NetDevsOld[i].sentColls) / elapsed));
+                output("%lu", (u_long)((NetDevs[i].sentColls - NetDevsOld[i].sentColls) / elapsed));
         }
     }
     free(retval[0]);
     free(retval[1]);
     free(retval);
 
-    fprintf(CurrentClient, "\n");
+    output("\n");
 }
 
 void printNetDevSentBytesInfo(const char *cmd)
@@ -335,15 +335,15 @@ void printNetDevSentBytesInfo(const char *cmd)
         return;
 
     if (!strncmp(retval[1], "data", 4))
-        fprintf(CurrentClient, "Sent Data\t0\t0\tKB/s\n");
+        output("Sent Data\t0\t0\tKB/s\n");
     if (!strncmp(retval[1], "packets", 7))
-        fprintf(CurrentClient, "Sent Packets\t0\t0\t1/s\n");
+        output("Sent Packets\t0\t0\t1/s\n");
     if (!strncmp(retval[1], "errors", 6))
-        fprintf(CurrentClient, "Transmitter Errors\t0\t0\t1/s\n");
+        output("Transmitter Errors\t0\t0\t1/s\n");
     if (!strncmp(retval[1], "multicast", 9))
-        fprintf(CurrentClient, "Sent Multicast Packets\t0\t0\t1/s\n");
+        output("Sent Multicast Packets\t0\t0\t1/s\n");
     if (!strncmp(retval[1], "collisions", 10))
-        fprintf(CurrentClient, "Transmitter Collisions\t0\t0\t1/s\n");
+        output("Transmitter Collisions\t0\t0\t1/s\n");
 
     free(retval[0]);
     free(retval[1]);
@@ -233,19 +233,19 @@ int updateStat(void) {
 }
 
 void printHardInt(const char *cmd) {
-	fprintf(CurrentClient, "%d\n", hardint);
+	output("%d\n", hardint);
 }
 
 void printHardIntInfo(const char *cmd) {
-	fprintf(CurrentClient, "Hardware Interrupts\t0\t0\t1/s\n");
+	output("Hardware Interrupts\t0\t0\t1/s\n");
 }
 
 void printSoftInt(const char *cmd) {
-	fprintf(CurrentClient, "%d\n", softint);
+	output("%d\n", softint);
 }
 
 void printSoftIntInfo(const char *cmd) {
-	fprintf(CurrentClient, "Software Interrupts\t0\t0\t1/s\n");
+	output("Software Interrupts\t0\t0\t1/s\n");
 }
 
 void printInterruptx(const char *cmd) {
@@ -254,7 +254,7 @@ void printInterruptx(const char *cmd) {
 	sscanf(cmd + 18, "%d", &irq);
 	if (irq > 255)
 		irq -= msi_offset - 1;
-	fprintf(CurrentClient, "%ld\n", intr[intr_map[irq - 1]]);
+	output("%ld\n", intr[intr_map[irq - 1]]);
 }
 
 void printInterruptxInfo(const char *cmd) {
@@ -263,31 +263,31 @@ void printInterruptxInfo(const char *cmd) {
 	sscanf(cmd + 18, "%d", &irq);
 	if (irq > 255)
 		irq -= msi_offset - 1;
-	fprintf(CurrentClient, "%s\t0\t0\t1/s\n", intrname[intr_map[irq - 1]]);
+	output("%s\t0\t0\t1/s\n", intrname[intr_map[irq - 1]]);
 }
 
 void printContext(const char *cmd) {
-	fprintf(CurrentClient, "%u\n", context);
+	output("%u\n", context);
 }
 
 void printContextInfo(const char *cmd) {
-	fprintf(CurrentClient, "Context switches\t0\t0\t1/s\n");
+	output("Context switches\t0\t0\t1/s\n");
 }
 
 void printTrap(const char *cmd) {
-	fprintf(CurrentClient, "%u\n", trap);
+	output("%u\n", trap);
 }
 
 void printTrapInfo(const char *cmd) {
-	fprintf(CurrentClient, "Traps\t0\t0\t1/s\n");
+	output("Traps\t0\t0\t1/s\n");
 }
 
 void printSyscall(const char *cmd) {
-	fprintf(CurrentClient, "%u\n", syscall);
+	output("%u\n", syscall);
 }
 
 void printSyscallInfo(const char *cmd) {
-	fprintf(CurrentClient, "System Calls\t0\t0\t1/s\n");
+	output("System Calls\t0\t0\t1/s\n");
 }
 
 /*
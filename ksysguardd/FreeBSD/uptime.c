@@ -42,9 +42,9 @@ void printUptime( const char* cmd ) {
 
     if (clock_gettime(CLOCK_UPTIME, &tp) != -1)
         uptime = tp.tv_nsec / 1000000000.0 + tp.tv_sec;
-    fprintf( CurrentClient, "%f\n", uptime);
+    output( "%f\n", uptime);
 }
 
 void printUptimeInfo( const char* cmd ) {
-    fprintf( CurrentClient, "System uptime\t0\t0\ts\n" );
+    output( "System uptime\t0\t0\ts\n" );
 }
@@ -0,0 +1,115 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#include <stdlib.h>
+
+#include "Command.h"
+
+#include "History.h"
+
+typedef struct HistorySample {
+  long long time;
+  double value;
+} HistorySample;
+
+struct History {
+  unsigned int resolution;
+  int size;
+  int count;
+  /* The slot of the next sample */
+  int next;
+  HistorySample samples[];
+};
+
+History* newHistory( unsigned int duration, unsigned int resolution )
+{
+  History* history;
+  unsigned long long size;
+
+  if ( resolution == 0 )
+    resolution = 1;
+
+  size = (unsigned long long)duration * 1000 / resolution;
+  if ( size < 1 )
+    size = 1;
+  if ( size > 1000000 )
+    size = 1000000;
+
+  if ( ( history = (History*)malloc( sizeof( History ) + size * sizeof( HistorySample ) ) ) == NULL )
+    return NULL;
+
+  history->resolution = resolution;
+  history->size = size;
+  history->count = 0;
+  history->next = 0;
+
+  return history;
+}
+
+void freeHistory( History* history )
+{
+  free( history );
+}
+
+void addHistorySample( History* history, long long time, double value )
+{
+  HistorySample* sample;
+
+  if ( history->count > 0 ) {
+    const HistorySample* last = &history->samples[ ( history->next + history->size - 1 ) % history->size ];
+    if ( time - last->time < (long long)history->resolution )
+      return;
+  }
+
+  sample = &history->samples[ history->next ];
+  sample->time = time;
+  sample->value = value;
+
+  history->next = ( history->next + 1 ) % history->size;
+  if ( history->count < history->size )
+    history->count++;
+}
+
+void replayHistory( const History* history,
+                    void (*add)( void* data, long long time, double value ), void* data )
+{
+  int first = ( history->next + history->size - history->count ) % history->size;
+  int i;
+
+  for ( i = 0; i < history->count; ++i ) {
+    const HistorySample* sample = &history->samples[ ( first + i ) % history->size ];
+    add( data, sample->time, sample->value );
+  }
+}
+
+void printHistorySamples( const History* history, long long from, int integer )
+{
+  int first = ( history->next + history->size - history->count ) % history->size;
+  int i;
+
+  for ( i = 0; i < history->count; ++i ) {
+    const HistorySample* sample = &history->samples[ ( first + i ) % history->size ];
+    if ( sample->time < from )
+      continue;
+
+    if ( integer )
+      output( "%lld\t%.0f\n", sample->time, sample->value );
+    else
+      output( "%lld\t%f\n", sample->time, sample->value );
+  }
+}
@@ -0,0 +1,57 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#ifndef KSG_HISTORY_H
+#define KSG_HISTORY_H
+
+/**
+  The recent values of a numeric sensor in a ring buffer of fixed size.
+  It holds one sample per @ref resolution ms for @ref duration seconds,
+  when it is full the oldest sample is overwritten. Samples that follow
+  the previous one within less than the resolution are dropped.
+ */
+typedef struct History History;
+
+/**
+  @return a history for @ref duration seconds at one sample per
+  @ref resolution ms or 0 if there is no memory.
+ */
+History* newHistory( unsigned int duration, unsigned int resolution );
+
+void freeHistory( History* history );
+
+/**
+  Adds @ref value, taken at @ref time ms since the epoch.
+ */
+void addHistorySample( History* history, long long time, double value );
+
+/**
+  Prints all samples that are not older than @ref from ms since the
+  epoch, one per line: the time in ms since the epoch and the value,
+  separated by a tab. The oldest sample comes first. If @ref integer is
+  set, the values are printed without fraction.
+ */
+void printHistorySamples( const History* history, long long from, int integer );
+
+/**
+  Calls @ref add with @ref data and every sample, the oldest first.
+ */
+void replayHistory( const History* history,
+                    void (*add)( void* data, long long time, double value ), void* data );
+
+#endif
@@ -243,22 +243,22 @@ void printNetDevRecBytes(const char *cmd)
 	for (i = 0; i < NetDevCnt; i++) {
 		if (!strcmp(NetDevs[i].name, retval[0])) {
 			if (!strncmp(retval[1], "data", 4))
-				fprintf(CurrentClient, "%lu", NetDevs[i].recBytes);
+				output("%lu", NetDevs[i].recBytes);
 			if (!strncmp(retval[1], "packets", 7))
-				fprintf(CurrentClient, "%lu", NetDevs[i].recPacks);
+				output("%lu", NetDevs[i].recPacks);
 			if (!strncmp(retval[1], "errors", 6))
-				fprintf(CurrentClient, "%lu", NetDevs[i].recErrs);
+				output("%lu", NetDevs[i].recErrs);
 			if (!strncmp(retval[1], "drops", 5))
-				fprintf(CurrentClient, "%lu", NetDevs[i].recDrop);
+				output("%lu", NetDevs[i].recDrop);
 			if (!strncmp(retval[1], "multicast", 9))
-				fprintf(CurrentClient, "%lu", NetDevs[i].recMulticast);
+				output("%lu", NetDevs[i].recMulticast);
 		}
 	}
 	free(retval[0]);
 	free(retval[1]);
 	free(retval);
 
-	fprintf(CurrentClient, "\n");
+	output("\n");
 }
 
 void printNetDevRecBytesInfo(const char *cmd)
@@ -271,15 +271,15 @@ void printNetDevRecBytesInfo(const char *cmd)
 		return;
 
 	if (!strncmp(retval[1], "data", 4))
-		fprintf(CurrentClient, "Received Data\t0\t0\tKB/s\n");
+		output("Received Data\t0\t0\tKB/s\n");
 	if (!strncmp(retval[1], "packets", 7))
-		fprintf(CurrentClient, "Received Packets\t0\t0\t1/s\n");
+		output("Received Packets\t0\t0\t1/s\n");
 	if (!strncmp(retval[1], "errors", 6))
-		fprintf(CurrentClient, "Receiver Errors\t0\t0\t1/s\n");
+		output("Receiver Errors\t0\t0\t1/s\n");
 	if (!strncmp(retval[1], "drops", 5))
-		fprintf(CurrentClient, "Receiver Drops\t0\t0\t1/s\n");
+		output("Receiver Drops\t0\t0\t1/s\n");
 	if (!strncmp(retval[1], "multicast", 9))
-		fprintf(CurrentClient, "Received Multicast Packets\t0\t0\t1/s\n");
+		output("Received Multicast Packets\t0\t0\t1/s\n");
 	
 	free(retval[0]);
 	free(retval[1]);
@@ -299,22 +299,22 @@ void printNetDevSentBytes(const char *cmd)
 	for (i = 0; i < NetDevCnt; i++) {
 		if (!strcmp(NetDevs[i].name, retval[0])) {
 			if (!strncmp(retval[1], "data", 4))
-				fprintf(CurrentClient, "%lu", NetDevs[i].sentBytes);
+				output("%lu", NetDevs[i].sentBytes);
 			if (!strncmp(retval[1], "packets", 7))
-				fprintf(CurrentClient, "%lu", NetDevs[i].sentPacks);
+				output("%lu", NetDevs[i].sentPacks);
 			if (!strncmp(retval[1], "errors", 6))
-				fprintf(CurrentClient, "%lu", NetDevs[i].sentErrs);
+				output("%lu", NetDevs[i].sentErrs);
 			if (!strncmp(retval[1], "multicast", 9))
-				fprintf(CurrentClient, "%lu", NetDevs[i].sentMulticast);
+				output("%lu", NetDevs[i].sentMulticast);
 			if (!strncmp(retval[1], "collisions", 10))
-				fprintf(CurrentClient, "%lu", NetDevs[i].sentColls);
+				output("%lu", NetDevs[i].sentColls);
 		}
 	}
 	free(retval[0]);
 	free(retval[1]);
 	free(retval);
 
-	fprintf(CurrentClient, "\n");
+	output("\n");
 }
 
 void printNetDevSentBytesInfo(const char *cmd)
@@ -327,15 +327,15 @@ void printNetDevSentBytesInfo(const char *cmd)
 		return;
 
 	if (!strncmp(retval[1], "data", 4))
-		fprintf(CurrentClient, "Sent Data\t0\t0\tKB/s\n");
+		output("Sent Data\t0\t0\tKB/s\n");
 	if (!strncmp(retval[1], "packets", 7))
-		fprintf(CurrentClient, "Sent Packets\t0\t0\t1/s\n");
+		output("Sent Packets\t0\t0\t1/s\n");
 	if (!strncmp(retval[1], "errors", 6))
-		fprintf(CurrentClient, "Transmitter Errors\t0\t0\t1/s\n");
+		output("Transmitter Errors\t0\t0\t1/s\n");
 	if (!strncmp(retval[1], "multicast", 9))
-		fprintf(CurrentClient, "Sent Multicast Packets\t0\t0\t1/s\n");
+		output("Sent Multicast Packets\t0\t0\t1/s\n");
 	if (!strncmp(retval[1], "collisions", 10))
-		fprintf(CurrentClient, "Transmitter Collisions\t0\t0\t1/s\n");
+		output("Transmitter Collisions\t0\t0\t1/s\n");
 
 	free(retval[0]);
 	free(retval[1]);
@@ -320,9 +320,9 @@ int updateProcessList( void ) {
 }
 
 void printProcessListInfo( const char *cmd ) {
-	fprintf(CurrentClient, "Name\tPID\tPPID\tGID\tStatus\tUser"
+	output("Name\tPID\tPPID\tGID\tStatus\tUser"
 		"\tSize\tResident\t%% CPU\tPriority\tCommand\n" );
-	fprintf(CurrentClient, "s\td\td\td\ts\ts\tD\tD\tf\td\ts\n" );
+	output("s\td\td\td\ts\ts\tD\tD\tf\td\ts\n" );
 }
 
 void printProcessList( const char *cmd ) {
@@ -330,8 +330,7 @@ void printProcessList( const char *cmd ) {
 	ProcessInfo *ps;
 
 	for( ps = first_ctnr( ProcessList ); ps; ps = next_ctnr( ProcessList )) {
-		fprintf(CurrentClient,
-			"%s\t%ld\t%ld\t%ld\t%s\t%s\t%d\t%d\t%.2f\t%d\t%s\n",
+		output("%s\t%ld\t%ld\t%ld\t%s\t%s\t%d\t%d\t%.2f\t%d\t%s\n",
 			ps->Command,
 			(long) ps->pid,
 			(long) ps->ppid,
@@ -345,15 +344,15 @@ void printProcessList( const char *cmd ) {
 			ps->CmdLine);
 	}
 
-	fprintf(CurrentClient, "\n");
+	output("\n");
 }
 
 void printProcessCount( const char *cmd ) {
-	fprintf(CurrentClient, "%d\n", ProcessCount );
+	output("%d\n", ProcessCount );
 }
 
 void printProcessCountInfo( const char *cmd ) {
-	fprintf(CurrentClient, "Number of Processes\t0\t0\t\n" );
+	output("Number of Processes\t0\t0\t\n" );
 }
 
 void killProcess( const char *cmd ) {
@@ -424,20 +423,20 @@ void killProcess( const char *cmd ) {
 	if( kill( (pid_t) pid, sig )) {
 		switch( errno ) {
 			case EINVAL:
-				fprintf(CurrentClient, "4\n" );
+				output("4\n" );
 				break;
 			case ESRCH:
-				fprintf(CurrentClient, "3\n" );
+				output("3\n" );
 				break;
 			case EPERM:
-				fprintf(CurrentClient, "2\n" );
+				output("2\n" );
 				break;
 			default:
-				fprintf(CurrentClient, "1\n" );	/* unknown error */
+				output("1\n" );	/* unknown error */
 				break;
 		}
 	} else
-		fprintf(CurrentClient, "0\n");
+		output("0\n");
 }
 
 void setPriority( const char *cmd ) {
@@ -447,19 +446,19 @@ void setPriority( const char *cmd ) {
 	if( setpriority( PRIO_PROCESS, pid, prio )) {
 		switch( errno ) {
 			case EINVAL:
-				fprintf(CurrentClient, "4\n" );
+				output("4\n" );
 				break;
 			case ESRCH:
-				fprintf(CurrentClient, "3\n" );
+				output("3\n" );
 				break;
 			case EPERM:
 			case EACCES:
-				fprintf(CurrentClient, "2\n" );
+				output("2\n" );
 				break;
 			default:
-				fprintf(CurrentClient, "1\n" );	/* unknown error */
+				output("1\n" );	/* unknown error */
 				break;
 		}
 	} else
-		fprintf(CurrentClient, "0\n");
+		output("0\n");
 }
@@ -151,55 +151,55 @@ updateCpuInfo(void)
 void
 printCPUUser(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", cpu_states[CPU_USER]/10);
+	output("%d\n", cpu_states[CPU_USER]/10);
 }
 
 void
 printCPUUserInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "CPU User Load\t0\t100\t%%\n");
+	output("CPU User Load\t0\t100\t%%\n");
 }
 
 void
 printCPUSys(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", cpu_states[CPU_KERNEL]/10);
+	output("%d\n", cpu_states[CPU_KERNEL]/10);
 }
 
 void
 printCPUSysInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "CPU System Load\t0\t100\t%%\n");
+	output("CPU System Load\t0\t100\t%%\n");
 }
 
 void
 printCPUIdle(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", cpu_states[CPU_IDLE]/10);
+	output("%d\n", cpu_states[CPU_IDLE]/10);
 }
 
 void
 printCPUIdleInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "CPU Idle Load\t0\t100\t%%\n");
+	output("CPU Idle Load\t0\t100\t%%\n");
 }
 /* same as above but for individual CPUs */
 void
 printCPUxUser(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", g_ci[getID(cmd)].cpu_states[CPU_USER]/10);
+	output("%d\n", g_ci[getID(cmd)].cpu_states[CPU_USER]/10);
 }
 
 void
 printCPUxSys(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", g_ci[getID(cmd)].cpu_states[CPU_KERNEL]/10);
+	output("%d\n", g_ci[getID(cmd)].cpu_states[CPU_KERNEL]/10);
 }
 
 void
 printCPUxIdle(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", g_ci[getID(cmd)].cpu_states[CPU_IDLE]/10);
+	output("%d\n", g_ci[getID(cmd)].cpu_states[CPU_IDLE]/10);
 }
 
 
@@ -0,0 +1,101 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#define _XOPEN_SOURCE 700 /* clock_gettime */
+#include <time.h>
+
+#include "Command.h"
+
+#include "Latency.h"
+
+#define SUB_BUCKETS	( 1 << LATENCY_SUB_BITS )
+
+static int bucketIndex( unsigned long long value )
+{
+  int magnitude;
+
+  if ( value < SUB_BUCKETS )
+    return (int)value;
+
+  magnitude = 63 - __builtin_clzll( value );
+  if ( magnitude > 31 )
+    return LATENCY_BUCKETS - 1;
+
+  return ( ( magnitude - LATENCY_SUB_BITS + 1 ) << LATENCY_SUB_BITS ) +
+         (int)( ( value >> ( magnitude - LATENCY_SUB_BITS ) ) & ( SUB_BUCKETS - 1 ) );
+}
+
+/**
+  @return the largest value that falls into bucket @ref index.
+ */
+static unsigned long long bucketEnd( int index )
+{
+  int shift;
+
+  if ( index < SUB_BUCKETS )
+    return index;
+
+  shift = ( index >> LATENCY_SUB_BITS ) - 1;
+  return ( ( (unsigned long long)( SUB_BUCKETS + ( index & ( SUB_BUCKETS - 1 ) ) ) + 1 ) << shift ) - 1;
+}
+
+unsigned long long monotonicMicros( void )
+{
+  struct timespec now;
+
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  return (unsigned long long)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+void addLatency( LatencyHistogram* histogram, unsigned long long micros )
+{
+  ++histogram->count;
+  histogram->sum += micros;
+  if ( micros > histogram->max )
+    histogram->max = micros;
+  ++histogram->buckets[ bucketIndex( micros ) ];
+}
+
+unsigned long long latencyPercentile( const LatencyHistogram* histogram, double percentile )
+{
+  unsigned long long rank, seen = 0;
+  int i;
+
+  if ( histogram->count == 0 )
+    return 0;
+
+  rank = (unsigned long long)( percentile / 100.0 * histogram->count + 0.5 );
+  if ( rank < 1 )
+    rank = 1;
+
+  for ( i = 0; i < LATENCY_BUCKETS; ++i ) {
+    seen += histogram->buckets[ i ];
+    if ( seen >= rank )
+      return bucketEnd( i ) < histogram->max ? bucketEnd( i ) : histogram->max;
+  }
+
+  return histogram->max;
+}
+
+void printLatency( const LatencyHistogram* histogram )
+{
+  output( "\t%llu\t%llu\t%llu\t%llu\t%llu\t%llu", histogram->count,
+          histogram->count ? histogram->sum / histogram->count : 0,
+          latencyPercentile( histogram, 50 ), latencyPercentile( histogram, 90 ),
+          latencyPercentile( histogram, 99 ), histogram->max );
+}
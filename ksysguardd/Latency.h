@@ -0,0 +1,61 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#ifndef KSG_LATENCY_H
+#define KSG_LATENCY_H
+
+/* Bits of precision below the leading bit of a value */
+#define LATENCY_SUB_BITS	3
+
+/* Enough buckets for values up to 2^32 microseconds */
+#define LATENCY_BUCKETS	( ( 32 - LATENCY_SUB_BITS + 1 ) << LATENCY_SUB_BITS )
+
+/**
+  A histogram of durations in microseconds in the manner of HdrHistogram.
+  Every power of two is split into 2^LATENCY_SUB_BITS buckets, so the
+  percentiles are accurate to 1/8 of the value while the histogram has
+  a fixed size and adding a value costs a few instructions. Values
+  above the last bucket are counted in the last one.
+ */
+typedef struct LatencyHistogram {
+  unsigned long long count;
+  unsigned long long sum;
+  unsigned long long max;
+  unsigned int buckets[ LATENCY_BUCKETS ];
+} LatencyHistogram;
+
+/**
+  @return the current time of the monotonic clock in microseconds.
+ */
+unsigned long long monotonicMicros( void );
+
+void addLatency( LatencyHistogram* histogram, unsigned long long micros );
+
+/**
+  @return the smallest value that @ref percentile percent of the values
+  do not exceed, rounded up to the end of its bucket.
+ */
+unsigned long long latencyPercentile( const LatencyHistogram* histogram, double percentile );
+
+/**
+  Prints the count, the mean, the 50th, 90th and 99th percentile and the
+  maximum, each preceded by a tab.
+ */
+void printLatency( const LatencyHistogram* histogram );
+
+#endif
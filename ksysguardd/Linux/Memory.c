@@ -28,6 +28,7 @@
 
 #include "Command.h"
 #include "ksysguardd.h"
+#include "SysRoot.h"
 
 #include "Memory.h"
 
@@ -148,7 +149,7 @@ int updateMemory( void )
   int fd;
   size_t n;
 
-  if ( ( fd = open( "/proc/meminfo", O_RDONLY ) ) < 0 ) {
+  if ( ( fd = sysOpen( "/proc/meminfo", O_RDONLY ) ) < 0 ) {
     print_error( "Cannot open \'/proc/meminfo\'!\n"
                  "The kernel needs to be compiled with support\n"
                  "for /proc file system enabled!\n" );
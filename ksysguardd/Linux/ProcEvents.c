@@ -0,0 +1,207 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#define _DEFAULT_SOURCE /* SOCK_NONBLOCK, SO_RCVBUFFORCE */
+
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+
+#include "Command.h"
+
+#include "ProcEvents.h"
+
+/* The events of the time between two scans have to fit */
+#define RECEIVE_BUFFER	( 4 * 1024 * 1024 )
+
+/* How long to wait for the kernel to acknowledge the subscription, in ms */
+#define ACK_TIMEOUT	250
+
+static int Socket = -1;
+
+/* A datagram of the connector, aligned for the netlink headers */
+static union {
+  struct nlmsghdr header;
+  char bytes[ 64 * 1024 ];
+} Buffer;
+
+/**
+  Sends @ref op to the process connector.
+  @return 0 on success, -1 on failure.
+ */
+static int sendControl( enum proc_cn_mcast_op op )
+{
+  union {
+    struct nlmsghdr header;
+    char bytes[ NLMSG_SPACE( sizeof( struct cn_msg ) + sizeof( enum proc_cn_mcast_op ) ) ];
+  } message;
+  struct cn_msg* cn;
+
+  memset( &message, 0, sizeof( message ) );
+  message.header.nlmsg_len = NLMSG_LENGTH( sizeof( struct cn_msg ) + sizeof( op ) );
+  message.header.nlmsg_type = NLMSG_DONE;
+  message.header.nlmsg_pid = getpid();
+
+  cn = (struct cn_msg*)NLMSG_DATA( &message.header );
+  cn->id.idx = CN_IDX_PROC;
+  cn->id.val = CN_VAL_PROC;
+  cn->len = sizeof( op );
+  memcpy( cn->data, &op, sizeof( op ) );
+
+  return send( Socket, &message, message.header.nlmsg_len, 0 ) < 0 ? -1 : 0;
+}
+
+/**
+  Passes the events in the first @ref length bytes of Buffer to @ref fn.
+  @return 1 if it contains the acknowledgement of the subscription.
+ */
+static int dispatchEvents( ssize_t length, void (*fn)( ProcEventType type, pid_t pid, void* data ), void* data )
+{
+  struct nlmsghdr* header;
+  int acknowledged = 0;
+
+  for ( header = &Buffer.header; NLMSG_OK( header, (size_t)length ); header = NLMSG_NEXT( header, length ) ) {
+    struct cn_msg* cn = (struct cn_msg*)NLMSG_DATA( header );
+    struct proc_event event;
+
+    if ( header->nlmsg_type == NLMSG_ERROR || header->nlmsg_type == NLMSG_NOOP ||
+         header->nlmsg_len < NLMSG_LENGTH( sizeof( struct cn_msg ) ) ||
+         cn->id.idx != CN_IDX_PROC || cn->id.val != CN_VAL_PROC ||
+         cn->len < sizeof( struct proc_event ) ||
+         header->nlmsg_len < NLMSG_LENGTH( sizeof( struct cn_msg ) + sizeof( struct proc_event ) ) )
+      continue;
+
+    /* The event follows the 20 bytes of the cn_msg, which leaves it
+     * misaligned for its 64 bit timestamp */
+    memcpy( &event, cn->data, sizeof( struct proc_event ) );
+
+    switch ( event.what ) {
+      case PROC_EVENT_NONE:
+        acknowledged = event.event_data.ack.err == 0;
+        break;
+      case PROC_EVENT_FORK:
+        if ( fn && event.event_data.fork.child_pid == event.event_data.fork.child_tgid )
+          fn( PROCESS_FORKED, event.event_data.fork.child_tgid, data );
+        break;
+      case PROC_EVENT_EXEC:
+        if ( fn )
+          fn( PROCESS_EXECUTED, event.event_data.exec.process_tgid, data );
+        break;
+      case PROC_EVENT_EXIT:
+        if ( fn && event.event_data.exit.process_pid == event.event_data.exit.process_tgid )
+          fn( PROCESS_EXITED, event.event_data.exit.process_tgid, data );
+        break;
+      default:
+        break;
+    }
+  }
+
+  return acknowledged;
+}
+
+/*
+================================ public part =================================
+*/
+
+int openProcEvents( void )
+{
+  struct sockaddr_nl address;
+  struct pollfd pfd;
+  int size = RECEIVE_BUFFER;
+  ssize_t length;
+
+  if ( ( Socket = socket( PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR ) ) < 0 )
+    return -1;
+
+  /* Only root may go beyond net.core.rmem_max */
+  if ( setsockopt( Socket, SOL_SOCKET, SO_RCVBUFFORCE, &size, sizeof( size ) ) < 0 )
+    setsockopt( Socket, SOL_SOCKET, SO_RCVBUF, &size, sizeof( size ) );
+
+  memset( &address, 0, sizeof( address ) );
+  address.nl_family = AF_NETLINK;
+  address.nl_groups = CN_IDX_PROC;
+  address.nl_pid = 0;
+
+  if ( bind( Socket, (struct sockaddr*)&address, sizeof( address ) ) < 0 ||
+       sendControl( PROC_CN_MCAST_LISTEN ) < 0 ) {
+    closeProcEvents();
+    return -1;
+  }
+
+  /* Without the capability the kernel ignores the request silently, so
+   * it only counts with an acknowledgement */
+  pfd.fd = Socket;
+  pfd.events = POLLIN;
+  while ( poll( &pfd, 1, ACK_TIMEOUT ) > 0 ) {
+    if ( ( length = recv( Socket, &Buffer, sizeof( Buffer ), 0 ) ) < 0 ) {
+      if ( errno == EAGAIN || errno == EINTR || errno == ENOBUFS )
+        continue;
+      break;
+    }
+    if ( dispatchEvents( length, NULL, NULL ) )
+      return 0;
+  }
+
+  closeProcEvents();
+  return -1;
+}
+
+void closeProcEvents( void )
+{
+  if ( Socket < 0 )
+    return;
+
+  sendControl( PROC_CN_MCAST_IGNORE );
+  close( Socket );
+  Socket = -1;
+}
+
+int readProcEvents( void (*fn)( ProcEventType type, pid_t pid, void* data ), void* data )
+{
+  ssize_t length;
+  int result = 0;
+
+  if ( Socket < 0 )
+    return -1;
+
+  for ( ;; ) {
+    if ( ( length = recv( Socket, &Buffer, sizeof( Buffer ), MSG_DONTWAIT ) ) < 0 ) {
+      if ( errno == EINTR )
+        continue;
+      if ( errno == EAGAIN || errno == EWOULDBLOCK )
+        break;
+      if ( errno == ENOBUFS ) {
+        /* The kernel has dropped events, the rest is still queued */
+        result = -1;
+        continue;
+      }
+      log_error( "Cannot read the process events: %s", strerror( errno ) );
+      return -1;
+    }
+
+    dispatchEvents( length, fn, data );
+  }
+
+  return result;
+}
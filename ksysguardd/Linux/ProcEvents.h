@@ -0,0 +1,53 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#ifndef KSG_PROCEVENTS_H
+#define KSG_PROCEVENTS_H
+
+#include <sys/types.h>
+
+/**
+  The fork, exec and exit events of processes from the process
+  connector of the kernel, so that the process list does not have to
+  read /proc to find out which processes have come and gone. Threads
+  are left out, the pids are those of thread group leaders.
+ */
+typedef enum {
+  PROCESS_FORKED,
+  PROCESS_EXECUTED,
+  PROCESS_EXITED
+} ProcEventType;
+
+/**
+  Subscribes to the events. This needs CAP_NET_ADMIN in the initial
+  network namespace.
+  @return 0 on success, -1 if the connector cannot be used.
+ */
+int openProcEvents( void );
+
+void closeProcEvents( void );
+
+/**
+  Calls @ref fn with @ref data for the events that have arrived since
+  the last call, in order, without blocking.
+  @return 0 if all events have been passed on, -1 if some were lost,
+  e.g. because the receive buffer ran full. The rest is read anyway.
+ */
+int readProcEvents( void (*fn)( ProcEventType type, pid_t pid, void* data ), void* data );
+
+#endif
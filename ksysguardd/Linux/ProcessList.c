@@ -21,10 +21,12 @@
 #define _BSD_SOURCE /* kill, syscall */
 #define _DEFAULT_SOURCE /* Eliminate warning from prev */
 
-#include <ctype.h>
-#include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
 #include <signal.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -40,14 +42,19 @@
 
 #include "../../gui/SignalIDs.h"
 #include "Command.h"
+#include "Latency.h"
 #include "PWUIDCache.h"
 #include "ccont.h"
+#include "conf.h"
+#include "htbl.h"
 #include "ksysguardd.h"
+#include "SysRoot.h"
+#include "TableDelta.h"
 
+#include "ProcEvents.h"
 #include "ProcessList.h"
 
-#define BUFSIZE 1024
-#define TAGSIZE 32
+#define LINESIZE 2048
 #define KDEINITLEN sizeof( "kdeinit: " )
 
 /* For ionice */
@@ -199,13 +206,234 @@ typedef struct {
   /** Mandatory Access Control (SELinux or AppArmor) context */
   char macContext[ 256 ];
 
+  /** The tty_nr field of stat that tty is decoded from */
+  long ttyNo;
+
+  /** The time the process started after boot in clock ticks */
+  unsigned long startTime;
+
+  /** The CPU usage in percent of one CPU since an earlier scan, see
+      measureCPUUsage() */
+  double cpuUsage;
+
 } ProcessInfo;
 
+/**
+  The attributes of a process that seldom change during its life, so
+  that a scan only needs to read them for new processes. A pid is only
+  reused with a different start time. The strings are 0 until read.
+ */
+typedef struct {
+  /** The key of the entry in ProcessCache */
+  pid_t pid;
+
+  unsigned long startTime;
+
+  /** The name from stat. When it changes, the process has most likely
+      called exec() and everything is read again. */
+  char comm[ 64 ];
+
+  /** The COLUMN() bits of the attributes below that are valid */
+  unsigned long columns;
+
+  /** The number of the last scan that has seen the process */
+  unsigned long seen;
+
+  /** The CPU time of the process at the scan the usage is measured
+      from, the time of that scan and the usage it has measured */
+  unsigned long cpuTicks;
+  unsigned long long cpuSince;
+  double cpuUsage;
+
+  /** The uid that userName has been looked up for */
+  uid_t uid;
+  char userName[ 32 ];
+  long ttyNo;
+  char tty[ 10 ];
+  char* name;
+  char* cmdline;
+  char* cGroup;
+  char* macContext;
+} CachedProcess;
+
 void getIOnice( int pid, ProcessInfo *ps );
 void ioniceProcess( const char* cmd );
 
-static unsigned ProcessCount;
-static DIR* procDir;
+/* The threads of a scan take this many processes at a time */
+#define SCAN_BLOCK	256
+#define MAX_SCAN_THREADS	16
+
+/* 'pscount' answers from the last scan if it is not older than this, in
+ * microseconds */
+#define PSCOUNT_MAX_AGE	1000000ULL
+
+/* The CPU usage is measured over at least this many microseconds, a
+ * scan that follows sooner reports the last measurement again */
+#define CPU_MIN_INTERVAL	500000ULL
+
+/* What 'ps' has been asked for, see parseOption() */
+typedef struct {
+  /* The COLUMN() bits of the cells that are printed */
+  unsigned long columns;
+  /* The columns that the filters and the sort key need on top */
+  unsigned long extra;
+  /* The column the rows are sorted by, largest first, SORT_CPU or -1
+   * for the order of /proc */
+  int sortColumn;
+  /* The number of rows to print, 0 for all */
+  unsigned int limit;
+  /* The filters, -1 and 0 if unused */
+  long uid;
+  const char* cGroup;
+  const char* name;
+} ProcessQuery;
+
+/* The rows of a block of processes, each a sort key and the text ended
+ * by a zero */
+typedef struct {
+  char* text;
+  size_t length;
+  size_t size;
+} ScanBlock;
+
+typedef struct {
+  const ProcessQuery* query;
+  unsigned int blocks;
+  atomic_uint nextBlock;
+} ScanJob;
+
+/* The rows of a 'ps' that is sorted or limited. With a limit they are
+ * a heap with the row that ranks last on top. */
+typedef struct {
+  double key;
+  /* The position in the scan, the earlier row wins a tie */
+  unsigned int order;
+  char* row;
+} RankedRow;
+
+typedef struct {
+  RankedRow* rows;
+  unsigned int count;
+  unsigned int size;
+  unsigned int limit;
+  unsigned int order;
+} Ranking;
+
+/* The pids of the last scan and their number. These and the
+ * rest of the scan state are guarded by ScanLock. */
+static pid_t* Pids;
+static unsigned int PidsSize;
+static unsigned int ProcessCount;
+static unsigned long long ListTime;
+static unsigned long long ScanTime;
+
+static ScanBlock* Blocks;
+static unsigned int BlocksSize;
+
+/* With the process connector the running processes are kept between
+ * scans as a bit per pid. Processes that have exited but are still in
+ * /proc, mostly zombies, are lingering until they are gone. */
+#define LONG_BITS	( 8 * sizeof( unsigned long ) )
+#define MAX_LINGERING	4096
+/* /proc is read again after this many scans anyway */
+#define RESYNC_SCANS	300
+
+static int Tracking;
+static int TableValid;
+static unsigned long* LivePids;
+static unsigned int LivePidsSize;
+static pid_t* Lingering;
+static unsigned int LingeringCount;
+static unsigned int LingeringSize;
+static unsigned int ScansSinceList;
+
+/* The descriptor of /proc, the files of a process are opened relative to it */
+static int ProcFD = -1;
+static char DentsBuffer[ 128 * 1024 ];
+static unsigned long PageSizeKiB;
+static long ClockTicks;
+
+/* The contents of the file that is being parsed, one per scan thread */
+static _Thread_local char FileBuffer[ 8192 ];
+
+/* Maps the pid to its CachedProcess. The threads of a scan only touch
+ * the entries of their own processes, the table is guarded by CacheLock. */
+static HTBL ProcessCache = 0;
+static pthread_mutex_t CacheLock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned long ScanNumber;
+
+/* The scans of /proc take turns. When the module is sampled in the
+ * background only the collector thread scans, see Sample. */
+static pthread_mutex_t ScanLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* The rows of the last 'ps' without arguments with their CPU usage as
+ * the key. When the module is sampled in the background, 'ps' with
+ * arguments is answered from them instead of scanning /proc on the main
+ * loop. Sample is guarded by SampleLock, SpareSample is the buffer of
+ * the sample before and only touched with ScanLock held. */
+static ScanBlock Sample;
+static ScanBlock SpareSample;
+static bool SampleTaken;
+static pthread_mutex_t SampleLock = PTHREAD_MUTEX_INITIALIZER;
+static struct SensorModul* ProcessListSM;
+
+/* The key of the TableDelta of a client, see printProcessDelta() */
+static const char DeltaKey = 0;
+
+/* The columns of the ps table in the order of printProcessListInfo() */
+enum {
+  COLUMN_NAME, COLUMN_PID, COLUMN_PPID, COLUMN_UID, COLUMN_GID, COLUMN_STATUS,
+  COLUMN_USERTIME, COLUMN_SYSTIME, COLUMN_NICE, COLUMN_VMSIZE, COLUMN_VMRSS,
+  COLUMN_VMURSS, COLUMN_LOGIN, COLUMN_TRACERPID, COLUMN_TTY, COLUMN_COMMAND,
+  COLUMN_IOCLASS, COLUMN_IOPRIO, COLUMN_NNP, COLUMN_CGROUP, COLUMN_MAC,
+  PS_COLUMNS
+};
+
+/* The names of the columns for 'ps cols=...' */
+static const char* const ColumnNames[ PS_COLUMNS ] = {
+  "name", "pid", "ppid", "uid", "gid", "status",
+  "utime", "stime", "nice", "vmsize", "rss",
+  "urss", "login", "tracerpid", "tty", "cmdline",
+  "ioclass", "ioprio", "nnp", "cgroup", "mac"
+};
+
+#define COLUMN( c )	( 1UL << COLUMN_##c )
+#define ALL_COLUMNS	( ( 1UL << PS_COLUMNS ) - 1 )
+
+/* 'ps sort=' takes the numeric columns and the CPU usage, which is not
+ * a column of its own */
+#define SORT_CPU	PS_COLUMNS
+#define SORT_COLUMNS	( COLUMN( PID ) | COLUMN( PPID ) | COLUMN( UID ) | COLUMN( GID ) | \
+                          COLUMN( USERTIME ) | COLUMN( SYSTIME ) | COLUMN( NICE ) | COLUMN( VMSIZE ) | \
+                          COLUMN( VMRSS ) | COLUMN( VMURSS ) | COLUMN( TRACERPID ) | COLUMN( IOCLASS ) | \
+                          COLUMN( IOPRIO ) | COLUMN( NNP ) )
+
+/* The columns that need a file or syscall, everything else is skipped.
+ * Login needs the uid from status. */
+#define STATUS_COLUMNS	( COLUMN( UID ) | COLUMN( GID ) | COLUMN( LOGIN ) | COLUMN( TRACERPID ) | \
+                          COLUMN( NNP ) )
+#define STAT_COLUMNS	( COLUMN( NAME ) | COLUMN( PPID ) | COLUMN( STATUS ) | COLUMN( USERTIME ) | \
+                          COLUMN( SYSTIME ) | COLUMN( NICE ) | COLUMN( VMSIZE ) | COLUMN( VMRSS ) | \
+                          COLUMN( VMURSS ) | COLUMN( TTY ) )
+#define CMDLINE_COLUMNS	( COLUMN( NAME ) | COLUMN( COMMAND ) )
+#define IONICE_COLUMNS	( COLUMN( IOCLASS ) | COLUMN( IOPRIO ) )
+
+/* The columns that are kept in the ProcessCache. status is read on every
+ * scan, since the ids change with setuid() and the tracer with ptrace(),
+ * and the login is only looked up again when the uid changes. */
+#define CACHED_COLUMNS	( COLUMN( LOGIN ) | CMDLINE_COLUMNS | COLUMN( TTY ) | COLUMN( CGROUP ) | \
+                          COLUMN( MAC ) )
+
+/* setproctitle() and moving to another cgroup do not show up in stat,
+ * so every entry is read again after this many scans. The pid staggers
+ * the entries across the scans. */
+#define CACHE_REFRESH	32
+
+/* The PID is the key and Name, Status, Login, TTY, CGroup and MAC
+ * Context repeat a lot, so they are sent as dictionary numbers */
+#define DELTA_KEY	COLUMN_PID
+#define DELTA_DICTIONARY	( COLUMN( NAME ) | COLUMN( STATUS ) | COLUMN( LOGIN ) | COLUMN( TTY ) | \
+                          COLUMN( CGROUP ) | COLUMN( MAC ) )
 static void validateStr( char* str )
 {
   char* s = str;
@@ -222,69 +450,141 @@ static void validateStr( char* str )
     strcpy( str, " " );
 }
 
-static bool getProcess( int pid, ProcessInfo *ps )
+/**
+  Reads /proc/<pid>/<file> with a single read() into @ref buf and
+  terminates it. Files longer than @ref size - 1 bytes are cut off.
+  @return the length or -1 if the file cannot be read, e.g. because the
+  process has terminated in the mean time.
+ */
+static ssize_t readProcFile( int pid, const char* file, char* buf, size_t size )
 {
-  FILE* fd;
-  char buf[ BUFSIZE ];
-  char tag[ TAGSIZE ];
-  char format[ 32 ];
-  char tagformat[ 32 ];
-  const char* uName;
-  char status;
+  char path[ 32 ];
+  ssize_t length;
+  int fd;
+
+  snprintf( path, sizeof( path ), "%d/%s", pid, file );
+  if ( ( fd = openat( ProcFD, path, O_RDONLY | O_CLOEXEC ) ) < 0 )
+    return -1;
+
+  do
+    length = read( fd, buf, size - 1 );
+  while ( length < 0 && errno == EINTR );
+  close( fd );
+
+  if ( length < 0 )
+    return -1;
+
+  buf[ length ] = '\0';
+  return length;
+}
+
+/*
+ * The field parsers take and return the position in a /proc file. They
+ * return 0 if the field is missing and pass 0 on, so a whole line can
+ * be parsed before the result is checked.
+ */
+static const char* skipBlanks( const char* p )
+{
+  while ( *p == ' ' || *p == '\t' )
+    ++p;
+  return p;
+}
+
+static const char* skipFields( const char* p, int count )
+{
+  while ( p && count-- > 0 ) {
+    p = skipBlanks( p );
+    if ( *p == '\0' || *p == '\n' )
+      return NULL;
+    while ( *p && *p != ' ' && *p != '\t' && *p != '\n' )
+      ++p;
+  }
+  return p;
+}
+
+static const char* parseULong( const char* p, unsigned long* value )
+{
+  unsigned long v = 0;
+
+  if ( p == NULL )
+    return NULL;
+
+  p = skipBlanks( p );
+  if ( *p < '0' || *p > '9' )
+    return NULL;
+  while ( *p >= '0' && *p <= '9' )
+    v = v * 10 + ( *p++ - '0' );
+
+  *value = v;
+  return p;
+}
+
+static const char* parseLong( const char* p, long* value )
+{
+  unsigned long v;
+  int negative;
+
+  if ( p == NULL )
+    return NULL;
+
+  p = skipBlanks( p );
+  if ( ( negative = *p == '-' ) )
+    ++p;
+  if ( ( p = parseULong( p, &v ) ) != NULL )
+    *value = negative ? -(long)v : (long)v;
+  return p;
+}
+
+/**
+  @return the position after "<tag>:" if @ref line starts with it.
+ */
+static const char* statusField( const char* line, const char* tag, size_t length )
+{
+  return strncmp( line, tag, length ) == 0 && line[ length ] == ':' ? line + length + 1 : NULL;
+}
+
+#define STATUS_FIELD( line, tag )	statusField( line, tag, sizeof( tag ) - 1 )
 
-  snprintf( buf, BUFSIZE - 1, "/proc/%d/status", pid );
-  if ( ( fd = fopen( buf, "r" ) ) == 0 ) {
+/**
+  Reads the user and group IDs, the tracer and the no new privileges
+  flag from /proc/<pid>/status.
+ */
+static bool readStatus( int pid, ProcessInfo *ps )
+{
+  const char* line;
+  const char* p;
+  unsigned long value;
+  long tracer;
+
+  if ( readProcFile( pid, "status", FileBuffer, sizeof( FileBuffer ) ) < 0 ) {
     /* process has terminated in the mean time */
     return false;
   }
-  ps->uid = 0;
-  ps->gid = 0;
-  ps->tracerpid = -1;
-  
-  sprintf( format, "%%%d[^\n]\n", (int)sizeof( buf ) - 1 );
-  sprintf( tagformat, "%%%ds", (int)sizeof( tag ) - 1 );
-  for ( ;; ) {
-    if ( fscanf( fd, format, buf ) != 1 )
-      break;
-    buf[ sizeof( buf ) - 1 ] = '\0';
-    sscanf( buf, tagformat, tag );
-    tag[ sizeof( tag ) - 1 ] = '\0';
-    if ( strcmp( tag, "Name:" ) == 0 ) {
-      sscanf( buf, "%*s %63s", ps->name );
-      validateStr( ps->name );
-    } else if ( strcmp( tag, "Uid:" ) == 0 ) {
-      sscanf( buf, "%*s %d %*d %*d %*d", (int*)&ps->uid );
-    } else if ( strcmp( tag, "Gid:" ) == 0 ) {
-      sscanf( buf, "%*s %d %*d %*d %*d", (int*)&ps->gid );
-    } else if ( strcmp( tag, "TracerPid:" ) == 0 ) {
-      sscanf( buf, "%*s %d", (int*)&ps->tracerpid );
-      if (ps->tracerpid == 0)
-          ps->tracerpid = -1; /* ksysguard uses -1 to indicate no tracerpid, but linux uses 0 */
-    } else if ( strcmp( tag, "NoNewPrivs:" ) == 0 ) {
-      sscanf( buf, "%*s %d", &ps->noNewPrivileges );
+
+  for ( line = FileBuffer; line; line = ( line = strchr( line, '\n' ) ) ? line + 1 : NULL ) {
+    if ( ( p = STATUS_FIELD( line, "Uid" ) ) != NULL ) {
+      if ( parseULong( p, &value ) )
+        ps->uid = value;
+    } else if ( ( p = STATUS_FIELD( line, "Gid" ) ) != NULL ) {
+      if ( parseULong( p, &value ) )
+        ps->gid = value;
+    } else if ( ( p = STATUS_FIELD( line, "TracerPid" ) ) != NULL ) {
+      if ( parseLong( p, &tracer ) )
+        /* ksysguard uses -1 to indicate no tracerpid, but linux uses 0 */
+        ps->tracerpid = tracer == 0 ? -1 : tracer;
+    } else if ( ( p = STATUS_FIELD( line, "NoNewPrivs" ) ) != NULL ) {
+      if ( parseULong( p, &value ) )
+        ps->noNewPrivileges = value;
     }
   }
 
-  if ( fclose( fd ) )
-    return false;
+  return true;
+}
 
-  snprintf( buf, BUFSIZE - 1, "/proc/%d/stat", pid );
-  buf[ BUFSIZE - 1 ] = '\0';
-  if ( ( fd = fopen( buf, "r" ) ) == 0 )
-    return false;
-  int ttyNo;
-  if ( fscanf( fd, "%*d %*s %c %d %*d %*d %d %*d %*u %*u %*u %*u %*u %lu %lu"
-                   "%*d %*d %*d %d %*u %*u %*d %lu %lu",
-                   &status, (int*)&ps->ppid, &ttyNo,
-                   &ps->userTime, &ps->sysTime, &ps->niceLevel, &ps->vmSize,
-                   &ps->vmRss) != 8 ) {
-    fclose( fd );
-    return false;
-  }
-  if (ps->ppid == 0) /* ksysguard uses -1 to indicate no parent, but linux uses 0 */
-      ps->ppid = -1;
-  int major = ttyNo >> 8;
-  int minor = ttyNo & 0xff;
+static void decodeTTY( ProcessInfo *ps )
+{
+  int major = ps->ttyNo >> 8;
+  int minor = ps->ttyNo & 0xff;
   switch(major) {
     case 136:
       snprintf(ps->tty, sizeof(ps->tty)-1, "pts/%d", minor);
@@ -298,6 +598,60 @@ static bool getProcess( int pid, ProcessInfo *ps )
     default:
       ps->tty[0] = 0;
   }
+}
+
+/**
+  Reads the name, the status, the parent, the tty number, the times, the
+  nice level, the start time and the memory sizes from /proc/<pid>/stat. The unique RSS is
+  only read from /proc/<pid>/statm if @ref withURss is set.
+ */
+static bool readStat( int pid, ProcessInfo *ps, bool withURss )
+{
+  const char* comm;
+  const char* p;
+  size_t length;
+  long ppid, ttyNo, nice;
+  unsigned long shared;
+  char status;
+
+  if ( readProcFile( pid, "stat", FileBuffer, sizeof( FileBuffer ) ) < 0 )
+    return false;
+
+  /* The name may contain blanks and parentheses itself, so it ends at
+   * the last closing parenthesis */
+  if ( ( comm = strchr( FileBuffer, '(' ) ) == NULL || ( p = strrchr( comm, ')' ) ) == NULL )
+    return false;
+
+  length = p - ++comm;
+  if ( length > sizeof( ps->name ) - 1 )
+    length = sizeof( ps->name ) - 1;
+  memcpy( ps->name, comm, length );
+  ps->name[ length ] = '\0';
+  validateStr( ps->name );
+
+  p = skipBlanks( p + 1 );
+  if ( ( status = *p ) == '\0' )
+    return false;
+
+  /* state ppid pgrp session tty_nr tpgid flags minflt cminflt majflt
+   * cmajflt utime stime cutime cstime priority nice num_threads
+   * itrealvalue starttime vsize rss */
+  p = parseLong( p + 1, &ppid );
+  p = parseLong( skipFields( p, 2 ), &ttyNo );
+  p = parseULong( skipFields( p, 6 ), &ps->userTime );
+  p = parseULong( p, &ps->sysTime );
+  p = parseLong( skipFields( p, 3 ), &nice );
+  p = parseULong( skipFields( p, 2 ), &ps->startTime );
+  p = parseULong( p, &ps->vmSize );
+  p = parseULong( p, &ps->vmRss );
+  if ( p == NULL )
+    return false;
+
+  ps->ppid = ppid;
+  ps->niceLevel = nice;
+  ps->ttyNo = ttyNo;
+  if (ps->ppid == 0) /* ksysguard uses -1 to indicate no parent, but linux uses 0 */
+      ps->ppid = -1;
 
   /*There was a "(ps->vmRss+3) * sysconf(_SC_PAGESIZE)" here originally.  I have no idea why!  After comparing it to
   meminfo and other tools, this means we report the RSS by 12 bytes different compared to them.  So I'm removing the +3
@@ -305,26 +659,16 @@ static bool getProcess( int pid, ProcessInfo *ps )
   
     Update: I think I now know why.  The kernel reserves 3kb for process information.
   */
-  ps->vmRss = ps->vmRss * sysconf(_SC_PAGESIZE) / 1024; /*convert to KiB*/
+  ps->vmRss = ps->vmRss * PageSizeKiB; /*convert to KiB*/
   ps->vmSize /= 1024; /* convert to KiB */
 
-  if ( fclose( fd ) )
-    return false;
-
-  snprintf( buf, BUFSIZE - 1, "/proc/%d/statm", pid );
-  buf[ BUFSIZE - 1 ] = '\0';
   ps->vmURss = -1;
-  if ( ( fd = fopen( buf, "r" ) ) != 0 )  {
-    unsigned long shared;
-    if ( fscanf( fd, "%*d %*u %lu",
-                   &shared)==1) {
-      /* we use the rss - shared  to find the amount of memory just this app uses */
-      ps->vmURss = ps->vmRss - (shared * sysconf(_SC_PAGESIZE) / 1024);
-    }
-    fclose( fd );
+  if ( withURss && readProcFile( pid, "statm", FileBuffer, sizeof( FileBuffer ) ) >= 0 &&
+       parseULong( skipFields( FileBuffer, 2 ), &shared ) ) {
+    /* we use the rss - shared  to find the amount of memory just this app uses */
+    ps->vmURss = ps->vmRss - shared * PageSizeKiB;
   }
 
-
   /* status decoding as taken from fs/proc/array.c */
   if ( status == 'R' )
     strcpy( ps->status, "running" );
@@ -341,20 +685,26 @@ static bool getProcess( int pid, ProcessInfo *ps )
   else
     sprintf( ps->status, "Unknown: %c", status );
 
+  return true;
+}
 
-  snprintf( buf, BUFSIZE - 1, "/proc/%d/cmdline", pid );
-  if ( ( fd = fopen( buf, "r" ) ) == 0 )
-    return false;
+/**
+  Reads the command line from /proc/<pid>/cmdline and takes the name
+  from its first argument.
+ */
+static bool readCmdline( int pid, ProcessInfo *ps )
+{
+  ssize_t length;
 
-  ps->cmdline[ 0 ] = '\0';
+  /* At most sizeof(cmdline) - 3 bytes, the rest is cut off */
+  if ( ( length = readProcFile( pid, "cmdline", ps->cmdline, sizeof( ps->cmdline ) - 2 ) ) < 0 )
+    return false;
 
   unsigned int processNameStartPosition = 0;
   unsigned int firstZeroPosition = -1U;
  
-  unsigned int i =0;
-  int c = EOF;
-  while( (c = fgetc(fd)) != EOF && i < sizeof(ps->cmdline)-3) {
-    ps->cmdline[i] = (char)c;
+  unsigned int i;
+  for( i = 0; i < (unsigned int)length; i++ ) {
     if(ps->cmdline[i] == '\0')
     {
       ps->cmdline[i] = ' ';
@@ -363,12 +713,13 @@ static bool getProcess( int pid, ProcessInfo *ps )
     }
     if(ps->cmdline[i] == '/' && firstZeroPosition == -1U)
       processNameStartPosition = i + 1;
-    i++;
   }
 
   if(firstZeroPosition != -1U)
   {
     unsigned int processNameLength = firstZeroPosition - processNameStartPosition;
+    if ( processNameLength > sizeof( ps->name ) - 1 )
+      processNameLength = sizeof( ps->name ) - 1;
     memcpy(ps->name, ps->cmdline + processNameStartPosition, processNameLength);
     ps->name[processNameLength] = '\0';
   }
@@ -381,8 +732,6 @@ static bool getProcess( int pid, ProcessInfo *ps )
   }
 
   validateStr( ps->cmdline );
-  if ( fclose( fd ) )
-    return false;
 
   /* Ugly hack to "fix" program name for kdeinit launched programs. */
   if ( strcmp( ps->name, "kdeinit" ) == 0 &&
@@ -401,68 +750,1210 @@ static bool getProcess( int pid, ProcessInfo *ps )
       ps->name[ len ] = '\0';
     }
   }
-  /* find out user name with the process uid */
-  uName = getCachedPWUID( ps->uid );
-  strncpy( ps->userName, uName, sizeof( ps->userName ) - 1 );
-  ps->userName[ sizeof( ps->userName ) - 1 ] = '\0';
-  validateStr( ps->userName );
 
-  getIOnice(pid, ps);
+  return true;
+}
+
+/**
+  Copies the first line of @ref text into @ref buf, with the newline
+  like fgets() but at most @ref size - 1 characters, and makes it
+  printable.
+ */
+static void copyLine( char* buf, size_t size, const char* text )
+{
+  const char* end = strchr( text, '\n' );
+  size_t length = end ? (size_t)( end - text ) + 1 : strlen( text );
+
+  if ( length > size - 1 )
+    length = size - 1;
+  memcpy( buf, text, length );
+  buf[ length ] = '\0';
+  validateStr( buf );
+}
+
+/* The path of the unified hierarchy, the line that starts with "0::" */
+static void readCGroup( int pid, ProcessInfo *ps )
+{
+  const char* line;
 
-  /* CGroups */
   ps->cGroup[ 0 ] = '\0';
-  snprintf( buf, BUFSIZE - 1, "/proc/%d/cgroup", pid );
-  buf[ BUFSIZE - 1 ] = '\0';
-  if ( ( fd = fopen( buf, "r" ) ) != 0 )  {
-    do {
-         fgets( buf, BUFSIZE, fd );
-    } while ( !feof( fd ) && buf[0] != '0' );
-    fclose ( fd );
-
-    if ( buf[0] == '0' && buf[1] == ':' && buf[2] == ':' ) {
-      strncpy( ps->cGroup, &buf[3], sizeof( ps->cGroup ) - 1 );
-      ps->cGroup[ sizeof( ps->cGroup ) - 1 ] = '\0';
-      validateStr( ps->cGroup );
+  if ( readProcFile( pid, "cgroup", FileBuffer, sizeof( FileBuffer ) ) < 0 )
+    return;
+
+  for ( line = FileBuffer; line; line = ( line = strchr( line, '\n' ) ) ? line + 1 : NULL ) {
+    if ( strncmp( line, "0::", 3 ) == 0 ) {
+      copyLine( ps->cGroup, sizeof( ps->cGroup ), line + 3 );
+      break;
     }
   }
+}
 
-  /* Mandatory Access Control (SELinux or AppArmor) context */
+/* Mandatory Access Control (SELinux or AppArmor) context */
+static void readMACContext( int pid, ProcessInfo *ps )
+{
   ps->macContext[ 0 ] = '\0';
-  snprintf( buf, BUFSIZE - 1, "/proc/%d/attr/current", pid );
-  if ( ( fd = fopen( buf, "r" ) ) != 0 )  {
-    if (fgets( ps->macContext, sizeof( ps->macContext ), fd ))
-      validateStr( ps->macContext );
-    fclose ( fd );
+  if ( readProcFile( pid, "attr/current", FileBuffer, sizeof( FileBuffer ) ) > 0 )
+    copyLine( ps->macContext, sizeof( ps->macContext ), FileBuffer );
+}
+
+static void freeCachedProcess( void* data )
+{
+  CachedProcess* cached = (CachedProcess*)data;
+
+  if ( cached ) {
+    free( cached->name );
+    free( cached->cmdline );
+    free( cached->cGroup );
+    free( cached->macContext );
+  }
+  free( cached );
+}
+
+/**
+  Replaces the string @ref string points to by a copy of @ref text.
+  @return 0 on success, -1 if there is no memory.
+ */
+static int setString( char** string, const char* text )
+{
+  char* copy = strdup( text );
+
+  if ( copy == NULL )
+    return -1;
+  free( *string );
+  *string = copy;
+  return 0;
+}
+
+/**
+  @return the cache entry of the process that @ref ps has just been read
+  from stat for, or 0 if there is no memory. A new entry or one that
+  has to be read again has no valid columns.
+ */
+static CachedProcess* cachedProcess( pid_t pid, const ProcessInfo *ps )
+{
+  CachedProcess* cached;
+
+  if ( ProcessCache == NULL )
+    return NULL;
+
+  pthread_mutex_lock( &CacheLock );
+  if ( ( cached = get_htbl( ProcessCache, &pid, sizeof( pid_t ) ) ) == NULL &&
+       ( cached = (CachedProcess*)calloc( 1, sizeof( CachedProcess ) ) ) != NULL ) {
+    cached->pid = pid;
+    cached->startTime = ps->startTime;
+    if ( put_htbl( ProcessCache, &cached->pid, sizeof( pid_t ), cached ) < 0 ) {
+      freeCachedProcess( cached );
+      cached = NULL;
+    }
+  }
+  pthread_mutex_unlock( &CacheLock );
+
+  if ( cached == NULL )
+    return NULL;
+
+  if ( cached->startTime != ps->startTime ) {
+    /* The pid belongs to a new process */
+    cached->startTime = ps->startTime;
+    cached->columns = 0;
+    cached->cpuSince = 0;
+  } else if ( strcmp( cached->comm, ps->name ) != 0 ||
+              ( ScanNumber + pid ) % CACHE_REFRESH == 0 ) {
+    cached->columns = 0;
+  }
+
+  strcpy( cached->comm, ps->name );
+  cached->seen = ScanNumber;
+  return cached;
+}
+
+/**
+  Sets the CPU usage of @ref ps from the CPU time it has used since the
+  scan that @ref cached has last measured at. Clients that ask at
+  different rates share the measurement, a scan less than
+  CPU_MIN_INTERVAL later gets the last usage again.
+ */
+static void measureCPUUsage( CachedProcess* cached, ProcessInfo *ps )
+{
+  unsigned long ticks = ps->userTime + ps->sysTime;
+  unsigned long long elapsed = ScanTime - cached->cpuSince;
+
+  if ( cached->cpuSince == 0 || ticks < cached->cpuTicks ) {
+    cached->cpuUsage = 0;
+  } else if ( elapsed >= CPU_MIN_INTERVAL ) {
+    cached->cpuUsage = ( ticks - cached->cpuTicks ) * 100.0 * 1000000 / ( (double)ClockTicks * elapsed );
+  } else {
+    ps->cpuUsage = cached->cpuUsage;
+    return;
+  }
+
+  cached->cpuTicks = ticks;
+  cached->cpuSince = ScanTime;
+  ps->cpuUsage = cached->cpuUsage;
+}
+
+/**
+  Keeps the attributes of @ref columns that have just been read.
+  @return the columns that could be kept.
+ */
+static unsigned long storeAttributes( CachedProcess* cached, const ProcessInfo *ps, unsigned long columns )
+{
+  if ( columns & COLUMN( LOGIN ) ) {
+    cached->uid = ps->uid;
+    strcpy( cached->userName, ps->userName );
+  }
+  if ( columns & COLUMN( TTY ) ) {
+    cached->ttyNo = ps->ttyNo;
+    strcpy( cached->tty, ps->tty );
+  }
+  if ( ( columns & CMDLINE_COLUMNS ) &&
+       ( setString( &cached->name, ps->name ) < 0 || setString( &cached->cmdline, ps->cmdline ) < 0 ) )
+    columns &= ~CMDLINE_COLUMNS;
+  if ( ( columns & COLUMN( CGROUP ) ) && setString( &cached->cGroup, ps->cGroup ) < 0 )
+    columns &= ~COLUMN( CGROUP );
+  if ( ( columns & COLUMN( MAC ) ) && setString( &cached->macContext, ps->macContext ) < 0 )
+    columns &= ~COLUMN( MAC );
+
+  return columns;
+}
+
+static void loadAttributes( const CachedProcess* cached, ProcessInfo *ps, unsigned long columns )
+{
+  if ( columns & COLUMN( LOGIN ) )
+    strcpy( ps->userName, cached->userName );
+  if ( columns & COLUMN( TTY ) )
+    strcpy( ps->tty, cached->tty );
+  if ( columns & CMDLINE_COLUMNS ) {
+    strcpy( ps->name, cached->name );
+    strcpy( ps->cmdline, cached->cmdline );
+  }
+  if ( columns & COLUMN( CGROUP ) )
+    strcpy( ps->cGroup, cached->cGroup );
+  if ( columns & COLUMN( MAC ) )
+    strcpy( ps->macContext, cached->macContext );
+}
+
+/**
+  Removes the processes that the last scan has not seen.
+ */
+static void evictProcesses( void )
+{
+  CachedProcess* cached;
+  INDEX pos = 0;
+
+  /* Removing leaves a tombstone, so the iteration is not disturbed */
+  while ( ProcessCache && ( cached = iter_htbl( ProcessCache, &pos ) ) != NULL ) {
+    if ( cached->seen != ScanNumber )
+      freeCachedProcess( remove_htbl( ProcessCache, &cached->pid, sizeof( pid_t ) ) );
+  }
+}
+
+/**
+  Fills in the fields of @ref ps that are needed for @ref columns, a
+  set of COLUMN() bits. The files and syscalls of the other columns are
+  skipped, and so are those of the attributes in the ProcessCache.
+  @return false if the process has terminated in the mean time.
+ */
+static bool getProcess( int pid, ProcessInfo *ps, unsigned long columns )
+{
+  CachedProcess* cached = NULL;
+  unsigned long missing = columns & CACHED_COLUMNS;
+  unsigned long read = 0;
+  bool loginPending = false;
+
+  ps->uid = 0;
+  ps->gid = 0;
+  ps->tracerpid = -1;
+  ps->cpuUsage = 0;
+
+  /* stat has the start time that tells whether the entry is still valid */
+  if ( columns & ( STAT_COLUMNS | CACHED_COLUMNS ) ) {
+    if ( !readStat( pid, ps, ( columns & COLUMN( VMURSS ) ) != 0 ) )
+      return false;
+    if ( ( cached = cachedProcess( pid, ps ) ) != NULL ) {
+      measureCPUUsage( cached, ps );
+      missing &= ~cached->columns;
+      /* The tty changes with setsid() and TIOCSCTTY */
+      if ( cached->ttyNo != ps->ttyNo )
+        missing |= columns & COLUMN( TTY );
+    }
+  }
+
+  if ( columns & STATUS_COLUMNS ) {
+    if ( !readStatus( pid, ps ) )
+      return false;
+    /* The login belongs to the uid it has been looked up for */
+    if ( cached && cached->uid != ps->uid )
+      missing |= columns & COLUMN( LOGIN );
+  }
+
+  if ( missing & CMDLINE_COLUMNS ) {
+    if ( !readCmdline( pid, ps ) )
+      return false;
+    read |= CMDLINE_COLUMNS;
+  }
+
+  if ( missing & COLUMN( LOGIN ) ) {
+    /* find out user name with the process uid */
+    loginPending = getCachedPWUID( ps->uid, ps->userName, sizeof( ps->userName ) ) < 0;
+    validateStr( ps->userName );
+    read |= COLUMN( LOGIN );
+  }
+
+  if ( missing & COLUMN( TTY ) ) {
+    decodeTTY( ps );
+    read |= COLUMN( TTY );
+  }
+
+  if ( missing & COLUMN( CGROUP ) ) {
+    readCGroup( pid, ps );
+    read |= COLUMN( CGROUP );
+  }
+
+  if ( missing & COLUMN( MAC ) ) {
+    readMACContext( pid, ps );
+    read |= COLUMN( MAC );
+  }
+
+  if ( columns & IONICE_COLUMNS )
+    getIOnice(pid, ps);
+
+  if ( cached ) {
+    cached->columns |= storeAttributes( cached, ps, read );
+    /* The numeric uid until then, the next scan asks again */
+    if ( loginPending )
+      cached->columns &= ~COLUMN( LOGIN );
+    loadAttributes( cached, ps, columns & CACHED_COLUMNS & ~read );
   }
 
   return true;
 }
 
-void printProcessList( const char* cmd)
+/**
+  Appends the cell of @ref column to the row of @ref length characters.
+  @return the new length.
+ */
+static size_t printColumn( char* row, size_t length, int column, long pid, const ProcessInfo* ps )
 {
-  (void)cmd;
-  struct dirent* entry;
+  /* Because of a stupid bug in kde3 ksysguard, make sure cmdline and tty are not empty */
+  char* cell = row + length;
+  size_t size = LINESIZE - length;
+  int n = 0;
+
+  switch ( column ) {
+    case COLUMN_NAME: n = snprintf( cell, size, "%s", ps->name ); break;
+    case COLUMN_PID: n = snprintf( cell, size, "%ld", pid ); break;
+    case COLUMN_PPID: n = snprintf( cell, size, "%ld", (long)ps->ppid ); break;
+    case COLUMN_UID: n = snprintf( cell, size, "%lu", (long)ps->uid ); break;
+    case COLUMN_GID: n = snprintf( cell, size, "%lu", (long)ps->gid ); break;
+    case COLUMN_STATUS: n = snprintf( cell, size, "%s", ps->status ); break;
+    case COLUMN_USERTIME: n = snprintf( cell, size, "%lu", ps->userTime ); break;
+    case COLUMN_SYSTIME: n = snprintf( cell, size, "%lu", ps->sysTime ); break;
+    case COLUMN_NICE: n = snprintf( cell, size, "%d", ps->niceLevel ); break;
+    case COLUMN_VMSIZE: n = snprintf( cell, size, "%lu", ps->vmSize ); break;
+    case COLUMN_VMRSS: n = snprintf( cell, size, "%lu", ps->vmRss ); break;
+    case COLUMN_VMURSS: n = snprintf( cell, size, "%lu", ps->vmURss ); break;
+    case COLUMN_LOGIN: n = snprintf( cell, size, "%s", (ps->userName[0]==0)?" ":ps->userName ); break;
+    case COLUMN_TRACERPID: n = snprintf( cell, size, "%ld", (long)ps->tracerpid ); break;
+    case COLUMN_TTY: n = snprintf( cell, size, "%s", (ps->tty[0]==0)?" ":ps->tty ); break;
+    case COLUMN_COMMAND: n = snprintf( cell, size, "%s", (ps->cmdline[0]==0)?" ":ps->cmdline ); break;
+    case COLUMN_IOCLASS: n = snprintf( cell, size, "%d", ps->ioPriorityClass ); break;
+    case COLUMN_IOPRIO: n = snprintf( cell, size, "%d", ps->ioPriority ); break;
+    case COLUMN_NNP: n = snprintf( cell, size, "%d", ps->noNewPrivileges ); break;
+    case COLUMN_CGROUP: n = snprintf( cell, size, "%s", ps->cGroup ); break;
+    case COLUMN_MAC: n = snprintf( cell, size, "%s", ps->macContext ); break;
+  }
+
+  /* A truncated cell ends the row */
+  if ( n < 0 || (size_t)n >= size )
+    return LINESIZE - 1;
+  return length + n;
+}
+
+/**
+  Prints the row of @ref ps in the format of the ps table, without the
+  newline. The cells of the columns that are not in @ref columns are
+  empty.
+  @return the length of the row.
+ */
+static size_t printRowOf( char* row, unsigned long columns, long pid, const ProcessInfo* ps )
+{
+  size_t length = 0;
+  int column;
+
+  for ( column = 0; column < PS_COLUMNS; ++column ) {
+    if ( column > 0 && length < LINESIZE - 1 )
+      row[ length++ ] = '\t';
+    if ( columns & ( 1UL << column ) )
+      length = printColumn( row, length, column, pid, ps );
+  }
+  row[ length ] = '\0';
+
+  return length;
+}
+
+/**
+  @return whether @ref ps passes the filters of @ref query.
+ */
+static bool matchesQuery( const ProcessQuery* query, const ProcessInfo* ps )
+{
+  if ( query->uid >= 0 && (long)ps->uid != query->uid )
+    return false;
+  if ( query->cGroup && strncmp( ps->cGroup, query->cGroup, strlen( query->cGroup ) ) != 0 )
+    return false;
+  if ( query->name && strstr( ps->name, query->name ) == NULL )
+    return false;
+
+  return true;
+}
+
+/**
+  @return the value of @ref ps that the rows of @ref query are sorted
+  by, 0 if they are not.
+ */
+static double sortKeyOf( const ProcessQuery* query, long pid, const ProcessInfo* ps )
+{
+  switch ( query->sortColumn ) {
+    case SORT_CPU: return ps->cpuUsage;
+    case COLUMN_PID: return pid;
+    case COLUMN_PPID: return ps->ppid;
+    case COLUMN_UID: return ps->uid;
+    case COLUMN_GID: return ps->gid;
+    case COLUMN_USERTIME: return ps->userTime;
+    case COLUMN_SYSTIME: return ps->sysTime;
+    case COLUMN_NICE: return ps->niceLevel;
+    case COLUMN_VMSIZE: return ps->vmSize;
+    case COLUMN_VMRSS: return ps->vmRss;
+    /* -1 if statm could not be read */
+    case COLUMN_VMURSS: return (long)ps->vmURss;
+    case COLUMN_TRACERPID: return ps->tracerpid;
+    case COLUMN_IOCLASS: return ps->ioPriorityClass;
+    case COLUMN_IOPRIO: return ps->ioPriority;
+    case COLUMN_NNP: return ps->noNewPrivileges;
+  }
+
+  return 0;
+}
+
+/**
+  Appends @ref pid to Pids.
+  @return 0 on success, -1 if there is no memory.
+ */
+static int appendPid( pid_t pid )
+{
+  if ( ProcessCount == PidsSize ) {
+    unsigned int size = PidsSize ? 2 * PidsSize : 1024;
+    pid_t* pids = (pid_t*)realloc( Pids, size * sizeof( pid_t ) );
+    if ( pids == NULL ) {
+      log_error( "Out of memory, the process list is incomplete" );
+      return -1;
+    }
+    Pids = pids;
+    PidsSize = size;
+  }
+
+  Pids[ ProcessCount++ ] = pid;
+  return 0;
+}
+
+/**
+  Reads the pids in /proc into Pids with getdents64(), which returns
+  many entries per call, and sets ProcessCount.
+  @return 0 on success, -1 if /proc cannot be read.
+ */
+static int readProcDirectory( void )
+{
+  struct linux_dirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+  } *entry;
+  long length, offset;
 
-  ProcessInfo ps;
   ProcessCount = 0;
-  rewinddir(procDir);
-  while ( ( entry = readdir( procDir ) ) ) {
-    if ( isdigit( entry->d_name[ 0 ] ) ) {
-      long pid;
-      pid = atol( entry->d_name );
-      if(getProcess( pid, &ps )) /* Print out the details of the process.  Because of a stupid bug in kde3 ksysguard, make sure cmdline and tty are not empty */
-        output( "%s\t%ld\t%ld\t%lu\t%lu\t%s\t%lu\t%lu\t%d\t%lu\t%lu\t%lu\t%s\t%ld\t%s\t%s\t%d\t%d\t%d\t%s\t%s\n",
-             ps.name, pid, (long)ps.ppid,
-             (long)ps.uid, (long)ps.gid, ps.status, ps.userTime,
-             ps.sysTime, ps.niceLevel, ps.vmSize, ps.vmRss, ps.vmURss,
-             (ps.userName[0]==0)?" ":ps.userName, (long)ps.tracerpid,
-             (ps.tty[0]==0)?" ":ps.tty, (ps.cmdline[0]==0)?" ":ps.cmdline,
-             ps.ioPriorityClass, ps.ioPriority, ps.noNewPrivileges, ps.cGroup, ps.macContext
-        );
+  if ( ProcFD < 0 || lseek( ProcFD, 0, SEEK_SET ) < 0 )
+    return -1;
+
+  while ( ( length = syscall( SYS_getdents64, ProcFD, DentsBuffer, sizeof( DentsBuffer ) ) ) > 0 ) {
+    for ( offset = 0; offset < length; offset += entry->d_reclen ) {
+      const char* name;
+      pid_t pid = 0;
+
+      entry = (struct linux_dirent64*)( DentsBuffer + offset );
+      /* Process directories are the only names that start with 1 to 9 */
+      name = entry->d_name;
+      if ( *name < '1' || *name > '9' )
+        continue;
+      while ( *name >= '0' && *name <= '9' )
+        pid = pid * 10 + ( *name++ - '0' );
+      if ( *name != '\0' )
+        continue;
+
+      if ( appendPid( pid ) < 0 )
+        return 0;
+    }
+  }
+
+  if ( length < 0 ) {
+    log_error( "Cannot read /proc: %s", strerror( errno ) );
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+  Marks @ref pid as running in LivePids, which grows if the pid_max
+  has been raised.
+ */
+static void setLive( pid_t pid )
+{
+  unsigned int word = pid / LONG_BITS;
+
+  if ( pid < 0 )
+    return;
+
+  if ( word >= LivePidsSize ) {
+    unsigned int size = word + 1 > 2 * LivePidsSize ? word + 1 : 2 * LivePidsSize;
+    unsigned long* live = (unsigned long*)realloc( LivePids, size * sizeof( unsigned long ) );
+    if ( live == NULL ) {
+      /* The next scan reads /proc again */
+      TableValid = 0;
+      return;
+    }
+    memset( live + LivePidsSize, 0, ( size - LivePidsSize ) * sizeof( unsigned long ) );
+    LivePids = live;
+    LivePidsSize = size;
+  }
+
+  LivePids[ word ] |= 1UL << ( pid % LONG_BITS );
+}
+
+static void clearLive( pid_t pid )
+{
+  if ( pid >= 0 && (unsigned int)pid / LONG_BITS < LivePidsSize )
+    LivePids[ pid / LONG_BITS ] &= ~( 1UL << ( pid % LONG_BITS ) );
+}
+
+/**
+  @return whether /proc/<pid> still exists, e.g. because the process
+  is a zombie or other threads of it are still running.
+ */
+static int procEntryExists( pid_t pid )
+{
+  char path[ 16 ];
+
+  snprintf( path, sizeof( path ), "%d", pid );
+  return faccessat( ProcFD, path, F_OK, 0 ) == 0;
+}
+
+static void removeLingering( unsigned int i )
+{
+  Lingering[ i ] = Lingering[ --LingeringCount ];
+}
+
+static void applyProcEvent( ProcEventType type, pid_t pid, void* data )
+{
+  CachedProcess* cached;
+  unsigned int i;
+
+  (void)data;
+
+  switch ( type ) {
+    case PROCESS_FORKED:
+      /* A pid is only reused once the old process is gone */
+      for ( i = 0; i < LingeringCount; ++i ) {
+        if ( Lingering[ i ] == pid ) {
+          removeLingering( i );
+          break;
+        }
+      }
+      setLive( pid );
+      break;
+
+    case PROCESS_EXECUTED:
+      pthread_mutex_lock( &CacheLock );
+      if ( ProcessCache && ( cached = get_htbl( ProcessCache, &pid, sizeof( pid_t ) ) ) != NULL )
+        cached->columns = 0;
+      pthread_mutex_unlock( &CacheLock );
+      break;
+
+    case PROCESS_EXITED:
+      /* Zombies stay in the list until they are reaped, like with a
+       * scan of /proc. Nothing tells when that happens, so they are
+       * checked with every scan. */
+      if ( !procEntryExists( pid ) )
+        clearLive( pid );
+      else if ( LingeringCount < MAX_LINGERING ) {
+        if ( LingeringCount == LingeringSize ) {
+          unsigned int size = LingeringSize ? 2 * LingeringSize : 64;
+          pid_t* lingering = (pid_t*)realloc( Lingering, size * sizeof( pid_t ) );
+          if ( lingering == NULL ) {
+            TableValid = 0;
+            break;
+          }
+          Lingering = lingering;
+          LingeringSize = size;
+        }
+        Lingering[ LingeringCount++ ] = pid;
+      } else
+        TableValid = 0;
+      break;
+  }
+}
+
+/**
+  Brings LivePids up to date with the events that have arrived since the
+  last scan, or reads /proc again if that is not possible.
+ */
+static int updateLivePids( void )
+{
+  unsigned int i;
+
+  if ( TableValid && ++ScansSinceList < RESYNC_SCANS ) {
+    if ( readProcEvents( applyProcEvent, NULL ) == 0 ) {
+      for ( i = 0; i < LingeringCount; ) {
+        if ( procEntryExists( Lingering[ i ] ) )
+          ++i;
+        else {
+          clearLive( Lingering[ i ] );
+          removeLingering( i );
+        }
+      }
+      if ( TableValid )
+        return 0;
+    }
+  }
+
+  /* Events have been lost. They are thrown away and /proc is read, the
+   * events that arrive meanwhile are applied on top, which does not
+   * change the state of a pid that has been listed already. */
+  readProcEvents( NULL, NULL );
+  if ( readProcDirectory() < 0 )
+    return -1;
+
+  memset( LivePids, 0, LivePidsSize * sizeof( unsigned long ) );
+  LingeringCount = 0;
+  TableValid = 1;
+  ScansSinceList = 0;
+  for ( i = 0; i < ProcessCount; ++i )
+    setLive( Pids[ i ] );
+
+  if ( readProcEvents( applyProcEvent, NULL ) < 0 )
+    TableValid = 0;
+
+  return 0;
+}
+
+/**
+  Fills Pids with the running processes and sets ProcessCount. They come
+  from the process connector if it is available, from /proc otherwise.
+  Must be called with ScanLock held.
+  @return 0 on success, -1 if /proc cannot be read.
+ */
+static int listProcesses( void )
+{
+  unsigned int word;
+  unsigned long bits;
+
+  if ( !Tracking ) {
+    if ( readProcDirectory() < 0 )
+      return -1;
+  } else {
+    if ( updateLivePids() < 0 )
+      return -1;
+
+    /* In the ascending order of /proc */
+    ProcessCount = 0;
+    for ( word = 0; word < LivePidsSize; ++word ) {
+      for ( bits = LivePids[ word ]; bits; bits &= bits - 1 ) {
+        if ( appendPid( word * LONG_BITS + __builtin_ctzl( bits ) ) < 0 ) {
+          word = LivePidsSize;
+          break;
+        }
+      }
+    }
+  }
+
+  ListTime = monotonicMicros();
+  return 0;
+}
+
+/**
+  Appends @ref key, @ref row and its terminating zero to the text of
+  @ref block.
+ */
+static void appendRow( ScanBlock* block, double key, const char* row, size_t length )
+{
+  size_t needed = sizeof( double ) + length + 1;
+
+  if ( block->length + needed > block->size ) {
+    size_t size = block->size ? 2 * block->size : 16 * LINESIZE;
+    char* text;
+
+    while ( size < block->length + needed )
+      size *= 2;
+    if ( ( text = (char*)realloc( block->text, size ) ) == NULL )
+      return;
+    block->text = text;
+    block->size = size;
+  }
+
+  /* The text is not aligned for a double */
+  memcpy( block->text + block->length, &key, sizeof( double ) );
+  memcpy( block->text + block->length + sizeof( double ), row, length + 1 );
+  block->length += needed;
+}
+
+/**
+  Takes blocks of Pids until there are none left and prints the rows
+  of their processes into the blocks.
+ */
+static void* scanWorker( void* data )
+{
+  ScanJob* job = (ScanJob*)data;
+  const ProcessQuery* query = job->query;
+  ProcessInfo ps;
+  char row[ LINESIZE ];
+  unsigned int block, i, end;
+
+  while ( ( block = atomic_fetch_add( &job->nextBlock, 1 ) ) < job->blocks ) {
+    Blocks[ block ].length = 0;
+    end = ( block + 1 ) * SCAN_BLOCK < ProcessCount ? ( block + 1 ) * SCAN_BLOCK : ProcessCount;
+    for ( i = block * SCAN_BLOCK; i < end; ++i ) {
+      if ( getProcess( Pids[ i ], &ps, query->columns | query->extra ) && matchesQuery( query, &ps ) )
+        appendRow( &Blocks[ block ], sortKeyOf( query, Pids[ i ], &ps ), row,
+                   printRowOf( row, query->columns, Pids[ i ], &ps ) );
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  @return the number of threads for a scan of ProcessCount processes.
+ */
+static int scanThreads( void )
+{
+  long threads = ScanThreads;
+
+  if ( threads <= 0 ) {
+    threads = sysconf( _SC_NPROCESSORS_ONLN );
+    if ( threads > MAX_SCAN_THREADS )
+      threads = MAX_SCAN_THREADS;
+  }
+
+  /* Starting a thread does not pay off for a few blocks */
+  if ( threads > (long)( ProcessCount / ( 4 * SCAN_BLOCK ) ) )
+    threads = ProcessCount / ( 4 * SCAN_BLOCK );
+
+  return threads < 1 ? 1 : (int)threads;
+}
+
+/**
+  Reads the processes of ProcessCount blocks of Pids on @ref threads
+  threads, the calling one included, and passes the rows to @ref fn in
+  the order of Pids.
+ */
+static void scanInParallel( const ProcessQuery* query, int threads,
+                            void (*fn)( const char* row, double key, void* data ), void* data )
+{
+  pthread_t workers[ MAX_SCAN_THREADS ];
+  ScanJob job;
+  unsigned int block;
+  size_t offset;
+  const char* text;
+  double key;
+  int started = 0;
+
+  job.query = query;
+  job.blocks = ( ProcessCount + SCAN_BLOCK - 1 ) / SCAN_BLOCK;
+  atomic_init( &job.nextBlock, 0 );
+
+  if ( job.blocks > BlocksSize ) {
+    ScanBlock* blocks = (ScanBlock*)realloc( Blocks, job.blocks * sizeof( ScanBlock ) );
+    if ( blocks == NULL ) {
+      log_error( "Out of memory, the process list is incomplete" );
+      return;
     }
+    memset( blocks + BlocksSize, 0, ( job.blocks - BlocksSize ) * sizeof( ScanBlock ) );
+    Blocks = blocks;
+    BlocksSize = job.blocks;
   }
+
+  /* If a thread cannot be started the others do its share */
+  while ( started < threads - 1 && started < MAX_SCAN_THREADS &&
+          pthread_create( &workers[ started ], NULL, scanWorker, &job ) == 0 )
+    ++started;
+  scanWorker( &job );
+  while ( started > 0 )
+    pthread_join( workers[ --started ], NULL );
+
+  for ( block = 0; block < job.blocks; ++block ) {
+    for ( offset = 0; offset < Blocks[ block ].length; offset += sizeof( double ) + strlen( text ) + 1 ) {
+      memcpy( &key, Blocks[ block ].text + offset, sizeof( double ) );
+      text = Blocks[ block ].text + offset + sizeof( double );
+      fn( text, key, data );
+    }
+  }
+}
+
+/**
+  Calls @ref fn with @ref data, the row in the format of the ps table
+  without the newline and the sort key of every process that passes the
+  filters of @ref query. The cells of the columns that are not in its
+  columns are empty. Must be called with ScanLock held.
+ */
+static void scanProcesses( const ProcessQuery* query, void (*fn)( const char* row, double key, void* data ), void* data )
+{
+  unsigned long columns = query->columns | query->extra;
+  ProcessInfo ps;
+  char row[ LINESIZE ];
+  unsigned int i;
+  int threads;
+
+  ++ScanNumber;
+  if ( listProcesses() < 0 )
+    return;
+
+  ScanTime = monotonicMicros();
+  if ( ( threads = scanThreads() ) > 1 )
+    scanInParallel( query, threads, fn, data );
+  else {
+    for ( i = 0; i < ProcessCount; ++i ) {
+      if ( getProcess( Pids[ i ], &ps, columns ) && matchesQuery( query, &ps ) ) {
+        printRowOf( row, query->columns, Pids[ i ], &ps );
+        fn( row, sortKeyOf( query, Pids[ i ], &ps ), data );
+      }
+    }
+  }
+
+  /* Without stat the scan has not looked at the cache */
+  if ( columns & ( STAT_COLUMNS | CACHED_COLUMNS ) )
+    evictProcesses();
+}
+
+/**
+  @return the value of @ref cell of @ref column as sortKeyOf() has it.
+ */
+static double cellKey( int column, const char* cell )
+{
+  /* vmURss is printed unsigned, -1 if statm could not be read */
+  if ( column == COLUMN_VMURSS )
+    return (long)strtoul( cell, NULL, 10 );
+
+  return strtod( cell, NULL );
+}
+
+/**
+  Like scanProcesses(), but the rows come from the last sample instead
+  of /proc. Must be called with SampleLock held.
+ */
+static void sampleProcesses( const ProcessQuery* query, void (*fn)( const char* row, double key, void* data ), void* data )
+{
+  char line[ LINESIZE ], row[ LINESIZE ];
+  char* cells[ PS_COLUMNS ];
+  const char* text;
+  size_t offset, length;
+  double key;
+  int column, count;
+
+  for ( offset = 0; offset < Sample.length; offset += sizeof( double ) + strlen( text ) + 1 ) {
+    memcpy( &key, Sample.text + offset, sizeof( double ) );
+    text = Sample.text + offset + sizeof( double );
+
+    strcpy( line, text );
+    cells[ 0 ] = line;
+    for ( count = 1; count < PS_COLUMNS && ( cells[ count ] = strchr( cells[ count - 1 ], '\t' ) ) != NULL; ++count )
+      *cells[ count ]++ = '\0';
+    /* A truncated row lacks the last cells */
+    while ( count < PS_COLUMNS )
+      cells[ count++ ] = line + strlen( text );
+
+    if ( ( query->uid >= 0 && strtol( cells[ COLUMN_UID ], NULL, 10 ) != query->uid ) ||
+         ( query->cGroup && strncmp( cells[ COLUMN_CGROUP ], query->cGroup, strlen( query->cGroup ) ) != 0 ) ||
+         ( query->name && strstr( cells[ COLUMN_NAME ], query->name ) == NULL ) )
+      continue;
+
+    if ( query->sortColumn >= 0 && query->sortColumn != SORT_CPU )
+      key = cellKey( query->sortColumn, cells[ query->sortColumn ] );
+    else if ( query->sortColumn < 0 )
+      key = 0;
+
+    length = 0;
+    for ( column = 0; column < PS_COLUMNS; ++column ) {
+      if ( column > 0 )
+        row[ length++ ] = '\t';
+      if ( query->columns & ( 1UL << column ) ) {
+        strcpy( row + length, cells[ column ] );
+        length += strlen( cells[ column ] );
+      }
+    }
+    row[ length ] = '\0';
+
+    fn( row, key, data );
+  }
+}
+
+/**
+  Calls scanProcesses() or, if @ref fromSample is set, sampleProcesses().
+ */
+static void selectProcesses( const ProcessQuery* query, bool fromSample,
+                             void (*fn)( const char* row, double key, void* data ), void* data )
+{
+  if ( fromSample )
+    sampleProcesses( query, fn, data );
+  else
+    scanProcesses( query, fn, data );
+}
+
+/**
+  @return whether @ref a comes before @ref b in the answer.
+ */
+static bool ranksBefore( const RankedRow* a, const RankedRow* b )
+{
+  return a->key > b->key || ( a->key == b->key && a->order < b->order );
+}
+
+static int compareRanks( const void* a, const void* b )
+{
+  const RankedRow* x = (const RankedRow*)a;
+  const RankedRow* y = (const RankedRow*)b;
+
+  if ( x->order == y->order )
+    return 0;
+  return ranksBefore( x, y ) ? -1 : 1;
+}
+
+static void swapRanks( RankedRow* a, RankedRow* b )
+{
+  RankedRow swap = *a;
+
+  *a = *b;
+  *b = swap;
+}
+
+/* Moves the row at @ref i of the heap up while it ranks after its parent */
+static void siftUp( Ranking* ranking, unsigned int i )
+{
+  while ( i > 0 && ranksBefore( &ranking->rows[ ( i - 1 ) / 2 ], &ranking->rows[ i ] ) ) {
+    swapRanks( &ranking->rows[ ( i - 1 ) / 2 ], &ranking->rows[ i ] );
+    i = ( i - 1 ) / 2;
+  }
+}
+
+/* Moves the row at @ref i of the heap down while a child ranks after it */
+static void siftDown( Ranking* ranking, unsigned int i )
+{
+  unsigned int last;
+
+  while ( 2 * i + 1 < ranking->count ) {
+    last = 2 * i + 1;
+    if ( last + 1 < ranking->count && ranksBefore( &ranking->rows[ last ], &ranking->rows[ last + 1 ] ) )
+      ++last;
+    if ( !ranksBefore( &ranking->rows[ i ], &ranking->rows[ last ] ) )
+      break;
+    swapRanks( &ranking->rows[ i ], &ranking->rows[ last ] );
+    i = last;
+  }
+}
+
+/**
+  Keeps @ref row if it is among the first rows of the answer. A full
+  heap only takes rows that rank before its top, so a scan of n
+  processes costs O(n log limit).
+ */
+static void rankRow( const char* row, double key, void* data )
+{
+  Ranking* ranking = (Ranking*)data;
+  RankedRow ranked;
+
+  ranked.key = key;
+  ranked.order = ranking->order++;
+
+  if ( ranking->limit > 0 && ranking->count == ranking->limit ) {
+    if ( !ranksBefore( &ranked, &ranking->rows[ 0 ] ) || ( ranked.row = strdup( row ) ) == NULL )
+      return;
+    free( ranking->rows[ 0 ].row );
+    ranking->rows[ 0 ] = ranked;
+    siftDown( ranking, 0 );
+    return;
+  }
+
+  if ( ranking->count == ranking->size ) {
+    unsigned int size = ranking->size ? 2 * ranking->size : 64;
+    RankedRow* rows;
+
+    if ( ranking->limit > 0 && size > ranking->limit )
+      size = ranking->limit;
+    if ( ( rows = (RankedRow*)realloc( ranking->rows, size * sizeof( RankedRow ) ) ) == NULL )
+      return;
+    ranking->rows = rows;
+    ranking->size = size;
+  }
+
+  if ( ( ranked.row = strdup( row ) ) == NULL )
+    return;
+  ranking->rows[ ranking->count++ ] = ranked;
+  if ( ranking->limit > 0 )
+    siftUp( ranking, ranking->count - 1 );
+}
+
+static void printRow( const char* row, double key, void* data )
+{
+  (void)key;
+  (void)data;
+  output( "%s\n", row );
+}
+
+static void addDeltaRow( const char* row, double key, void* data )
+{
+  (void)key;
+  addTableDeltaRow( (TableDelta*)data, row );
+}
+
+static void keepRow( const char* row, double key, void* data )
+{
+  output( "%s\n", row );
+  appendRow( (ScanBlock*)data, key, row, strlen( row ) );
+}
+
+/**
+  Like selectProcesses(), but @ref fn gets the rows in the order and
+  number that @ref query asks for.
+ */
+static void queryProcesses( const ProcessQuery* query, bool fromSample,
+                            void (*fn)( const char* row, double key, void* data ), void* data )
+{
+  Ranking ranking;
+  unsigned int i;
+
+  if ( query->sortColumn < 0 && query->limit == 0 ) {
+    selectProcesses( query, fromSample, fn, data );
+    return;
+  }
+
+  memset( &ranking, 0, sizeof( Ranking ) );
+  ranking.limit = query->limit;
+  selectProcesses( query, fromSample, rankRow, &ranking );
+
+  qsort( ranking.rows, ranking.count, sizeof( RankedRow ), compareRanks );
+  for ( i = 0; i < ranking.count; ++i ) {
+    fn( ranking.rows[ i ].row, ranking.rows[ i ].key, data );
+    free( ranking.rows[ i ].row );
+  }
+  free( ranking.rows );
+}
+
+/**
+  Answers 'ps delta <generation>' with the changes since the answer of
+  that generation, see TableDelta.h.
+ */
+static void printProcessDelta( const char* generation, const ProcessQuery* query, bool fromSample )
+{
+  TableDelta* delta;
+
+  if ( ( delta = (TableDelta*)clientData( &DeltaKey ) ) == NULL ) {
+    if ( ( delta = newTableDelta( PS_COLUMNS, DELTA_KEY, DELTA_DICTIONARY ) ) == NULL ||
+         setClientData( &DeltaKey, delta, freeTableDelta ) < 0 ) {
+      freeTableDelta( delta );
+      print_error( "Cannot keep the process list for this client" );
+      return;
+    }
+  }
+
+  beginTableDelta( delta, generation ? strtoul( generation, NULL, 10 ) : 0 );
+  queryProcesses( query, fromSample, addDeltaRow, delta );
+  endTableDelta( delta );
+}
+
+/**
+  Answers 'ps' without arguments and keeps the rows as the Sample. Must
+  be called with ScanLock held.
+ */
+static void takeSample( void )
+{
+  ProcessQuery query;
+  ScanBlock previous;
+
+  memset( &query, 0, sizeof( ProcessQuery ) );
+  query.columns = ALL_COLUMNS;
+  query.uid = -1;
+  /* Makes the CPU usage the key of the rows, they are not sorted */
+  query.sortColumn = SORT_CPU;
+
+  SpareSample.length = 0;
+  scanProcesses( &query, keepRow, &SpareSample );
   output( "\n" );
-  return;
+
+  pthread_mutex_lock( &SampleLock );
+  previous = Sample;
+  Sample = SpareSample;
+  SampleTaken = true;
+  pthread_mutex_unlock( &SampleLock );
+  SpareSample = previous;
+}
+
+/**
+  @return the column of @ref name or -1 if there is none.
+ */
+static int columnNamed( const char* name, size_t length )
+{
+  int column;
+
+  for ( column = 0; column < PS_COLUMNS; ++column ) {
+    if ( strlen( ColumnNames[ column ] ) == length &&
+         strncmp( ColumnNames[ column ], name, length ) == 0 )
+      return column;
+  }
+
+  return -1;
+}
+
+/**
+  Turns the comma separated column names of 'ps cols=...' into a set of
+  COLUMN() bits. The PID is always included, it is the key of a delta.
+  @return 0 on success, -1 if a name is unknown.
+ */
+static int parseColumns( const char* names, unsigned long* columns )
+{
+  const char* name = names;
+  size_t length;
+  int column;
+
+  *columns = COLUMN( PID );
+  while ( *name ) {
+    length = strcspn( name, "," );
+    if ( ( column = columnNamed( name, length ) ) < 0 )
+      return -1;
+
+    *columns |= 1UL << column;
+    name += length;
+    if ( *name == ',' )
+      ++name;
+  }
+
+  return 0;
+}
+
+/**
+  Adds an argument of 'ps' like 'sort=cpu' to @ref query. The values
+  point into @ref word.
+  @return 0 on success, -1 if the argument is not valid.
+ */
+static int parseOption( char* word, ProcessQuery* query )
+{
+  char* value = strchr( word, '=' );
+  char* end;
+
+  if ( value == NULL || *++value == '\0' )
+    return -1;
+
+  if ( strncmp( word, "cols=", 5 ) == 0 )
+    return parseColumns( value, &query->columns );
+
+  if ( strncmp( word, "sort=", 5 ) == 0 ) {
+    if ( strcmp( value, "cpu" ) == 0 ) {
+      query->sortColumn = SORT_CPU;
+      query->extra |= COLUMN( USERTIME ) | COLUMN( SYSTIME );
+      return 0;
+    }
+    query->sortColumn = columnNamed( value, strlen( value ) );
+    if ( query->sortColumn < 0 || !( SORT_COLUMNS & ( 1UL << query->sortColumn ) ) )
+      return -1;
+    query->extra |= 1UL << query->sortColumn;
+    return 0;
+  }
+
+  if ( strncmp( word, "limit=", 6 ) == 0 ) {
+    query->limit = strtoul( value, &end, 10 );
+    return *end == '\0' ? 0 : -1;
+  }
+
+  if ( strncmp( word, "uid=", 4 ) == 0 ) {
+    query->uid = strtol( value, &end, 10 );
+    query->extra |= COLUMN( UID );
+    return *end == '\0' && query->uid >= 0 ? 0 : -1;
+  }
+
+  if ( strncmp( word, "cgroup=", 7 ) == 0 ) {
+    query->cGroup = value;
+    query->extra |= COLUMN( CGROUP );
+    return 0;
+  }
+
+  if ( strncmp( word, "name=", 5 ) == 0 ) {
+    query->name = value;
+    query->extra |= COLUMN( NAME );
+    return 0;
+  }
+
+  return -1;
+}
+
+void printProcessList( const char* cmd )
+{
+  ProcessQuery query;
+  const char* generation = NULL;
+  char* line = strdup( cmd );
+  char** words = (char**)malloc( ( strlen( cmd ) / 2 + 1 ) * sizeof( char* ) );
+  int count, i = 1, delta = 0;
+
+  if ( line == NULL || words == NULL ) {
+    free( line );
+    free( words );
+    print_error( "Out of memory" );
+    return;
+  }
+
+  memset( &query, 0, sizeof( ProcessQuery ) );
+  query.columns = ALL_COLUMNS;
+  query.sortColumn = -1;
+  query.uid = -1;
+
+  count = splitWords( line, words );
+  if ( count > 1 && strcmp( words[ 1 ], "delta" ) == 0 ) {
+    delta = 1;
+    if ( ++i < count && strchr( words[ i ], '=' ) == NULL )
+      generation = words[ i++ ];
+  }
+  while ( i < count && parseOption( words[ i ], &query ) == 0 )
+    ++i;
+
+  if ( i < count )
+    print_error( "Usage: ps [delta [<generation>]] [cols=<column>,...] [sort=<column>|cpu] "
+                 "[limit=<rows>] [uid=<uid>] [cgroup=<prefix>] [name=<text>]" );
+  else if ( count == 1 ) {
+    /* When the module is sampled only the collector asks without
+     * arguments, the first sample is taken by the main loop */
+    pthread_mutex_lock( &ScanLock );
+    takeSample();
+    pthread_mutex_unlock( &ScanLock );
+  } else if ( ProcessListSM && ProcessListSM->sampleInterval ) {
+    pthread_mutex_lock( &SampleLock );
+    if ( !SampleTaken )
+      print_error( "Sensor 'ps' has not been sampled yet" );
+    else if ( delta )
+      printProcessDelta( generation, &query, true );
+    else {
+      queryProcesses( &query, true, printRow, NULL );
+      output( "\n" );
+    }
+    pthread_mutex_unlock( &SampleLock );
+  } else {
+    pthread_mutex_lock( &ScanLock );
+    if ( delta )
+      printProcessDelta( generation, &query, false );
+    else {
+      queryProcesses( &query, false, printRow, NULL );
+      output( "\n" );
+    }
+    pthread_mutex_unlock( &ScanLock );
+  }
+
+  free( words );
+  free( line );
 }
 
 void getIOnice( int pid, ProcessInfo *ps ) {
@@ -487,10 +1978,15 @@ void getIOnice( int pid, ProcessInfo *ps ) {
 
 void initProcessList( struct SensorModul* sm )
 {
+  PageSizeKiB = sysconf( _SC_PAGESIZE ) / 1024;
+  ClockTicks = sysconf( _SC_CLK_TCK );
+  ProcessListSM = sm;
+  ProcessCache = new_htbl();
   initPWUIDCache();
 
   registerMonitor( "pscount", "integer", printProcessCount, printProcessCountInfo, sm );
   registerMonitor( "ps", "table", printProcessList, printProcessListInfo, sm );
+  acceptArguments( "ps" );
 
   if ( !RunAsDaemon ) {
     registerCommand( "kill", killProcess );
@@ -502,12 +1998,16 @@ void initProcessList( struct SensorModul* sm )
 
   /*open /proc now in advance*/
   /* read in current process list via the /proc file system entry */
-  if ( ( procDir = opendir( "/proc" ) ) == NULL ) {
+  if ( ( ProcFD = sysOpen( "/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC ) ) < 0 ) {
     print_error( "Cannot open directory \'/proc\'!\n"
                  "The kernel needs to be compiled with support\n"
                  "for /proc file system enabled!\n" );
     return;
   }
+
+  /* The events describe the running system, not the tree below SysRoot */
+  if ( ProcessEvents && !haveSysRoot() && openProcEvents() == 0 )
+    Tracking = 1;
 }
 
 void exitProcessList( void )
@@ -519,11 +2019,44 @@ void exitProcessList( void )
     removeCommand( "kill" );
     removeCommand( "setpriority" );
   }
-  closedir( procDir );
+  if ( Tracking )
+    closeProcEvents();
+  Tracking = TableValid = 0;
+  free( LivePids );
+  LivePids = NULL;
+  LivePidsSize = 0;
+  free( Lingering );
+  Lingering = NULL;
+  LingeringSize = LingeringCount = 0;
+
+  if ( ProcFD >= 0 )
+    close( ProcFD );
+  ProcFD = -1;
+  destr_htbl( ProcessCache, freeCachedProcess );
+
+  while ( BlocksSize > 0 )
+    free( Blocks[ --BlocksSize ].text );
+  free( Blocks );
+  Blocks = NULL;
+  free( Sample.text );
+  free( SpareSample.text );
+  memset( &Sample, 0, sizeof( ScanBlock ) );
+  memset( &SpareSample, 0, sizeof( ScanBlock ) );
+  SampleTaken = false;
+  free( Pids );
+  Pids = NULL;
+  PidsSize = ProcessCount = 0;
 
   exitPWUIDCache();
 }
 
+int updateProcessList( void )
+{
+  /* 'ps' and 'pscount' read /proc when they are printed. Having an
+   * update lets the sampler take the module to a collector thread. */
+  return 0;
+}
+
 void printProcessListInfo( const char* cmd )
 {
   (void)cmd;
@@ -535,15 +2068,13 @@ void printProcessListInfo( const char* cmd )
 void printProcessCount( const char* cmd )
 {
   (void)cmd;
-  struct dirent* entry;
-  ProcessCount = 0;
-  rewinddir(procDir);
-  while ( ( entry = readdir( procDir ) ) )
-    if ( isdigit( entry->d_name[ 0 ] ) )
-      ProcessCount++;
-
+  pthread_mutex_lock( &ScanLock );
+  /* The sampler asks right after 'ps', so the pids are usually fresh */
+  if ( ListTime == 0 || monotonicMicros() - ListTime > PSCOUNT_MAX_AGE )
+    listProcesses();
 
   output( "%d\n", ProcessCount );
+  pthread_mutex_unlock( &ScanLock );
 }
 
 void printProcessCountInfo( const char* cmd )
@@ -24,6 +24,7 @@
 
 void initProcessList( struct SensorModul* );
 void exitProcessList( void );
+int updateProcessList( void );
 
 void printProcessList( const char* );
 void printProcessListInfo( const char* );
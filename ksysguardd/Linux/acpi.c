@@ -31,6 +31,7 @@
 
 #include "Command.h"
 #include "ksysguardd.h"
+#include "SysRoot.h"
 
 #include "acpi.h"
 
@@ -112,7 +113,7 @@ void initAcpiBattery( struct SensorModul* sm )
     struct dirent *de;
     char name[ ACPIFILENAMELENGTHMAX ];
 
-    d = opendir("/sys/class/power_supply/");
+    d = sysOpendir("/sys/class/power_supply/");
     if (d != NULL) {
         while ( (de = readdir(d)) != NULL ) {
             if (de->d_name[0] == '.')
@@ -340,7 +341,7 @@ void readTypeFile(const char *fileFormat, int number, char *buffer, int bufferSi
     char filename[ ACPIFILENAMELENGTHMAX ];
     snprintf(filename, sizeof(filename), fileFormat, number);
 
-    int typeFile = open(filename, O_RDONLY);
+    int typeFile = sysOpen(filename, O_RDONLY);
     if (typeFile < 0) {
         print_error( "Cannot open file \'%s\'!\n"
                      "Unable to fetch ACPI type", filename);
@@ -384,7 +385,7 @@ void initAcpiThermal(struct SensorModul *sm)
   DIR *d = NULL;
   struct dirent *de;
 
-  d = opendir("/sys/class/thermal/");
+  d = sysOpendir("/sys/class/thermal/");
   if (d != NULL) {
       while ( (de = readdir(d)) != NULL ) {
           if ( de->d_name[0] == '.')
@@ -408,7 +409,7 @@ void initAcpiThermal(struct SensorModul *sm)
       }
       closedir( d );
   } else {
-      d = opendir(OLD_THERMAL_ZONE_DIR);
+      d = sysOpendir(OLD_THERMAL_ZONE_DIR);
       if (d != NULL) {
           while ( (de = readdir(d)) != NULL ) {
               if ( de->d_name[0] == '.')
@@ -422,7 +423,7 @@ void initAcpiThermal(struct SensorModul *sm)
           closedir( d );
       }
 
-      d = opendir(OLD_FAN_DIR);
+      d = sysOpendir(OLD_FAN_DIR);
       if (d != NULL) {
           while ( (de = readdir(d)) != NULL ) {
               if ( de->d_name[0] == '.')
@@ -445,7 +446,7 @@ static int getSysFileValue(const char *className, const char *group, int value,
     char th_file[ ACPIFILENAMELENGTHMAX ];
     char input_buf[ 100 ];
     snprintf(th_file, sizeof(th_file), "/sys/class/%s/%s%d/%s", className, group, value, file);
-    int fd = open(th_file, O_RDONLY);
+    int fd = sysOpen(th_file, O_RDONLY);
     if (fd < 0) {
         return -1;/* ignore failures, as sys files disappear when battery is removed */
     }
@@ -523,7 +524,7 @@ static int getCurrentTemperature(const char *cmd)
 			OLD_THERMAL_ZONE_DIR "/%.*s/" OLD_TEMPERATURE_FILE,
 			len_zone_name, zone_name);
 
-	fd = open(th_file, O_RDONLY);
+	fd = sysOpen(th_file, O_RDONLY);
 	if (fd < 0) {
 		print_error( "Cannot open file \'%s\'!\n"
 		"Load the thermal ACPI kernel module or\n"
@@ -584,7 +585,7 @@ static int getFanState(const char *cmd)
 			OLD_FAN_DIR "/%.*s/" OLD_FAN_STATE_FILE,
 			len_fan_name, fan_name);
 
-	fd = open(fan_state_file, O_RDONLY);
+	fd = sysOpen(fan_state_file, O_RDONLY);
 	if (fd < 0) {
 		print_error( "Cannot open file \'%s\'!\n"
 		"Load the fan ACPI kernel module or\n"
@@ -26,6 +26,7 @@
 
 #include "Command.h"
 #include "ksysguardd.h"
+#include "SysRoot.h"
 
 #include "apm.h"
 
@@ -72,7 +73,7 @@ int updateApm( void )
   if ( ApmOK < 0 )
     return -1;
 
-  if ( ( fd = open( "/proc/apm", O_RDONLY ) ) < 0 ) {
+  if ( ( fd = sysOpen( "/proc/apm", O_RDONLY ) ) < 0 ) {
     if ( ApmOK != 0 )
       print_error( "Cannot open file \'/proc/apm\'!\n"
                    "The kernel needs to be compiled with support\n"
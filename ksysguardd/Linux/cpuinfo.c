@@ -30,6 +30,7 @@
 
 #include "Command.h"
 #include "ksysguardd.h"
+#include "SysRoot.h"
 
 #include "cpuinfo.h"
 
@@ -105,7 +106,7 @@ static void processCpuInfo( void )
                 const char freqTemplate[] = "/sys/bus/cpu/devices/cpu%d/cpufreq/scaling_cur_freq";
                 char freqName[sizeof(freqTemplate) + 3];
                 snprintf(freqName, sizeof(freqName) - 1, freqTemplate, coreUniqueId);
-                FILE *freqFd = fopen(freqName, "r");
+                FILE *freqFd = sysFopen(freqName, "r");
                 if (freqFd) {
                     unsigned long khz;
                     if(fscanf(freqFd, "%lu\n", &khz) == 1) {
@@ -183,7 +184,7 @@ int updateCpuInfo( void )
     if ( CpuInfoOK < 0 )
         return -1;
 
-    if ( ( fd = open( "/proc/cpuinfo", O_RDONLY ) ) < 0 ) {
+    if ( ( fd = sysOpen( "/proc/cpuinfo", O_RDONLY ) ) < 0 ) {
         if ( CpuInfoOK != 0 )
             print_error( "Cannot open file \'/proc/cpuinfo\'!\n"
                     "The kernel needs to be compiled with support\n"
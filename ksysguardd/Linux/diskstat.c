@@ -30,11 +30,13 @@
 #include <time.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <limits.h>
 
 #include "Command.h"
-#include "ccont.h"
 #include "diskstat.h"
 #include "ksysguardd.h"
+#include "SysRoot.h"
+#include "vector.h"
 
 typedef struct {
     char device[ 256 ];
@@ -42,8 +44,8 @@ typedef struct {
     struct statvfs statvfs;
 } DiskInfo;
 
-static CONTAINER DiskStatList = 0;
-static CONTAINER OldDiskStatList = 0;
+static VECTOR DiskStatList = 0;
+static VECTOR OldDiskStatList = 0;
 static struct SensorModul* DiskStatSM;
 char *getMntPnt( const char* cmd );
 
@@ -76,11 +78,13 @@ char *getMntPnt( const char* cmd )
 unsigned long getTotal( const char* mntpnt )
 {
     DiskInfo* disk_info;
+    INDEX i;
 
     unsigned long total = 0;
     int is_all = strcmp( mntpnt, "/all" ) == 0;
 
-    for ( disk_info = first_ctnr( DiskStatList ); disk_info; disk_info = next_ctnr( DiskStatList ) ) {
+    for ( i = 0; i < level_vctr( DiskStatList ); i++ ) {
+        disk_info = get_vctr( DiskStatList, i );
         if ( !strcmp( mntpnt, disk_info->mntpnt ) || is_all ) {
             unsigned long totalSizeKB =  disk_info->statvfs.f_blocks * (disk_info->statvfs.f_frsize/1024);
 
@@ -122,6 +126,7 @@ static void removeMonitors(const char* mntpnt) {
 void initDiskStat( struct SensorModul* sm )
 {
     DiskInfo* disk_info;
+    INDEX i;
 
     DiskStatList = NULL;
     OldDiskStatList = NULL;
@@ -133,7 +138,8 @@ void initDiskStat( struct SensorModul* sm )
 
     registerMonitors( "/all" );
 
-    for ( disk_info = first_ctnr( DiskStatList ); disk_info; disk_info = next_ctnr( DiskStatList ) ) {
+    for ( i = 0; i < level_vctr( DiskStatList ); i++ ) {
+        disk_info = get_vctr( DiskStatList, i );
         registerMonitors(disk_info->mntpnt);
     }
 }
@@ -141,18 +147,21 @@ void initDiskStat( struct SensorModul* sm )
 void exitDiskStat( void )
 {
     DiskInfo* disk_info;
+    INDEX i;
 
     removeMonitor( "partitions/list" );
 
     removeMonitors( "/all" );
 
-    for ( disk_info = first_ctnr( DiskStatList ); disk_info; disk_info = next_ctnr( DiskStatList ) ) {
+    for ( i = 0; i < level_vctr( DiskStatList ); i++ ) {
+        disk_info = get_vctr( DiskStatList, i );
         removeMonitors(disk_info->mntpnt);
     }
 
-    destr_ctnr( DiskStatList, free );
-    if(OldDiskStatList)
-        destr_ctnr( OldDiskStatList, free );
+    destr_vctr( DiskStatList, free );
+    if(OldDiskStatList) {
+        destr_vctr( OldDiskStatList, free );
+    }
 }
 
 void checkDiskStat( void )
@@ -160,14 +169,16 @@ void checkDiskStat( void )
     updateDiskStat();
     DiskInfo* disk_info_new;
     DiskInfo* disk_info_old;
+    INDEX i, j;
     int changed = 0;
-    for ( disk_info_new = first_ctnr( DiskStatList ); disk_info_new; disk_info_new = next_ctnr( DiskStatList ) ) {
+    for ( i = 0; i < level_vctr( DiskStatList ); i++ ) {
         int found = 0;
-        for ( disk_info_old = first_ctnr( OldDiskStatList ); disk_info_old; disk_info_old = next_ctnr( OldDiskStatList ) ) {
+        disk_info_new = get_vctr( DiskStatList, i );
+        for ( j = level_vctr( OldDiskStatList ) - 1; j >= 0; j-- ) {
+            disk_info_old = get_vctr( OldDiskStatList, j );
             if(strcmp(disk_info_new->mntpnt, disk_info_old->mntpnt) == 0) {
-                free( remove_ctnr( OldDiskStatList ) );
+                free( remove_at_vctr( OldDiskStatList, j ) );
                 found = 1;
-                continue;
             }
         }
         if(!found) {
@@ -177,12 +188,12 @@ void checkDiskStat( void )
         }
     }
     /*Now remove all the devices that do not exist anymore*/
-    for ( disk_info_old = first_ctnr( OldDiskStatList ); disk_info_old; disk_info_old = next_ctnr( OldDiskStatList ) ) {
+    for ( j = 0; j < level_vctr( OldDiskStatList ); j++ ) {
+        disk_info_old = get_vctr( OldDiskStatList, j );
         removeMonitors(disk_info_old->mntpnt);
         changed++;
     }
-    destr_ctnr( OldDiskStatList, free );
-    OldDiskStatList = NULL;
+    destr_vctr( OldDiskStatList, free );
     updateDiskStat();
     if(changed)
         print_error( "RECONFIGURE" ); /*Let ksysguard know that we've added a sensor*/
@@ -193,16 +204,17 @@ int updateDiskStat( void )
     DiskInfo *disk_info;
     FILE *fh;
     struct mntent *mnt_info;
+    char mtab[ PATH_MAX ];
 
-    if ( ( fh = setmntent( "/etc/mtab", "r" ) ) == NULL ) {
+    if ( ( fh = setmntent( sysPath( mtab, sizeof( mtab ), "/etc/mtab" ), "r" ) ) == NULL ) {
         print_error( "Cannot open \'/etc/mtab\'!\n" );
         return -1;
     }
     if(OldDiskStatList == 0) {
         OldDiskStatList = DiskStatList;
-        DiskStatList = new_ctnr();
+        DiskStatList = new_vctr();
     } else {
-        empty_ctnr(DiskStatList);
+        empty_vctr( DiskStatList, free );
     }
 
     while ( ( mnt_info = getmntent( fh ) ) != NULL ) {
@@ -230,8 +242,10 @@ int updateDiskStat( void )
 
         memset( disk_info, 0, sizeof( DiskInfo ) );
 
-        if ( statvfs( mnt_info->mnt_dir, &(disk_info->statvfs) ) < 0 )
+        if ( statvfs( mnt_info->mnt_dir, &(disk_info->statvfs) ) < 0 ) {
+            free( disk_info );
             continue;
+        }
 
         strncpy( disk_info->device, mnt_info->mnt_fsname, sizeof( disk_info->device ) );
         disk_info->device[ sizeof(disk_info->device) -1] = 0;
@@ -244,7 +258,8 @@ int updateDiskStat( void )
         }
         sanitize(disk_info->mntpnt);
 
-        push_ctnr( DiskStatList, disk_info );
+        if ( push_vctr( DiskStatList, disk_info ) < 0 )
+            free( disk_info );
     }
     endmntent( fh );
 
@@ -269,9 +284,11 @@ int calculatePercentageUsed( unsigned long totalSizeKB, unsigned long available)
 void printDiskStat( const char* cmd )
 {
     DiskInfo* disk_info;
+    INDEX i;
 
     (void)cmd;
-    for ( disk_info = first_ctnr( DiskStatList ); disk_info; disk_info = next_ctnr( DiskStatList ) ) {
+    for ( i = 0; i < level_vctr( DiskStatList ); i++ ) {
+        disk_info = get_vctr( DiskStatList, i );
         /* See man statvfs(2) for meaning of fields */
         unsigned long totalSizeKB =  disk_info->statvfs.f_blocks * (disk_info->statvfs.f_frsize/1024);
         unsigned long usedKB = totalSizeKB - (disk_info->statvfs.f_bfree * (disk_info->statvfs.f_bsize/1024)); /* used is the total size minus free blocks including those for root only */
@@ -299,11 +316,13 @@ void printDiskStatUsed( const char* cmd )
 {
     char *mntpnt = (char*)getMntPnt( cmd );
     DiskInfo* disk_info;
+    INDEX i;
 
     unsigned long total = 0;
     int is_all = strcmp( mntpnt, "/all" ) == 0;
 
-    for ( disk_info = first_ctnr( DiskStatList ); disk_info; disk_info = next_ctnr( DiskStatList ) ) {
+    for ( i = 0; i < level_vctr( DiskStatList ); i++ ) {
+        disk_info = get_vctr( DiskStatList, i );
         if ( !strcmp( mntpnt, disk_info->mntpnt ) || is_all ) {
             unsigned long totalSizeKB =  disk_info->statvfs.f_blocks * (disk_info->statvfs.f_frsize/1024);
             unsigned long usedKB = totalSizeKB - (disk_info->statvfs.f_bfree * (disk_info->statvfs.f_bsize/1024)); /* used is the total size minus free blocks including those for root only */
@@ -340,11 +359,13 @@ void printDiskStatFree( const char* cmd )
 {
     char *mntpnt = (char*)getMntPnt( cmd );
     DiskInfo* disk_info;
+    INDEX i;
 
     unsigned long total = 0;
     int is_all = strcmp( mntpnt, "/all" ) == 0;
 
-    for ( disk_info = first_ctnr( DiskStatList ); disk_info; disk_info = next_ctnr( DiskStatList ) ) {
+    for ( i = 0; i < level_vctr( DiskStatList ); i++ ) {
+        disk_info = get_vctr( DiskStatList, i );
         if ( !strcmp( mntpnt, disk_info->mntpnt ) || is_all ) {
             unsigned long available = disk_info->statvfs.f_bavail * (disk_info->statvfs.f_bsize/1024); /* available is only those for non-root.  So available + used != total because some are reserved for root */
             if ( !is_all ) {
@@ -379,12 +400,14 @@ void printDiskStatPercent( const char* cmd )
 {
     char *mntpnt = (char*)getMntPnt( cmd );
     DiskInfo* disk_info;
+    INDEX i;
 
     unsigned long totalSize = 0;
     unsigned long totalAvailable = 0;
     int is_all = strcmp( mntpnt, "/all" ) == 0;
 
-    for ( disk_info = first_ctnr( DiskStatList ); disk_info; disk_info = next_ctnr( DiskStatList ) ) {
+    for ( i = 0; i < level_vctr( DiskStatList ); i++ ) {
+        disk_info = get_vctr( DiskStatList, i );
         if ( !strcmp( mntpnt, disk_info->mntpnt ) || is_all ) {
             unsigned long totalSizeKB =  disk_info->statvfs.f_blocks * (disk_info->statvfs.f_frsize/1024);
             unsigned long available = disk_info->statvfs.f_bavail * (disk_info->statvfs.f_bsize/1024); /* available is only those for non-root.  So available + used != total because some are reserved for root */
@@ -34,6 +34,7 @@
 
 #include "Command.h"
 #include "ksysguardd.h"
+#include "SysRoot.h"
 
 #include "diskstats.h"
 
@@ -111,7 +112,7 @@ void processDiskstats( void ) {
 
     gettimeofday( &currSampling, 0 );
 	/* Process values from /proc/diskstats (Linux >= 2.6.x) */
-	if ( ( file = fopen( "/proc/diskstats", "r" ) ) == NULL )
+	if ( ( file = sysFopen( "/proc/diskstats", "r" ) ) == NULL )
 		return; /* unable to open file. disable this module. */
 
 
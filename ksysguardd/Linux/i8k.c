@@ -26,6 +26,7 @@
 
 #include "Command.h"
 #include "ksysguardd.h"
+#include "SysRoot.h"
 
 #include "i8k.h"
 
@@ -70,7 +71,7 @@ int updateI8k( void )
   if ( I8kOK < 0 )
     return -1;
 
-  if ( ( fd = open( "/proc/i8k", O_RDONLY ) ) < 0 ) {
+  if ( ( fd = sysOpen( "/proc/i8k", O_RDONLY ) ) < 0 ) {
     print_error( "Cannot open file \'/proc/i8k\'!\n"
                  "The kernel needs to be compiled with support\n"
                  "for /proc file system enabled!\n" );
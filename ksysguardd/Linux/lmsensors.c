@@ -26,8 +26,9 @@
 #include <string.h>
 
 #include "Command.h"
-#include "ccont.h"
+#include "vector.h"
 #include "ksysguardd.h"
+#include "SysRoot.h"
 
 #include "lmsensors.h"
 
@@ -57,7 +58,7 @@ typedef struct
 #endif
 } LMSENSOR;
 
-static CONTAINER LmSensors;
+static VECTOR LmSensors;
 static int LmSensorsOk = -1;
 
 static int sensorCmp( void* s1, void* s2 )
@@ -76,13 +77,13 @@ static LMSENSOR* findMatchingSensor( const char* name )
   int end = strlen(key.fullName)-1;
   if(key.fullName[end] == '?')
     key.fullName[end] = '\0';
-  if ( ( idx = search_ctnr( LmSensors, sensorCmp, &key ) ) < 0 ) {
+  if ( ( idx = bsearch_vctr( LmSensors, sensorCmp, &key ) ) < 0 ) {
     free( key.fullName );
     return 0;
   }
 
   free( key.fullName );
-  s = get_ctnr( LmSensors, idx );
+  s = get_vctr( LmSensors, idx );
 
   return s;
 }
@@ -113,7 +114,7 @@ void initLmSensors( struct SensorModul* sm )
     return;
   }
 
-  LmSensors = new_ctnr();
+  LmSensors = new_vctr();
   while ( ( scn = sensors_get_detected_chips( NULL, &nr ) ) != NULL ) {
     int nr1 = 0;
     const sensors_feature* sf;
@@ -184,8 +185,8 @@ void initLmSensors( struct SensorModul* sm )
          sensors per CPU. This are really 2 distinct sensors measuring the
          same thing, but fullName must be unique so we just drop the second
          sensor */
-      if ( search_ctnr( LmSensors, sensorCmp, p ) < 0 ) {
-        push_ctnr( LmSensors, p );
+      if ( search_vctr( LmSensors, sensorCmp, p ) < 0 ) {
+        push_vctr( LmSensors, p );
         registerMonitor( p->fullName, "float", printLmSensor, printLmSensorInfo, sm );
       } else {
         free( p->fullName );
@@ -194,7 +195,7 @@ void initLmSensors( struct SensorModul* sm )
       free( label );
     }
   }
-  bsort_ctnr( LmSensors, sensorCmp );
+  sort_vctr( LmSensors, sensorCmp );
 }
 #else /* SENSORS_API_VERSION & 0x400 */
 void initLmSensors( struct SensorModul* sm )
@@ -204,7 +205,7 @@ void initLmSensors( struct SensorModul* sm )
   int nr = 0;
 
   FILE* input;
-  if ( ( input = fopen( "/etc/sensors.conf", "r" ) ) == NULL ) {
+  if ( ( input = sysFopen( "/etc/sensors.conf", "r" ) ) == NULL ) {
     LmSensorsOk = -1;
     return;
   }
@@ -217,7 +218,7 @@ void initLmSensors( struct SensorModul* sm )
 
   fclose( input );
 
-  LmSensors = new_ctnr();
+  LmSensors = new_vctr();
   while ( ( scn = sensors_get_detected_chips( &nr ) ) != NULL ) {
     int nr1, nr2;
     const sensors_feature_data* sfd;
@@ -245,8 +246,8 @@ void initLmSensors( struct SensorModul* sm )
 
         p->scn = scn;
         p->sfd = sfd;
-        if ( search_ctnr( LmSensors, sensorCmp, p ) < 0 ) {
-          push_ctnr( LmSensors, p );
+        if ( search_vctr( LmSensors, sensorCmp, p ) < 0 ) {
+          push_vctr( LmSensors, p );
           registerMonitor( p->fullName, "float", printLmSensor, printLmSensorInfo, sm );
         } else {
           free( p->fullName );
@@ -255,13 +256,13 @@ void initLmSensors( struct SensorModul* sm )
       }
     }
   }
-  bsort_ctnr( LmSensors, sensorCmp );
+  sort_vctr( LmSensors, sensorCmp );
 }
 #endif /* SENSORS_API_VERSION & 0x400 */
 
 void exitLmSensors( void )
 {
-  destr_ctnr( LmSensors, free );
+  destr_vctr( LmSensors, free );
 }
 
 void printLmSensor( const char* cmd )
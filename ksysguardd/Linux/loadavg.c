@@ -25,6 +25,7 @@
 #include <stdio.h>
 
 #include "ksysguardd.h"
+#include "SysRoot.h"
 #include "Command.h"
 
 #include "loadavg.h"
@@ -77,7 +78,7 @@ int updateLoadAvg( void )
   if ( LoadAvgOK < 0 )
     return -1;
 
-  if ( ( fd = open( "/proc/loadavg", O_RDONLY ) ) < 0 ) {
+  if ( ( fd = sysOpen( "/proc/loadavg", O_RDONLY ) ) < 0 ) {
     if ( LoadAvgOK != 0 )
       print_error( "Cannot open file \'/proc/loadavg\'!\n"
                    "The kernel needs to be compiled with support\n"
@@ -23,22 +23,34 @@
 #include <string.h>
 
 #include "Command.h"
-#include "ccont.h"
 #include "conf.h"
+#include "ilist.h"
 #include "ksysguardd.h"
 
 #include "logfile.h"
 
-static CONTAINER LogFiles = 0;
+static ILIST LogFiles;
 static unsigned long counter = 1;
 
 typedef struct {
+  struct ilist_node link;
   char name[ 256 ];
   FILE* fh;
   unsigned long id;
 } LogFileEntry;
 
-extern CONTAINER LogFileList;
+static LogFileEntry* findLogFile( unsigned long id )
+{
+  struct ilist_node* node;
+
+  for ( node = first_ilist( &LogFiles ); node; node = next_ilist( &LogFiles, node ) ) {
+    LogFileEntry* entry = ILIST_ENTRY( node, LogFileEntry, link );
+    if ( entry->id == id )
+      return entry;
+  }
+
+  return NULL;
+}
 
 /*
 ================================ public part =================================
@@ -48,13 +60,17 @@ void initLogFile( struct SensorModul* sm )
 {
   char monitor[ 1024 ];
   ConfigLogFile *entry;
+  INDEX i;
+
+  init_ilist( &LogFiles );
 
   registerCommand( "logfile_register", registerLogFile );
   registerCommand( "logfile_unregister", unregisterLogFile );
   registerCommand( "logfile_registered", printRegistered );
 
-  for ( entry = first_ctnr( LogFileList ); entry; entry = next_ctnr( LogFileList ) ) {
+  for ( i = 0; i < level_vctr( LogFileList ); i++ ) {
     FILE* fp;
+    entry = get_vctr( LogFileList, i );
     /* Register the log file only if we can actually read the file. */
     if ( ( fp = fopen( entry->path, "r" ) ) != NULL ) {
       snprintf( monitor, 1024, "logfiles/%s", entry->name );
@@ -63,13 +79,18 @@ void initLogFile( struct SensorModul* sm )
       fclose( fp );
     }
   }
-
-  LogFiles = new_ctnr();
 }
 
 void exitLogFile( void )
 {
-  destr_ctnr( LogFiles, free );
+  struct ilist_node* node;
+
+  while ( ( node = first_ilist( &LogFiles ) ) != NULL ) {
+    LogFileEntry* entry = ILIST_ENTRY( node, LogFileEntry, link );
+    remove_ilist( &LogFiles, node );
+    fclose( entry->fh );
+    free( entry );
+  }
 }
 
 void printLogFile( const char* cmd )
@@ -80,14 +101,12 @@ void printLogFile( const char* cmd )
 
   sscanf( cmd, "%*s %lu", &id );
 
-  for ( entry = first_ctnr( LogFiles ); entry; entry = next_ctnr( LogFiles ) ) {
-    if ( entry->id == id ) {
-      while ( fgets( line, 1024, entry->fh ) != NULL )
-        output( "%s", line );
+  if ( ( entry = findLogFile( id ) ) != NULL ) {
+    while ( fgets( line, 1024, entry->fh ) != NULL )
+      output( "%s", line );
 
-      /* delete the EOF */
-      clearerr( entry->fh );
-    }
+    /* delete the EOF */
+    clearerr( entry->fh );
   }
 
   output( "\n" );
@@ -104,13 +123,13 @@ void registerLogFile( const char* cmd )
   char name[ 257 ];
   FILE* file;
   LogFileEntry *entry;
-  int i;
+  INDEX i;
 
   memset( name, 0, sizeof( name ) );
   sscanf( cmd, "%*s %256s", name );
 
-  for ( i = 0; i < level_ctnr( LogFileList ); i++ ) {
-    ConfigLogFile *conf = get_ctnr( LogFileList, i );
+  for ( i = 0; i < level_vctr( LogFileList ); i++ ) {
+    ConfigLogFile *conf = get_vctr( LogFileList, i );
     if ( !strcmp( conf->name, name ) ) {
       if ( ( file = fopen( conf->path, "r" ) ) == NULL ) {
         print_error( "fopen()" );
@@ -131,7 +150,7 @@ void registerLogFile( const char* cmd )
       strncpy( entry->name, conf->name, 256 );
       entry->id = counter;
 
-      push_ctnr( LogFiles, entry );
+      push_ilist( &LogFiles, &entry->link );
 
       output( "%lu\n", counter );
       counter++;
@@ -150,13 +169,10 @@ void unregisterLogFile( const char* cmd )
 
   sscanf( cmd, "%*s %lu", &id );
 
-  for ( entry = first_ctnr( LogFiles ); entry; entry = next_ctnr( LogFiles ) ) {
-    if ( entry->id == id ) {
-      fclose( entry->fh );
-      free( remove_ctnr( LogFiles ) );
-      output( "\n" );
-      return;
-    }
+  if ( ( entry = findLogFile( id ) ) != NULL ) {
+    remove_ilist( &LogFiles, &entry->link );
+    fclose( entry->fh );
+    free( entry );
   }
 
   output( "\n" );
@@ -164,11 +180,13 @@ void unregisterLogFile( const char* cmd )
 
 void printRegistered( const char* cmd )
 {
-  LogFileEntry *entry;
+  struct ilist_node* node;
 
   (void)cmd;
-  for ( entry = first_ctnr( LogFiles ); entry; entry = next_ctnr( LogFiles ) )
+  for ( node = first_ilist( &LogFiles ); node; node = next_ilist( &LogFiles, node ) ) {
+    LogFileEntry *entry = ILIST_ENTRY( node, LogFileEntry, link );
     output( "%s:%lu\n", entry->name, entry->id );
+  }
 
   output( "\n" );
 }
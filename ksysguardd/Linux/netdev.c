@@ -30,6 +30,7 @@
 
 #include "Command.h"
 #include "ksysguardd.h"
+#include "SysRoot.h"
 
 #include "netdev.h"
 
@@ -409,7 +410,7 @@ int updateNetDev( void )
   long hash;
   char* p;
 
-  if ((fd = open("/proc/net/dev", O_RDONLY)) > 0) {
+  if ((fd = sysOpen("/proc/net/dev", O_RDONLY)) > 0) {
     n = read(fd, NetDevBuf, NETDEVBUFSIZE - 1);
     if (n == NETDEVBUFSIZE - 1 || n <= 0) {
       log_error("Internal buffer too small to read \'/proc/net/dev\'");
@@ -437,7 +438,7 @@ int updateNetDev( void )
   }
 
   /* We read the information about the wifi from /proc/net/wireless and store it into NetDevWifiBuf */
-  if ( ( fd = open( "/proc/net/wireless", O_RDONLY ) ) < 0 ) {
+  if ( ( fd = sysOpen( "/proc/net/wireless", O_RDONLY ) ) < 0 ) {
     /* /proc/net/wireless may not exist on some machines. */
     NetDevWifiBuf[0]='\0';
   } else if ( ( n = read( fd, NetDevWifiBuf, NETDEVBUFSIZE - 1 ) ) == NETDEVBUFSIZE - 1 ) {
@@ -31,14 +31,15 @@
 #include <time.h>
 
 #include "ksysguardd.h"
+#include "SysRoot.h"
 #include "Command.h"
-#include "ccont.h"
+#include "vector.h"
 #include "netstat.h"
 
-static CONTAINER TcpSocketList = 0;
-static CONTAINER UdpSocketList = 0;
-static CONTAINER UnixSocketList = 0;
-static CONTAINER RawSocketList = 0;
+static VECTOR TcpSocketList = 0;
+static VECTOR UdpSocketList = 0;
+static VECTOR UnixSocketList = 0;
+static VECTOR RawSocketList = 0;
 
 static int num_tcp = 0;
 static int num_udp = 0;
@@ -196,42 +197,42 @@ initNetStat(struct SensorModul* sm)
 {
 	FILE *netstat;
 	
-	if ((netstat = fopen("/proc/net/tcp", "r")) != NULL) {
+	if ((netstat = sysFopen("/proc/net/tcp", "r")) != NULL) {
 		registerMonitor("network/sockets/tcp/count", "integer", printNetStat, printNetStatInfo, sm);
         /* This monitor takes _way_ too much time (up to a minute, or more) since it does DNS lookups
            Hide the monitor, leaving it there for backwards compatibility */
 		registerLegacyMonitor("network/sockets/tcp/list", "listview", printNetStatTcpUdpRaw, printNetStatTcpUdpRawInfo, sm);
 		fclose(netstat);
 	}
-	if ((netstat = fopen("/proc/net/udp", "r")) != NULL) {
+	if ((netstat = sysFopen("/proc/net/udp", "r")) != NULL) {
 		registerMonitor("network/sockets/udp/count", "integer", printNetStat, printNetStatInfo, sm);
 		registerMonitor("network/sockets/udp/list", "listview", printNetStatTcpUdpRaw, printNetStatTcpUdpRawInfo, sm);
 		fclose(netstat);
 	}
-	if ((netstat = fopen("/proc/net/unix", "r")) != NULL) {
+	if ((netstat = sysFopen("/proc/net/unix", "r")) != NULL) {
 		registerMonitor("network/sockets/unix/count", "integer", printNetStat, printNetStatInfo, sm);
 		registerMonitor("network/sockets/unix/list", "listview", printNetStatUnix, printNetStatUnixInfo, sm);
 		fclose(netstat);
 	}
-	if ((netstat = fopen("/proc/net/raw", "r")) != NULL) {
+	if ((netstat = sysFopen("/proc/net/raw", "r")) != NULL) {
 		registerMonitor("network/sockets/raw/count", "integer", printNetStat, printNetStatInfo, sm);
 		registerMonitor("network/sockets/raw/list", "listview", printNetStatTcpUdpRaw, printNetStatTcpUdpRawInfo, sm);
 		fclose(netstat);
 	}
 
-	TcpSocketList = new_ctnr();
-	UdpSocketList = new_ctnr();
-	RawSocketList = new_ctnr();
-	UnixSocketList = new_ctnr();
+	TcpSocketList = new_vctr();
+	UdpSocketList = new_vctr();
+	RawSocketList = new_vctr();
+	UnixSocketList = new_vctr();
 }
 
 void
 exitNetStat(void)
 {
-	destr_ctnr(TcpSocketList, free);
-	destr_ctnr(UdpSocketList, free);
-	destr_ctnr(RawSocketList, free);
-	destr_ctnr(UnixSocketList, free);
+	destr_vctr(TcpSocketList, free);
+	destr_vctr(UdpSocketList, free);
+	destr_vctr(RawSocketList, free);
+	destr_vctr(UnixSocketList, free);
 }
 
 int
@@ -239,21 +240,21 @@ updateNetStat(void)
 {
 	FILE *netstat;
 
-	if ((netstat = fopen("/proc/net/tcp", "r")) != NULL) {
+	if ((netstat = sysFopen("/proc/net/tcp", "r")) != NULL) {
 		num_tcp = get_num_sockets(netstat);
 		fclose(netstat);
 	}
 
-	if ((netstat = fopen("/proc/net/udp", "r")) != NULL) {
+	if ((netstat = sysFopen("/proc/net/udp", "r")) != NULL) {
 		num_udp = get_num_sockets(netstat);
 		fclose(netstat);
 	}
 
-	if ((netstat = fopen("/proc/net/unix", "r")) != NULL) {
+	if ((netstat = sysFopen("/proc/net/unix", "r")) != NULL) {
 		num_unix = get_num_sockets(netstat);
 		fclose(netstat);
 	}
-	if ((netstat = fopen("/proc/net/raw", "r")) != NULL) {
+	if ((netstat = sysFopen("/proc/net/raw", "r")) != NULL) {
 		num_raw = get_num_sockets(netstat);
 		fclose(netstat);
 	}
@@ -275,22 +276,22 @@ updateNetStatTcpUdpRaw(const char *cmd)
 
 	if (strstr(cmd, "tcp")) {
 		snprintf(buffer, sizeof(buffer), "/proc/net/tcp");
-		empty_ctnr(TcpSocketList);
+		empty_vctr(TcpSocketList, free);
 	}
         else if (strstr(cmd, "udp")) {
 		snprintf(buffer, sizeof(buffer), "/proc/net/udp");
-		empty_ctnr(UdpSocketList);
+		empty_vctr(UdpSocketList, free);
 	}
         else if (strstr(cmd, "raw")) {
 		snprintf(buffer, sizeof(buffer), "/proc/net/raw");
-		empty_ctnr(RawSocketList);
+		empty_vctr(RawSocketList, free);
 	}
         else {
 		print_error("cmd needs to be [tcp|udp|raw], is %s\n", cmd);
 		return -1;
         }
 
-	if ((netstat = fopen(buffer, "r")) == NULL) {
+	if ((netstat = sysFopen(buffer, "r")) == NULL) {
 		print_error("Cannot open \'%s\'!\n"
 		   "The kernel needs to be compiled with support\n"
 		   "for /proc file system enabled!\n", buffer);
@@ -325,7 +326,7 @@ updateNetStatTcpUdpRaw(const char *cmd)
 				socket_info->state[sizeof(socket_info->state)-1] = 0;
 				socket_info->uid = uid;
 
-				push_ctnr(TcpSocketList, socket_info);
+				push_vctr(TcpSocketList, socket_info);
 			}
 
 			if (strstr(cmd, "udp")) {
@@ -339,7 +340,7 @@ updateNetStatTcpUdpRaw(const char *cmd)
 				
 				socket_info->uid = uid;
 
-				push_ctnr(UdpSocketList, socket_info);
+				push_vctr(UdpSocketList, socket_info);
 			}
 
 			if (strstr(cmd, "raw")) {
@@ -351,7 +352,7 @@ updateNetStatTcpUdpRaw(const char *cmd)
 				socket_info->state[sizeof(socket_info->state)-1] = 0;
 				socket_info->uid = uid;
 
-				push_ctnr(RawSocketList, socket_info);
+				push_vctr(RawSocketList, socket_info);
 			}
 		}
 	}
@@ -370,14 +371,14 @@ updateNetStatUnix(void)
 	int ref_count, type, state, inode;
 	UnixInfo *unix_info;
 
-	if ((file = fopen("/proc/net/unix", "r")) == NULL) {
+	if ((file = sysFopen("/proc/net/unix", "r")) == NULL) {
 		print_error("Cannot open \'/proc/net/unix\'!\n"
 		   "The kernel needs to be compiled with support\n"
 		   "for /proc file system enabled!\n");
 		return -1;
 	}
 
-	empty_ctnr(UnixSocketList);
+	empty_vctr(UnixSocketList, free);
 
 	while (fgets(buffer, sizeof(buffer), file) != NULL) {
 		if(buffer[0] != 0) {
@@ -401,7 +402,7 @@ updateNetStatUnix(void)
 			strncpy(unix_info->path, path, sizeof(unix_info->path)-1);
 			unix_info->path[ sizeof(unix_info->path)-1] = 0;
 
-			push_ctnr(UnixSocketList, unix_info);
+			push_vctr(UnixSocketList, unix_info);
 		}
 	}
 	fclose(file);
@@ -441,35 +442,35 @@ printNetStatInfo(const char* cmd)
 void
 printNetStatTcpUdpRaw(const char *cmd)
 {
-	SocketInfo* socket_info;
+	INDEX i;
 
 	if (strstr(cmd, "tcp")) {
         updateNetStatTcpUdpRaw("tcp");
 
-		for (socket_info = first_ctnr(TcpSocketList); socket_info; socket_info = next_ctnr(TcpSocketList))
-			printSocketInfo(socket_info);
+		for (i = 0; i < level_vctr(TcpSocketList); i++)
+			printSocketInfo(get_vctr(TcpSocketList, i));
 
-		if (level_ctnr(TcpSocketList) == 0)
+		if (level_vctr(TcpSocketList) == 0)
 			output( "\n");
 	}
 
 	if (strstr(cmd, "udp")) {
         updateNetStatTcpUdpRaw("udp");
 
-		for (socket_info = first_ctnr(UdpSocketList); socket_info; socket_info = next_ctnr(UdpSocketList))
-			printSocketInfo(socket_info);
+		for (i = 0; i < level_vctr(UdpSocketList); i++)
+			printSocketInfo(get_vctr(UdpSocketList, i));
 
-		if (level_ctnr(UdpSocketList) == 0)
+		if (level_vctr(UdpSocketList) == 0)
 			output( "\n");
 	}
 
 	if (strstr(cmd, "raw")) {
         updateNetStatTcpUdpRaw("raw");
 
-		for (socket_info = first_ctnr(RawSocketList); socket_info; socket_info = next_ctnr(RawSocketList))
-			printSocketInfo(socket_info);
+		for (i = 0; i < level_vctr(RawSocketList); i++)
+			printSocketInfo(get_vctr(RawSocketList, i));
 
-		if (level_ctnr(RawSocketList) == 0)
+		if (level_vctr(RawSocketList) == 0)
 			output( "\n");
 	}
 }
@@ -484,11 +485,13 @@ printNetStatTcpUdpRawInfo(const char *cmd)
 void printNetStatUnix(const char *cmd)
 {
 	UnixInfo* unix_info;
+	INDEX i;
 
 	(void) cmd;
     updateNetStatUnix();
 	
-	for (unix_info = first_ctnr(UnixSocketList); unix_info; unix_info = next_ctnr(UnixSocketList)) {
+	for (i = 0; i < level_vctr(UnixSocketList); i++) {
+		unix_info = get_vctr(UnixSocketList, i);
 		output( "%d\t%s\t%s\t%d\t%s\n",
 			unix_info->refcount,
 			unix_info->type,
@@ -497,7 +500,7 @@ void printNetStatUnix(const char *cmd)
 			unix_info->path);
 	}
 
-	if (level_ctnr(UnixSocketList) == 0)
+	if (level_vctr(UnixSocketList) == 0)
 		output( "\n");
 }
 
@@ -19,6 +19,7 @@
 
 #include "Command.h"
 #include "ksysguardd.h"
+#include "SysRoot.h"
 #include "softraid.h"
 
 #define _POSIX_C_SOURCE 200809L /* strndup */
@@ -32,7 +33,7 @@
 #include <stdlib.h> /* for exit */
 #include <sys/wait.h> /* for wait :) */
 #include <stdbool.h> /* for bool */
-#include "ccont.h" /* for CONTAINER */
+#include "htbl.h" /* for HTBL */
 
 #define MDSTATBUFSIZE (1 * 1024)
 #define MDADMSTATBUFSIZE (2 * 1024)
@@ -41,7 +42,7 @@
 
 static struct SensorModul* StatSM;
 
-static CONTAINER ArrayInfos = 0;
+static HTBL ArrayInfos = 0;	/* ArrayInfo by ArrayName */
 char mdstatBuf[ MDSTATBUFSIZE ];	/* Buffer for /proc/mdstat */
 
 typedef struct Disks {
@@ -93,21 +94,18 @@ typedef struct {
 	Disks *first_disk;		/* A linked list of hard disks */
 } ArrayInfo;
 
-static int ArrayInfoEqual( void* s1, void* s2 )
+static ArrayInfo* findArrayInfo( const char* name )
 {
-	/* Returns 0 if both ArrayInfos have the same name.  */
-	return strncmp( ((ArrayInfo*)s1)->ArrayName, ((ArrayInfo*)s2)->ArrayName,ARRAYNAMELEN );
+	return get_htbl( ArrayInfos, name, strlen( name ) );
 }
 
 void printArrayAttribute( const char* cmd ) {
-	INDEX idx;
-	ArrayInfo key;
+	char arrayName[ ARRAYNAMELEN + 1 ];
 	ArrayInfo* foundArray;
 	char attribute[40];
 
-	if ( sscanf(cmd, "SoftRaid/%[^/]/%39s", key.ArrayName, attribute) == 2 ) {
-		if ( ( idx = search_ctnr( ArrayInfos, ArrayInfoEqual, &key ) ) == 0 ) {
-			foundArray = get_ctnr( ArrayInfos, idx );
+	if ( sscanf(cmd, "SoftRaid/%" ARRAYNAMELENSTRING "[^/]/%39s", arrayName, attribute) == 2 ) {
+		if ( ( foundArray = findArrayInfo( arrayName ) ) != NULL ) {
 
 			if ( strcmp( attribute, "NumBlocks" ) == 0 )
 				output( "%d\n", foundArray->NumBlocks );
@@ -155,14 +153,12 @@ void printArrayAttribute( const char* cmd ) {
 }
 
 void printArrayAttributeInfo( const char* cmd ) {
-	INDEX idx;
-	ArrayInfo key;
+	char arrayName[ ARRAYNAMELEN + 1 ];
 	ArrayInfo* foundArray;
 	char attribute[40];
 
-	if ( sscanf(cmd, "SoftRaid/%[^/]/%39s", key.ArrayName, attribute) == 2 ) {
-		if ( ( idx = search_ctnr( ArrayInfos, ArrayInfoEqual, &key ) ) == 0 ) {
-			foundArray = get_ctnr( ArrayInfos, idx );
+	if ( sscanf(cmd, "SoftRaid/%" ARRAYNAMELENSTRING "[^/]/%39s", arrayName, attribute) == 2 ) {
+		if ( ( foundArray = findArrayInfo( arrayName ) ) != NULL ) {
 
 			if ( strcmp( attribute, "NumBlocks?" ) == 0 )
 				output( "Num blocks\t0\t0\t\n" );
@@ -317,7 +313,7 @@ void openMdstatFile() {
 	int fd;
 
 	mdstatBuf[ 0 ] = '\0';
-	if ( ( fd = open( "/proc/mdstat", O_RDONLY ) ) < 0 )
+	if ( ( fd = sysOpen( "/proc/mdstat", O_RDONLY ) ) < 0 )
 		return; /* couldn't open /proc/mdstat */
 	
 	n = read( fd, mdstatBuf, MDSTATBUFSIZE - 1 );
@@ -333,17 +329,14 @@ void openMdstatFile() {
 }
 
 ArrayInfo *getOrCreateArrayInfo(char *array_name, int array_name_length) {
-	ArrayInfo key;
-	INDEX idx;
+	char arrayName[ ARRAYNAMELEN + 1 ];
 	ArrayInfo* MyArray;
 	/*We have the array name.  see if we already have a record for it*/
-	strncpy(key.ArrayName, array_name, array_name_length);
-	key.ArrayName[array_name_length]='\0';
-	if ( ( idx = search_ctnr( ArrayInfos, ArrayInfoEqual, &key ) ) == 0 ) {
-		/* Found an existing array device */
-		MyArray = get_ctnr( ArrayInfos, idx );
-	}
-	else {
+	if ( array_name_length > ARRAYNAMELEN )
+		array_name_length = ARRAYNAMELEN;
+	strncpy(arrayName, array_name, array_name_length);
+	arrayName[array_name_length]='\0';
+	if ( ( MyArray = findArrayInfo( arrayName ) ) == NULL ) {
 		/* Found a new array device. Create a data structure for it. */
 		MyArray = calloc(1,sizeof (ArrayInfo));
 		if (MyArray == NULL) {
@@ -351,9 +344,12 @@ ArrayInfo *getOrCreateArrayInfo(char *array_name, int array_name_length) {
 			fprintf(stderr, "Could not allocate memory\n");
 			exit(EXIT_FAILURE);
 		}
-		strcpy( MyArray->ArrayName, key.ArrayName );
+		strcpy( MyArray->ArrayName, arrayName );
 		/* Add this array to our list of array devices */
-		push_ctnr(ArrayInfos, MyArray);
+		if ( put_htbl( ArrayInfos, MyArray->ArrayName, strlen( MyArray->ArrayName ), MyArray ) < 0 ) {
+			fprintf(stderr, "Could not allocate memory\n");
+			exit(EXIT_FAILURE);
+		}
 		char sensorName[128];
 		sprintf(sensorName, "SoftRaid/%s/NumBlocks", MyArray->ArrayName);
 		registerMonitor(sensorName, "integer", printArrayAttribute, printArrayAttributeInfo, StatSM );
@@ -398,9 +394,10 @@ bool scanForArrays() {
 	int current_word_length = 0;
 
 	ArrayInfo* MyArray;
+	INDEX pos = 0;
 
 	/* Mark all data as dead. As we find data, we'll mark it alive. */
-	for ( MyArray = first_ctnr( ArrayInfos ); MyArray; MyArray = next_ctnr( ArrayInfos ) ) {
+	while ( ( MyArray = iter_htbl( ArrayInfos, &pos ) ) != NULL ) {
 		MyArray->Alive = false;
 	}
 	MyArray = NULL;
@@ -589,7 +586,8 @@ md1 : active raid1 sda2[0] sdb2[1]
 	}
 	
 	/* Look for dead arrays, and for NumBlocksIsRegistered */
-	for ( MyArray = first_ctnr( ArrayInfos ); MyArray; MyArray = next_ctnr( ArrayInfos ) ) {
+	pos = 0;
+	while ( ( MyArray = iter_htbl( ArrayInfos, &pos ) ) != NULL ) {
 		if ( MyArray->Alive == false ) {
 			print_error( "RECONFIGURE" );
 			
@@ -605,12 +603,12 @@ md1 : active raid1 sda2[0] sdb2[1]
 void initSoftRaid( struct SensorModul* sm ) {
   	StatSM = sm;
 
-	ArrayInfos = new_ctnr();
+	ArrayInfos = new_htbl();
 	updateSoftRaid();
 }
 
 void exitSoftRaid( void ) {
-	destr_ctnr( ArrayInfos, free );
+	destr_htbl( ArrayInfos, free );
 }
 
 int updateSoftRaid( void ) {
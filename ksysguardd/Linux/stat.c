@@ -32,27 +32,14 @@
 
 #include "Command.h"
 #include "ksysguardd.h"
+#include "SysRoot.h"
 
 #include "stat.h"
 
-typedef struct {
-	/* A CPU can be loaded with user processes, reniced processes and
-	* system processes. Unused processing time is called idle load.
-	* These variable store the percentage of each load type. */
-	float userLoad;
-	float niceLoad;
-	float sysLoad;
-	float idleLoad;
-	float waitLoad;
-	
-	/* To calculate the loads we need to remember the tick values for each
-	* load type. */
-	unsigned long userTicks;
-	unsigned long niceTicks;
-	unsigned long sysTicks;
-	unsigned long idleTicks;
-	unsigned long waitTicks;
-} CPULoadInfo;
+/* A CPU can be loaded with user processes, reniced processes and
+* system processes. Unused processing time is called idle load. The
+* states are in the order of their counters in the cpu lines. */
+enum { CPU_USER, CPU_NICE, CPU_SYS, CPU_IDLE, CPU_WAIT, CPU_STATES };
 
 typedef struct {
 	unsigned long delta;
@@ -91,9 +78,23 @@ static struct timeval lastSampling;
 static struct timeval currSampling;
 static struct SensorModul* StatSM;
 
-static CPULoadInfo CPULoad;
-static CPULoadInfo* SMPLoad = 0;
+/* The tick counters and the loads in percent, one array per state with
+* an element per CPU, so that the loads of all CPUs are computed in
+* loops without branches that the compiler can vectorize. Element 0 is
+* the total of the cpu line, element n + 1 is cpun. */
+static unsigned long* Ticks[ CPU_STATES ];
+static unsigned long* OldTicks[ CPU_STATES ];
+static unsigned long* TotalTicks = 0;
+static float* Load[ CPU_STATES ];
 static unsigned CPUCount = 0;
+
+/* The contents of /proc/stat or /proc/vmstat, grown to fit the file */
+#define STATBUFSIZE 16384
+static char* StatBuf = 0;
+static size_t StatBufSize = 0;
+static int StatFD = -1;
+static int VMStatFD = -1;
+
 static DiskLoadInfo* DiskLoad = 0;
 static unsigned DiskCount = 0;
 static DiskIOInfo* DiskIO = 0;
@@ -109,7 +110,7 @@ static unsigned long* Intr = 0;
 
 static int initStatDisk( char* tag, char* buf, const char* label, const char* shortLabel,
 			int idx, cmdExecutor ex, cmdExecutor iq );
-static void updateCPULoad( const char* line, CPULoadInfo* load );
+static void updateCPUTicks( const char* p );
 static int process24Disk( char* tag, char* buf, const char* label, int idx );
 static void processStat( void );
 static int process24DiskIO( const char* buf );
@@ -141,40 +142,193 @@ static int initStatDisk( char* tag, char* buf, const char* label,
 }
 
 /**
- * updateCPULoad
+ * Reads the whole file @ref fd into StatBuf with a single pread() and
+ * ends it with a zero. The proc files are generated in one go, so a
+ * read that does not fill the buffer has got everything, otherwise the
+ * buffer grows and the file is read again.
+ * @return the length or -1 on failure.
+ */
+static ssize_t readStatFile( int fd ) {
+	ssize_t n;
+	
+	if ( fd < 0 || StatBuf == 0 )
+		return -1;
+	
+	while ( ( n = pread( fd, StatBuf, StatBufSize - 1, 0 ) ) == (ssize_t)StatBufSize - 1 ) {
+		char* buf = (char*)realloc( StatBuf, 2 * StatBufSize );
+		
+		if ( buf == 0 ) {
+			log_error( "Out of memory, /proc/stat is cut off" );
+			break;
+		}
+		StatBuf = buf;
+		StatBufSize *= 2;
+	}
+	
+	if ( n < 0 )
+		return -1;
+	StatBuf[ n ] = '\0';
+	return n;
+}
+
+/**
+ * Cuts the line at @ref line off the rest of StatBuf.
+ * @return the start of the next line.
+ */
+static char* nextLine( char* line ) {
+	char* end = strchr( line, '\n' );
+	
+	if ( end == 0 )
+		return line + strlen( line );
+	*end = '\0';
+	return end + 1;
+}
+
+/**
+ * Parses the decimal number after the blanks at @ref p.
+ * @return the position after it, 0 if there is none.
+ */
+static const char* scanULong( const char* p, unsigned long* value ) {
+	unsigned long v = 0;
+	
+	while ( *p == ' ' || *p == '\t' )
+		++p;
+	if ( *p < '0' || *p > '9' )
+		return 0;
+	while ( *p >= '0' && *p <= '9' )
+		v = v * 10 + ( *p++ - '0' );
+	
+	*value = v;
+	return p;
+}
+
+/* The first field of a line, e.g. "intr" */
+static int isTag( const char* line, const char* tag ) {
+	size_t length = strlen( tag );
+	
+	return strncmp( line, tag, length ) == 0 && ( line[ length ] == ' ' || line[ length ] == '\0' );
+}
+
+static void freeCPULoads( void ) {
+	int s;
+	
+	for ( s = 0; s < CPU_STATES; ++s ) {
+		free( Ticks[ s ] );
+		free( OldTicks[ s ] );
+		free( Load[ s ] );
+		Ticks[ s ] = OldTicks[ s ] = 0;
+		Load[ s ] = 0;
+	}
+	free( TotalTicks );
+	TotalTicks = 0;
+}
+
+/**
+ * Allocates the counters of @ref count CPUs and the total.
+ * @return 0 on success, -1 if there is no memory.
+ */
+static int allocCPULoads( unsigned count ) {
+	int s;
+	int ok;
+	
+	TotalTicks = (unsigned long*)calloc( count + 1, sizeof( unsigned long ) );
+	ok = TotalTicks != 0;
+	for ( s = 0; s < CPU_STATES; ++s ) {
+		Ticks[ s ] = (unsigned long*)calloc( count + 1, sizeof( unsigned long ) );
+		OldTicks[ s ] = (unsigned long*)calloc( count + 1, sizeof( unsigned long ) );
+		Load[ s ] = (float*)calloc( count + 1, sizeof( float ) );
+		ok = ok && Ticks[ s ] && OldTicks[ s ] && Load[ s ];
+	}
+	
+	if ( !ok ) {
+		freeCPULoads();
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * updateCPUTicks
  *
- * Parses the total cpu status line from /proc/stat
+ * Parses a cpu line of /proc/stat after the "cpu". The total has no
+ * number. The counters of a CPU that is offline stay as they are.
+ */
+static void updateCPUTicks( const char* p ) {
+	unsigned long ticks[ CPU_STATES ];
+	unsigned long id = 0;
+	int s;
+	
+	if ( TotalTicks == 0 )
+		return;
+	
+	if ( *p != ' ' ) {
+		if ( ( p = scanULong( p, &id ) ) == 0 || id >= CPUCount )
+			return;
+		++id;
+	}
+	
+	for ( s = 0; s < CPU_STATES; ++s ) {
+		if ( ( p = scanULong( p, &ticks[ s ] ) ) == 0 )
+			return;
+	}
+	for ( s = 0; s < CPU_STATES; ++s )
+		Ticks[ s ][ id ] = ticks[ s ];
+}
+
+/**
+ * Computes the loads of all CPUs from the ticks since the last call.
  */
-static void updateCPULoad( const char* line, CPULoadInfo* load ) {
-	unsigned long currUserTicks, currSysTicks, currNiceTicks;
-	unsigned long currIdleTicks, currWaitTicks, totalTicks;
-	
-	if(sscanf( line, "%*s %lu %lu %lu %lu %lu", &currUserTicks, &currNiceTicks,
-		&currSysTicks, &currIdleTicks, &currWaitTicks ) != 5) {
-        return;
-    }
-	
-	totalTicks = ( currUserTicks - load->userTicks ) +
-		( currSysTicks - load->sysTicks ) +
-		( currNiceTicks - load->niceTicks ) +
-		( currIdleTicks - load->idleTicks ) +
-		( currWaitTicks - load->waitTicks );
-	
-	if ( totalTicks > 10 ) {
-		load->userLoad = ( 100.0 * ( currUserTicks - load->userTicks ) ) / totalTicks;
-		load->sysLoad = ( 100.0 * ( currSysTicks - load->sysTicks ) ) / totalTicks;
-		load->niceLoad = ( 100.0 * ( currNiceTicks - load->niceTicks ) ) / totalTicks;
-		load->idleLoad = ( 100.0 * ( currIdleTicks - load->idleTicks ) ) / totalTicks;
-		load->waitLoad = ( 100.0 * ( currWaitTicks - load->waitTicks ) ) / totalTicks;
+static void computeCPULoads( void ) {
+	unsigned n = CPUCount + 1;
+	unsigned i;
+	int s;
+	
+	if ( TotalTicks == 0 )
+		return;
+	
+	for ( i = 0; i < n; ++i )
+		TotalTicks[ i ] = 0;
+	for ( s = 0; s < CPU_STATES; ++s ) {
+		const unsigned long* ticks = Ticks[ s ];
+		const unsigned long* oldTicks = OldTicks[ s ];
+		
+		for ( i = 0; i < n; ++i )
+			TotalTicks[ i ] += ticks[ i ] - oldTicks[ i ];
 	}
-	else
-		load->userLoad = load->sysLoad = load->niceLoad = load->idleLoad = load->waitLoad = 0.0;
+	
+	for ( s = 0; s < CPU_STATES; ++s ) {
+		const unsigned long* ticks = Ticks[ s ];
+		unsigned long* oldTicks = OldTicks[ s ];
+		float* load = Load[ s ];
 		
-	load->userTicks = currUserTicks;
-	load->sysTicks = currSysTicks;
-	load->niceTicks = currNiceTicks;
-	load->idleTicks = currIdleTicks;
-	load->waitTicks = currWaitTicks;
+		for ( i = 0; i < n; ++i ) {
+			load[ i ] = TotalTicks[ i ] > 10 ? ( 100.0 * ( ticks[ i ] - oldTicks[ i ] ) ) / TotalTicks[ i ] : 0.0;
+			oldTicks[ i ] = ticks[ i ];
+		}
+	}
+}
+
+/**
+ * @return the total load of @ref state.
+ */
+static float cpuLoad( int state ) {
+	if ( StatDirty )
+		processStat();
+	
+	return TotalTicks ? Load[ state ][ 0 ] : 0.0;
+}
+
+/**
+ * @return the load of @ref state of the CPU that the command @ref cmd
+ * "cpu/cpu<n>/..." is about.
+ */
+static float cpuxLoad( const char* cmd, int state ) {
+	unsigned long id = strtoul( cmd + 7, 0, 10 );
+	
+	if ( StatDirty )
+		processStat();
+	
+	return id < CPUCount && TotalTicks ? Load[ state ][ id + 1 ] : 0.0;
 }
 	
 static int process24Disk( char* tag, char* buf, const char* label, int idx ) {
@@ -333,40 +487,36 @@ static void cleanup24DiskList( void ) {
 }
 
 static void processStat( void ) {
-	char format[ 32 ];
-	char tagFormat[ 16 ];
-	char buf[ 1024 ];
 	char tag[ 32 ];
-	
-	sprintf( format, "%%%d[^\n]\n", (int)sizeof( buf ) - 1 );
-	sprintf( tagFormat, "%%%ds", (int)sizeof( tag ) - 1 );
+	char* buf;
+	char* next;
+	size_t length;
 
 	gettimeofday( &currSampling, 0 );
 	StatDirty = 0;
 
-    FILE *stat = fopen("/proc/stat", "r");
-    if(!stat) {
-		print_error( "Cannot open file \'/proc/stat\'!\n"
+	if ( readStatFile( StatFD ) < 0 ) {
+		print_error( "Cannot read file \'/proc/stat\'!\n"
 				"The kernel needs to be compiled with support\n"
 				"for /proc file system enabled!\n" );
 		return;
-    }
+	}
 
-	while ( fscanf( stat, format, buf ) == 1 ) {
-		buf[ sizeof( buf ) - 1 ] = '\0';
-		sscanf( buf, tagFormat, tag );
+	for ( buf = StatBuf; *buf; buf = next ) {
+		next = nextLine( buf );
 		
-		if ( strcmp( "cpu", tag ) == 0 ) {
-			/* Total CPU load */
-			updateCPULoad( buf, &CPULoad );
+		if ( strncmp( "cpu", buf, 3 ) == 0 ) {
+			/* Total CPU load and load for each SMP CPU */
+			updateCPUTicks( buf + 3 );
+			continue;
 		}
-		else if ( strncmp( "cpu", tag, 3 ) == 0 ) {
-			/* Load for each SMP CPU */
-			int id;
-			sscanf( tag + 3, "%d", &id );
-			updateCPULoad( buf, &SMPLoad[ id ]  );
-		}
-		else if ( process24Disk( tag, buf, "disk", 0 ) ) {
+		
+		if ( ( length = strcspn( buf, " " ) ) >= sizeof( tag ) )
+			continue;
+		memcpy( tag, buf, length );
+		tag[ length ] = '\0';
+		
+		if ( process24Disk( tag, buf, "disk", 0 ) ) {
 		}
 		else if ( process24Disk( tag, buf, "disk_rio", 1 ) ) {
 		}
@@ -381,59 +531,56 @@ static void processStat( void ) {
 		}
 		else if ( strcmp( "page", tag ) == 0 ) {
 			unsigned long v1, v2;
-			sscanf( buf + 5, "%lu %lu", &v1, &v2 );
-			PageIn = v1 - OldPageIn;
-			OldPageIn = v1;
-			PageOut = v2 - OldPageOut;
-			OldPageOut = v2;
+			const char* p;
+			if ( ( p = scanULong( buf + 4, &v1 ) ) && scanULong( p, &v2 ) ) {
+				PageIn = v1 - OldPageIn;
+				OldPageIn = v1;
+				PageOut = v2 - OldPageOut;
+				OldPageOut = v2;
+			}
 		}
 		else if ( strcmp( "intr", tag ) == 0 ) {
-			unsigned int i = 0;
-			char* p = buf + 5;
+			/* Only the first values are monitored, the rest of the
+			* line is not even parsed */
+			unsigned int i;
+			const char* p = buf + 4;
 			
 			for ( i = 0; i < NumOfInts; i++ ) {
 				unsigned long val;
 			
-				sscanf( p, "%lu", &val );
+				if ( ( p = scanULong( p, &val ) ) == 0 )
+					break;
 				Intr[ i ] = val - OldIntr[ i ];
 				OldIntr[ i ] = val;
-				while ( *p && *p != ' ' )
-					p++;
-				while ( *p && *p == ' ' )
-					p++;
 			}
 		} else if ( strcmp( "ctxt", tag ) == 0 ) {
 			unsigned long val;
 			
-			sscanf( buf + 5, "%lu", &val );
-			Ctxt = val - OldCtxt;
-			OldCtxt = val;
+			if ( scanULong( buf + 4, &val ) ) {
+				Ctxt = val - OldCtxt;
+				OldCtxt = val;
+			}
 		}
 	}
-    fclose(stat);
+	
+	computeCPULoads();
 	
 	/* Read Linux 2.5.x /proc/vmstat */
-    stat = fopen("/proc/vmstat", "r");
-    if(stat) {
-        while ( fscanf( stat, format, buf ) == 1 ) {
-            buf[ sizeof( buf ) - 1 ] = '\0';
-            sscanf( buf, tagFormat, tag );
-
-            if ( strcmp( "pgpgin", tag ) == 0 ) {
-                unsigned long v1;
-                sscanf( buf + 7, "%lu", &v1 );
-                PageIn = v1 - OldPageIn;
-                OldPageIn = v1;
-            }
-            else if ( strcmp( "pgpgout", tag ) == 0 ) {
-                unsigned long v1;
-                sscanf( buf + 7, "%lu", &v1 );
-                PageOut = v1 - OldPageOut;
-                OldPageOut = v1;
-            }
-        }
-        fclose(stat);
-    }
+	if ( readStatFile( VMStatFD ) >= 0 ) {
+		for ( buf = StatBuf; *buf; buf = next ) {
+			unsigned long v1;
+			
+			next = nextLine( buf );
+			if ( isTag( buf, "pgpgin" ) && scanULong( buf + 6, &v1 ) ) {
+				PageIn = v1 - OldPageIn;
+				OldPageIn = v1;
+			}
+			else if ( isTag( buf, "pgpgout" ) && scanULong( buf + 7, &v1 ) ) {
+				PageOut = v1 - OldPageOut;
+				OldPageOut = v1;
+			}
+		}
+	}
 	
 	/* save exact time interval between this and the last read of /proc/stat */
 	timeInterval = currSampling.tv_sec - lastSampling.tv_sec +
@@ -480,26 +627,29 @@ void initStat( struct SensorModul* sm ) {
 	* and no disk relevant lines are found in /proc/stat
 	*/
 	
-	char format[ 32 ];
-	char tagFormat[ 16 ];
-	char buf[ 1024 ];
 	char tag[ 32 ];
+	char* buf;
+	char* next;
+	size_t length;
 	
 	StatSM = sm;
 	
-	sprintf( format, "%%%d[^\n]\n", (int)sizeof( buf ) - 1 );
-	sprintf( tagFormat, "%%%ds", (int)sizeof( tag ) - 1 );
-
-    FILE *stat = fopen("/proc/stat", "r");
-    if(!stat) {
+	if ( ( StatBuf = (char*)malloc( STATBUFSIZE ) ) != 0 )
+		StatBufSize = STATBUFSIZE;
+	
+	if ( ( StatFD = sysOpen( "/proc/stat", O_RDONLY | O_CLOEXEC ) ) < 0 || readStatFile( StatFD ) < 0 ) {
 		print_error( "Cannot open file \'/proc/stat\'!\n"
 				"The kernel needs to be compiled with support\n"
 				"for /proc file system enabled!\n" );
 		return;
-    }
-	while ( fscanf( stat, format, buf ) == 1 ) {
-		buf[ sizeof( buf ) - 1 ] = '\0';
-		sscanf( buf, tagFormat, tag );
+	}
+	
+	for ( buf = StatBuf; *buf; buf = next ) {
+		next = nextLine( buf );
+		if ( ( length = strcspn( buf, " " ) ) >= sizeof( tag ) )
+			continue;
+		memcpy( tag, buf, length );
+		tag[ length ] = '\0';
 		
 		if ( strcmp( "cpu", tag ) == 0 ) {
 			/* Total CPU load */
@@ -521,22 +671,23 @@ void initStat( struct SensorModul* sm ) {
 		else if ( strncmp( "cpu", tag, 3 ) == 0 ) {
 			char cmdName[ 24 ];
 			/* Load for each SMP CPU */
-			unsigned id;
+			unsigned long id;
 			
-			sscanf( tag + 3, "%d", &id );
+			if ( scanULong( tag + 3, &id ) == 0 )
+				continue;
 			if ( CPUCount < id + 1 )
 				CPUCount = id + 1;
-			sprintf( cmdName, "cpu/cpu%d/user", id );
+			sprintf( cmdName, "cpu/cpu%lu/user", id );
 			registerMonitor( cmdName, "float", printCPUxUser, printCPUxUserInfo, StatSM );
-			sprintf( cmdName, "cpu/cpu%d/nice", id );
+			sprintf( cmdName, "cpu/cpu%lu/nice", id );
 			registerMonitor( cmdName, "float", printCPUxNice, printCPUxNiceInfo, StatSM );
-			sprintf( cmdName, "cpu/cpu%d/sys", id );
+			sprintf( cmdName, "cpu/cpu%lu/sys", id );
 			registerMonitor( cmdName, "float", printCPUxSys, printCPUxSysInfo, StatSM );
-			sprintf( cmdName, "cpu/cpu%d/TotalLoad", id );
+			sprintf( cmdName, "cpu/cpu%lu/TotalLoad", id );
 			registerMonitor( cmdName, "float", printCPUxTotalLoad, printCPUxTotalLoadInfo, StatSM );
-			sprintf( cmdName, "cpu/cpu%d/idle", id );
+			sprintf( cmdName, "cpu/cpu%lu/idle", id );
 			registerMonitor( cmdName, "float", printCPUxIdle, printCPUxIdleInfo, StatSM );
-			sprintf( cmdName, "cpu/cpu%d/wait", id );
+			sprintf( cmdName, "cpu/cpu%lu/wait", id );
 			registerMonitor( cmdName, "float", printCPUxWait, printCPUxWaitInfo, StatSM );
 		}
 		else if ( strcmp( "disk", tag ) == 0 ) {
@@ -561,67 +712,60 @@ void initStat( struct SensorModul* sm ) {
 		else if ( strcmp( "disk_io:", tag ) == 0 )
 			process24DiskIO( buf );
 		else if ( strcmp( "page", tag ) == 0 ) {
-			sscanf( buf + 5, "%lu %lu", &OldPageIn, &OldPageOut );
+			const char* p;
+			if ( ( p = scanULong( buf + 4, &OldPageIn ) ) )
+				scanULong( p, &OldPageOut );
 			registerMonitor( "cpu/pageIn", "float", printPageIn, printPageInInfo, StatSM );
 			registerMonitor( "cpu/pageOut", "float", printPageOut, printPageOutInfo, StatSM );
 		}
 		else if ( strcmp( "intr", tag ) == 0 ) {
 			unsigned int i;
+			unsigned long val;
 			char cmdName[ 32 ];
-			char* p = buf + 5;
+			const char* p = buf + 4;
 			
-			/* Count the number of listed values in the intr line. */
-			NumOfInts = 0;
-			while ( *p )
-				if ( *p++ == ' ' )
-					NumOfInts++;
+			/* The first value is the sum of all interrupts. It looks like
+			* anything above 24 is always 0, so let's just ignore this for
+			* the time being. Large machines list thousands of them. */
+			for ( NumOfInts = 0; NumOfInts < 25 && ( p = scanULong( p, &val ) ); NumOfInts++ )
+				;
 			
-			/* It looks like anything above 24 is always 0. So let's just
-			* ignore this for the time being. */
-			if ( NumOfInts > 25 )
-				NumOfInts = 25;
-			OldIntr = (unsigned long*)malloc( NumOfInts * sizeof( unsigned long ) );
-			Intr = (unsigned long*)malloc( NumOfInts * sizeof( unsigned long ) );
-			i = 0;
-			p = buf + 5;
-			for ( i = 0; p && i < NumOfInts; i++ ) {
-				sscanf( p, "%lu", &OldIntr[ i ] );
-				while ( *p && *p != ' ' )
-					p++;
-				while ( *p && *p == ' ' )
-					p++;
+			OldIntr = (unsigned long*)calloc( NumOfInts, sizeof( unsigned long ) );
+			Intr = (unsigned long*)calloc( NumOfInts, sizeof( unsigned long ) );
+			if ( !OldIntr || !Intr ) {
+				NumOfInts = 0;
+				continue;
+			}
+			p = buf + 4;
+			for ( i = 0; i < NumOfInts; i++ ) {
+				p = scanULong( p, &OldIntr[ i ] );
 				sprintf( cmdName, "cpu/interrupts/int%02d", i );
 				registerMonitor( cmdName, "float", printInterruptx, printInterruptxInfo, StatSM );
 			}
 		}
 		else if ( strcmp( "ctxt", tag ) == 0 ) {
-			sscanf( buf + 5, "%lu", &OldCtxt );
+			scanULong( buf + 4, &OldCtxt );
 			registerMonitor( "cpu/context", "float", printCtxt, printCtxtInfo, StatSM );
 		}
 	}
-    fclose(stat);
 
-	stat = fopen("/proc/vmstat", "r");
-    if(!stat) {
+	if ( ( VMStatFD = sysOpen( "/proc/vmstat", O_RDONLY | O_CLOEXEC ) ) < 0 || readStatFile( VMStatFD ) < 0 ) {
 		print_error( "Cannot open file \'/proc/vmstat\'\n");
-    } else {
-        while ( fscanf( stat, format, buf ) == 1 ) {
-            buf[ sizeof( buf ) - 1 ] = '\0';
-            sscanf( buf, tagFormat, tag );
-
-            if ( strcmp( "pgpgin", tag ) == 0 ) {
-                sscanf( buf + 7, "%lu", &OldPageIn );
-                registerMonitor( "cpu/pageIn", "float", printPageIn, printPageInInfo, StatSM );
-            }
-            else if ( strcmp( "pgpgout", tag ) == 0 ) {
-                sscanf( buf + 7, "%lu", &OldPageOut );
-                registerMonitor( "cpu/pageOut", "float", printPageOut, printPageOutInfo, StatSM );
-            }
-        }
-        fclose(stat);
-    }
-	if ( CPUCount > 0 )
-		SMPLoad = (CPULoadInfo*)calloc( CPUCount, sizeof( CPULoadInfo ) );
+	} else {
+		for ( buf = StatBuf; *buf; buf = next ) {
+			next = nextLine( buf );
+			if ( isTag( buf, "pgpgin" ) ) {
+				scanULong( buf + 6, &OldPageIn );
+				registerMonitor( "cpu/pageIn", "float", printPageIn, printPageInInfo, StatSM );
+			}
+			else if ( isTag( buf, "pgpgout" ) ) {
+				scanULong( buf + 7, &OldPageOut );
+				registerMonitor( "cpu/pageOut", "float", printPageOut, printPageOutInfo, StatSM );
+			}
+		}
+	}
+	if ( allocCPULoads( CPUCount ) < 0 )
+		log_error( "Out of memory, the CPU loads are not available" );
 	
 	/* Call processStat to eliminate initial peek values. */
 	processStat();
@@ -631,14 +775,24 @@ void exitStat( void ) {
 	free( DiskLoad );
 	DiskLoad = 0;
 	
-	free( SMPLoad );
-	SMPLoad = 0;
+	freeCPULoads();
+	CPUCount = 0;
 	
 	free( OldIntr );
 	OldIntr = 0;
 	
 	free( Intr );
 	Intr = 0;
+	NumOfInts = 0;
+	
+	if ( StatFD >= 0 )
+		close( StatFD );
+	if ( VMStatFD >= 0 )
+		close( VMStatFD );
+	StatFD = VMStatFD = -1;
+	free( StatBuf );
+	StatBuf = 0;
+	StatBufSize = 0;
 	
 	removeMonitor("cpu/system/user");
 	removeMonitor("cpu/system/nice");
@@ -663,10 +817,7 @@ int updateStat( void )
 void printCPUUser( const char* cmd ) {
 	(void)cmd;
 	
-	if ( StatDirty )
-		processStat();
-	
-	output( "%f\n", CPULoad.userLoad );
+	output( "%f\n", cpuLoad( CPU_USER ) );
 }
 
 void printCPUUserInfo( const char* cmd ) {
@@ -678,10 +829,7 @@ void printCPUUserInfo( const char* cmd ) {
 void printCPUNice( const char* cmd ) {
 	(void)cmd;
 	
-	if ( StatDirty )
-		processStat();
-	
-	output( "%f\n", CPULoad.niceLoad );
+	output( "%f\n", cpuLoad( CPU_NICE ) );
 }
 
 void printCPUNiceInfo( const char* cmd ) {
@@ -693,10 +841,7 @@ void printCPUNiceInfo( const char* cmd ) {
 void printCPUSys( const char* cmd ) {
 	(void)cmd;
 	
-	if ( StatDirty )
-		processStat();
-	
-	output( "%f\n", CPULoad.sysLoad );
+	output( "%f\n", cpuLoad( CPU_SYS ) );
 }
 
 void printCPUSysInfo( const char* cmd ) {
@@ -708,10 +853,7 @@ void printCPUSysInfo( const char* cmd ) {
 void printCPUTotalLoad( const char* cmd ) {
 	(void)cmd;
 	
-	if ( StatDirty )
-		processStat();
-	
-	output( "%f\n", CPULoad.userLoad + CPULoad.sysLoad + CPULoad.niceLoad + CPULoad.waitLoad );
+	output( "%f\n", cpuLoad( CPU_USER ) + cpuLoad( CPU_SYS ) + cpuLoad( CPU_NICE ) + cpuLoad( CPU_WAIT ) );
 }
 
 void printCPUTotalLoadInfo( const char* cmd ) {
@@ -723,10 +865,7 @@ void printCPUTotalLoadInfo( const char* cmd ) {
 void printCPUIdle( const char* cmd ) {
 	(void)cmd;
 	
-	if ( StatDirty )
-		processStat();
-	
-	output( "%f\n", CPULoad.idleLoad );
+	output( "%f\n", cpuLoad( CPU_IDLE ) );
 }
 
 void printCPUIdleInfo( const char* cmd ) {
@@ -739,10 +878,7 @@ void printCPUWait( const char* cmd )
 {
 	(void)cmd;
 
-	if ( StatDirty )
-		processStat();
-
-	output( "%f\n", CPULoad.waitLoad );
+	output( "%f\n", cpuLoad( CPU_WAIT ) );
 }
 
 void printCPUWaitInfo( const char* cmd )
@@ -752,13 +888,7 @@ void printCPUWaitInfo( const char* cmd )
 }
 
 void printCPUxUser( const char* cmd ) {
-	int id;
-	
-	if ( StatDirty )
-		processStat();
-	
-	sscanf( cmd + 7, "%d", &id );
-	output( "%f\n", SMPLoad[ id ].userLoad );
+	output( "%f\n", cpuxLoad( cmd, CPU_USER ) );
 }
 
 void printCPUxUserInfo( const char* cmd ) {
@@ -769,13 +899,7 @@ void printCPUxUserInfo( const char* cmd ) {
 }
 
 void printCPUxNice( const char* cmd ) {
-	int id;
-	
-	if ( StatDirty )
-		processStat();
-	
-	sscanf( cmd + 7, "%d", &id );
-	output( "%f\n", SMPLoad[ id ].niceLoad );
+	output( "%f\n", cpuxLoad( cmd, CPU_NICE ) );
 }
 
 void printCPUxNiceInfo( const char* cmd ) {
@@ -786,13 +910,7 @@ void printCPUxNiceInfo( const char* cmd ) {
 }
 
 void printCPUxSys( const char* cmd ) {
-	int id;
-	
-	if ( StatDirty )
-		processStat();
-	
-	sscanf( cmd + 7, "%d", &id );
-	output( "%f\n", SMPLoad[ id ].sysLoad );
+	output( "%f\n", cpuxLoad( cmd, CPU_SYS ) );
 }
 
 void printCPUxSysInfo( const char* cmd ) {
@@ -803,13 +921,8 @@ void printCPUxSysInfo( const char* cmd ) {
 }
 
 void printCPUxTotalLoad( const char* cmd ) {
-	int id;
-	
-	if ( StatDirty )
-		processStat();
-	
-	sscanf( cmd + 7, "%d", &id );
-	output( "%f\n", SMPLoad[ id ].userLoad + SMPLoad[ id ].sysLoad + SMPLoad[ id ].niceLoad + SMPLoad[ id ].waitLoad );
+	output( "%f\n", cpuxLoad( cmd, CPU_USER ) + cpuxLoad( cmd, CPU_SYS ) + cpuxLoad( cmd, CPU_NICE ) +
+		cpuxLoad( cmd, CPU_WAIT ) );
 }
 
 void printCPUxTotalLoadInfo( const char* cmd ) {
@@ -820,13 +933,7 @@ void printCPUxTotalLoadInfo( const char* cmd ) {
 }
 
 void printCPUxIdle( const char* cmd ) {
-	int id;
-	
-	if ( StatDirty )
-		processStat();
-	
-	sscanf( cmd + 7, "%d", &id );
-	output( "%f\n", SMPLoad[ id ].idleLoad );
+	output( "%f\n", cpuxLoad( cmd, CPU_IDLE ) );
 }
 
 void printCPUxIdleInfo( const char* cmd ) {
@@ -838,13 +945,7 @@ void printCPUxIdleInfo( const char* cmd ) {
 
 void printCPUxWait( const char* cmd )
 {
-	int id;
-
-	if ( StatDirty )
-		processStat();
-
-	sscanf( cmd + 7, "%d", &id );
-	output( "%f\n", SMPLoad[ id ].waitLoad );
+	output( "%f\n", cpuxLoad( cmd, CPU_WAIT ) );
 }
 
 void printCPUxWaitInfo( const char* cmd )
@@ -988,7 +1089,7 @@ void printInterruptx( const char* cmd ) {
 void printInterruptxInfo( const char* cmd ) {
 	int id;
 	
-	sscanf( cmd + strlen( "cpu/interrupt/int" ), "%d", &id );
+	sscanf( cmd + strlen( "cpu/interrupts/int" ), "%d", &id );
 	output( "Interrupt %d\t0\t0\t1/s\n", id );
 }
 
@@ -32,6 +32,7 @@
 
 #include "Command.h"
 #include "ksysguardd.h"
+#include "SysRoot.h"
 
 #include "uptime.h"
 
@@ -101,7 +102,7 @@ static void openUptimeFile() {
 	int fd;
 
 	UptimeBuf[ 0 ] = '\0';
-	if ( ( fd = open( "/proc/uptime", O_RDONLY ) ) < 0 )
+	if ( ( fd = sysOpen( "/proc/uptime", O_RDONLY ) ) < 0 )
 		return; /* couldn't open /proc/uptime */
 	
 	n = read( fd, UptimeBuf, UPTIMEBUFSIZE - 1 );
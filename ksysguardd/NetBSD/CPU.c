@@ -91,49 +91,49 @@ updateCpuInfo(void)
 void
 printCPUUser(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", cpu_states[CP_USER]/10);
+	output("%d\n", cpu_states[CP_USER]/10);
 }
 
 void
 printCPUUserInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "CPU User Load\t0\t100\t%%\n");
+	output("CPU User Load\t0\t100\t%%\n");
 }
 
 void
 printCPUNice(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", cpu_states[CP_NICE]/10);
+	output("%d\n", cpu_states[CP_NICE]/10);
 }
 
 void
 printCPUNiceInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "CPU Nice Load\t0\t100\t%%\n");
+	output("CPU Nice Load\t0\t100\t%%\n");
 }
 
 void
 printCPUSys(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", cpu_states[CP_SYS]/10);
+	output("%d\n", cpu_states[CP_SYS]/10);
 }
 
 void
 printCPUSysInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "CPU System Load\t0\t100\t%%\n");
+	output("CPU System Load\t0\t100\t%%\n");
 }
 
 void
 printCPUIdle(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", cpu_states[CP_IDLE]/10);
+	output("%d\n", cpu_states[CP_IDLE]/10);
 }
 
 void
 printCPUIdleInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "CPU Idle Load\t0\t100\t%%\n");
+	output("CPU Idle Load\t0\t100\t%%\n");
 }
 
 
@@ -113,107 +113,107 @@ updateMemory(void)
 void
 printMFree(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", MFree);
+	output("%d\n", MFree);
 }
 
 void
 printMFreeInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "Free Memory\t0\t%d\tKB\n", Total);
+	output("Free Memory\t0\t%d\tKB\n", Total);
 }
 
 void
 printUsed(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", Used);
+	output("%d\n", Used);
 }
 
 void
 printUsedInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "Used Memory\t0\t%d\tKB\n", Total);
+	output("Used Memory\t0\t%d\tKB\n", Total);
 }
 
 void
 printActive(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", Active);
+	output("%d\n", Active);
 }
 
 void
 printActiveInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "Active Memory\t0\t%d\tKB\n", Total);
+	output("Active Memory\t0\t%d\tKB\n", Total);
 }
 
 void
 printInactive(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", Inactive);
+	output("%d\n", Inactive);
 }
 
 void
 printInactiveInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "Inactive Memory\t0\t%d\tKB\n", Total);
+	output("Inactive Memory\t0\t%d\tKB\n", Total);
 }
 
 void
 printWired(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", Wired);
+	output("%d\n", Wired);
 }
 
 void
 printWiredInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "Wired Memory\t0\t%d\tKB\n", Total);
+	output("Wired Memory\t0\t%d\tKB\n", Total);
 }
 
 void
 printExecpages(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", Execpages);
+	output("%d\n", Execpages);
 }
 
 void
 printExecpagesInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "Exec Pages\t0\t%d\tKB\n", Total);
+	output("Exec Pages\t0\t%d\tKB\n", Total);
 }
 
 void
 printFilepages(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", Filepages);
+	output("%d\n", Filepages);
 }
 
 void
 printFilepagesInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "File Pages\t0\t%d\tKB\n", Total);
+	output("File Pages\t0\t%d\tKB\n", Total);
 }
 
 void
 printSwapUsed(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", SUsed);
+	output("%d\n", SUsed);
 }
 
 void
 printSwapUsedInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "Used Swap Memory\t0\t%d\tKB\n", STotal);
+	output("Used Swap Memory\t0\t%d\tKB\n", STotal);
 }
 
 void
 printSwapFree(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", SFree);
+	output("%d\n", SFree);
 }
 
 void
 printSwapFreeInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "Free Swap Memory\t0\t%d\tKB\n", STotal);
+	output("Free Swap Memory\t0\t%d\tKB\n", STotal);
 }
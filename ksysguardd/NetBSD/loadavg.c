@@ -69,35 +69,35 @@ updateLoadAvg(void)
 void
 printLoadAvg1(const char* c)
 {
-	fprintf(CurrentClient, "%f\n", LoadAvg[0]);
+	output("%f\n", LoadAvg[0]);
 }
 
 void
 printLoadAvg1Info(const char* c)
 {
-	fprintf(CurrentClient, "Load average 1 min\t0\t0\t\n");
+	output("Load average 1 min\t0\t0\t\n");
 }
 
 void
 printLoadAvg5(const char* c)
 {
-	fprintf(CurrentClient, "%f\n", LoadAvg[1]);
+	output("%f\n", LoadAvg[1]);
 }
 
 void
 printLoadAvg5Info(const char* c)
 {
-	fprintf(CurrentClient, "Load average 5 min\t0\t0\t\n");
+	output("Load average 5 min\t0\t0\t\n");
 }
 
 void
 printLoadAvg15(const char* c)
 {
-	fprintf(CurrentClient, "%f\n", LoadAvg[2]);
+	output("%f\n", LoadAvg[2]);
 }
 
 void
 printLoadAvg15Info(const char* c)
 {
-	fprintf(CurrentClient, "Load average 15 min\t0\t0\t\n");
+	output("Load average 15 min\t0\t0\t\n");
 }
@@ -39,8 +39,6 @@ typedef struct {
 	unsigned long id;
 } LogFileEntry;
 
-extern CONTAINER LogFileList;
-
 /*
 ================================ public part =================================
 */
@@ -49,14 +47,16 @@ void initLogFile(struct SensorModul* sm)
 {
 	char monitor[1024];
 	ConfigLogFile *entry;
+	INDEX i;
 
 	registerCommand("logfile_register", registerLogFile);
 	registerCommand("logfile_unregister", unregisterLogFile);
 	registerCommand("logfile_registered", printRegistered);
 
-	for (entry = first_ctnr(LogFileList); entry; entry = next_ctnr(LogFileList))
+	for (i = 0; i < level_vctr(LogFileList); i++)
 	{
 		FILE* fp;
+		entry = get_vctr(LogFileList, i);
 
 		/* register the log file if we can actually read the file. */
 		if ((fp = fopen(entry->path, "r")) != NULL)
@@ -89,18 +89,18 @@ void printLogFile(const char* cmd)
 	for (entry = first_ctnr(LogFiles); entry; entry = next_ctnr(LogFiles)) {
 		if (entry->id == id) {
 			while (fgets(line, sizeof(line), entry->fh) != NULL) {
-				fprintf(CurrentClient, "%s", line);
+				output("%s", line);
 			}
 			clearerr(entry->fh);
 		}
 	}
 
-	fprintf(CurrentClient, "\n");
+	output("\n");
 }
 
 void printLogFileInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "LogFile\n");
+	output("LogFile\n");
 }
 
 void registerLogFile(const char* cmd)
@@ -109,15 +109,17 @@ void registerLogFile(const char* cmd)
 	FILE* file;
 	LogFileEntry *entry;
 	ConfigLogFile *conf;
+	INDEX i;
 
 	memset(name, 0, sizeof(name));
 	sscanf(cmd, "%*s %256s", name);
 	
-	for (conf = first_ctnr(LogFileList); conf; conf = next_ctnr(LogFileList)) {
+	for (i = 0; i < level_vctr(LogFileList); i++) {
+		conf = get_vctr(LogFileList, i);
 		if (!strcmp(conf->name, name)) {
 			if ((file = fopen(conf->path, "r")) == NULL) {
 				print_error("fopen()");
-				fprintf(CurrentClient, "0\n");
+				output("0\n");
 				return;
 			}
 
@@ -125,7 +127,7 @@ void registerLogFile(const char* cmd)
 
 			if ((entry = (LogFileEntry *)malloc(sizeof(LogFileEntry))) == NULL) {
 				print_error("malloc()");
-				fprintf(CurrentClient, "0\n");
+				output("0\n");
 				return;
 			}
 
@@ -135,14 +137,14 @@ void registerLogFile(const char* cmd)
 
 			push_ctnr(LogFiles, entry);	
 
-			fprintf(CurrentClient, "%lu\n", counter);
+			output("%lu\n", counter);
 			counter++;
 
 			return;
 		}
 	}
 
-	fprintf(CurrentClient, "0\n");
+	output("0\n");
 }
 
 void unregisterLogFile(const char* cmd)
@@ -156,12 +158,12 @@ void unregisterLogFile(const char* cmd)
 		if (entry->id == id) {
 			fclose(entry->fh);
 			free(remove_ctnr(LogFiles));
-			fprintf(CurrentClient, "\n");
+			output("\n");
 			return;
 		}
 	}
 
-	fprintf(CurrentClient, "\n");
+	output("\n");
 }
 
 void printRegistered(const char* cmd)
@@ -169,7 +171,7 @@ void printRegistered(const char* cmd)
 	LogFileEntry *entry;
 
 	for (entry = first_ctnr(LogFiles); entry; entry = next_ctnr(LogFiles))
-		fprintf(CurrentClient, "%s:%lu\n", entry->name, entry->id);
+		output("%s:%lu\n", entry->name, entry->id);
 
-	fprintf(CurrentClient, "\n");
+	output("\n");
 }
@@ -190,10 +190,10 @@ static void prVal(const char *cmd, int N) {
   p++;
   for (i=0; i<LEN(opTable[0].op); i++)
     if (!strcmp(p, opTable[N].op[i].label))
-      fprintf(CurrentClient, "%lu",
+      output("%lu",
 	      /*fixme: ugly and presumptuous */
 	      (N?NetDevs[d].Dsent:NetDevs[d].Drecv)[opTable[N].op[i].index]);
-  fprintf(CurrentClient, "\n");
+  output("\n");
 }
 
 
@@ -210,7 +210,7 @@ static void prInfo(const char *cmd, int N) {
 
   for (i=0; i<LEN(opTable[0].op); i++)
     if (!strcmp(p, opTable[N].op[i].label))
-      fputs(opTable[N].op[i].info, CurrentClient);
+      output("%s", opTable[N].op[i].info);
   *q='?';
 }
 
@@ -347,8 +347,8 @@ updateProcessList(void)
 void
 printProcessListInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "Name\tPID\tPPID\tUID\tGID\tStatus\tUser%%\tSystem%%\tNice\tVmSize\tVmRss\tLogin\tCommand\n");
-	fprintf(CurrentClient, "s\td\td\td\td\tS\tf\tf\td\tD\tD\ts\ts\n");
+	output("Name\tPID\tPPID\tUID\tGID\tStatus\tUser%%\tSystem%%\tNice\tVmSize\tVmRss\tLogin\tCommand\n");
+	output("s\td\td\td\td\tS\tf\tf\td\tD\tD\ts\ts\n");
 }
 
 void
@@ -358,7 +358,7 @@ printProcessList(const char* cmd)
 
 	for (ps = first_ctnr(ProcessList); ps; ps = next_ctnr(ProcessList))
 	{
-		fprintf(CurrentClient, "%s\t%ld\t%ld\t%ld\t%ld\t%s\t%.2f\t%.2f\t%d\t%d\t%d\t%s\t%s\n",
+		output("%s\t%ld\t%ld\t%ld\t%ld\t%s\t%.2f\t%.2f\t%d\t%d\t%d\t%s\t%s\n",
 			   ps->name, (long)ps->pid, (long)ps->ppid,
 			   (long)ps->uid, (long)ps->gid, ps->status,
 			   ps->userLoad, ps->sysLoad, ps->niceLevel,
@@ -369,13 +369,13 @@ printProcessList(const char* cmd)
 void
 printProcessCount(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", ProcessCount);
+	output("%d\n", ProcessCount);
 }
 
 void
 printProcessCountInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "Number of Processes\t1\t65535\t\n");
+	output("Number of Processes\t1\t65535\t\n");
 }
 
 void
@@ -449,22 +449,22 @@ killProcess(const char* cmd)
 		switch(errno)
 		{
 		case EINVAL:
-			fprintf(CurrentClient, "4\t%d\n", pid);
+			output("4\t%d\n", pid);
 			break;
 		case ESRCH:
-			fprintf(CurrentClient, "3\t%d\n", pid);
+			output("3\t%d\n", pid);
 			break;
 		case EPERM:
-			fprintf(CurrentClient, "2\t%d\n", pid);
+			output("2\t%d\n", pid);
 			break;
 		default:
-			fprintf(CurrentClient, "1\t%d\n", pid);	/* unknown error */
+			output("1\t%d\n", pid);	/* unknown error */
 			break;
 		}
 
 	}
 	else
-		fprintf(CurrentClient, "0\t%d\n", pid);
+		output("0\t%d\n", pid);
 }
 
 void
@@ -478,20 +478,20 @@ setPriority(const char* cmd)
 		switch(errno)
 		{
 		case EINVAL:
-			fprintf(CurrentClient, "4\n");
+			output("4\n");
 			break;
 		case ESRCH:
-			fprintf(CurrentClient, "3\n");
+			output("3\n");
 			break;
 		case EPERM:
 		case EACCES:
-			fprintf(CurrentClient, "2\n");
+			output("2\n");
 			break;
 		default:
-			fprintf(CurrentClient, "1\n");	/* unknown error */
+			output("1\n");	/* unknown error */
 			break;
 		}
 	}
 	else
-		fprintf(CurrentClient, "0\n");
+		output("0\n");
 }
@@ -114,85 +114,85 @@ updateMemory(void)
 void
 printMFree(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", MFree);
+	output("%d\n", MFree);
 }
 
 void
 printMFreeInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "Free Memory\t0\t%d\tKB\n", Total);
+	output("Free Memory\t0\t%d\tKB\n", Total);
 }
 
 void
 printUsed(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", Used);
+	output("%d\n", Used);
 }
 
 void
 printUsedInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "Used Memory\t0\t%d\tKB\n", Total);
+	output("Used Memory\t0\t%d\tKB\n", Total);
 }
 
 void
 printApplication(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", Application);
+	output("%d\n", Application);
 }
 
 void
 printApplicationInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "Application Memory\t0\t%ld\tKB\n", Total);
+	output("Application Memory\t0\t%ld\tKB\n", Total);
 }
 
 void
 printActive(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", Active);
+	output("%d\n", Active);
 }
 
 void
 printActiveInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "Active Memory\t0\t%d\tKB\n", Total);
+	output("Active Memory\t0\t%d\tKB\n", Total);
 }
 
 void
 printInActive(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", InActive);
+	output("%d\n", InActive);
 }
 
 void
 printInActiveInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "InActive Memory\t0\t%d\tKB\n", Total);
+	output("InActive Memory\t0\t%d\tKB\n", Total);
 }
 
 void
 printSwapUsed(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", SUsed);
+	output("%d\n", SUsed);
 }
 
 void
 printSwapUsedInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "Used Swap Memory\t0\t%d\tKB\n", STotal);
+	output("Used Swap Memory\t0\t%d\tKB\n", STotal);
 }
 
 void
 printSwapFree(const char* cmd)
 {
-	fprintf(CurrentClient, "%d\n", SFree);
+	output("%d\n", SFree);
 }
 
 void
 printSwapFreeInfo(const char* cmd)
 {
-	fprintf(CurrentClient, "Free Swap Memory\t0\t%d\tKB\n", STotal);
+	output("Free Swap Memory\t0\t%d\tKB\n", STotal);
 }
 
 /*
@@ -0,0 +1,265 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#define _XOPEN_SOURCE 700 /* writev, va_copy */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "OutputSink.h"
+
+/* Default size of a chunk. Bigger answers get a chunk of their own size. */
+#define CHUNKSIZE 16384
+
+/* Maximum number of chunks handed to a single writev() */
+#define MAX_IOVECS 64
+
+typedef struct OutputChunk {
+  struct OutputChunk* next;
+  size_t size;
+  /* Bytes stored in data */
+  size_t length;
+  /* Bytes of data that have been sent already */
+  size_t offset;
+  char data[];
+} OutputChunk;
+
+static OutputChunk* appendChunk( OutputSink* sink, size_t size )
+{
+  OutputChunk* chunk;
+
+  if ( size < CHUNKSIZE )
+    size = CHUNKSIZE;
+
+  if ( ( chunk = (OutputChunk*)malloc( sizeof( OutputChunk ) + size ) ) == NULL ) {
+    sink->failed = 1;
+    return NULL;
+  }
+
+  chunk->next = NULL;
+  chunk->size = size;
+  chunk->length = 0;
+  chunk->offset = 0;
+
+  if ( sink->last )
+    sink->last->next = chunk;
+  else
+    sink->first = chunk;
+  sink->last = chunk;
+
+  return chunk;
+}
+
+/**
+  Checks whether @ref length more bytes fit into the sink.
+ */
+static int reserve( OutputSink* sink, size_t length )
+{
+  if ( sink->failed )
+    return 0;
+
+  if ( sink->limit && sink->pending + length > sink->limit ) {
+    sink->failed = 1;
+    return 0;
+  }
+
+  return 1;
+}
+
+void initSink( OutputSink* sink, int fd, size_t highWaterMark, size_t limit )
+{
+  sink->fd = fd;
+  sink->first = NULL;
+  sink->last = NULL;
+  sink->pending = 0;
+  sink->highWaterMark = highWaterMark;
+  sink->limit = limit;
+  sink->failed = 0;
+  sink->sent = 0;
+}
+
+void clearSink( OutputSink* sink )
+{
+  OutputChunk* chunk = sink->first;
+
+  while ( chunk ) {
+    OutputChunk* next = chunk->next;
+    free( chunk );
+    chunk = next;
+  }
+
+  sink->first = NULL;
+  sink->last = NULL;
+  sink->pending = 0;
+}
+
+void sinkWrite( OutputSink* sink, const char* data, size_t length )
+{
+  OutputChunk* chunk = sink->last;
+
+  if ( length == 0 || !reserve( sink, length ) )
+    return;
+
+  if ( !chunk || chunk->size - chunk->length < length ) {
+    /* Fill up the current chunk first so that they stay dense */
+    if ( chunk && chunk->size > chunk->length ) {
+      size_t part = chunk->size - chunk->length;
+      memcpy( chunk->data + chunk->length, data, part );
+      chunk->length += part;
+      sink->pending += part;
+      data += part;
+      length -= part;
+    }
+
+    if ( ( chunk = appendChunk( sink, length ) ) == NULL )
+      return;
+  }
+
+  memcpy( chunk->data + chunk->length, data, length );
+  chunk->length += length;
+  sink->pending += length;
+}
+
+void sinkVPrintf( OutputSink* sink, const char* fmt, va_list az )
+{
+  OutputChunk* chunk = sink->last;
+  size_t space = chunk ? chunk->size - chunk->length : 0;
+  va_list copy;
+  int length;
+
+  if ( sink->failed )
+    return;
+
+  /* Try to format directly into the free space of the last chunk */
+  va_copy( copy, az );
+  length = vsnprintf( chunk ? chunk->data + chunk->length : NULL, space, fmt, copy );
+  va_end( copy );
+
+  if ( length <= 0 )
+    return;
+
+  if ( (size_t)length >= space ) {
+    /* Did not fit, vsnprintf() told us how much room we need. The
+     * terminating zero is not part of the output but needs room. */
+    if ( !reserve( sink, length ) || ( chunk = appendChunk( sink, length + 1 ) ) == NULL )
+      return;
+    vsnprintf( chunk->data, chunk->size, fmt, az );
+  } else if ( !reserve( sink, length ) )
+    return;
+
+  chunk->length += length;
+  sink->pending += length;
+}
+
+void sinkPrintf( OutputSink* sink, const char* fmt, ... )
+{
+  va_list az;
+
+  va_start( az, fmt );
+  sinkVPrintf( sink, fmt, az );
+  va_end( az );
+}
+
+int flushSink( OutputSink* sink )
+{
+  if ( sink->fd < 0 )
+    return sink->pending ? 1 : 0;
+
+  while ( sink->first ) {
+    struct iovec iov[ MAX_IOVECS ];
+    OutputChunk* chunk;
+    ssize_t written;
+    int count = 0;
+
+    for ( chunk = sink->first; chunk && count < MAX_IOVECS; chunk = chunk->next ) {
+      iov[ count ].iov_base = chunk->data + chunk->offset;
+      iov[ count ].iov_len = chunk->length - chunk->offset;
+      ++count;
+    }
+
+    if ( ( written = writev( sink->fd, iov, count ) ) < 0 ) {
+      if ( errno == EINTR )
+        continue;
+      if ( errno == EAGAIN || errno == EWOULDBLOCK )
+        return 1;
+
+      sink->failed = 1;
+      return -1;
+    }
+
+    sink->pending -= written;
+    sink->sent += written;
+
+    /* Release the chunks that have been sent completely */
+    while ( ( chunk = sink->first ) && written >= (ssize_t)( chunk->length - chunk->offset ) ) {
+      written -= chunk->length - chunk->offset;
+      sink->first = chunk->next;
+      free( chunk );
+    }
+
+    if ( chunk )
+      chunk->offset += written;
+    else
+      sink->last = NULL;
+  }
+
+  return 0;
+}
+
+int sinkIsCongested( const OutputSink* sink )
+{
+  return sink->failed || sink->pending > sink->highWaterMark;
+}
+
+int sinkLastChar( const OutputSink* sink )
+{
+  const OutputChunk* chunk = sink->last;
+
+  if ( !chunk || chunk->length == chunk->offset )
+    return -1;
+
+  return (unsigned char)chunk->data[ chunk->length - 1 ];
+}
+
+char* sinkToString( const OutputSink* sink, size_t* length )
+{
+  OutputChunk* chunk;
+  char* result;
+  char* p;
+
+  if ( ( result = (char*)malloc( sink->pending + 1 ) ) == NULL )
+    return NULL;
+
+  p = result;
+  for ( chunk = sink->first; chunk; chunk = chunk->next ) {
+    memcpy( p, chunk->data + chunk->offset, chunk->length - chunk->offset );
+    p += chunk->length - chunk->offset;
+  }
+  *p = '\0';
+
+  if ( length )
+    *length = sink->pending;
+
+  return result;
+}
@@ -0,0 +1,108 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#ifndef KSG_OUTPUTSINK_H
+#define KSG_OUTPUTSINK_H
+
+#include <stdarg.h>
+#include <stddef.h>
+
+struct OutputChunk;
+
+/**
+  An OutputSink collects the answers of the modules. Data is appended
+  to a list of chunks, so large answers like the process list are never
+  copied around. A sink is either connected to a file descriptor and
+  sent with flushSink(), or it is a memory sink (fd -1) whose contents
+  can be fetched with sinkToString().
+ */
+typedef struct OutputSink {
+  int fd;
+
+  struct OutputChunk* first;
+  struct OutputChunk* last;
+
+  /* Number of bytes that have not been sent yet */
+  size_t pending;
+
+  /**
+    The owner should stop producing more output for this sink while
+    more than highWaterMark bytes are pending.
+   */
+  size_t highWaterMark;
+
+  /**
+    Output beyond this many pending bytes is discarded and the sink is
+    marked as failed. 0 means no limit.
+   */
+  size_t limit;
+
+  /* Set on write errors and overflows. The owner should drop the sink. */
+  int failed;
+
+  /* Number of bytes that have been sent in total */
+  unsigned long long sent;
+} OutputSink;
+
+/**
+  Initializes @ref sink for the file descriptor @ref fd. Pass -1 to
+  create a memory sink.
+ */
+void initSink( OutputSink* sink, int fd, size_t highWaterMark, size_t limit );
+
+/**
+  Frees all pending data. The file descriptor is not closed.
+ */
+void clearSink( OutputSink* sink );
+
+void sinkWrite( OutputSink* sink, const char* data, size_t length );
+
+void sinkPrintf( OutputSink* sink, const char* fmt, ... )
+#ifdef __GNUC__
+    __attribute__ (  (  format (  printf, 2, 3 ) ) )
+#endif
+    ;
+
+void sinkVPrintf( OutputSink* sink, const char* fmt, va_list az );
+
+/**
+  Writes as much pending data as possible without blocking, unless the
+  file descriptor itself is blocking.
+  @return 0 if everything has been sent, 1 if data is still pending
+  and -1 on errors.
+ */
+int flushSink( OutputSink* sink );
+
+/**
+  @return 1 if the owner should not queue more output right now.
+ */
+int sinkIsCongested( const OutputSink* sink );
+
+/**
+  @return the last byte that has been added to @ref sink and is still
+  pending, or -1 if nothing is pending.
+ */
+int sinkLastChar( const OutputSink* sink );
+
+/**
+  @return the pending data as a newly allocated, zero terminated
+  string. The caller has to free it. The sink is not modified.
+ */
+char* sinkToString( const OutputSink* sink, size_t* length );
+
+#endif
@@ -18,36 +18,58 @@
 
 */
 
-#define _POSIX_C_SOURCE 200809L /* strdup */
+#define _POSIX_C_SOURCE 200809L /* strdup, getpwuid_r */
+#define _DEFAULT_SOURCE /* getpwent */
 
+#include <pthread.h>
 #include <pwd.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
 #include <time.h>
 
-#include "ccont.h"
+#include "htbl.h"
 
 #include "PWUIDCache.h"
 
-/* Cached values become invalid after 5 minutes */
+/* The passwd database is read again every 5 minutes, entries that have
+ * not been asked for since then and are not in it are removed */
 #define TIMEOUT 300
 
-typedef struct {
+typedef struct CachedPWUID {
   uid_t uid;
+  /* The numeric uid until the name has been looked up */
   char* uName;
+  int resolved;
+  /* The last time the name has been asked for */
   time_t tStamp;
+  /* The Refresh that has last set the name */
+  unsigned long refresh;
+  /* The next entry of the Pending list if queued is set */
+  struct CachedPWUID* nextPending;
+  int queued;
 } CachedPWUID;
 
-static CONTAINER UIDCache = 0;
-static time_t lastCleanup = 0;
+/* Maps the uid to its CachedPWUID, the key is the uid in the entry.
+ * UIDLock guards the table and the rest of the state, the lookups run
+ * on the Resolver thread without it. */
+static HTBL UIDCache = 0;
+static pthread_mutex_t UIDLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t Wakeup = PTHREAD_COND_INITIALIZER;
 
-void PWUIDCache_cleanup( void* c );
+/* The entries that wait for their lookup, the newest first */
+static CachedPWUID* Pending = 0;
 
-static int uidCmp( void* p1, void* p2 )
-{
-  return ( ((CachedPWUID*)p1)->uid - ((CachedPWUID*)p2)->uid );
-}
+/* 1 while the Resolver runs, -1 if it cannot be started */
+static pthread_t Resolver;
+static int ResolverState = 0;
+static int Stop = 0;
+
+/* Counts the times the passwd database has been read */
+static unsigned long Refresh = 0;
+
+void PWUIDCache_cleanup( void* c );
 
 void PWUIDCache_cleanup( void* c )
 {
@@ -56,56 +78,221 @@ void PWUIDCache_cleanup( void* c )
   free ( c );
 }
 
-void initPWUIDCache()
+/**
+  Replaces the name of @ref entry, without memory it keeps the old one.
+ */
+static void setName( CachedPWUID* entry, const char* name )
 {
-  UIDCache = new_ctnr();
+  char* copy;
+
+  if ( ( copy = strdup( name ) ) == NULL )
+    return;
+
+  free( entry->uName );
+  entry->uName = copy;
+  entry->resolved = 1;
+  entry->refresh = Refresh;
 }
 
-void exitPWUIDCache()
+/**
+  @return the entry of @ref uid or 0 if there is no memory. A new entry
+  has the numeric uid as its name. Must be called with UIDLock held.
+ */
+static CachedPWUID* entryOf( uid_t uid )
 {
-  destr_ctnr( UIDCache, PWUIDCache_cleanup );
+  CachedPWUID* entry;
+  char number[ 16 ];
+
+  if ( ( entry = get_htbl( UIDCache, &uid, sizeof( uid_t ) ) ) != NULL )
+    return entry;
+
+  snprintf( number, sizeof( number ), "%lu", (unsigned long)uid );
+  if ( ( entry = (CachedPWUID*)calloc( 1, sizeof( CachedPWUID ) ) ) == NULL ||
+       ( entry->uName = strdup( number ) ) == NULL ) {
+    PWUIDCache_cleanup( entry );
+    return NULL;
+  }
+  entry->uid = uid;
+  entry->tStamp = time( 0 );
+
+  if ( put_htbl( UIDCache, &entry->uid, sizeof( uid_t ), entry ) < 0 ) {
+    PWUIDCache_cleanup( entry );
+    return NULL;
+  }
+
+  return entry;
 }
 
-const char* getCachedPWUID( uid_t uid )
+static void queueLookup( CachedPWUID* entry )
 {
-  CachedPWUID key;
-  CachedPWUID* entry = 0;
-  long idx;
-  time_t stamp;
-
-  stamp = time( 0 );
-  if ( stamp - lastCleanup > TIMEOUT ) {
-    /* Cleanup cache entries every TIMEOUT seconds so that we
-     * don't pile tons of unused entries, and to make sure that
-     * our entries are not outdated. */
-    for ( entry = first_ctnr( UIDCache ); entry; entry = next_ctnr( UIDCache ) ) {
-      /* If a cache entry has not been updated for TIMEOUT
-       * seconds the entry is removed. */
-      if ( stamp - entry->tStamp > TIMEOUT )
-        PWUIDCache_cleanup( remove_ctnr( UIDCache ) );
-    }
+  if ( entry->queued )
+    return;
+
+  entry->queued = 1;
+  entry->nextPending = Pending;
+  Pending = entry;
+  pthread_cond_signal( &Wakeup );
+}
+
+/**
+  Looks up @ref uid in the passwd database, which blocks as long as a
+  directory service takes to answer. A uid without a user gets "?".
+ */
+static void lookupName( uid_t uid, char* name, size_t size )
+{
+  struct passwd pwent;
+  struct passwd* result = NULL;
+  char buffer[ 16384 ];
 
-    lastCleanup = stamp;
+  if ( getpwuid_r( uid, &pwent, buffer, sizeof( buffer ), &result ) == 0 && result )
+    snprintf( name, size, "%s", result->pw_name );
+  else
+    snprintf( name, size, "?" );
+}
+
+/**
+  Reads the whole passwd database, so that the processes of most users
+  find their name in the table right away. Directory services may list
+  only some or none of their users here, they are looked up one by one.
+ */
+static void preloadNames( void )
+{
+  struct passwd* pwent;
+  CachedPWUID* entry;
+  int stop = 0;
+
+  setpwent();
+  while ( !stop && ( pwent = getpwent() ) != NULL ) {
+    pthread_mutex_lock( &UIDLock );
+    /* Like getpwuid(), the first user of a uid wins */
+    if ( ( entry = entryOf( pwent->pw_uid ) ) != NULL && entry->refresh != Refresh )
+      setName( entry, pwent->pw_name );
+    stop = Stop;
+    pthread_mutex_unlock( &UIDLock );
   }
+  endpwent();
+}
 
-  key.uid = uid;
-  if ( ( idx = search_ctnr( UIDCache, uidCmp, &key ) ) < 0 ) {
-    struct passwd* pwent;
+/**
+  Queues the entries that the last preloadNames() has not seen for a
+  lookup of their own and removes those that nobody has asked for in
+  the last TIMEOUT seconds. Must be called with UIDLock held.
+ */
+static void refreshEntries( void )
+{
+  CachedPWUID* entry;
+  INDEX pos = 0;
+  time_t stamp = time( 0 );
 
-    /* User id is not yet known */
-    entry = (CachedPWUID*)malloc( sizeof( CachedPWUID ) );
-    entry->tStamp = stamp;
-    entry->uid = uid;
+  /* Removing leaves a tombstone, so the iteration is not disturbed */
+  while ( ( entry = iter_htbl( UIDCache, &pos ) ) != NULL ) {
+    if ( entry->refresh == Refresh || entry->queued )
+      continue;
 
-    pwent = getpwuid( uid );
-    entry->uName = strdup( pwent ? pwent->pw_name : "?" );
+    if ( stamp - entry->tStamp > TIMEOUT )
+      PWUIDCache_cleanup( remove_htbl( UIDCache, &entry->uid, sizeof( uid_t ) ) );
+    else
+      queueLookup( entry );
+  }
+}
+
+/**
+  The Resolver thread. It reads the passwd database every TIMEOUT
+  seconds and looks up the queued entries in between. Only this thread
+  removes entries, so an entry stays valid during its lookup.
+ */
+static void* resolveNames( void* data )
+{
+  CachedPWUID* entry;
+  struct timespec until;
+  time_t nextRefresh = 0;
+  char name[ 256 ];
 
-    push_ctnr( UIDCache, entry );
-    bsort_ctnr( UIDCache, uidCmp );
-	} else {
-    /* User is is already known */
-    entry = get_ctnr( UIDCache, idx );
+  (void)data;
+  pthread_mutex_lock( &UIDLock );
+  while ( !Stop ) {
+    if ( time( 0 ) >= nextRefresh ) {
+      ++Refresh;
+      pthread_mutex_unlock( &UIDLock );
+      preloadNames();
+      pthread_mutex_lock( &UIDLock );
+      refreshEntries();
+      nextRefresh = time( 0 ) + TIMEOUT;
+      continue;
+    }
+
+    if ( ( entry = Pending ) == NULL ) {
+      until.tv_sec = nextRefresh;
+      until.tv_nsec = 0;
+      pthread_cond_timedwait( &Wakeup, &UIDLock, &until );
+      continue;
+    }
+
+    Pending = entry->nextPending;
+    entry->queued = 0;
+    /* The preload may have found it in the mean time */
+    if ( entry->resolved && entry->refresh == Refresh )
+      continue;
+
+    pthread_mutex_unlock( &UIDLock );
+    lookupName( entry->uid, name, sizeof( name ) );
+    pthread_mutex_lock( &UIDLock );
+    setName( entry, name );
   }
+  pthread_mutex_unlock( &UIDLock );
+
+  return NULL;
+}
+
+void initPWUIDCache()
+{
+  UIDCache = new_htbl();
+}
+
+void exitPWUIDCache()
+{
+  pthread_mutex_lock( &UIDLock );
+  Stop = 1;
+  pthread_cond_signal( &Wakeup );
+  pthread_mutex_unlock( &UIDLock );
+
+  /* A lookup that is in progress is finished first */
+  if ( ResolverState > 0 )
+    pthread_join( Resolver, NULL );
+  ResolverState = 0;
+  Stop = 0;
+  Pending = 0;
+
+  destr_htbl( UIDCache, PWUIDCache_cleanup );
+  UIDCache = 0;
+}
+
+int getCachedPWUID( uid_t uid, char* name, size_t size )
+{
+  CachedPWUID* entry;
+  char found[ 256 ];
+  int resolved = 0;
+
+  pthread_mutex_lock( &UIDLock );
+  /* Not started by initPWUIDCache(), the modules are initialized
+   * before ksysguardd forks into the background */
+  if ( ResolverState == 0 )
+    ResolverState = pthread_create( &Resolver, NULL, resolveNames, NULL ) == 0 ? 1 : -1;
+
+  if ( UIDCache && ( entry = entryOf( uid ) ) != NULL ) {
+    entry->tStamp = time( 0 );
+    if ( !entry->resolved && ResolverState > 0 )
+      queueLookup( entry );
+    else if ( !entry->resolved ) {
+      /* Without the thread the lookup blocks, as it always has */
+      lookupName( uid, found, sizeof( found ) );
+      setName( entry, found );
+    }
+    resolved = entry->resolved;
+    snprintf( name, size, "%s", entry->uName );
+  } else
+    snprintf( name, size, "%lu", (unsigned long)uid );
+  pthread_mutex_unlock( &UIDLock );
 
-  return entry->uName;
+  return resolved ? 0 : -1;
 }
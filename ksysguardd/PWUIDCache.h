@@ -26,11 +26,20 @@
 /**
   getpwuid() can be fairly expensive on NIS or LDAP systems that do not
   use caching. This module implements a cache for uid to user name
-  mappings.
+  mappings. The names are looked up by a thread of its own, which reads
+  the whole passwd database in advance, so a slow directory service
+  never blocks the caller.
  */
 void initPWUIDCache( void );
 void exitPWUIDCache( void );
 
-const char* getCachedPWUID( uid_t uid );
+/**
+  Copies the user name of @ref uid into @ref name, which has room for
+  @ref size characters. May be called from any thread.
+  @return 0, or -1 if the name has not been looked up yet. @ref name
+  holds the numeric uid in that case and the caller should ask again
+  later.
+ */
+int getCachedPWUID( uid_t uid, char* name, size_t size );
 
 #endif
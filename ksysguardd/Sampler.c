@@ -0,0 +1,270 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+
+#define _XOPEN_SOURCE 700 /* gettimeofday */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "config-ksysguardd.h"
+
+#ifdef HAVE_SYS_TIMERFD_H
+#include <sys/timerfd.h>
+#endif
+
+#include "Command.h"
+#include "conf.h"
+#include "WorkerPool.h"
+#include "ksysguardd.h"
+
+#include "Sampler.h"
+
+/* Sampling faster than the update interval used without a sampler
+ * makes no sense. */
+#define MIN_INTERVAL	( UPDATEINTERVAL * 100 )
+
+typedef struct SampledModule {
+  struct SensorModul* sm;
+  /* Run the checkCommand with the next sample */
+  int check;
+  /* The sample that is being taken, if any */
+  struct CollectorTask* task;
+} SampledModule;
+
+/**
+  All modules with the same sample interval. They are sampled by a
+  single timer.
+ */
+typedef struct SampleGroup {
+  struct SampleGroup* next;
+  unsigned int interval;
+  int fd;
+  struct EventWatch* watch;
+  int count;
+  SampledModule* modules;
+} SampleGroup;
+
+static SampleGroup* Groups = 0;
+
+/* Runs the collectors, 0 if they run in the main loop */
+static struct WorkerPool* Pool = 0;
+
+static void freeGroup( SampleGroup* group )
+{
+  if ( group->watch )
+    unwatchFD( group->watch );
+  if ( group->fd >= 0 )
+    close( group->fd );
+  free( group->modules );
+  free( group );
+}
+
+static void runSample( void* data )
+{
+  runCollectorTask( ((SampledModule*)data)->task );
+}
+
+static void sampleDone( void* data )
+{
+  SampledModule* module = (SampledModule*)data;
+
+  finishCollectorTask( module->task );
+  module->task = NULL;
+}
+
+/**
+  Starts a new sample of every module of the group. Each module is a
+  task of its own, so a pass takes as long as the slowest collector.
+ */
+static void sampleModules( SampleGroup* group )
+{
+  int i;
+
+  for ( i = 0; i < group->count; ++i ) {
+    SampledModule* module = &group->modules[ i ];
+
+    /* The last sample is still being taken, e.g. because a collector
+     * hangs. Missed samples are not made up for. */
+    if ( module->task )
+      continue;
+
+    if ( ( module->task = newCollectorTask( module->sm, module->check ) ) == NULL )
+      continue;
+    module->check = 0;
+
+    if ( Pool == NULL || submitWork( Pool, runSample, sampleDone, module ) < 0 ) {
+      runSample( module );
+      sampleDone( module );
+    }
+  }
+}
+
+#ifdef HAVE_SYS_TIMERFD_H
+
+static void sampleTimeout( void* data )
+{
+  SampleGroup* group = (SampleGroup*)data;
+  uint64_t expirations;
+
+  if ( read( group->fd, &expirations, sizeof( expirations ) ) != sizeof( expirations ) )
+    return;
+
+  sampleModules( group );
+}
+
+static int startTimer( SampleGroup* group )
+{
+  struct itimerspec timer;
+
+  timer.it_interval.tv_sec = group->interval / 1000;
+  timer.it_interval.tv_nsec = ( group->interval % 1000 ) * 1000000;
+  timer.it_value = timer.it_interval;
+
+  if ( ( group->fd = timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC ) ) < 0 ||
+       timerfd_settime( group->fd, 0, &timer, NULL ) < 0 ||
+       ( group->watch = watchFD( group->fd, sampleTimeout, group ) ) == NULL ) {
+    log_error( "Cannot create timer for sampling: %s", strerror( errno ) );
+    return -1;
+  }
+
+  return 0;
+}
+
+#else
+
+static int startTimer( SampleGroup* group )
+{
+  (void)group;
+  log_error( "Sampling in the background is not supported on this platform" );
+  return -1;
+}
+
+#endif /* HAVE_SYS_TIMERFD_H */
+
+static SampleGroup* findGroup( unsigned int interval )
+{
+  SampleGroup* group;
+
+  for ( group = Groups; group; group = group->next )
+    if ( group->interval == interval )
+      return group;
+
+  if ( ( group = (SampleGroup*)calloc( 1, sizeof( SampleGroup ) ) ) == NULL )
+    return NULL;
+
+  group->interval = interval;
+  group->fd = -1;
+  if ( startTimer( group ) < 0 ) {
+    freeGroup( group );
+    return NULL;
+  }
+
+  group->next = Groups;
+  Groups = group;
+
+  return group;
+}
+
+/*
+================================ public part =================================
+*/
+
+void initSampler( struct SensorModul* modulList )
+{
+  struct SensorModul* sm;
+  SampledModule* modules;
+  SampleGroup* group;
+  unsigned int interval;
+
+  for ( sm = modulList; sm->configName != NULL; sm++ ) {
+    if ( !sm->available || sm->updateCommand == NULL )
+      continue;
+    if ( ( interval = moduleSampleInterval( sm->configName ) ) == 0 )
+      continue;
+    if ( interval < MIN_INTERVAL )
+      interval = MIN_INTERVAL;
+
+    if ( ( group = findGroup( interval ) ) == NULL )
+      return;
+
+    modules = (SampledModule*)realloc( group->modules, ( group->count + 1 ) * sizeof( SampledModule ) );
+    if ( modules == NULL ) {
+      log_error( "Out of memory" );
+      return;
+    }
+    group->modules = modules;
+    memset( &group->modules[ group->count ], 0, sizeof( SampledModule ) );
+    group->modules[ group->count++ ].sm = sm;
+  }
+
+  if ( Groups == NULL )
+    return;
+
+  enableHistory( HistoryDuration, HistoryResolution );
+  enableAggregation( AggregationWindow, AggregationResolution );
+
+  /* Take the first snapshot right away in the main loop, so that there
+   * is an answer for every sensor before a client asks. */
+  for ( group = Groups; group; group = group->next )
+    sampleModules( group );
+
+  for ( group = Groups; group; group = group->next ) {
+    int i;
+    for ( i = 0; i < group->count; ++i )
+      group->modules[ i ].sm->sampleInterval = group->interval;
+  }
+
+  Pool = newWorkerPool( CollectorThreads );
+}
+
+int scheduleCheck( struct SensorModul* sm )
+{
+  SampleGroup* group;
+  int i;
+
+  for ( group = Groups; group; group = group->next )
+    for ( i = 0; i < group->count; ++i )
+      if ( group->modules[ i ].sm == sm ) {
+        group->modules[ i ].check = 1;
+        return 1;
+      }
+
+  return 0;
+}
+
+void exitSampler( void )
+{
+  /* Waits for the samples that are still being taken */
+  freeWorkerPool( Pool );
+  Pool = NULL;
+
+  while ( Groups ) {
+    SampleGroup* next = Groups->next;
+    int i;
+
+    for ( i = 0; i < Groups->count; ++i )
+      Groups->modules[ i ].sm->sampleInterval = 0;
+    freeGroup( Groups );
+    Groups = next;
+  }
+}
@@ -0,0 +1,63 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+
+#ifndef KSG_SAMPLER_H
+#define KSG_SAMPLER_H
+
+/**
+  Normally a module is updated when one of its sensors is requested and
+  the last update is older than UPDATEINTERVAL. Modules that have a
+  sample interval in ksysguarddrc (SampleIntervals) are updated by a
+  timer instead and all requests are answered from the latest sample,
+  no matter how many clients ask. Modules with the same interval are
+  updated together, so their values belong to the same moment.
+
+  The collectors run on a pool of worker threads, one task per module,
+  so a slow collector neither blocks the clients nor the other modules.
+  Requests for the sensors of these modules are answered from the
+  snapshot that the last task has published, see CollectorTask in
+  Command.h.
+
+  Every update of a module increments its generation number, see
+  struct SensorModul.
+ */
+
+struct SensorModul;
+
+/**
+  Starts the timers for the modules of @ref modulList, which is
+  terminated by an entry without configName. Must be called after the
+  modules have been initialized and the main loop is ready to watch
+  file descriptors.
+ */
+void initSampler( struct SensorModul* modulList );
+
+/**
+  Runs the checkCommand of @ref sm along with its next sample.
+  @return 0 if @ref sm is not sampled in the background, the caller
+  has to run the check itself then.
+ */
+int scheduleCheck( struct SensorModul* sm );
+
+/**
+  Waits for the samples that are being taken and stops sampling.
+ */
+void exitSampler( void );
+
+#endif
@@ -250,62 +250,62 @@ int updateLoadAvg( void ) {
 }
 
 void printLoadAvg1Info( const char *cmd ) {
-	fprintf(CurrentClient, "avnrun 1min\t0\t0\n" );
+	output("avnrun 1min\t0\t0\n" );
 }
 
 void printLoadAvg1( const char *cmd ) {
-	fprintf(CurrentClient, "%f\n", loadavg1 );
+	output("%f\n", loadavg1 );
 }
 
 void printLoadAvg5Info( const char *cmd ) {
-	fprintf(CurrentClient, "avnrun 5min\t0\t0\n" );
+	output("avnrun 5min\t0\t0\n" );
 }
 
 void printLoadAvg5( const char *cmd ) {
-	fprintf(CurrentClient, "%f\n", loadavg5 );
+	output("%f\n", loadavg5 );
 }
 
 void printLoadAvg15Info( const char *cmd ) {
-	fprintf(CurrentClient, "avnrun 15min\t0\t0\n" );
+	output("avnrun 15min\t0\t0\n" );
 }
 
 void printLoadAvg15( const char *cmd ) {
-	fprintf(CurrentClient, "%f\n", loadavg15 );
+	output("%f\n", loadavg15 );
 }
 
 void printCPUxUser( const char* cmd ) {
 	int id;
 
 	sscanf( cmd + 7, "%d", &id );
-	fprintf(CurrentClient, "%f\n", cpu_load[ id ].user_load );
+	output("%f\n", cpu_load[ id ].user_load );
 }
 
 void printCPUxUserInfo( const char* cmd ) {
 	int id;
 
 	sscanf( cmd + 7, "%d", &id );
-	fprintf(CurrentClient, "CPU %d User Load\t0\t100\t%%\n", id );
+	output("CPU %d User Load\t0\t100\t%%\n", id );
 }
 
 void printCPUxKernel( const char* cmd ) {
 	int id;
 
 	sscanf( cmd + 7, "%d", &id );
-	fprintf(CurrentClient, "%f\n", cpu_load[ id ].kernel_load );
+	output("%f\n", cpu_load[ id ].kernel_load );
 }
 
 void printCPUxKernelInfo( const char* cmd ) {
 	int id;
 
 	sscanf( cmd + 7, "%d", &id );
-	fprintf(CurrentClient, "CPU %d System Load\t0\t100\t%%\n", id );
+	output("CPU %d System Load\t0\t100\t%%\n", id );
 }
 
 void printCPUxTotalLoad( const char* cmd ) {
 	int id;
 
 	sscanf( cmd + 7, "%d", &id );
-	fprintf(CurrentClient, "%f\n", cpu_load[ id ].user_load + \
+	output("%f\n", cpu_load[ id ].user_load + \
 	    cpu_load[ id ].kernel_load + cpu_load[ id ].wait_load );
 }
 
@@ -313,29 +313,29 @@ void printCPUxTotalLoadInfo( const char* cmd ) {
 	int id;
 
 	sscanf( cmd + 7, "%d", &id );
-	fprintf(CurrentClient, "CPU %d Total Load\t0\t100\t%%\n", id );
+	output("CPU %d Total Load\t0\t100\t%%\n", id );
 }
 
 void printCPUIdle( const char* cmd ) {
-	fprintf(CurrentClient, "%f\n", idle_load );
+	output("%f\n", idle_load );
 }
 
 void printCPUIdleInfo( const char* cmd ) {
-	fprintf(CurrentClient, "CPU Idle Load\t0\t100\t%%\n" );
+	output("CPU Idle Load\t0\t100\t%%\n" );
 }
 
 void printCPUxIdle( const char* cmd ) {
 	int id;
 
 	sscanf( cmd + 7, "%d", &id );
-	fprintf(CurrentClient, "%f\n", cpu_load[ id ].idle_load );
+	output("%f\n", cpu_load[ id ].idle_load );
 }
 
 void printCPUxIdleInfo( const char* cmd ) {
 	int id;
 
 	sscanf( cmd + 7, "%d", &id );
-	fprintf(CurrentClient, "CPU %d Idle Load\t0\t100\t%%\n", id );
+	output("CPU %d Idle Load\t0\t100\t%%\n", id );
 }
 
 void printCPUxWait( const char* cmd )
@@ -343,7 +343,7 @@ void printCPUxWait( const char* cmd )
 	int id;
 
 	sscanf( cmd + 7, "%d", &id );
-	fprintf(CurrentClient, "%f\n", cpu_load[ id ].wait_load );
+	output("%f\n", cpu_load[ id ].wait_load );
 }
 
 void printCPUxWaitInfo( const char* cmd )
@@ -351,5 +351,5 @@ void printCPUxWaitInfo( const char* cmd )
 	int id;
 
 	sscanf( cmd + 7, "%d", &id );
-	fprintf(CurrentClient, "CPU %d Wait Load\t0\t100\t%%\n", id );
+	output("CPU %d Wait Load\t0\t100\t%%\n", id );
 }
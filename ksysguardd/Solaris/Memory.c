@@ -267,37 +267,37 @@ done:
 	return( 0 );
 }
 void printMemFreeInfo( const char *cmd ) {
-	fprintf(CurrentClient, "Free Memory\t0\t%lu\tKB\n", totalmem );
+	output("Free Memory\t0\t%lu\tKB\n", totalmem );
 }
 
 void printMemFree( const char *cmd ) {
 	updateMemory();
-	fprintf(CurrentClient, "%lu\n", freemem );
+	output("%lu\n", freemem );
 }
 
 void printMemUsedInfo( const char *cmd ) {
-	fprintf(CurrentClient, "Used Memory\t0\t%lu\tKB\n", totalmem );
+	output("Used Memory\t0\t%lu\tKB\n", totalmem );
 }
 
 void printMemUsed( const char *cmd ) {
 	updateMemory();
-	fprintf(CurrentClient, "%lu\n", totalmem - freemem );
+	output("%lu\n", totalmem - freemem );
 }
 
 void printSwapFreeInfo( const char *cmd ) {
-	fprintf(CurrentClient, "Free Swap\t0\t%lu\tKB\n", freeswap );
+	output("Free Swap\t0\t%lu\tKB\n", freeswap );
 }
 
 void printSwapFree( const char *cmd ) {
 	updateSwap(1);
-	fprintf(CurrentClient, "%lu\n", freeswap );
+	output("%lu\n", freeswap );
 }
 
 void printSwapUsedInfo( const char *cmd ) {
-	fprintf(CurrentClient, "Used Swap\t0\t%lu\tKB\n", usedswap );
+	output("Used Swap\t0\t%lu\tKB\n", usedswap );
 }
 
 void printSwapUsed( const char *cmd ) {
 	updateSwap(1);
-	fprintf(CurrentClient, "%lu\n", usedswap );
+	output("%lu\n", usedswap );
 }
@@ -0,0 +1,263 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#define _XOPEN_SOURCE 700 /* getrusage */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "Command.h"
+#include "Latency.h"
+#include "OutputSink.h"
+#include "ksysguardd.h"
+
+#include "Stats.h"
+
+/* ksysguardd/loopLag shows the longest round within this many us */
+#define LAG_WINDOW	5000000
+
+/* ksysguardd/cpu is averaged over at least this many us */
+#define CPU_WINDOW	1000000
+
+static struct SensorModul* Modules = 0;
+static LatencyHistogram LoopLatency;
+
+/* The longest round of the current and the previous lag window */
+static unsigned long long LagWindowStart = 0;
+static unsigned long long LagCurrent = 0;
+static unsigned long long LagPrevious = 0;
+
+/* CPU time in us at the start of the current CPU window */
+static unsigned long long CpuWindowStart = 0;
+static unsigned long long CpuAtStart = 0;
+static double CpuLoad = 0.0;
+
+typedef struct {
+  unsigned int count;
+  unsigned long long queued;
+} ClientTotals;
+
+static unsigned long long cpuMicros( void )
+{
+  struct rusage usage;
+
+  if ( getrusage( RUSAGE_SELF, &usage ) < 0 )
+    return 0;
+
+  return (unsigned long long)( usage.ru_utime.tv_sec + usage.ru_stime.tv_sec ) * 1000000 +
+         usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+/**
+  @return the resident set size in KB. Where /proc/self/statm does not
+  exist this is the largest size so far.
+ */
+static unsigned long residentKB( void )
+{
+  struct rusage usage;
+  unsigned long pages;
+  FILE* file;
+
+  if ( ( file = fopen( "/proc/self/statm", "r" ) ) != NULL ) {
+    int found = fscanf( file, "%*u %lu", &pages );
+    fclose( file );
+    if ( found == 1 )
+      return pages * ( sysconf( _SC_PAGESIZE ) / 1024 );
+  }
+
+  if ( getrusage( RUSAGE_SELF, &usage ) < 0 )
+    return 0;
+
+  return usage.ru_maxrss;
+}
+
+static void rotateLagWindow( unsigned long long now )
+{
+  if ( now - LagWindowStart < LAG_WINDOW )
+    return;
+
+  LagPrevious = now - LagWindowStart < 2 * LAG_WINDOW ? LagCurrent : 0;
+  LagCurrent = 0;
+  LagWindowStart = now;
+}
+
+static void countClient( ClientContext* context, void* data )
+{
+  ClientTotals* totals = (ClientTotals*)data;
+
+  ++totals->count;
+  totals->queued += context->sink->pending;
+}
+
+static void printClient( ClientContext* context, void* data )
+{
+  (void)data;
+
+  output( "client\t%d\t%llu\t%lu\n", context->sink->fd, context->sink->sent,
+          (unsigned long)context->sink->pending );
+}
+
+static void printCpu( const char* cmd )
+{
+  unsigned long long now = monotonicMicros();
+
+  (void)cmd;
+
+  /* Several clients may ask, so only start a new window once the
+   * current one is long enough */
+  if ( now - CpuWindowStart >= CPU_WINDOW ) {
+    unsigned long long cpu = cpuMicros();
+
+    if ( CpuWindowStart )
+      CpuLoad = 100.0 * ( cpu - CpuAtStart ) / ( now - CpuWindowStart );
+    CpuWindowStart = now;
+    CpuAtStart = cpu;
+  }
+
+  output( "%f\n", CpuLoad );
+}
+
+static void printCpuInfo( const char* cmd )
+{
+  (void)cmd;
+  output( "ksysguardd CPU Load\t0\t100\t%%\n" );
+}
+
+static void printRss( const char* cmd )
+{
+  (void)cmd;
+  output( "%lu\n", residentKB() );
+}
+
+static void printRssInfo( const char* cmd )
+{
+  (void)cmd;
+  output( "ksysguardd Resident Memory\t0\t0\tKB\n" );
+}
+
+static void printClients( const char* cmd )
+{
+  ClientTotals totals = { 0, 0 };
+
+  (void)cmd;
+
+  forEachClient( countClient, &totals );
+  output( "%u\n", totals.count );
+}
+
+static void printClientsInfo( const char* cmd )
+{
+  (void)cmd;
+  output( "ksysguardd Clients\t0\t0\t\n" );
+}
+
+static void printQueued( const char* cmd )
+{
+  ClientTotals totals = { 0, 0 };
+
+  (void)cmd;
+
+  forEachClient( countClient, &totals );
+  output( "%llu\n", totals.queued );
+}
+
+static void printQueuedInfo( const char* cmd )
+{
+  (void)cmd;
+  output( "ksysguardd Queued Output\t0\t0\tB\n" );
+}
+
+static void printLoopLag( const char* cmd )
+{
+  (void)cmd;
+
+  rotateLagWindow( monotonicMicros() );
+  output( "%llu\n", LagCurrent > LagPrevious ? LagCurrent : LagPrevious );
+}
+
+static void printLoopLagInfo( const char* cmd )
+{
+  (void)cmd;
+  output( "ksysguardd Event Loop Lag\t0\t0\tus\n" );
+}
+
+/*
+================================ public part =================================
+*/
+
+void initStats( struct SensorModul* modules )
+{
+  Modules = modules;
+
+  registerCommand( "ksysguardd/stats", printStats );
+  setAnswerType( "ksysguardd/stats", ANSWER_TABLE );
+
+  registerMonitor( "ksysguardd/cpu", "float", printCpu, printCpuInfo, NULL );
+  registerMonitor( "ksysguardd/rss", "integer", printRss, printRssInfo, NULL );
+  registerMonitor( "ksysguardd/clients", "integer", printClients, printClientsInfo, NULL );
+  registerMonitor( "ksysguardd/queued", "integer", printQueued, printQueuedInfo, NULL );
+  registerMonitor( "ksysguardd/loopLag", "integer", printLoopLag, printLoopLagInfo, NULL );
+}
+
+void exitStats( void )
+{
+  struct SensorModul* sm;
+
+  for ( sm = Modules; sm && sm->configName != NULL; sm++ ) {
+    free( sm->updateLatency );
+    sm->updateLatency = NULL;
+  }
+}
+
+void recordLoopRound( unsigned long long start, unsigned long long end )
+{
+  addLatency( &LoopLatency, end - start );
+
+  rotateLagWindow( end );
+  if ( end - start > LagCurrent )
+    LagCurrent = end - start;
+}
+
+void printStats( const char* cmd )
+{
+  struct SensorModul* sm;
+
+  (void)cmd;
+
+  output( "process\t%ld\t%llu\t%lu\n", (long)getpid(), cpuMicros() / 1000, residentKB() );
+
+  output( "loop\tmain" );
+  printLatency( &LoopLatency );
+  output( "\n" );
+
+  printCommandStats();
+
+  for ( sm = Modules; sm && sm->configName != NULL; sm++ ) {
+    if ( sm->updateLatency == NULL )
+      continue;
+
+    output( "module\t%s", sm->configName );
+    printLatency( sm->updateLatency );
+    output( "\t%llu\n", sm->updateBytes );
+  }
+
+  forEachClient( printClient, NULL );
+}
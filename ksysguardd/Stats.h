@@ -0,0 +1,54 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#ifndef KSG_STATS_H
+#define KSG_STATS_H
+
+struct SensorModul;
+
+/**
+  The cost of ksysguardd itself. 'ksysguardd/stats' prints one line per
+  item, each starting with the kind of the item and its name:
+
+    process <pid> <CPU time in ms> <resident set in KB>
+    loop main <latency>
+    command <name> <latency>
+    module <name> <latency> <bytes read>
+    client <fd> <bytes sent> <bytes queued>
+
+  <latency> stands for the count, the mean, the 50th, 90th and 99th
+  percentile and the maximum of the durations in microseconds: of the
+  rounds of the main loop, the requests of a command and the updates of
+  a module. For modules that are sampled in the background an update
+  includes printing the values. Bytes read are only counted where
+  /proc/thread-self/io can be read. The ksysguardd/... monitors show
+  the current values, so the overhead of the daemon can be plotted like
+  any other sensor.
+ */
+void initStats( struct SensorModul* modules );
+void exitStats( void );
+
+/**
+  Adds a round of the main loop that has handled events from @ref start
+  to @ref end, both taken with monotonicMicros().
+ */
+void recordLoopRound( unsigned long long start, unsigned long long end );
+
+void printStats( const char* cmd );
+
+#endif
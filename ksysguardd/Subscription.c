@@ -0,0 +1,347 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+
+#define _XOPEN_SOURCE 700 /* strdup, gettimeofday */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "config-ksysguardd.h"
+
+#ifdef HAVE_SYS_TIMERFD_H
+#include <sys/timerfd.h>
+#endif
+
+#include "BinaryProtocol.h"
+#include "Command.h"
+#include "OutputSink.h"
+
+#include "Subscription.h"
+
+/* The modules are not updated more often than every UPDATEINTERVAL
+ * anyway, so shorter intervals make no sense. */
+#define MIN_INTERVAL	100
+
+/**
+  All subscriptions with the same interval. They are served by a single
+  timer.
+ */
+typedef struct SubscriptionGroup {
+  struct SubscriptionGroup* next;
+  unsigned long interval;
+  int fd;
+  struct EventWatch* watch;
+  struct Subscription* first;
+} SubscriptionGroup;
+
+typedef struct Subscription {
+  /* Next subscription in the group */
+  struct Subscription* next;
+  /* Next subscription of the same client */
+  struct Subscription* nextOfClient;
+
+  SubscriptionGroup* group;
+  ClientContext* client;
+  unsigned int id;
+
+  /* Samples are only pushed if they are new */
+  unsigned long generation;
+
+  /* The sensor names point into buffer */
+  int count;
+  char** sensors;
+  char* buffer;
+} Subscription;
+
+static SubscriptionGroup* Groups = 0;
+static unsigned int LastId = 0;
+
+/* Collects the values for clients that use the binary protocol */
+static OutputSink ValueSink = { -1, 0, 0, 0, 0, 0, 0, 0 };
+
+static void freeGroup( SubscriptionGroup* group )
+{
+  SubscriptionGroup** pos;
+
+  for ( pos = &Groups; *pos != group; pos = &(*pos)->next )
+    ;
+  *pos = group->next;
+
+  if ( group->watch )
+    unwatchFD( group->watch );
+  if ( group->fd >= 0 )
+    close( group->fd );
+  free( group );
+}
+
+/**
+  Removes @ref subscription from its group and frees it. The caller has
+  to remove it from the list of the client.
+ */
+static void freeSubscription( Subscription* subscription )
+{
+  SubscriptionGroup* group = subscription->group;
+  Subscription** pos;
+
+  if ( group ) {
+    for ( pos = &group->first; *pos != subscription; pos = &(*pos)->next )
+      ;
+    *pos = subscription->next;
+
+    if ( group->first == NULL )
+      freeGroup( group );
+  }
+
+  free( subscription->sensors );
+  free( subscription->buffer );
+  free( subscription );
+}
+
+#ifdef HAVE_SYS_TIMERFD_H
+
+/**
+  Runs a sampling pass for all subscriptions of the group and queues the
+  values for the subscribers.
+ */
+static void sampleGroup( void* data )
+{
+  SubscriptionGroup* group = (SubscriptionGroup*)data;
+  OutputSink* oldSink = CurrentSink;
+  ClientContext* oldContext = CurrentContext;
+  Subscription* subscription;
+  unsigned long long timeStamp;
+  struct timeval now;
+  uint64_t expirations;
+  char** names;
+  int count = 0;
+
+  /* Missed expirations are not made up for */
+  if ( read( group->fd, &expirations, sizeof( expirations ) ) != sizeof( expirations ) )
+    return;
+
+  for ( subscription = group->first; subscription; subscription = subscription->next )
+    count += subscription->count;
+
+  CurrentSink = NULL;
+  CurrentContext = NULL;
+
+  /* Update every module only once for all subscribers */
+  if ( ( names = (char**)malloc( count * sizeof( char* ) ) ) != NULL ) {
+    count = 0;
+    for ( subscription = group->first; subscription; subscription = subscription->next ) {
+      memcpy( names + count, subscription->sensors, subscription->count * sizeof( char* ) );
+      count += subscription->count;
+    }
+    updateSensors( names, count );
+    free( names );
+  }
+
+  gettimeofday( &now, NULL );
+  timeStamp = (unsigned long long)now.tv_sec * 1000 + now.tv_usec / 1000;
+
+  for ( subscription = group->first; subscription; subscription = subscription->next ) {
+    unsigned long generation;
+
+    /* Drop the sample for clients that do not keep up */
+    if ( sinkIsCongested( subscription->client->sink ) )
+      continue;
+
+    /* The modules are sampled less often than the subscription asks
+     * for, don't send the same values again */
+    generation = sensorsGeneration( subscription->sensors, subscription->count );
+    if ( generation == subscription->generation )
+      continue;
+    subscription->generation = generation;
+
+    CurrentContext = subscription->client;
+
+    if ( subscription->client->binary ) {
+      char* values;
+      size_t length;
+
+      CurrentSink = &ValueSink;
+      printSensorValues( subscription->sensors, subscription->count );
+      if ( ( values = sinkToString( &ValueSink, &length ) ) != NULL ) {
+        writeBinaryPush( subscription->client->sink, subscription->id, timeStamp, values, length );
+        free( values );
+      }
+      clearSink( &ValueSink );
+    } else {
+      CurrentSink = subscription->client->sink;
+      output( "@%u %llu\n", subscription->id, timeStamp );
+      printSensorValues( subscription->sensors, subscription->count );
+      output( "ksysguardd> " );
+    }
+
+    wakeClient( subscription->client );
+  }
+
+  CurrentSink = oldSink;
+  CurrentContext = oldContext;
+}
+
+static SubscriptionGroup* findGroup( unsigned long interval )
+{
+  SubscriptionGroup* group;
+  struct itimerspec timer;
+
+  for ( group = Groups; group; group = group->next )
+    if ( group->interval == interval )
+      return group;
+
+  if ( ( group = (SubscriptionGroup*)calloc( 1, sizeof( SubscriptionGroup ) ) ) == NULL )
+    return NULL;
+
+  group->interval = interval;
+  group->next = Groups;
+  Groups = group;
+
+  timer.it_interval.tv_sec = interval / 1000;
+  timer.it_interval.tv_nsec = ( interval % 1000 ) * 1000000;
+  timer.it_value = timer.it_interval;
+
+  if ( ( group->fd = timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC ) ) < 0 ||
+       timerfd_settime( group->fd, 0, &timer, NULL ) < 0 ||
+       ( group->watch = watchFD( group->fd, sampleGroup, group ) ) == NULL ) {
+    log_error( "Cannot create timer for subscriptions: %s", strerror( errno ) );
+    freeGroup( group );
+    return NULL;
+  }
+
+  return group;
+}
+
+#endif /* HAVE_SYS_TIMERFD_H */
+
+/*
+================================ public part =================================
+*/
+
+void initSubscriptions( void )
+{
+#ifdef HAVE_SYS_TIMERFD_H
+  registerCommand( "subscribe", subscribeCommand );
+  registerCommand( "unsubscribe", unsubscribeCommand );
+#endif
+}
+
+void clearSubscriptions( ClientContext* context )
+{
+  while ( context->subscriptions ) {
+    Subscription* next = context->subscriptions->nextOfClient;
+    freeSubscription( context->subscriptions );
+    context->subscriptions = next;
+  }
+}
+
+void subscribeCommand( const char* cmd )
+{
+#ifdef HAVE_SYS_TIMERFD_H
+  Subscription* subscription;
+  unsigned long interval;
+  char* end;
+  int count;
+
+  if ( !CurrentContext )
+    return;
+
+  if ( ( subscription = (Subscription*)calloc( 1, sizeof( Subscription ) ) ) == NULL ||
+       ( subscription->buffer = strdup( cmd ) ) == NULL ||
+       ( subscription->sensors = (char**)malloc( ( strlen( cmd ) / 2 + 1 ) * sizeof( char* ) ) ) == NULL ) {
+    if ( subscription )
+      free( subscription->buffer );
+    free( subscription );
+    print_error( "Out of memory" );
+    return;
+  }
+
+  /* subscribe <sensor>... <interval> */
+  count = splitWords( subscription->buffer, subscription->sensors );
+  if ( count < 3 ) {
+    freeSubscription( subscription );
+    print_error( "Usage: subscribe <sensor>... <interval in ms>" );
+    return;
+  }
+
+  interval = strtoul( subscription->sensors[ count - 1 ], &end, 10 );
+  if ( *end != '\0' || interval < MIN_INTERVAL ) {
+    freeSubscription( subscription );
+    print_error( "The interval must be at least %d ms", MIN_INTERVAL );
+    return;
+  }
+
+  subscription->count = count - 2;
+  memmove( subscription->sensors, subscription->sensors + 1, subscription->count * sizeof( char* ) );
+
+  if ( ( subscription->group = findGroup( interval ) ) == NULL ) {
+    freeSubscription( subscription );
+    print_error( "Cannot create timer" );
+    return;
+  }
+
+  subscription->id = ++LastId;
+  subscription->generation = ~0UL;
+  subscription->client = CurrentContext;
+  subscription->next = subscription->group->first;
+  subscription->group->first = subscription;
+  subscription->nextOfClient = CurrentContext->subscriptions;
+  CurrentContext->subscriptions = subscription;
+
+  output( "%u\n", subscription->id );
+#else
+  (void)cmd;
+#endif
+}
+
+void unsubscribeCommand( const char* cmd )
+{
+  Subscription** pos;
+  unsigned long id = 0;
+  int all = 1;
+  int count = 0;
+
+  if ( !CurrentContext )
+    return;
+
+  cmd += strlen( "unsubscribe" );
+  while ( *cmd == ' ' || *cmd == '\t' )
+    ++cmd;
+  if ( *cmd ) {
+    all = 0;
+    id = strtoul( cmd, NULL, 10 );
+  }
+
+  pos = &CurrentContext->subscriptions;
+  while ( *pos ) {
+    Subscription* subscription = *pos;
+
+    if ( all || subscription->id == id ) {
+      *pos = subscription->nextOfClient;
+      freeSubscription( subscription );
+      ++count;
+    } else
+      pos = &subscription->nextOfClient;
+  }
+
+  output( "%d\n", count );
+}
@@ -0,0 +1,56 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+
+#ifndef KSG_SUBSCRIPTION_H
+#define KSG_SUBSCRIPTION_H
+
+#include "ksysguardd.h"
+
+/**
+  A client can subscribe to a list of sensors with
+
+    subscribe <sensor>... <interval in ms>
+
+  and ksysguardd then pushes the values to the client on its own. The
+  answer to 'subscribe' is the id of the subscription. Every push looks
+  like an answer to a 'getset' preceded by a line with an '@', the id
+  and the time of the sample in milliseconds since the epoch:
+
+    @1 1215440839123
+    4.040404
+    260708
+    ksysguardd>
+
+  All subscriptions with the same interval are served by one timer and
+  share one update of the modules. 'unsubscribe <id>' cancels a
+  subscription, 'unsubscribe' without an id cancels all of them.
+ */
+struct Subscription;
+
+void initSubscriptions( void );
+
+/**
+  Cancels all subscriptions of @ref context.
+ */
+void clearSubscriptions( ClientContext* context );
+
+void subscribeCommand( const char* cmd );
+void unsubscribeCommand( const char* cmd );
+
+#endif
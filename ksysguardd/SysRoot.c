@@ -0,0 +1,89 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#define _XOPEN_SOURCE 700 /* strdup, O_CLOEXEC */
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SysRoot.h"
+
+static char* SysRoot = 0;
+static size_t SysRootLength = 0;
+
+void setSysRoot( const char* root )
+{
+  free( SysRoot );
+  SysRoot = 0;
+  SysRootLength = 0;
+
+  if ( root == NULL || *root == '\0' )
+    return;
+
+  SysRoot = strdup( root );
+  SysRootLength = strlen( SysRoot );
+
+  /* The paths start with a '/' already */
+  while ( SysRootLength > 0 && SysRoot[ SysRootLength - 1 ] == '/' )
+    SysRoot[ --SysRootLength ] = '\0';
+}
+
+int haveSysRoot( void )
+{
+  return SysRootLength > 0;
+}
+
+const char* sysPath( char* buffer, size_t size, const char* path )
+{
+  size_t length;
+
+  if ( SysRoot == NULL || path[ 0 ] != '/' )
+    return path;
+
+  /* Never fall back to the file of the running system */
+  length = strlen( path );
+  if ( SysRootLength + length + 1 > size )
+    return "";
+
+  memcpy( buffer, SysRoot, SysRootLength );
+  memcpy( buffer + SysRootLength, path, length + 1 );
+
+  return buffer;
+}
+
+int sysOpen( const char* path, int flags )
+{
+  char buffer[ PATH_MAX ];
+
+  return open( sysPath( buffer, sizeof( buffer ), path ), flags );
+}
+
+FILE* sysFopen( const char* path, const char* mode )
+{
+  char buffer[ PATH_MAX ];
+
+  return fopen( sysPath( buffer, sizeof( buffer ), path ), mode );
+}
+
+DIR* sysOpendir( const char* path )
+{
+  char buffer[ PATH_MAX ];
+
+  return opendir( sysPath( buffer, sizeof( buffer ), path ) );
+}
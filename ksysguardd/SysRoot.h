@@ -0,0 +1,57 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#ifndef KSG_SYSROOT_H
+#define KSG_SYSROOT_H
+
+#include <dirent.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+  The collectors read the system files, e.g. /proc/stat, below SysRoot
+  instead of /, if it is set. This lets the parsers run against a tree
+  that has been captured on another machine or written by
+  benchmarks/fixturegen.
+  Paths must be passed through these functions for that.
+ */
+
+/**
+  Sets the directory that the system files are read below. NULL or ""
+  reads them from /, which is the default. Must be called before the
+  modules are initialized.
+ */
+void setSysRoot( const char* root );
+
+/**
+  @return whether the files are read below a SysRoot, i.e. do not
+  describe the running system.
+ */
+int haveSysRoot( void );
+
+/**
+  @return the path under which @ref path is found. That is @ref path
+  itself or the path stored in @ref buffer of @ref size bytes.
+ */
+const char* sysPath( char* buffer, size_t size, const char* path );
+
+int sysOpen( const char* path, int flags );
+FILE* sysFopen( const char* path, const char* mode );
+DIR* sysOpendir( const char* path );
+
+#endif
@@ -0,0 +1,309 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "htbl.h"
+#include "Command.h"
+
+#include "TableDelta.h"
+
+/* Strings are never dropped from the dictionary, so an answer starts
+ * over once there are more than this many and twice as many as rows */
+#define DICTIONARY_LIMIT	4096
+
+/**
+  A row as the client has it. The cells point into the text behind the
+  cell array.
+ */
+typedef struct {
+  /* The generation of the last answer that contained the row */
+  unsigned long seen;
+  char* cells[];
+} Row;
+
+typedef struct {
+  unsigned int number;
+  char text[];
+} DictionaryString;
+
+struct TableDelta {
+  int columns;
+  int keyColumn;
+  unsigned long dictionaryColumns;
+  unsigned long generation;
+
+  HTBL rows;
+  HTBL strings;
+  unsigned int nextString;
+
+  /* The row that is being added, split into cells */
+  char* buffer;
+  size_t bufferSize;
+  size_t length;
+  char** cells;
+  unsigned int* numbers;
+  unsigned char* changed;
+};
+
+static int isDictionaryColumn( const TableDelta* delta, int column )
+{
+  return column < (int)( 8 * sizeof( unsigned long ) ) && ( delta->dictionaryColumns >> column ) & 1;
+}
+
+/**
+  Copies @ref row into the buffer and splits it into cells.
+  @return 0 if it has the right number of cells.
+ */
+static int splitRow( TableDelta* delta, const char* row )
+{
+  size_t length = strlen( row );
+  char* cell;
+  int count = 0;
+
+  if ( length + 1 > delta->bufferSize ) {
+    char* buffer = (char*)realloc( delta->buffer, length + 1 );
+    if ( buffer == NULL )
+      return -1;
+    delta->buffer = buffer;
+    delta->bufferSize = length + 1;
+  }
+
+  memcpy( delta->buffer, row, length + 1 );
+  delta->length = length;
+
+  for ( cell = delta->buffer; ; ++cell ) {
+    if ( count == delta->columns )
+      return -1;
+    delta->cells[ count++ ] = cell;
+    if ( ( cell = strchr( cell, '\t' ) ) == NULL )
+      break;
+    *cell = '\0';
+  }
+
+  return count == delta->columns ? 0 : -1;
+}
+
+/**
+  @return a copy of the row in the buffer or 0 if there is no memory.
+ */
+static Row* copyRow( const TableDelta* delta )
+{
+  size_t cellsSize = delta->columns * sizeof( char* );
+  Row* row;
+  char* text;
+  int i;
+
+  if ( ( row = (Row*)malloc( sizeof( Row ) + cellsSize + delta->length + 1 ) ) == NULL )
+    return NULL;
+
+  text = (char*)row->cells + cellsSize;
+  memcpy( text, delta->buffer, delta->length + 1 );
+  for ( i = 0; i < delta->columns; ++i )
+    row->cells[ i ] = text + ( delta->cells[ i ] - delta->buffer );
+
+  row->seen = delta->generation;
+  return row;
+}
+
+/**
+  @return the number of @ref text in the dictionary. New strings are
+  added and sent to the client.
+ */
+static unsigned int stringNumber( TableDelta* delta, const char* text )
+{
+  size_t length = strlen( text );
+  DictionaryString* string;
+
+  if ( ( string = get_htbl( delta->strings, text, length ) ) != NULL )
+    return string->number;
+
+  if ( ( string = (DictionaryString*)malloc( sizeof( DictionaryString ) + length + 1 ) ) != NULL ) {
+    memcpy( string->text, text, length + 1 );
+    string->number = delta->nextString;
+    if ( put_htbl( delta->strings, string->text, length, string ) < 0 ) {
+      free( string );
+      string = NULL;
+    }
+  }
+
+  /* Without memory the string is sent again with every use */
+  output( "S\t%u\t%s\n", delta->nextString, text );
+  return delta->nextString++;
+}
+
+static void printCell( const TableDelta* delta, int column, const char* text )
+{
+  if ( isDictionaryColumn( delta, column ) )
+    output( "\t%u", delta->numbers[ column ] );
+  else
+    output( "\t%s", text );
+}
+
+static void clearTables( TableDelta* delta )
+{
+  destr_htbl( delta->rows, free );
+  destr_htbl( delta->strings, free );
+  delta->rows = new_htbl();
+  delta->strings = new_htbl();
+  delta->nextString = 0;
+}
+
+/*
+================================ public part =================================
+*/
+
+TableDelta* newTableDelta( int columns, int keyColumn, unsigned long dictionaryColumns )
+{
+  TableDelta* delta;
+
+  if ( ( delta = (TableDelta*)calloc( 1, sizeof( TableDelta ) ) ) == NULL )
+    return NULL;
+
+  delta->columns = columns;
+  delta->keyColumn = keyColumn;
+  delta->dictionaryColumns = dictionaryColumns;
+  delta->rows = new_htbl();
+  delta->strings = new_htbl();
+  delta->cells = (char**)malloc( columns * sizeof( char* ) );
+  delta->numbers = (unsigned int*)malloc( columns * sizeof( unsigned int ) );
+  delta->changed = (unsigned char*)malloc( columns );
+
+  if ( !delta->rows || !delta->strings || !delta->cells || !delta->numbers || !delta->changed ) {
+    freeTableDelta( delta );
+    return NULL;
+  }
+
+  return delta;
+}
+
+void freeTableDelta( void* data )
+{
+  TableDelta* delta = (TableDelta*)data;
+
+  if ( delta == NULL )
+    return;
+
+  destr_htbl( delta->rows, free );
+  destr_htbl( delta->strings, free );
+  free( delta->buffer );
+  free( delta->cells );
+  free( delta->numbers );
+  free( delta->changed );
+  free( delta );
+}
+
+void beginTableDelta( TableDelta* delta, unsigned long generation )
+{
+  INDEX strings = level_htbl( delta->strings );
+  int reset = generation != delta->generation || delta->generation == 0 ||
+              ( strings > DICTIONARY_LIMIT && strings > 2 * level_htbl( delta->rows ) );
+  const char* separator = "";
+  int i;
+
+  if ( reset )
+    clearTables( delta );
+
+  /* 0 is never a valid generation, so a new client always starts over */
+  if ( ++delta->generation == 0 )
+    ++delta->generation;
+
+  output( "delta\t%lu\t%d\t", delta->generation, reset );
+  for ( i = 0; i < delta->columns; ++i ) {
+    if ( isDictionaryColumn( delta, i ) ) {
+      output( "%s%d", separator, i );
+      separator = ",";
+    }
+  }
+  output( "\n" );
+}
+
+void addTableDeltaRow( TableDelta* delta, const char* text )
+{
+  const char* key;
+  Row* old;
+  Row* row;
+  int changed = 0;
+  int i;
+
+  if ( delta->rows == NULL || delta->strings == NULL || splitRow( delta, text ) < 0 )
+    return;
+
+  key = delta->cells[ delta->keyColumn ];
+  old = get_htbl( delta->rows, key, strlen( key ) );
+
+  for ( i = 0; i < delta->columns; ++i ) {
+    delta->changed[ i ] = !old || strcmp( old->cells[ i ], delta->cells[ i ] ) != 0;
+    if ( !delta->changed[ i ] )
+      continue;
+
+    ++changed;
+    if ( isDictionaryColumn( delta, i ) )
+      delta->numbers[ i ] = stringNumber( delta, delta->cells[ i ] );
+  }
+
+  if ( old && !changed ) {
+    old->seen = delta->generation;
+    return;
+  }
+
+  if ( old ) {
+    output( "C\t%s", key );
+    for ( i = 0; i < delta->columns; ++i ) {
+      if ( delta->changed[ i ] ) {
+        output( "\t%d", i );
+        printCell( delta, i, delta->cells[ i ] );
+      }
+    }
+  } else {
+    output( "N" );
+    for ( i = 0; i < delta->columns; ++i )
+      printCell( delta, i, delta->cells[ i ] );
+  }
+  output( "\n" );
+
+  /* The key of the table entry points into the old row */
+  if ( old ) {
+    remove_htbl( delta->rows, key, strlen( key ) );
+    free( old );
+  }
+
+  /* Without memory the row is sent as new again next time */
+  if ( ( row = copyRow( delta ) ) != NULL &&
+       put_htbl( delta->rows, row->cells[ delta->keyColumn ], strlen( row->cells[ delta->keyColumn ] ), row ) < 0 )
+    free( row );
+}
+
+void endTableDelta( TableDelta* delta )
+{
+  INDEX pos = 0;
+  Row* row;
+
+  /* Removing leaves a tombstone, so the iteration is not disturbed */
+  while ( delta->rows && ( row = iter_htbl( delta->rows, &pos ) ) != NULL ) {
+    if ( row->seen == delta->generation )
+      continue;
+
+    output( "X\t%s\n", row->cells[ delta->keyColumn ] );
+    remove_htbl( delta->rows, row->cells[ delta->keyColumn ], strlen( row->cells[ delta->keyColumn ] ) );
+    free( row );
+  }
+
+  output( "\n" );
+}
@@ -0,0 +1,75 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#ifndef KSG_TABLEDELTA_H
+#define KSG_TABLEDELTA_H
+
+/**
+  The rows of a table monitor that a client has received, so that the
+  next answer only needs to carry the differences. Rows are identified
+  by the value of their key column. The values of the dictionary columns
+  are replaced by numbers, each string is sent once per client.
+
+  A delta answer consists of these lines, the cells separated by tabs:
+
+    delta <generation> <reset> <dictionary columns>
+    S <number> <string>
+    N <cells of a new row>
+    C <key> <column> <value> [<column> <value> ...]
+    X <key>
+
+  The client passes the generation of the last answer it has applied
+  with its next request. If it does not match, e.g. after a lost answer,
+  the answer starts over: <reset> is 1 and all rows and strings are sent
+  as new. <dictionary columns> lists the column numbers that hold string
+  numbers, separated by commas. S lines come before the first row that
+  uses the string. Columns are counted from 0 and the answer ends with an
+  empty line like the table itself.
+ */
+typedef struct TableDelta TableDelta;
+
+/**
+  @return the state for a table of @ref columns columns with the key
+  in @ref keyColumn, or 0 if there is no memory. Bit n of
+  @ref dictionaryColumns is set if column n is dictionary coded.
+ */
+TableDelta* newTableDelta( int columns, int keyColumn, unsigned long dictionaryColumns );
+
+/* Takes a void pointer to be usable with setClientData() */
+void freeTableDelta( void* delta );
+
+/**
+  Starts an answer for a client that holds @ref generation and prints
+  its first line.
+ */
+void beginTableDelta( TableDelta* delta, unsigned long generation );
+
+/**
+  Compares a row of the current table, its cells separated by tabs, to
+  the row with the same key that the client has and prints the
+  difference. Rows with the wrong number of cells are skipped.
+ */
+void addTableDeltaRow( TableDelta* delta, const char* row );
+
+/**
+  Prints the rows that have not been added since beginTableDelta() as
+  gone and ends the answer.
+ */
+void endTableDelta( TableDelta* delta );
+
+#endif
@@ -109,25 +109,25 @@ int updateLoadAvg( void ) {
 }
 
 void printLoadAvg1Info( const char *cmd ) {
-	fprintf(CurrentClient, "avnrun 1min\t0\t0\n" );
+	output("avnrun 1min\t0\t0\n" );
 }
 
 void printLoadAvg1( const char *cmd ) {
-	fprintf(CurrentClient, "%f\n", loadavg1 );
+	output("%f\n", loadavg1 );
 }
 
 void printLoadAvg5Info( const char *cmd ) {
-	fprintf(CurrentClient, "avnrun 5min\t0\t0\n" );
+	output("avnrun 5min\t0\t0\n" );
 }
 
 void printLoadAvg5( const char *cmd ) {
-	fprintf(CurrentClient, "%f\n", loadavg5 );
+	output("%f\n", loadavg5 );
 }
 
 void printLoadAvg15Info( const char *cmd ) {
-	fprintf(CurrentClient, "avnrun 15min\t0\t0\n" );
+	output("avnrun 15min\t0\t0\n" );
 }
 
 void printLoadAvg15( const char *cmd ) {
-	fprintf(CurrentClient, "%f\n", loadavg15 );
+	output("%f\n", loadavg15 );
 }
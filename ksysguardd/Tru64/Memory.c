@@ -191,47 +191,47 @@ int updateMemory( void ) {
 void printMemFreeInfo( const char *cmd ) {
 	if( Dirty )
 		updateMemory();
-	fprintf(CurrentClient, "Free Memory\t0\t%ld\tKB\n", totalmem );
+	output("Free Memory\t0\t%ld\tKB\n", totalmem );
 }
 
 void printMemFree( const char *cmd ) {
 	if( Dirty )
 		updateMemory();
-	fprintf(CurrentClient, "%ld\n", freemem );
+	output("%ld\n", freemem );
 }
 
 void printMemUsedInfo( const char *cmd ) {
 	if( Dirty )
 		updateMemory();
-	fprintf(CurrentClient, "Used Memory\t0\t%ld\tKB\n", totalmem );
+	output("Used Memory\t0\t%ld\tKB\n", totalmem );
 }
 
 void printMemUsed( const char *cmd ) {
 	if( Dirty )
 		updateMemory();
-	fprintf(CurrentClient, "%ld\n", totalmem - freemem );
+	output("%ld\n", totalmem - freemem );
 }
 
 void printSwapFreeInfo( const char *cmd ) {
 	if( Dirty )
 		updateMemory();
-	fprintf(CurrentClient, "Free Swap\t0\t%ld\tKB\n", totalswap );
+	output("Free Swap\t0\t%ld\tKB\n", totalswap );
 }
 
 void printSwapFree( const char *cmd ) {
 	if( Dirty )
 		updateMemory();
-	fprintf(CurrentClient, "%ld\n", freeswap );
+	output("%ld\n", freeswap );
 }
 
 void printSwapUsedInfo( const char *cmd ) {
 	if( Dirty )
 		updateMemory();
-	fprintf(CurrentClient, "Used Swap\t0\t%ld\tKB\n", totalswap );
+	output("Used Swap\t0\t%ld\tKB\n", totalswap );
 }
 
 void printSwapUsed( const char *cmd ) {
 	if( Dirty )
 		updateMemory();
-	fprintf(CurrentClient, "%ld\n", totalswap - freeswap );
+	output("%ld\n", totalswap - freeswap );
 }
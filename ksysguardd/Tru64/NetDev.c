@@ -426,7 +426,7 @@ int updateNetDev( void ) {
 }
 
 void printIPacketsInfo( const char *cmd ) {
-	fprintf(CurrentClient, "Received Packets\t0\t0\tPackets\n" );
+	output("Received Packets\t0\t0\tPackets\n" );
 }
 
 void printIPackets( const char *cmd ) {
@@ -443,18 +443,18 @@ void printIPackets( const char *cmd ) {
 	for( i = 0; i < NetDevCount; i++ ) {
 		if( (IfInfo[i].OLDipackets > 0)
 				&& (strcmp( IfInfo[i].Name, name ) == 0) ) {
-			fprintf(CurrentClient, "%ld\n",
+			output("%ld\n",
 				IfInfo[i].ipackets - IfInfo[i].OLDipackets);
 			free( cmdcopy );
 			return;
 		}
 	}
 	free( cmdcopy );
-	fprintf(CurrentClient, "0\n" );
+	output("0\n" );
 }
 
 void printOPacketsInfo( const char *cmd ) {
-	fprintf(CurrentClient, "Transmitted Packets\t0\t0\tPackets\n" );
+	output("Transmitted Packets\t0\t0\tPackets\n" );
 }
 
 void printOPackets( const char *cmd ) {
@@ -471,18 +471,18 @@ void printOPackets( const char *cmd ) {
 	for( i = 0; i < NetDevCount; i++ ) {
 		if( (IfInfo[i].OLDopackets > 0)
 				&& (strcmp( IfInfo[i].Name, name ) == 0) ) {
-			fprintf(CurrentClient, "%ld\n",
+			output("%ld\n",
 				IfInfo[i].opackets - IfInfo[i].OLDopackets );
 			free( cmdcopy );
 			return;
 		}
 	}
 	free( cmdcopy );
-	fprintf(CurrentClient, "0\n" );
+	output("0\n" );
 }
 
 void printIErrorsInfo( const char *cmd ) {
-	fprintf(CurrentClient, "Input Errors\t0\t0\tPackets\n" );
+	output("Input Errors\t0\t0\tPackets\n" );
 }
 
 void printIErrors( const char *cmd ) {
@@ -499,18 +499,18 @@ void printIErrors( const char *cmd ) {
 	for( i = 0; i < NetDevCount; i++ ) {
 		if( (IfInfo[i].OLDierrors > 0)
 				&& (strcmp( IfInfo[i].Name, name ) == 0) ) {
-			fprintf(CurrentClient, "%ld\n",
+			output("%ld\n",
 				IfInfo[i].ierrors - IfInfo[i].OLDierrors );
 			free( cmdcopy );
 			return;
 		}
 	}
 	free( cmdcopy );
-	fprintf(CurrentClient, "0\n" );
+	output("0\n" );
 }
 
 void printOErrorsInfo( const char *cmd ) {
-	fprintf(CurrentClient, "Output Errors\t0\t0\tPackets\n" );
+	output("Output Errors\t0\t0\tPackets\n" );
 }
 
 void printOErrors( const char *cmd ) {
@@ -527,18 +527,18 @@ void printOErrors( const char *cmd ) {
 	for( i = 0; i < NetDevCount; i++ ) {
 		if( (IfInfo[i].OLDoerrors > 0)
 				&& (strcmp( IfInfo[i].Name, name ) == 0) ) {
-			fprintf(CurrentClient, "%ld\n",
+			output("%ld\n",
 				IfInfo[i].oerrors - IfInfo[i].OLDoerrors );
 			free( cmdcopy );
 			return;
 		}
 	}
 	free( cmdcopy );
-	fprintf(CurrentClient, "0\n" );
+	output("0\n" );
 }
 
 void printCollisionsInfo( const char *cmd ) {
-	fprintf(CurrentClient, "Collisions\t0\t0\tPackets\n" );
+	output("Collisions\t0\t0\tPackets\n" );
 }
 
 void printCollisions( const char *cmd ) {
@@ -555,18 +555,18 @@ void printCollisions( const char *cmd ) {
 	for( i = 0; i < NetDevCount; i++ ) {
 		if( (IfInfo[i].OLDcollisions > 0)
 				&& (strcmp( IfInfo[i].Name, name ) == 0) ) {
-			fprintf(CurrentClient, "%ld\n",
+			output("%ld\n",
 				IfInfo[i].collisions - IfInfo[i].OLDcollisions );
 			free( cmdcopy );
 			return;
 		}
 	}
 	free( cmdcopy );
-	fprintf(CurrentClient, "0\n" );
+	output("0\n" );
 }
 
 void printMultiXmitsInfo( const char *cmd ) {
-	fprintf(CurrentClient, "Multicasts Sent\t0\t0\tPackets\n" );
+	output("Multicasts Sent\t0\t0\tPackets\n" );
 }
 
 void printMultiXmits( const char *cmd ) {
@@ -583,18 +583,18 @@ void printMultiXmits( const char *cmd ) {
 	for( i = 0; i < NetDevCount; i++ ) {
 		if( (IfInfo[i].OLDmultixmt > 0)
 				&& (strcmp( IfInfo[i].Name, name ) == 0) ) {
-			fprintf(CurrentClient, "%ld\n",
+			output("%ld\n",
 				IfInfo[i].multixmt - IfInfo[i].OLDmultixmt );
 			free( cmdcopy );
 			return;
 		}
 	}
 	free( cmdcopy );
-	fprintf(CurrentClient, "0\n" );
+	output("0\n" );
 }
 
 void printMultiRecvsInfo( const char *cmd ) {
-	fprintf(CurrentClient, "Multicasts Received\t0\t0\tPackets\n" );
+	output("Multicasts Received\t0\t0\tPackets\n" );
 }
 
 void printMultiRecvs( const char *cmd ) {
@@ -611,18 +611,18 @@ void printMultiRecvs( const char *cmd ) {
 	for( i = 0; i < NetDevCount; i++ ) {
 		if( (IfInfo[i].OLDmultircv > 0)
 				&& (strcmp( IfInfo[i].Name, name ) == 0) ) {
-			fprintf(CurrentClient, "%ld\n",
+			output("%ld\n",
 				IfInfo[i].multircv - IfInfo[i].OLDmultircv );
 			free( cmdcopy );
 			return;
 		}
 	}
 	free( cmdcopy );
-	fprintf(CurrentClient, "0\n" );
+	output("0\n" );
 }
 
 void printBcastXmitsInfo( const char *cmd ) {
-	fprintf(CurrentClient, "Broadcasts Sent\t0\t0\tPackets\n" );
+	output("Broadcasts Sent\t0\t0\tPackets\n" );
 }
 
 void printBcastXmits( const char *cmd ) {
@@ -639,18 +639,18 @@ void printBcastXmits( const char *cmd ) {
 	for( i = 0; i < NetDevCount; i++ ) {
 		if( (IfInfo[i].OLDbrdcstxmt > 0)
 				&& (strcmp( IfInfo[i].Name, name ) == 0) ) {
-			fprintf(CurrentClient, "%ld\n",
+			output("%ld\n",
 				IfInfo[i].brdcstxmt - IfInfo[i].OLDbrdcstxmt );
 			free( cmdcopy );
 			return;
 		}
 	}
 	free( cmdcopy );
-	fprintf(CurrentClient, "0\n" );
+	output("0\n" );
 }
 
 void printBcastRecvsInfo( const char *cmd ) {
-	fprintf(CurrentClient, "Broadcasts Received\t0\t0\tPackets\n" );
+	output("Broadcasts Received\t0\t0\tPackets\n" );
 }
 
 void printBcastRecvs( const char *cmd ) {
@@ -667,12 +667,12 @@ void printBcastRecvs( const char *cmd ) {
 	for( i = 0; i < NetDevCount; i++ ) {
 		if( (IfInfo[i].OLDbrdcstrcv > 0)
 				&& (strcmp( IfInfo[i].Name, name ) == 0) ) {
-			fprintf(CurrentClient, "%ld\n",
+			output("%ld\n",
 				IfInfo[i].brdcstrcv - IfInfo[i].OLDbrdcstrcv );
 			free( cmdcopy );
 			return;
 		}
 	}
 	free( cmdcopy );
-	fprintf(CurrentClient, "0\n" );
+	output("0\n" );
 }
@@ -0,0 +1,244 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+
+#define _XOPEN_SOURCE 700 /* sysconf */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Command.h"
+#include "ksysguardd.h"
+
+#include "WorkerPool.h"
+
+/* More threads only help if many collectors block at the same time */
+#define MAX_THREADS	4
+
+typedef struct WorkItem {
+  struct WorkItem* next;
+  WorkFunc run;
+  WorkFunc done;
+  void* data;
+} WorkItem;
+
+typedef struct WorkerPool {
+  pthread_mutex_t lock;
+  pthread_cond_t wakeup;
+
+  /* Work waiting for a thread, in order */
+  WorkItem* first;
+  WorkItem** last;
+
+  /* Work waiting for its done function */
+  WorkItem* finished;
+
+  /* Written to whenever an item is finished, to wake up the main loop */
+  int pipe[ 2 ];
+  struct EventWatch* watch;
+
+  int stop;
+  int threadCount;
+  pthread_t* threads;
+} WorkerPool;
+
+static void* workerThread( void* data )
+{
+  WorkerPool* pool = (WorkerPool*)data;
+  WorkItem* item;
+  char byte = 0;
+
+  pthread_mutex_lock( &pool->lock );
+  for ( ;; ) {
+    while ( pool->first == NULL && !pool->stop )
+      pthread_cond_wait( &pool->wakeup, &pool->lock );
+    if ( ( item = pool->first ) == NULL )
+      break;
+
+    if ( ( pool->first = item->next ) == NULL )
+      pool->last = &pool->first;
+    pthread_mutex_unlock( &pool->lock );
+
+    item->run( item->data );
+
+    pthread_mutex_lock( &pool->lock );
+    item->next = pool->finished;
+    pool->finished = item;
+    /* The pipe only has to be readable, it does not matter if it is full */
+    if ( write( pool->pipe[ 1 ], &byte, 1 ) < 0 && errno != EAGAIN )
+      log_error( "Cannot wake up the main loop: %s", strerror( errno ) );
+  }
+  pthread_mutex_unlock( &pool->lock );
+
+  return NULL;
+}
+
+/**
+  Calls the done functions of all finished items in the order they
+  were finished.
+ */
+static void finishWork( WorkerPool* pool )
+{
+  WorkItem* finished;
+  WorkItem* reversed = NULL;
+
+  pthread_mutex_lock( &pool->lock );
+  finished = pool->finished;
+  pool->finished = NULL;
+  pthread_mutex_unlock( &pool->lock );
+
+  while ( finished ) {
+    WorkItem* next = finished->next;
+    finished->next = reversed;
+    reversed = finished;
+    finished = next;
+  }
+
+  while ( reversed ) {
+    WorkItem* next = reversed->next;
+    reversed->done( reversed->data );
+    free( reversed );
+    reversed = next;
+  }
+}
+
+static void wakeupReceived( void* data )
+{
+  WorkerPool* pool = (WorkerPool*)data;
+  char buffer[ 64 ];
+
+  while ( read( pool->pipe[ 0 ], buffer, sizeof( buffer ) ) > 0 )
+    ;
+
+  finishWork( pool );
+}
+
+/*
+================================ public part =================================
+*/
+
+struct WorkerPool* newWorkerPool( int threads )
+{
+  WorkerPool* pool;
+  int i;
+
+  if ( threads <= 0 ) {
+    long cpus = sysconf( _SC_NPROCESSORS_ONLN );
+    threads = cpus < 1 ? 1 : cpus > MAX_THREADS ? MAX_THREADS : (int)cpus;
+  }
+
+  if ( ( pool = (WorkerPool*)calloc( 1, sizeof( WorkerPool ) ) ) == NULL ||
+       ( pool->threads = (pthread_t*)calloc( threads, sizeof( pthread_t ) ) ) == NULL ) {
+    log_error( "Out of memory" );
+    free( pool );
+    return NULL;
+  }
+
+  pthread_mutex_init( &pool->lock, NULL );
+  pthread_cond_init( &pool->wakeup, NULL );
+  pool->last = &pool->first;
+  pool->pipe[ 0 ] = pool->pipe[ 1 ] = -1;
+
+  if ( pipe( pool->pipe ) < 0 ) {
+    log_error( "Cannot create pipe for the worker threads: %s", strerror( errno ) );
+    freeWorkerPool( pool );
+    return NULL;
+  }
+
+  for ( i = 0; i < 2; ++i ) {
+    fcntl( pool->pipe[ i ], F_SETFL, fcntl( pool->pipe[ i ], F_GETFL ) | O_NONBLOCK );
+    fcntl( pool->pipe[ i ], F_SETFD, FD_CLOEXEC );
+  }
+
+  if ( ( pool->watch = watchFD( pool->pipe[ 0 ], wakeupReceived, pool ) ) == NULL ) {
+    freeWorkerPool( pool );
+    return NULL;
+  }
+
+  for ( i = 0; i < threads; ++i ) {
+    if ( ( errno = pthread_create( &pool->threads[ i ], NULL, workerThread, pool ) ) != 0 ) {
+      log_error( "Cannot start worker thread: %s", strerror( errno ) );
+      break;
+    }
+    pool->threadCount++;
+  }
+
+  if ( pool->threadCount == 0 ) {
+    freeWorkerPool( pool );
+    return NULL;
+  }
+
+  return pool;
+}
+
+void freeWorkerPool( struct WorkerPool* pool )
+{
+  int i;
+
+  if ( pool == NULL )
+    return;
+
+  pthread_mutex_lock( &pool->lock );
+  pool->stop = 1;
+  pthread_cond_broadcast( &pool->wakeup );
+  pthread_mutex_unlock( &pool->lock );
+
+  /* The threads run the queued work before they stop */
+  for ( i = 0; i < pool->threadCount; ++i )
+    pthread_join( pool->threads[ i ], NULL );
+
+  finishWork( pool );
+
+  if ( pool->watch )
+    unwatchFD( pool->watch );
+  for ( i = 0; i < 2; ++i )
+    if ( pool->pipe[ i ] >= 0 )
+      close( pool->pipe[ i ] );
+
+  pthread_cond_destroy( &pool->wakeup );
+  pthread_mutex_destroy( &pool->lock );
+  free( pool->threads );
+  free( pool );
+}
+
+int submitWork( struct WorkerPool* pool, WorkFunc run, WorkFunc done, void* data )
+{
+  WorkItem* item;
+
+  if ( ( item = (WorkItem*)malloc( sizeof( WorkItem ) ) ) == NULL ) {
+    log_error( "Out of memory" );
+    return -1;
+  }
+
+  item->next = NULL;
+  item->run = run;
+  item->done = done;
+  item->data = data;
+
+  pthread_mutex_lock( &pool->lock );
+  *pool->last = item;
+  pool->last = &item->next;
+  pthread_cond_signal( &pool->wakeup );
+  pthread_mutex_unlock( &pool->lock );
+
+  return 0;
+}
@@ -0,0 +1,53 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+
+#ifndef KSG_WORKERPOOL_H
+#define KSG_WORKERPOOL_H
+
+/**
+  A small pool of threads that runs work off the main loop, so that a
+  slow task, e.g. a statvfs() on a hung NFS mount, does not block the
+  clients. Every work item has two functions: @ref run is called on a
+  worker thread, @ref done is called afterwards by the main loop. Only
+  @ref done may touch state that is shared with the main loop.
+ */
+struct WorkerPool;
+
+typedef void (*WorkFunc)( void* data );
+
+/**
+  Starts @ref threads worker threads, 0 chooses a number that suits
+  the machine.
+  @return 0 if the threads cannot be started.
+ */
+struct WorkerPool* newWorkerPool( int threads );
+
+/**
+  Waits for all submitted work to be done, calls the pending @ref done
+  functions and stops the threads.
+ */
+void freeWorkerPool( struct WorkerPool* pool );
+
+/**
+  Queues a work item.
+  @return -1 on failure, the item will not be run in that case.
+ */
+int submitWork( struct WorkerPool* pool, WorkFunc run, WorkFunc done, void* data );
+
+#endif
@@ -0,0 +1,114 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+/*
+ * Times the command dispatch of executeCommand() with a large number of
+ * registered monitors.
+ *
+ * usage: commandbench [monitors] [rounds]
+ */
+
+#define _POSIX_C_SOURCE 200809L /* clock_gettime */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Command.h"
+#include "ksysguardd.h"
+
+int RunAsDaemon = 1;
+int QuitApp = 0;
+_Thread_local struct OutputSink* CurrentSink = 0;
+_Thread_local ClientContext* CurrentContext = 0;
+
+static unsigned long Hits = 0;
+
+static void printValue( const char* cmd )
+{
+  (void)cmd;
+  ++Hits;
+}
+
+static void printValueInfo( const char* cmd )
+{
+  (void)cmd;
+}
+
+static double now( void )
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main( int argc, char* argv[] )
+{
+  struct SensorModul sm = { "Bench", NULL, NULL, NULL, NULL, 1, 0, 0, 0, 0, 0 };
+  int monitors = argc > 1 ? atoi( argv[ 1 ] ) : 50000;
+  int rounds = argc > 2 ? atoi( argv[ 2 ] ) : 20;
+  char** names;
+  double start, elapsed;
+  int i, r;
+
+  if ( monitors <= 0 || rounds <= 0 ) {
+    fprintf( stderr, "usage: %s [monitors] [rounds]\n", argv[ 0 ] );
+    return 1;
+  }
+
+  names = (char**)malloc( monitors * sizeof( char* ) );
+  for ( i = 0; i < monitors; ++i ) {
+    char name[ 64 ];
+    snprintf( name, sizeof( name ), "disk/dm-%d_(%d:%d)/Rate/rblk", i, 253, i );
+    names[ i ] = strdup( name );
+  }
+
+  initCommand();
+
+  start = now();
+  for ( i = 0; i < monitors; ++i )
+    registerMonitor( names[ i ], "float", printValue, printValueInfo, &sm );
+  elapsed = now() - start;
+  printf( "register: %d monitors in %.3f ms (%.1f ns/monitor)\n",
+          monitors, elapsed * 1e3, elapsed * 1e9 / monitors );
+
+  start = now();
+  for ( r = 0; r < rounds; ++r ) {
+    for ( i = 0; i < monitors; ++i )
+      executeCommand( names[ i ] );
+  }
+  elapsed = now() - start;
+  printf( "dispatch: %lu requests in %.3f ms (%.1f ns/request)\n",
+          Hits, elapsed * 1e3, elapsed * 1e9 / ( (double)monitors * rounds ) );
+
+  start = now();
+  for ( i = 0; i < monitors; ++i )
+    removeMonitor( names[ i ] );
+  elapsed = now() - start;
+  printf( "remove:   %d monitors in %.3f ms (%.1f ns/monitor)\n",
+          monitors, elapsed * 1e3, elapsed * 1e9 / monitors );
+
+  exitCommand();
+
+  for ( i = 0; i < monitors; ++i )
+    free( names[ i ] );
+  free( names );
+
+  return Hits == (unsigned long)monitors * rounds ? 0 : 1;
+}
@@ -0,0 +1,237 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+/*
+ * Compares the linked list container of ccont.h with the vector, the
+ * hash table and the intrusive list for the access patterns of the
+ * ksysguardd modules. Operations that are quadratic with the linked list
+ * are skipped for it above 10000 entries.
+ *
+ * usage: containerbench [entries]...
+ */
+
+#define _POSIX_C_SOURCE 200809L /* clock_gettime */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ccont.h"
+#include "htbl.h"
+#include "ilist.h"
+#include "vector.h"
+
+#define QUADRATIC_LIMIT 10000
+#define LOOKUPS 1000
+
+typedef struct {
+  int key;
+  struct ilist_node link;
+} Entry;
+
+static volatile long Sink;
+
+static double now( void )
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int keyCmp( void* p1, void* p2 )
+{
+  int k1 = ((Entry*)p1)->key, k2 = ((Entry*)p2)->key;
+  return ( k1 > k2 ) - ( k1 < k2 );
+}
+
+static void noDestr( void* p )
+{
+  (void)p;
+}
+
+static void report( const char* op, const char* container, int n, long ops, double elapsed )
+{
+  printf( "%-8s %-8s %7d entries %10.1f ns/op\n", op, container, n, elapsed * 1e9 / ops );
+}
+
+static void run( int n )
+{
+  Entry* entries = (Entry*)malloc( n * sizeof( Entry ) );
+  int* order = (int*)malloc( n * sizeof( int ) );
+  int quadratic = n <= QUADRATIC_LIMIT;
+  CONTAINER ctnr;
+  VECTOR vctr;
+  HTBL htbl;
+  ILIST list;
+  struct ilist_node* node;
+  Entry* e;
+  Entry key;
+  double start;
+  long sum;
+  int i;
+
+  /* Shuffled keys, so sorting has to do some work, and an independent
+   * random order of the keys for the lookups */
+  for ( i = 0; i < n; ++i )
+    entries[ i ].key = order[ i ] = i;
+  for ( i = n - 1; i > 0; --i ) {
+    int j = rand() % ( i + 1 ), t = entries[ i ].key;
+    entries[ i ].key = entries[ j ].key;
+    entries[ j ].key = t;
+  }
+  for ( i = n - 1; i > 0; --i ) {
+    int j = rand() % ( i + 1 ), t = order[ i ];
+    order[ i ] = order[ j ];
+    order[ j ] = t;
+  }
+
+  /* push */
+  ctnr = new_ctnr();
+  start = now();
+  for ( i = 0; i < n; ++i )
+    push_ctnr( ctnr, &entries[ i ] );
+  report( "push", "ccont", n, n, now() - start );
+
+  vctr = new_vctr();
+  start = now();
+  for ( i = 0; i < n; ++i )
+    push_vctr( vctr, &entries[ i ] );
+  report( "push", "vector", n, n, now() - start );
+
+  htbl = new_htbl();
+  start = now();
+  for ( i = 0; i < n; ++i )
+    put_htbl( htbl, &entries[ i ].key, sizeof( int ), &entries[ i ] );
+  report( "push", "htbl", n, n, now() - start );
+
+  init_ilist( &list );
+  start = now();
+  for ( i = 0; i < n; ++i )
+    push_ilist( &list, &entries[ i ].link );
+  report( "push", "ilist", n, n, now() - start );
+
+  /* iterate */
+  sum = 0;
+  start = now();
+  for ( e = first_ctnr( ctnr ); e; e = next_ctnr( ctnr ) )
+    sum += e->key;
+  report( "iterate", "ccont", n, n, now() - start );
+
+  start = now();
+  for ( i = 0; i < level_vctr( vctr ); ++i )
+    sum += ((Entry*)get_vctr( vctr, i ))->key;
+  report( "iterate", "vector", n, n, now() - start );
+
+  start = now();
+  for ( node = first_ilist( &list ); node; node = next_ilist( &list, node ) )
+    sum += ILIST_ENTRY( node, Entry, link )->key;
+  report( "iterate", "ilist", n, n, now() - start );
+
+  /* get by position */
+  if ( quadratic ) {
+    start = now();
+    for ( i = 0; i < n; ++i )
+      sum += ((Entry*)get_ctnr( ctnr, order[ i ] ))->key;
+    report( "get", "ccont", n, n, now() - start );
+  }
+
+  start = now();
+  for ( i = 0; i < n; ++i )
+    sum += ((Entry*)get_vctr( vctr, order[ i ] ))->key;
+  report( "get", "vector", n, n, now() - start );
+
+  /* search by key */
+  start = now();
+  for ( i = 0; i < LOOKUPS; ++i ) {
+    key.key = order[ i % n ];
+    sum += search_ctnr( ctnr, keyCmp, &key );
+  }
+  report( "search", "ccont", n, LOOKUPS, now() - start );
+
+  start = now();
+  for ( i = 0; i < LOOKUPS; ++i ) {
+    key.key = order[ i % n ];
+    sum += ((Entry*)get_htbl( htbl, &key.key, sizeof( int ) ))->key;
+  }
+  report( "search", "htbl", n, LOOKUPS, now() - start );
+
+  /* sort */
+  start = now();
+  bsort_ctnr( ctnr, keyCmp );
+  report( "sort", "ccont", n, n, now() - start );
+
+  start = now();
+  sort_vctr( vctr, keyCmp );
+  report( "sort", "vector", n, n, now() - start );
+
+  start = now();
+  for ( i = 0; i < LOOKUPS; ++i ) {
+    key.key = order[ i % n ];
+    sum += bsearch_vctr( vctr, keyCmp, &key );
+  }
+  report( "bsearch", "vector", n, LOOKUPS, now() - start );
+
+  /* remove a known object in random order */
+  if ( quadratic ) {
+    start = now();
+    for ( i = 0; i < n; ++i ) {
+      key.key = order[ i ];
+      remove_at_ctnr( ctnr, search_ctnr( ctnr, keyCmp, &key ) );
+    }
+    report( "remove", "ccont", n, n, now() - start );
+  }
+
+  start = now();
+  for ( i = 0; i < n; ++i )
+    remove_htbl( htbl, &entries[ order[ i ] ].key, sizeof( int ) );
+  report( "remove", "htbl", n, n, now() - start );
+
+  start = now();
+  for ( i = 0; i < n; ++i )
+    remove_ilist( &list, &entries[ order[ i ] ].link );
+  report( "remove", "ilist", n, n, now() - start );
+
+  Sink = sum;
+  destr_ctnr( ctnr, noDestr );
+  destr_vctr( vctr, NULL );
+  destr_htbl( htbl, NULL );
+  free( order );
+  free( entries );
+}
+
+int main( int argc, char* argv[] )
+{
+  int i;
+
+  srand( 1 );
+  if ( argc < 2 ) {
+    run( 10000 );
+    run( 100000 );
+    return 0;
+  }
+
+  for ( i = 1; i < argc; ++i ) {
+    if ( atoi( argv[ i ] ) <= 0 ) {
+      fprintf( stderr, "usage: %s [entries]...\n", argv[ 0 ] );
+      return 1;
+    }
+    run( atoi( argv[ i ] ) );
+  }
+
+  return 0;
+}
@@ -0,0 +1,394 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+/*
+ * Writes a directory tree that looks like /proc, /sys and /etc/mtab of a
+ * large machine, for 'ksysguardd -r' and parserbench. The defaults are
+ * 512 CPUs, 4000 interrupts, 2000 veth interfaces, 500 disks and 100000
+ * processes. The files are generated instead of captured, so the tree
+ * has the same shape on every machine and the same content for every
+ * run of the same binary.
+ * Four files per process take some room, 100000 processes need about
+ * 400000 inodes.
+ *
+ * usage: fixturegen [-c cpus] [-i interrupts] [-n interfaces]
+ *                   [-d disks] [-p processes] directory
+ */
+
+#define _XOPEN_SOURCE 700 /* getopt */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char* Root;
+static unsigned long long Seed = 1;
+
+static const char* const Names[] = {
+  "systemd", "bash", "sshd", "kworker/0:1", "nginx", "postgres", "java",
+  "python3", "(sd-pam)", "containerd-shim", "node", "Web Content"
+};
+
+/**
+  @return a pseudo random number, the same sequence on every machine.
+ */
+static unsigned long long next( void )
+{
+  Seed = Seed * 6364136223846793005ULL + 1442695040888963407ULL;
+  return Seed >> 33;
+}
+
+static void fail( const char* path )
+{
+  fprintf( stderr, "fixturegen: %s: %s\n", path, strerror( errno ) );
+  exit( 1 );
+}
+
+/**
+  Creates the directory @ref path below the root and all its parents.
+ */
+static void makeDirectory( const char* path )
+{
+  char buffer[ PATH_MAX ];
+  char* p;
+
+  snprintf( buffer, sizeof( buffer ), "%s/%s", Root, path );
+  for ( p = buffer + strlen( Root ) + 1; ; ++p ) {
+    if ( *p != '/' && *p != '\0' )
+      continue;
+
+    char c = *p;
+    *p = '\0';
+    if ( mkdir( buffer, 0755 ) < 0 && errno != EEXIST )
+      fail( buffer );
+    if ( ( *p = c ) == '\0' )
+      break;
+  }
+}
+
+static FILE* createFile( const char* fmt, ... )
+{
+  char path[ 256 ];
+  char buffer[ PATH_MAX ];
+  va_list ap;
+  FILE* file;
+
+  va_start( ap, fmt );
+  vsnprintf( path, sizeof( path ), fmt, ap );
+  va_end( ap );
+
+  snprintf( buffer, sizeof( buffer ), "%s/%s", Root, path );
+  if ( ( file = fopen( buffer, "w" ) ) == NULL )
+    fail( buffer );
+
+  return file;
+}
+
+static void closeFile( FILE* file )
+{
+  if ( fclose( file ) != 0 )
+    fail( "fclose" );
+}
+
+/**
+  The interrupts are only counted in the intr line of /proc/stat, there
+  is no collector for /proc/interrupts.
+ */
+static void writeStat( int cpus, int interrupts, int processes )
+{
+  FILE* file = createFile( "proc/stat" );
+  unsigned long long total = 0;
+  int i;
+
+  fprintf( file, "cpu  %llu %llu %llu %llu %llu %llu %llu 0 0 0\n",
+           cpus * 52000ULL, cpus * 300ULL, cpus * 21000ULL, cpus * 910000ULL,
+           cpus * 900ULL, 0ULL, cpus * 150ULL );
+  for ( i = 0; i < cpus; ++i )
+    fprintf( file, "cpu%d %llu %llu %llu %llu %llu 0 %llu 0 0 0\n", i,
+             40000 + next() % 24000, next() % 600, 15000 + next() % 12000,
+             880000 + next() % 60000, next() % 1800, next() % 300 );
+
+  for ( i = 0; i < interrupts; ++i )
+    total += i % 7 ? i : 0;
+  fprintf( file, "intr %llu", total );
+  for ( i = 0; i < interrupts; ++i )
+    fprintf( file, " %d", i % 7 ? i : 0 );
+
+  fprintf( file, "\nctxt 8734520012\n"
+                 "btime 1700000000\n"
+                 "processes %d\n"
+                 "procs_running 12\n"
+                 "procs_blocked 0\n"
+                 "softirq 945000 0 310000 20 52000 60000 0 9000 280000 0 234000\n",
+           processes * 4 );
+  closeFile( file );
+}
+
+static void writeCpuInfo( int cpus )
+{
+  FILE* file = createFile( "proc/cpuinfo" );
+  int i;
+
+  for ( i = 0; i < cpus; ++i ) {
+    fprintf( file, "processor\t: %d\n"
+                   "vendor_id\t: GenuineIntel\n"
+                   "model name\t: Intel(R) Xeon(R) Platinum 8480+\n"
+                   "cpu MHz\t\t: %d.%03d\n"
+                   "cache size\t: 107520 KB\n"
+                   "physical id\t: %d\n"
+                   "core id\t\t: %d\n"
+                   "cpu cores\t: 56\n\n",
+             i, 2000 + (int)( next() % 1800 ), (int)( next() % 1000 ), i / 112, i % 56 );
+
+    FILE* freq;
+    char path[ 96 ];
+    snprintf( path, sizeof( path ), "sys/bus/cpu/devices/cpu%d/cpufreq", i );
+    makeDirectory( path );
+    freq = createFile( "%s/scaling_cur_freq", path );
+    fprintf( freq, "%d\n", 2000000 + (int)( next() % 1800000 ) );
+    closeFile( freq );
+  }
+  closeFile( file );
+}
+
+static void writeMemory( void )
+{
+  FILE* file = createFile( "proc/meminfo" );
+
+  fprintf( file, "MemTotal:       2113241148 kB\n"
+                 "MemFree:        1311254412 kB\n"
+                 "MemAvailable:   1820432296 kB\n"
+                 "Buffers:         4128020 kB\n"
+                 "Cached:        497412380 kB\n"
+                 "SwapCached:            0 kB\n"
+                 "Active:        301224508 kB\n"
+                 "Inactive:      412840236 kB\n"
+                 "SwapTotal:      8388604 kB\n"
+                 "SwapFree:       8388604 kB\n"
+                 "Dirty:            20412 kB\n"
+                 "Writeback:            0 kB\n"
+                 "AnonPages:     210348832 kB\n"
+                 "Mapped:         3482540 kB\n"
+                 "Shmem:          1932012 kB\n"
+                 "Slab:          30412384 kB\n"
+                 "SReclaimable:  21340216 kB\n"
+                 "PageTables:      912436 kB\n"
+                 "CommitLimit:  1064989176 kB\n"
+                 "Committed_AS: 301847212 kB\n" );
+  closeFile( file );
+
+  file = createFile( "proc/vmstat" );
+  fprintf( file, "nr_free_pages 327813603\n"
+                 "pgpgin 903412844\n"
+                 "pgpgout 2183450120\n"
+                 "pswpin 0\n"
+                 "pswpout 0\n"
+                 "pgfault 98234123412\n"
+                 "pgmajfault 3412344\n" );
+  closeFile( file );
+
+  file = createFile( "proc/loadavg" );
+  fprintf( file, "212.41 198.07 187.93 14/%d 4194301\n", 4000 );
+  closeFile( file );
+
+  file = createFile( "proc/uptime" );
+  fprintf( file, "3912044.18 1899123312.41\n" );
+  closeFile( file );
+}
+
+static void writeNetDev( int interfaces )
+{
+  FILE* file = createFile( "proc/net/dev" );
+  int i;
+
+  fprintf( file, "Inter-|   Receive                                                |  Transmit\n"
+                 " face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets errs drop fifo colls carrier compressed\n"
+                 "    lo: 98234123 712341    0    0    0     0          0         0 98234123 712341    0    0    0     0       0          0\n" );
+  for ( i = 0; i < interfaces; ++i )
+    fprintf( file, "veth%05d: %llu %llu    0    0    0     0          0         0 %llu %llu    0    0    0     0       0          0\n",
+             i, next(), next() % 10000000, next(), next() % 10000000 );
+  closeFile( file );
+
+  file = createFile( "proc/net/wireless" );
+  fprintf( file, "Inter-| sta-|   Quality        |   Discarded packets               | Missed | WE\n"
+                 " face | tus | link level noise |  nwid  crypt   frag  retry   misc | beacon | 22\n" );
+  closeFile( file );
+
+  /* The socket tables, 1000 entries each */
+  file = createFile( "proc/net/tcp" );
+  fprintf( file, "  sl  local_address rem_address   st tx_queue rx_queue tr tm->when retrnsmt   uid  timeout inode\n" );
+  for ( i = 0; i < 1000; ++i )
+    fprintf( file, "%4d: 0100007F:%04X 0100007F:%04X 01 00000000:00000000 00:00000000 00000000  1000        0 %d 1 0000000000000000 20 4 30 10 -1\n",
+             i, 1024 + i, 8080, 100000 + i );
+  closeFile( file );
+
+  file = createFile( "proc/net/udp" );
+  fprintf( file, "  sl  local_address rem_address   st tx_queue rx_queue tr tm->when retrnsmt   uid  timeout inode ref pointer drops\n" );
+  for ( i = 0; i < 1000; ++i )
+    fprintf( file, "%4d: 00000000:%04X 00000000:0000 07 00000000:00000000 00:00000000 00000000     0        0 %d 2 0000000000000000 0\n",
+             i, 20000 + i, 200000 + i );
+  closeFile( file );
+
+  file = createFile( "proc/net/raw" );
+  fprintf( file, "  sl  local_address rem_address   st tx_queue rx_queue tr tm->when retrnsmt   uid  timeout inode ref pointer drops\n" );
+  closeFile( file );
+
+  file = createFile( "proc/net/unix" );
+  fprintf( file, "Num       RefCount Protocol Flags    Type St Inode Path\n" );
+  for ( i = 0; i < 1000; ++i )
+    fprintf( file, "0000000000000000: 00000002 00000000 00010000 0001 01 %d /run/user/1000/bus-%d\n",
+             300000 + i, i );
+  closeFile( file );
+}
+
+static void writeDisks( int disks )
+{
+  FILE* file = createFile( "proc/diskstats" );
+  FILE* mtab = createFile( "etc/mtab" );
+  int i;
+
+  /* ksysguardd asks statvfs() about the mount points, which always
+   * describes the running system, so only / and /tmp are listed */
+  fprintf( mtab, "/dev/nvme0n1p2 / ext4 rw,relatime 0 0\n"
+                 "proc /proc proc rw,nosuid,nodev,noexec,relatime 0 0\n"
+                 "tmpfs /tmp tmpfs rw,nosuid,nodev 0 0\n" );
+  closeFile( mtab );
+
+  for ( i = 0; i < disks; ++i )
+    fprintf( file, " %4d %7d nvme%dn1 %llu %llu %llu %llu %llu %llu %llu %llu 0 %llu %llu 0 0 0 0 0 0\n",
+             259, i * 2, i, next() % 90000000, next() % 100000, next(), next() % 40000000,
+             next() % 70000000, next() % 100000, next(), next() % 80000000,
+             next() % 20000000, next() % 90000000 );
+  closeFile( file );
+}
+
+static void writeProcesses( int processes )
+{
+  int pid;
+
+  for ( pid = 1; pid <= processes; ++pid ) {
+    const char* name = Names[ next() % ( sizeof( Names ) / sizeof( Names[ 0 ] ) ) ];
+    unsigned int uid = pid < 100 ? 0 : 1000 + next() % 20;
+    unsigned long long vsize = 4096ULL * ( 1000 + next() % 2000000 );
+    unsigned long rss = 100 + next() % 400000;
+    char path[ 32 ];
+    FILE* file;
+
+    snprintf( path, sizeof( path ), "proc/%d", pid );
+    makeDirectory( path );
+
+    file = createFile( "%s/status", path );
+    fprintf( file, "Name:\t%s\n"
+                   "Umask:\t0022\n"
+                   "State:\tS (sleeping)\n"
+                   "Tgid:\t%d\n"
+                   "Ngid:\t0\n"
+                   "Pid:\t%d\n"
+                   "PPid:\t%d\n"
+                   "TracerPid:\t0\n"
+                   "Uid:\t%u\t%u\t%u\t%u\n"
+                   "Gid:\t%u\t%u\t%u\t%u\n"
+                   "FDSize:\t64\n"
+                   "Groups:\t%u\n"
+                   "VmPeak:\t%llu kB\n"
+                   "VmSize:\t%llu kB\n"
+                   "VmRSS:\t%lu kB\n"
+                   "Threads:\t%d\n"
+                   "NoNewPrivs:\t0\n"
+                   "Seccomp:\t0\n"
+                   "Cpus_allowed_list:\t0-511\n"
+                   "voluntary_ctxt_switches:\t%llu\n"
+                   "nonvoluntary_ctxt_switches:\t%llu\n",
+             name, pid, pid, pid > 1 ? 1 : 0, uid, uid, uid, uid, uid, uid, uid, uid, uid,
+             vsize / 1024, vsize / 1024, rss * 4, 1 + (int)( next() % 64 ), next() % 100000,
+             next() % 1000 );
+    closeFile( file );
+
+    file = createFile( "%s/stat", path );
+    fprintf( file, "%d (%s) S %d %d %d 0 -1 4194560 %llu 0 %llu 0 %llu %llu 0 0 20 0 %d 0 %llu %llu %lu "
+                   "18446744073709551615 1 1 0 0 0 0 0 4096 0 0 0 0 17 %d 0 0 0 0 0 0 0 0 0 0 0 0 0\n",
+             pid, name, pid > 1 ? 1 : 0, pid, pid, next() % 100000, next() % 1000,
+             next() % 5000000, next() % 2000000, 1 + (int)( next() % 64 ), next() % 400000000,
+             vsize, rss, (int)( pid % 512 ) );
+    closeFile( file );
+
+    file = createFile( "%s/statm", path );
+    fprintf( file, "%llu %lu %lu 200 0 %lu 0\n", vsize / 4096, rss, rss / 4, rss / 2 );
+    closeFile( file );
+
+    file = createFile( "%s/cmdline", path );
+    fprintf( file, "/usr/bin/%s%c--worker=%d%c", name, '\0', pid, '\0' );
+    closeFile( file );
+  }
+}
+
+int main( int argc, char* argv[] )
+{
+  int cpus = 512, interrupts = 4000, interfaces = 2000, disks = 500, processes = 100000;
+  int option;
+
+  while ( ( option = getopt( argc, argv, "c:i:n:d:p:" ) ) != -1 ) {
+    switch ( option ) {
+      case 'c':
+        cpus = atoi( optarg );
+        break;
+      case 'i':
+        interrupts = atoi( optarg );
+        break;
+      case 'n':
+        interfaces = atoi( optarg );
+        break;
+      case 'd':
+        disks = atoi( optarg );
+        break;
+      case 'p':
+        processes = atoi( optarg );
+        break;
+      default:
+        optind = argc + 1;
+        break;
+    }
+  }
+
+  if ( optind != argc - 1 || cpus <= 0 || interrupts < 0 || interfaces < 0 ||
+       disks < 0 || processes < 0 ) {
+    fprintf( stderr, "usage: %s [-c cpus] [-i interrupts] [-n interfaces] [-d disks]\n"
+                     "       [-p processes] directory\n", argv[ 0 ] );
+    return 1;
+  }
+
+  Root = argv[ optind ];
+  if ( mkdir( Root, 0755 ) < 0 && errno != EEXIST )
+    fail( Root );
+  makeDirectory( "proc/net" );
+  makeDirectory( "etc" );
+
+  writeStat( cpus, interrupts, processes );
+  writeCpuInfo( cpus );
+  writeMemory();
+  writeNetDev( interfaces );
+  writeDisks( disks );
+  writeProcesses( processes );
+
+  return 0;
+}
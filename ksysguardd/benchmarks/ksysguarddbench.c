@@ -0,0 +1,690 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+/*
+ * Puts load on a ksysguardd and measures how it copes: the requests
+ * per second, the latency percentiles and the CPU time the daemon used.
+ *
+ * Every client has one request outstanding at a time and picks the
+ * commands at random from the mix, according to their weights. With a
+ * rate the requests of a client are due at fixed intervals and the
+ * latency is taken from the time a request was due, so a daemon that
+ * falls behind is not flattered by the clients slowing down with it.
+ *
+ * In stdin mode every client starts a ksysguardd of its own, like the
+ * GUI does for the local host. In tcp and unix mode all clients connect
+ * to one daemon, which is started with -d unless -c names the address
+ * of a running one. Starting the daemon requires the permissions to
+ * write its lock file. After the run the clients disconnect, and the
+ * daemon has to accept new connections and answer 'ps delta' again
+ * before it is stopped, otherwise the benchmark fails.
+ *
+ * usage: ksysguardd-bench [-m stdin|tcp|unix] [-n clients] [-r rate]
+ *                         [-t seconds] [-x command:weight,...]
+ *                         [-f rcfile] [-k ksysguardd] [-c address]
+ *                         [-p port] [-s socket]
+ */
+
+#define _GNU_SOURCE /* memmem */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef KSYSGUARDD_BINARY
+#define KSYSGUARDD_BINARY "ksysguardd"
+#endif
+
+#define DEFAULT_MIX "cpu/system/user:4,mem/physical/used:4,cpu/system/loadavg1:2," \
+                    "ps:1,network/sockets/tcp/list:1,partitions/list:1"
+
+#define LOCK_FILE "/var/run/ksysguardd.pid"
+
+static const char Prompt[] = "ksysguardd> ";
+#define PROMPT_LENGTH ( sizeof( Prompt ) - 1 )
+
+typedef struct {
+  char* command;
+  unsigned int weight;
+  unsigned long errors;
+  /* Latencies in us */
+  unsigned long long* latencies;
+  size_t count;
+  size_t size;
+} MixEntry;
+
+typedef struct {
+  int out;
+  int in;
+  pid_t pid;
+
+  char* buffer;
+  size_t length;
+  size_t size;
+
+  int welcomed;
+  int busy;
+  int entry;
+  unsigned int seed;
+  /* When the next request is due and when the outstanding one was */
+  unsigned long long due;
+  unsigned long long requested;
+} Client;
+
+static MixEntry* Mix = 0;
+static int MixCount = 0;
+static unsigned int MixWeight = 0;
+
+static unsigned long long now( void )
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (unsigned long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void usage( const char* name )
+{
+  fprintf( stderr, "usage: %s [-m stdin|tcp|unix] [-n clients] [-r rate] [-t seconds]\n"
+                   "       [-x command:weight,...] [-f rcfile] [-k ksysguardd] [-c address]\n"
+                   "       [-p port] [-s socket]\n", name );
+  exit( 1 );
+}
+
+static void parseMix( const char* text )
+{
+  char* copy = strdup( text );
+  char* token;
+
+  for ( token = strtok( copy, "," ); token; token = strtok( NULL, "," ) ) {
+    char* colon = strrchr( token, ':' );
+    MixEntry* entry;
+
+    Mix = (MixEntry*)realloc( Mix, ( MixCount + 1 ) * sizeof( MixEntry ) );
+    entry = &Mix[ MixCount++ ];
+    memset( entry, 0, sizeof( MixEntry ) );
+    entry->weight = 1;
+    if ( colon ) {
+      *colon = '\0';
+      entry->weight = strtoul( colon + 1, NULL, 10 );
+    }
+    entry->command = strdup( token );
+    MixWeight += entry->weight;
+  }
+
+  free( copy );
+
+  if ( MixWeight == 0 ) {
+    fprintf( stderr, "The mix has no commands\n" );
+    exit( 1 );
+  }
+}
+
+static void addLatency( MixEntry* entry, unsigned long long latency )
+{
+  if ( entry->count == entry->size ) {
+    entry->size = entry->size ? entry->size * 2 : 4096;
+    entry->latencies = (unsigned long long*)realloc( entry->latencies,
+                                                     entry->size * sizeof( unsigned long long ) );
+    if ( !entry->latencies ) {
+      fprintf( stderr, "Out of memory\n" );
+      exit( 1 );
+    }
+  }
+  entry->latencies[ entry->count++ ] = latency;
+}
+
+static int compareLatencies( const void* a, const void* b )
+{
+  unsigned long long x = *(const unsigned long long*)a, y = *(const unsigned long long*)b;
+  return x < y ? -1 : x > y;
+}
+
+static unsigned long long percentile( const unsigned long long* sorted, size_t count, double p )
+{
+  size_t rank;
+
+  if ( count == 0 )
+    return 0;
+
+  rank = (size_t)( p / 100.0 * count + 0.5 );
+  return sorted[ rank ? rank - 1 : 0 ];
+}
+
+/**
+  @return the CPU time of @ref pid in ms or -1 if /proc cannot tell.
+ */
+static long cpuMillis( pid_t pid )
+{
+  char path[ 64 ], buffer[ 1024 ], *end;
+  unsigned long utime, stime;
+  ssize_t length;
+  int fd;
+
+  snprintf( path, sizeof( path ), "/proc/%ld/stat", (long)pid );
+  if ( ( fd = open( path, O_RDONLY ) ) < 0 )
+    return -1;
+  length = read( fd, buffer, sizeof( buffer ) - 1 );
+  close( fd );
+  if ( length <= 0 )
+    return -1;
+  buffer[ length ] = '\0';
+
+  /* The name may contain anything, the fields follow its last ')' */
+  if ( ( end = strrchr( buffer, ')' ) ) == NULL ||
+       sscanf( end + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime ) != 2 )
+    return -1;
+
+  return ( utime + stime ) * 1000 / sysconf( _SC_CLK_TCK );
+}
+
+static pid_t startDaemon( const char* binary, char* const argv[], int* in, int* out )
+{
+  int toDaemon[ 2 ], fromDaemon[ 2 ];
+  pid_t pid;
+
+  if ( in && ( pipe( toDaemon ) < 0 || pipe( fromDaemon ) < 0 ) ) {
+    perror( "pipe()" );
+    exit( 1 );
+  }
+
+  if ( ( pid = fork() ) < 0 ) {
+    perror( "fork()" );
+    exit( 1 );
+  }
+
+  if ( pid == 0 ) {
+    if ( in ) {
+      dup2( toDaemon[ 0 ], STDIN_FILENO );
+      dup2( fromDaemon[ 1 ], STDOUT_FILENO );
+      close( toDaemon[ 0 ] );
+      close( toDaemon[ 1 ] );
+      close( fromDaemon[ 0 ] );
+      close( fromDaemon[ 1 ] );
+    } else {
+      /* Keep the welcome message off our report */
+      int null = open( "/dev/null", O_WRONLY );
+      dup2( null, STDOUT_FILENO );
+      close( null );
+    }
+    execv( binary, argv );
+    perror( binary );
+    _exit( 1 );
+  }
+
+  if ( in ) {
+    close( toDaemon[ 0 ] );
+    close( fromDaemon[ 1 ] );
+    /* The daemons of the other clients must not inherit them */
+    fcntl( toDaemon[ 1 ], F_SETFD, FD_CLOEXEC );
+    fcntl( fromDaemon[ 0 ], F_SETFD, FD_CLOEXEC );
+    *out = toDaemon[ 1 ];
+    *in = fromDaemon[ 0 ];
+  }
+
+  return pid;
+}
+
+static int connectTcp( const char* address )
+{
+  char* host = strdup( address );
+  char* colon = strrchr( host, ':' );
+  struct addrinfo hints, *result, *ai;
+  int fd = -1;
+
+  if ( colon )
+    *colon = '\0';
+
+  memset( &hints, 0, sizeof( hints ) );
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  if ( getaddrinfo( host, colon ? colon + 1 : "3112", &hints, &result ) != 0 ) {
+    free( host );
+    return -1;
+  }
+
+  for ( ai = result; ai && fd < 0; ai = ai->ai_next ) {
+    if ( ( fd = socket( ai->ai_family, ai->ai_socktype, ai->ai_protocol ) ) < 0 )
+      continue;
+    if ( connect( fd, ai->ai_addr, ai->ai_addrlen ) < 0 ) {
+      close( fd );
+      fd = -1;
+    }
+  }
+
+  freeaddrinfo( result );
+  free( host );
+  return fd;
+}
+
+static int connectUnix( const char* path )
+{
+  struct sockaddr_un s_un;
+  int fd;
+
+  if ( strlen( path ) >= sizeof( s_un.sun_path ) || ( fd = socket( AF_UNIX, SOCK_STREAM, 0 ) ) < 0 )
+    return -1;
+
+  memset( &s_un, 0, sizeof( s_un ) );
+  s_un.sun_family = AF_UNIX;
+  strcpy( s_un.sun_path, path );
+  if ( connect( fd, (struct sockaddr*)&s_un, sizeof( s_un ) ) < 0 ) {
+    close( fd );
+    return -1;
+  }
+
+  return fd;
+}
+
+/**
+  Reads the pid that a daemon started with -d has written to its lock
+  file, waiting for it to appear.
+ */
+static pid_t daemonPid( void )
+{
+  int i;
+
+  for ( i = 0; i < 100; ++i ) {
+    FILE* file;
+    long pid;
+
+    if ( ( file = fopen( LOCK_FILE, "r" ) ) != NULL ) {
+      int found = fscanf( file, "%ld", &pid );
+      fclose( file );
+      if ( found == 1 && pid > 0 && kill( (pid_t)pid, 0 ) == 0 )
+        return (pid_t)pid;
+    }
+    usleep( 20000 );
+  }
+
+  return -1;
+}
+
+static void sendRequest( Client* client, unsigned long long time )
+{
+  unsigned int pick = rand_r( &client->seed ) % MixWeight;
+  size_t length;
+  char line[ 1024 ];
+  int i;
+
+  for ( i = 0; pick >= Mix[ i ].weight; ++i )
+    pick -= Mix[ i ].weight;
+
+  length = snprintf( line, sizeof( line ), "%s\n", Mix[ i ].command );
+  if ( write( client->out, line, length ) != (ssize_t)length ) {
+    perror( "write()" );
+    exit( 1 );
+  }
+
+  client->entry = i;
+  client->busy = 1;
+  client->requested = time;
+}
+
+/**
+  Reads what the daemon sent and completes the outstanding request if
+  its answer is there.
+  @return -1 if the connection has been closed.
+ */
+static int readAnswer( Client* client, int counting )
+{
+  size_t searchFrom;
+  ssize_t result;
+  char* prompt;
+
+  if ( client->size - client->length < 65536 ) {
+    client->size = client->size ? client->size * 2 : 131072;
+    if ( ( client->buffer = (char*)realloc( client->buffer, client->size ) ) == NULL ) {
+      fprintf( stderr, "Out of memory\n" );
+      exit( 1 );
+    }
+  }
+
+  searchFrom = client->length > PROMPT_LENGTH ? client->length - PROMPT_LENGTH : 0;
+  if ( ( result = read( client->in, client->buffer + client->length,
+                        client->size - client->length ) ) <= 0 )
+    return result < 0 && errno == EINTR ? 0 : -1;
+  client->length += result;
+
+  prompt = memmem( client->buffer + searchFrom, client->length - searchFrom, Prompt, PROMPT_LENGTH );
+  if ( prompt == NULL )
+    return 0;
+
+  if ( !client->welcomed ) {
+    client->welcomed = 1;
+  } else if ( client->busy ) {
+    MixEntry* entry = &Mix[ client->entry ];
+
+    client->busy = 0;
+    if ( counting ) {
+      addLatency( entry, now() - client->requested );
+      if ( memchr( client->buffer, '\033', prompt - client->buffer ) ||
+           !strncmp( client->buffer, "UNKNOWN", 7 ) )
+        ++entry->errors;
+    }
+  }
+
+  /* Only one request is outstanding, so nothing follows the prompt */
+  client->length = 0;
+  return 0;
+}
+
+/**
+  Waits for the answer to the outstanding request of @ref client, or for
+  the welcome message.
+  @return -1 if the connection has been closed or the daemon does not
+  answer.
+ */
+static int waitForAnswer( Client* client )
+{
+  struct pollfd fd;
+
+  fd.fd = client->in;
+  fd.events = POLLIN;
+  while ( !client->welcomed || client->busy ) {
+    if ( poll( &fd, 1, 5000 ) <= 0 || readAnswer( client, 0 ) < 0 )
+      return -1;
+  }
+
+  return 0;
+}
+
+/**
+  Connects a few times in a row, asks for a table whose state the daemon
+  keeps per client and disconnects again, the way front-ends come and go.
+  @return -1 if the daemon stopped accepting or answering.
+ */
+static int checkReconnect( int local, const char* address )
+{
+  int round;
+
+  for ( round = 0; round < 3; ++round ) {
+    Client client;
+    int fd, result;
+
+    if ( ( fd = local ? connectUnix( address ) : connectTcp( address ) ) < 0 )
+      return -1;
+
+    memset( &client, 0, sizeof( client ) );
+    client.in = client.out = fd;
+    result = waitForAnswer( &client );
+    if ( result == 0 && write( fd, "ps delta 0\n", 11 ) == 11 ) {
+      client.busy = 1;
+      result = waitForAnswer( &client );
+    } else {
+      result = -1;
+    }
+
+    close( fd );
+    free( client.buffer );
+    if ( result < 0 )
+      return -1;
+  }
+
+  return 0;
+}
+
+int main( int argc, char* argv[] )
+{
+  const char* mode = "stdin";
+  const char* binary = KSYSGUARDD_BINARY;
+  const char* rcFile = NULL;
+  const char* address = NULL;
+  const char* port = "3112";
+  const char* socketPath = "/tmp/ksysguardd-bench.sock";
+  const char* mixText = DEFAULT_MIX;
+  double rate = 0;
+  int seconds = 10, clientCount = 4;
+  pid_t daemon = -1;
+  int local = 0, reconnected = 1;
+  Client* clients;
+  struct pollfd* fds;
+  unsigned long long start, end, interval, deadline;
+  long cpuStart = 0, cpuEnd = 0;
+  size_t total = 0;
+  int option, i;
+
+  while ( ( option = getopt( argc, argv, "m:n:r:t:x:f:k:c:p:s:h" ) ) != -1 ) {
+    switch ( option ) {
+      case 'm': mode = optarg; break;
+      case 'n': clientCount = atoi( optarg ); break;
+      case 'r': rate = atof( optarg ); break;
+      case 't': seconds = atoi( optarg ); break;
+      case 'x': mixText = optarg; break;
+      case 'f': rcFile = optarg; break;
+      case 'k': binary = optarg; break;
+      case 'c': address = optarg; break;
+      case 'p': port = optarg; break;
+      case 's': socketPath = optarg; break;
+      default: usage( argv[ 0 ] );
+    }
+  }
+
+  if ( clientCount <= 0 || seconds <= 0 || rate < 0 ||
+       ( strcmp( mode, "stdin" ) && strcmp( mode, "tcp" ) && strcmp( mode, "unix" ) ) )
+    usage( argv[ 0 ] );
+
+  parseMix( mixText );
+  signal( SIGPIPE, SIG_IGN );
+
+  clients = (Client*)calloc( clientCount, sizeof( Client ) );
+  fds = (struct pollfd*)calloc( clientCount, sizeof( struct pollfd ) );
+
+  if ( !strcmp( mode, "stdin" ) ) {
+    char* args[] = { (char*)binary, rcFile ? "-f" : NULL, (char*)rcFile, NULL };
+
+    for ( i = 0; i < clientCount; ++i )
+      clients[ i ].pid = startDaemon( binary, args, &clients[ i ].in, &clients[ i ].out );
+  } else {
+    local = !strcmp( mode, "unix" );
+
+    if ( address == NULL ) {
+      char tcpAddress[ 64 ];
+      char* args[] = { (char*)binary, "-d", "-p", (char*)port, "-s", (char*)socketPath,
+                       rcFile ? "-f" : NULL, (char*)rcFile, NULL };
+      pid_t parent = startDaemon( binary, args, NULL, NULL );
+
+      /* The daemon forks and the parent exits right away */
+      waitpid( parent, NULL, 0 );
+      if ( ( daemon = daemonPid() ) < 0 ) {
+        fprintf( stderr, "The daemon did not start, see the syslog\n" );
+        return 1;
+      }
+
+      snprintf( tcpAddress, sizeof( tcpAddress ), "localhost:%s", port );
+      address = local ? socketPath : strdup( tcpAddress );
+    }
+
+    for ( i = 0; i < clientCount; ++i ) {
+      int fd = -1, attempt;
+
+      for ( attempt = 0; attempt < 100 && fd < 0; ++attempt ) {
+        if ( ( fd = local ? connectUnix( address ) : connectTcp( address ) ) < 0 )
+          usleep( 20000 );
+      }
+      if ( fd < 0 ) {
+        fprintf( stderr, "Cannot connect to %s\n", address );
+        return 1;
+      }
+      clients[ i ].in = clients[ i ].out = fd;
+    }
+  }
+
+  for ( i = 0; i < clientCount; ++i ) {
+    clients[ i ].seed = i + 1;
+    fds[ i ].fd = clients[ i ].in;
+    fds[ i ].events = POLLIN;
+  }
+
+  /* Wait for the welcome messages */
+  for ( ;; ) {
+    int welcomed = 0;
+
+    for ( i = 0; i < clientCount; ++i )
+      welcomed += clients[ i ].welcomed;
+    if ( welcomed == clientCount )
+      break;
+
+    if ( poll( fds, clientCount, 5000 ) <= 0 ) {
+      fprintf( stderr, "The daemon does not answer\n" );
+      return 1;
+    }
+    for ( i = 0; i < clientCount; ++i ) {
+      if ( fds[ i ].revents && readAnswer( &clients[ i ], 0 ) < 0 ) {
+        fprintf( stderr, "The daemon closed the connection\n" );
+        return 1;
+      }
+    }
+  }
+
+  for ( i = 0; i < clientCount; ++i ) {
+    long cpu = cpuMillis( daemon > 0 ? daemon : clients[ i ].pid );
+    cpuStart = cpu < 0 || cpuStart < 0 ? -1 : cpuStart + cpu;
+    if ( daemon > 0 )
+      break;
+  }
+
+  interval = rate > 0 ? (unsigned long long)( 1000000 / rate ) : 0;
+  start = now();
+  deadline = start + (unsigned long long)seconds * 1000000;
+
+  /* Spread the clients over the first interval */
+  for ( i = 0; i < clientCount; ++i )
+    clients[ i ].due = start + interval * i / clientCount;
+
+  for ( ;; ) {
+    unsigned long long time = now();
+    unsigned long long next = (unsigned long long)-1;
+    int busy = 0, timeout;
+
+    for ( i = 0; i < clientCount; ++i ) {
+      Client* client = &clients[ i ];
+
+      if ( !client->busy && time < deadline && client->due <= time ) {
+        sendRequest( client, interval ? client->due : time );
+        client->due += interval;
+      }
+      if ( client->busy )
+        ++busy;
+      else if ( time < deadline && client->due < next )
+        next = client->due;
+    }
+
+    if ( time >= deadline && busy == 0 )
+      break;
+
+    if ( next == (unsigned long long)-1 )
+      timeout = 1000;
+    else
+      timeout = next > time ? (int)( ( next - time + 999 ) / 1000 ) : 0;
+
+    if ( poll( fds, clientCount, timeout ) < 0 && errno != EINTR ) {
+      perror( "poll()" );
+      return 1;
+    }
+
+    for ( i = 0; i < clientCount; ++i ) {
+      if ( fds[ i ].revents && readAnswer( &clients[ i ], 1 ) < 0 ) {
+        fprintf( stderr, "The daemon closed the connection\n" );
+        return 1;
+      }
+    }
+  }
+
+  end = now();
+
+  for ( i = 0; i < clientCount; ++i ) {
+    long cpu = cpuMillis( daemon > 0 ? daemon : clients[ i ].pid );
+    cpuEnd = cpu < 0 || cpuEnd < 0 ? -1 : cpuEnd + cpu;
+    if ( daemon > 0 )
+      break;
+  }
+
+  for ( i = 0; i < clientCount; ++i ) {
+    if ( clients[ i ].pid > 0 && write( clients[ i ].out, "quit\n", 5 ) < 0 )
+      kill( clients[ i ].pid, SIGTERM );
+    close( clients[ i ].out );
+    if ( clients[ i ].in != clients[ i ].out )
+      close( clients[ i ].in );
+    if ( clients[ i ].pid > 0 )
+      waitpid( clients[ i ].pid, NULL, 0 );
+  }
+  if ( address && checkReconnect( local, address ) < 0 ) {
+    fprintf( stderr, "The daemon does not accept clients after others have disconnected\n" );
+    reconnected = 0;
+  }
+  if ( daemon > 0 && kill( daemon, SIGTERM ) == 0 ) {
+    /* Let the next run find the lock file released */
+    for ( i = 0; i < 100 && kill( daemon, 0 ) == 0; ++i )
+      usleep( 20000 );
+  }
+
+  printf( "mode %s, %d clients, %s, %.1f s\n\n", mode, clientCount,
+          rate > 0 ? "rate limited" : "closed loop", ( end - start ) / 1e6 );
+  printf( "%-32s %9s %7s %9s %9s %9s %9s\n", "command", "requests", "errors",
+          "p50 us", "p99 us", "p999 us", "max us" );
+
+  for ( i = 0; i < MixCount; ++i )
+    total += Mix[ i ].count;
+
+  {
+    unsigned long long* all = (unsigned long long*)malloc( ( total ? total : 1 ) * sizeof( unsigned long long ) );
+    unsigned long errors = 0;
+    size_t offset = 0;
+
+    for ( i = 0; i < MixCount; ++i ) {
+      MixEntry* entry = &Mix[ i ];
+
+      qsort( entry->latencies, entry->count, sizeof( unsigned long long ), compareLatencies );
+      printf( "%-32s %9zu %7lu %9llu %9llu %9llu %9llu\n", entry->command, entry->count,
+              entry->errors, percentile( entry->latencies, entry->count, 50 ),
+              percentile( entry->latencies, entry->count, 99 ),
+              percentile( entry->latencies, entry->count, 99.9 ),
+              entry->count ? entry->latencies[ entry->count - 1 ] : 0ULL );
+      if ( entry->count )
+        memcpy( all + offset, entry->latencies, entry->count * sizeof( unsigned long long ) );
+      offset += entry->count;
+      errors += entry->errors;
+    }
+
+    qsort( all, total, sizeof( unsigned long long ), compareLatencies );
+    printf( "%-32s %9zu %7lu %9llu %9llu %9llu %9llu\n\n", "all", total, errors,
+            percentile( all, total, 50 ), percentile( all, total, 99 ),
+            percentile( all, total, 99.9 ), total ? all[ total - 1 ] : 0ULL );
+    free( all );
+  }
+
+  printf( "requests/s   %.1f\n", total / ( ( end - start ) / 1e6 ) );
+  if ( cpuStart >= 0 && cpuEnd >= 0 )
+    printf( "daemon CPU   %ld ms, %.1f%% of one CPU\n", cpuEnd - cpuStart,
+            ( cpuEnd - cpuStart ) / ( ( end - start ) / 1e5 ) );
+  else
+    printf( "daemon CPU   unknown\n" );
+
+  return reconnected ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+/*
+    KSysGuard, the KDE System Guard
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of version 2 of the GNU General Public
+    License as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+/*
+ * Times the update of the collectors against a tree written by
+ * fixturegen, the same way the sampler runs them: the update and the
+ * rendering of every sensor of the module. Each module is timed on its
+ * own, the numbers are in microseconds per sample. The cost of the
+ * ProcessList module is also printed per process.
+ *
+ * usage: parserbench [-r rounds] [-m module,...] [-t scan threads] root
+ */
+
+#define _XOPEN_SOURCE 700 /* getopt, strdup */
+
+#include <ctype.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Command.h"
+#include "Latency.h"
+#include "SysRoot.h"
+#include "conf.h"
+#include "ksysguardd.h"
+#include "modules.h"
+
+/* The modules that read a file that fixturegen writes */
+static const char DefaultModules[] =
+  "CpuInfo,DiskStat,DiskStats,LoadAvg,Memory,NetDev,NetStat,ProcessList,Stat,Uptime";
+
+int RunAsDaemon = 1;
+int QuitApp = 0;
+_Thread_local struct OutputSink* CurrentSink = 0;
+_Thread_local ClientContext* CurrentContext = 0;
+
+/* The sampler is not used, there is no main loop to call the watch */
+struct EventWatch* watchFD( int fd, EventHandler handler, void* data )
+{
+  (void)fd;
+  (void)handler;
+  (void)data;
+  return NULL;
+}
+
+void unwatchFD( struct EventWatch* watch )
+{
+  (void)watch;
+}
+
+void wakeClient( ClientContext* context )
+{
+  (void)context;
+}
+
+void forEachClient( void (*fn)( ClientContext* context, void* data ), void* data )
+{
+  (void)fn;
+  (void)data;
+}
+
+/**
+  @return the number of process directories in the /proc of the tree.
+ */
+static int countProcesses( void )
+{
+  struct dirent* entry;
+  DIR* dir;
+  int count = 0;
+
+  if ( ( dir = sysOpendir( "/proc" ) ) == NULL )
+    return 0;
+  while ( ( entry = readdir( dir ) ) != NULL )
+    if ( isdigit( entry->d_name[ 0 ] ) )
+      ++count;
+  closedir( dir );
+
+  return count;
+}
+
+static int selected( const char* modules, const char* name )
+{
+  size_t length = strlen( name );
+  const char* p;
+
+  for ( p = modules; ( p = strstr( p, name ) ) != NULL; p += length ) {
+    if ( ( p == modules || p[ -1 ] == ',' ) && ( p[ length ] == ',' || p[ length ] == '\0' ) )
+      return 1;
+  }
+
+  return 0;
+}
+
+int main( int argc, char* argv[] )
+{
+  const char* modules = DefaultModules;
+  struct SensorModul* sm;
+  int rounds = 20;
+  int option, r, processes;
+
+  while ( ( option = getopt( argc, argv, "r:m:t:" ) ) != -1 ) {
+    switch ( option ) {
+      case 'r':
+        rounds = atoi( optarg );
+        break;
+      case 'm':
+        modules = optarg;
+        break;
+      case 't':
+        ScanThreads = atoi( optarg );
+        break;
+      default:
+        rounds = 0;
+        break;
+    }
+  }
+
+  if ( optind != argc - 1 || rounds <= 0 ) {
+    fprintf( stderr, "usage: %s [-r rounds] [-m module,...] [-t scan threads] root\n", argv[ 0 ] );
+    return 1;
+  }
+
+  setSysRoot( argv[ optind ] );
+  initCommand();
+
+  printf( "%-12s %8s %8s %8s %8s %8s\n", "module", "init", "mean", "p50", "p99", "max" );
+
+  for ( sm = SensorModulList; sm->configName != NULL; sm++ ) {
+    unsigned long long start, init;
+
+    if ( sm->initCommand == NULL || !selected( modules, sm->configName ) )
+      continue;
+
+    start = monotonicMicros();
+    sm->available = 1;
+    sm->initCommand( sm );
+    init = monotonicMicros() - start;
+
+    /* The first sample runs the checkCommand and sets up the counters
+     * of the modules that print rates, it is not counted */
+    for ( r = -1; r < rounds; ++r ) {
+      struct CollectorTask* task;
+
+      if ( ( task = newCollectorTask( sm, r < 0 ) ) == NULL )
+        return 1;
+      runCollectorTask( task );
+      finishCollectorTask( task );
+
+      if ( r < 0 ) {
+        free( sm->updateLatency );
+        sm->updateLatency = NULL;
+      }
+    }
+
+    if ( sm->updateLatency == NULL ) {
+      printf( "%-12s %8llu %8s\n", sm->configName, init, "-" );
+      continue;
+    }
+
+    printf( "%-12s %8llu %8llu %8llu %8llu %8llu\n", sm->configName, init,
+            sm->updateLatency->sum / sm->updateLatency->count,
+            latencyPercentile( sm->updateLatency, 50 ), latencyPercentile( sm->updateLatency, 99 ),
+            sm->updateLatency->max );
+
+    if ( strcmp( sm->configName, "ProcessList" ) == 0 && ( processes = countProcesses() ) > 0 )
+      printf( "%-12s %.3f us per process (%d processes)\n", "", (double)sm->updateLatency->sum /
+              sm->updateLatency->count / processes, processes );
+  }
+
+  return 0;
+}
@@ -21,18 +21,35 @@
 #include "config-ksysguardd.h"
 
 #define _POSIX_C_SOURCE 200809L /* strdup */
+#include <ctype.h>
+#include <pwd.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "Command.h"
-#include "ccont.h"
 #include "conf.h"
+#include "vector.h"
 
-CONTAINER LogFileList = 0;
-CONTAINER SensorList = 0;
+VECTOR LogFileList = 0;
+static VECTOR SensorList = 0;
+static VECTOR SampleIntervalList = 0;
+/* The uids of the LocalSocketUsers key */
+static VECTOR LocalSocketUserList = 0;
+char* LocalSocketPath = 0;
+char* SysRootPath = 0;
+unsigned long ClientHighWaterMark = 1024 * 1024;
+unsigned long ClientQueueLimit = 64 * 1024 * 1024;
+int CollectorThreads = 0;
+int ScanThreads = 0;
+int ProcessEvents = 1;
+unsigned int HistoryDuration = 600;
+unsigned int HistoryResolution = 1000;
+unsigned int AggregationWindow = 3600;
+unsigned int AggregationResolution = 1000;
 
 void LogFileList_cleanup( void *ptr );
+void SampleIntervalList_cleanup( void *ptr );
 void freeConfigFile( void );
 
 void LogFileList_cleanup( void *ptr )
@@ -43,10 +60,24 @@ void LogFileList_cleanup( void *ptr )
   free( ptr );
 }
 
+void SampleIntervalList_cleanup( void *ptr )
+{
+  if ( ptr ) {
+      free( ((ConfigSampleInterval*)ptr)->name );
+  }
+  free( ptr );
+}
+
 void freeConfigFile( void )
 {
-  destr_ctnr( LogFileList, LogFileList_cleanup );
-  destr_ctnr( SensorList, free );
+  destr_vctr( LogFileList, LogFileList_cleanup );
+  destr_vctr( SensorList, free );
+  destr_vctr( SampleIntervalList, SampleIntervalList_cleanup );
+  destr_vctr( LocalSocketUserList, free );
+  free( LocalSocketPath );
+  LocalSocketPath = 0;
+  free( SysRootPath );
+  SysRootPath = 0;
 }
 
 void parseConfigFile( const char *filename )
@@ -55,9 +86,14 @@ void parseConfigFile( const char *filename )
   char line[ 2048 ];
   char *begin, *token, *tmp;
   ConfigLogFile *confLog;
+  ConfigSampleInterval *confInterval;
+  struct passwd *pwd;
+  uid_t *uid;
 
-  LogFileList = new_ctnr();
-  SensorList = new_ctnr();
+  LogFileList = new_vctr();
+  SensorList = new_vctr();
+  SampleIntervalList = new_vctr();
+  LocalSocketUserList = new_vctr();
 
   if ( ( config = fopen( filename, "r" ) ) == NULL ) {
     log_error( "cannot open config file '%s'", filename );
@@ -66,24 +102,24 @@ void parseConfigFile( const char *filename )
       If we can't open a config file we have to add the
       available sensors manually
      */
-    push_ctnr( SensorList, strdup( "Acpi" ) );
-    push_ctnr( SensorList, strdup( "Apm" ) );
-    push_ctnr( SensorList, strdup( "CpuInfo" ) );
-    push_ctnr( SensorList, strdup( "DellLaptop" ) );
-    push_ctnr( SensorList, strdup( "DiskStat" ) );
-    push_ctnr( SensorList, strdup( "DiskStats" ) );
+    push_vctr( SensorList, strdup( "Acpi" ) );
+    push_vctr( SensorList, strdup( "Apm" ) );
+    push_vctr( SensorList, strdup( "CpuInfo" ) );
+    push_vctr( SensorList, strdup( "DellLaptop" ) );
+    push_vctr( SensorList, strdup( "DiskStat" ) );
+    push_vctr( SensorList, strdup( "DiskStats" ) );
 #ifdef HAVE_LMSENSORS
-    push_ctnr( SensorList, strdup( "LmSensors" ) );
+    push_vctr( SensorList, strdup( "LmSensors" ) );
 #endif
-    push_ctnr( SensorList, strdup( "LoadAvg" ) );
-    push_ctnr( SensorList, strdup( "LogFile" ) );
-    push_ctnr( SensorList, strdup( "Memory" ) );
-    push_ctnr( SensorList, strdup( "NetDev" ) );
-    push_ctnr( SensorList, strdup( "NetStat" ) );
-    push_ctnr( SensorList, strdup( "ProcessList" ) );
-    push_ctnr( SensorList, strdup( "Stat" ) );
-    push_ctnr( SensorList, strdup( "SoftRaid" ) );
-    push_ctnr( SensorList, strdup( "Uptime" ) );
+    push_vctr( SensorList, strdup( "LoadAvg" ) );
+    push_vctr( SensorList, strdup( "LogFile" ) );
+    push_vctr( SensorList, strdup( "Memory" ) );
+    push_vctr( SensorList, strdup( "NetDev" ) );
+    push_vctr( SensorList, strdup( "NetStat" ) );
+    push_vctr( SensorList, strdup( "ProcessList" ) );
+    push_vctr( SensorList, strdup( "Stat" ) );
+    push_vctr( SensorList, strdup( "SoftRaid" ) );
+    push_vctr( SensorList, strdup( "Uptime" ) );
 
     return;
   }
@@ -113,7 +149,7 @@ void parseConfigFile( const char *filename )
           *tmp = '\0';
           confLog->path = tmp;
           confLog->path++;
-          push_ctnr( LogFileList, confLog );
+          push_vctr( LogFileList, confLog );
         }
         else
         {
@@ -123,11 +159,91 @@ void parseConfigFile( const char *filename )
       }
     }
 
+    if ( !strncmp( line, "ClientHighWaterMark", 19 ) && (begin = strchr( line, '=' )) )
+      ClientHighWaterMark = strtoul( begin + 1, NULL, 10 );
+
+    if ( !strncmp( line, "ClientQueueLimit", 16 ) && (begin = strchr( line, '=' )) )
+      ClientQueueLimit = strtoul( begin + 1, NULL, 10 );
+
+    if ( !strncmp( line, "CollectorThreads", 16 ) && (begin = strchr( line, '=' )) )
+      CollectorThreads = atoi( begin + 1 );
+
+    if ( !strncmp( line, "ScanThreads", 11 ) && (begin = strchr( line, '=' )) )
+      ScanThreads = atoi( begin + 1 );
+
+    if ( !strncmp( line, "ProcessEvents", 13 ) && (begin = strchr( line, '=' )) )
+      ProcessEvents = atoi( begin + 1 );
+
+    if ( !strncmp( line, "HistoryDuration", 15 ) && (begin = strchr( line, '=' )) )
+      HistoryDuration = strtoul( begin + 1, NULL, 10 );
+
+    if ( !strncmp( line, "HistoryResolution", 17 ) && (begin = strchr( line, '=' )) )
+      HistoryResolution = strtoul( begin + 1, NULL, 10 );
+
+    if ( !strncmp( line, "AggregationWindow", 17 ) && (begin = strchr( line, '=' )) )
+      AggregationWindow = strtoul( begin + 1, NULL, 10 );
+
+    if ( !strncmp( line, "AggregationResolution", 21 ) && (begin = strchr( line, '=' )) )
+      AggregationResolution = strtoul( begin + 1, NULL, 10 );
+
+    if ( !strncmp( line, "LocalSocketUsers", 16 ) && (begin = strchr( line, '=' )) ) {
+      begin++;
+
+      /* Resolve the names now, the daemon may not be able to later */
+      for ( token = strtok( begin, "," ); token; token = strtok( NULL, "," ) ) {
+        if ( ( uid = (uid_t *)malloc( sizeof( uid_t ) ) ) == NULL ) {
+          log_error( "malloc() no free memory avail" );
+          continue;
+        }
+        if ( isdigit( (unsigned char)token[ 0 ] ) )
+          *uid = strtoul( token, NULL, 10 );
+        else if ( ( pwd = getpwnam( token ) ) != NULL )
+          *uid = pwd->pw_uid;
+        else {
+          log_error( "Unknown user '%s' in LocalSocketUsers", token );
+          free( uid );
+          continue;
+        }
+        push_vctr( LocalSocketUserList, uid );
+      }
+
+      /* Nobody but root, not everybody */
+      if ( level_vctr( LocalSocketUserList ) == 0 && ( uid = (uid_t *)malloc( sizeof( uid_t ) ) ) != NULL ) {
+        *uid = 0;
+        push_vctr( LocalSocketUserList, uid );
+      }
+    } else if ( !strncmp( line, "LocalSocket", 11 ) && (begin = strchr( line, '=' )) && begin[ 1 ] ) {
+      free( LocalSocketPath );
+      LocalSocketPath = strdup( begin + 1 );
+    } else if ( !strncmp( line, "SysRoot", 7 ) && (begin = strchr( line, '=' )) && begin[ 1 ] ) {
+      free( SysRootPath );
+      SysRootPath = strdup( begin + 1 );
+    }
+
+    if ( !strncmp( line, "SampleIntervals", 15 ) && (begin = strchr( line, '=' )) ) {
+      begin++;
+
+      for ( token = strtok( begin, "," ); token; token = strtok( NULL, "," ) ) {
+        if ( ( tmp = strchr( token, ':' ) ) == NULL ) {
+          print_error( "Invalid config file" );
+          exit( EXIT_FAILURE );
+        }
+        if ( ( confInterval = (ConfigSampleInterval *)malloc( sizeof( ConfigSampleInterval ) ) ) == NULL ) {
+          log_error( "malloc() no free memory avail" );
+          continue;
+        }
+        *tmp = '\0';
+        confInterval->name = strdup( token );
+        confInterval->interval = strtoul( tmp + 1, NULL, 10 );
+        push_vctr( SampleIntervalList, confInterval );
+      }
+    }
+
     if ( !strncmp( line, "Sensors", 7 ) && (begin = strchr( line, '=' )) ) {
       begin++;
 
       for ( token = strtok( begin, ","); token; token = strtok( NULL, "," ) )
-        push_ctnr( SensorList, strdup( token ) );
+        push_vctr( SensorList, strdup( token ) );
     }
   }
 
@@ -136,12 +252,44 @@ void parseConfigFile( const char *filename )
 
 int sensorAvailable( const char *sensor )
 {
-  char* name;
+  INDEX i;
+
+  for ( i = 0; i < level_vctr( SensorList ); i++ ) {
+    if ( !strcmp( get_vctr( SensorList, i ), sensor ) )
+      return 1;
+  }
+
+  return 0;
+}
+
+int localSocketUserAllowed( uid_t uid )
+{
+  INDEX i;
+
+  if ( uid == 0 || level_vctr( LocalSocketUserList ) == 0 )
+    return 1;
 
-  for ( name = first_ctnr( SensorList ); name; name = next_ctnr( SensorList ) ) {
-    if ( !strcmp( name, sensor ) )
+  for ( i = 0; i < level_vctr( LocalSocketUserList ); i++ ) {
+    if ( *(uid_t *)get_vctr( LocalSocketUserList, i ) == uid )
       return 1;
   }
 
   return 0;
 }
+
+unsigned int moduleSampleInterval( const char *module )
+{
+  ConfigSampleInterval *entry;
+  unsigned int interval = 0;
+  INDEX i;
+
+  for ( i = 0; i < level_vctr( SampleIntervalList ); i++ ) {
+    entry = get_vctr( SampleIntervalList, i );
+    if ( !strcmp( entry->name, module ) )
+      return entry->interval;
+    if ( !strcmp( entry->name, "*" ) )
+      interval = entry->interval;
+  }
+
+  return interval;
+}
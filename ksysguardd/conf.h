@@ -18,7 +18,9 @@
 
 */
 
-#include "ccont.h"
+#include <sys/types.h>
+
+#include "vector.h"
 
 #ifndef KSG_CONF_H
 #define KSG_CONF_H
@@ -28,6 +30,62 @@ typedef struct {
   char *path;
 } ConfigLogFile;
 
+typedef struct {
+  char *name;
+  unsigned int interval;
+} ConfigSampleInterval;
+
+/* The ConfigLogFile entries of the LogFiles key */
+extern VECTOR LogFileList;
+
+/* Stop serving a client while more than this many bytes are queued for it */
+extern unsigned long ClientHighWaterMark;
+
+/* Drop a client if more than this many bytes are queued for it */
+extern unsigned long ClientQueueLimit;
+
+/* Number of threads that run the collectors, 0 to choose automatically */
+extern int CollectorThreads;
+
+/* Number of threads that read the processes of a large ps scan, 0 to
+ * choose automatically */
+extern int ScanThreads;
+
+/* Follow the processes with the process connector if possible, 0 to
+ * always read /proc */
+extern int ProcessEvents;
+
+/* Seconds of history to keep for the sensors of sampled modules, 0 to
+ * keep none, and the ms between two values of the history */
+extern unsigned int HistoryDuration;
+extern unsigned int HistoryResolution;
+
+/* The longest window in seconds of the 'aggregate' command, 0 to refuse
+ * it, and the ms per slot of the windows */
+extern unsigned int AggregationWindow;
+extern unsigned int AggregationResolution;
+
+/* Path of the Unix domain socket the daemon listens on in addition to
+ * the TCP port, NULL for none */
+extern char* LocalSocketPath;
+
+/* Directory the collectors read /proc, /sys and /etc/mtab below, NULL
+ * for / */
+extern char* SysRootPath;
+
+/**
+  Returns whether the user @ref uid may connect to the Unix domain
+  socket. Everybody may if the LocalSocketUsers key is not set, root
+  always may.
+ */
+int localSocketUserAllowed( uid_t uid );
+
+/**
+  Returns the interval in ms in which @ref module should be sampled in
+  the background or 0 if it is updated on demand.
+ */
+unsigned int moduleSampleInterval( const char* module );
+
 void parseConfigFile( const char *filename );
 void freeConfigFile();
 
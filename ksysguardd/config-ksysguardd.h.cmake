@@ -1,3 +1,7 @@
 #cmakedefine HAVE_LMSENSORS 1
 #cmakedefine HAVE_XRES 1
 #cmakedefine HAVE_SYS_INOTIFY_H 1
+#cmakedefine HAVE_SYS_EPOLL_H 1
+#cmakedefine HAVE_SYS_TIMERFD_H 1
+#cmakedefine HAVE_ACCEPT4 1
+#cmakedefine HAVE_GETPEEREID 1
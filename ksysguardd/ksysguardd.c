@@ -22,6 +22,9 @@
 
 */
 
+/* accept4 */
+#define _GNU_SOURCE
+
 /* gettimeofday, strdup, fileno, fdopen */
 #define _XOPEN_SOURCE 700
 
@@ -36,10 +39,13 @@
 #include <config-workspace.h>
 #include <ctype.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <pwd.h>
 #include <signal.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -47,40 +53,136 @@
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <sys/un.h>
 #include <sys/wait.h>
 #include <unistd.h>
 #include <errno.h>
 
 #include "modules.h"
 
+#include "BinaryProtocol.h"
+#include "Latency.h"
+#include "OutputSink.h"
+#include "Subscription.h"
+#include "Sampler.h"
+#include "Stats.h"
+#include "SysRoot.h"
 #include "ksysguardd.h"
 
 #ifdef HAVE_SYS_INOTIFY_H
 #include <sys/inotify.h>
 #endif
 
-#define CMDBUFSIZE	128
-#define MAX_CLIENTS	100
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
+
+/* Input is read in chunks of this size */
+#define INBUFSIZE	4096
+
+/* Longer command lines are rejected */
+#define MAX_COMMAND_LENGTH	( 1024 * 1024 )
+
+/* Number of events fetched from the poller in one go */
+#define MAX_EVENTS	64
+
+/* Flags for addEventSource() */
+#define WATCH_INPUT	1
+#define WATCH_OUTPUT	2
+#define WATCH_EDGE	4
+
+/**
+  Everything the main loop waits for is described by an EventSource.
+  The poller hands back a pointer to it, so the type tells us how to
+  dispatch the event without searching any list.
+ */
+typedef enum {
+  SOURCE_SERVER,
+  SOURCE_LOCAL_SERVER,
+  SOURCE_CLIENT,
+  SOURCE_STDIN,
+  SOURCE_INOTIFY,
+  SOURCE_WATCH
+} EventSourceType;
 
 typedef struct {
-  int socket;
-  FILE* out;
+  EventSourceType type;
+  int fd;
+  /* Position in the pollfd array, only used by the poll() backend */
+  int pollIndex;
+} EventSource;
+
+/**
+  Holds the input of a client that has not been executed yet. This can
+  be any number of complete command lines followed by a partial one.
+ */
+typedef struct {
+  char* data;
+  size_t length;
+  size_t size;
+} InputBuffer;
+
+typedef struct ClientInfo {
+  EventSource source;
+  OutputSink out;
+  ClientContext context;
+  /* Position in ClientList */
+  unsigned int index;
+  InputBuffer in;
+  /* Set by wakeClient(), the output is sent after the current events */
+  int isAwake;
+  struct ClientInfo* nextAwake;
 } ClientInfo;
 
-static int ServerSocket;
-static ClientInfo ClientList[ MAX_CLIENTS ];
+/**
+  A file descriptor that a module watches with watchFD().
+ */
+struct EventWatch {
+  EventSource source;
+  EventHandler handler;
+  void* data;
+};
+
+static EventSource ServerSource = { SOURCE_SERVER, -1, -1 };
+static EventSource LocalServerSource = { SOURCE_LOCAL_SERVER, -1, -1 };
+static EventSource StdinSource = { SOURCE_STDIN, STDIN_FILENO, -1 };
+static InputBuffer StdinBuffer = { 0, 0, 0 };
+static OutputSink StdoutSink;
+/* Collects the text answer of a command for the binary protocol */
+static OutputSink AnswerSink = { -1, 0, 0, 0, 0, 0, 0, 0 };
+static ClientContext StdinContext = { 0 };
+static int StdinAwake = 0;
+static ClientInfo* AwakeClients = 0;
+static ClientInfo** ClientList = 0;
+static unsigned int ClientCount = 0;
+static unsigned int ClientListSize = 0;
 static int SocketPort = -1;
+static int ListenBacklog = SOMAXCONN;
 static unsigned char BindToAllInterfaces = 0;
-static int CurrentSocket;
+/* The -s command line option, it overrides LocalSocket of the config file */
+static const char* LocalSocketOption = 0;
+/* The -r command line option, it overrides SysRoot of the config file */
+static const char* SysRootOption = 0;
 static const char LockFile[] = "/var/run/ksysguardd.pid";
 static const char *ConfigFile = KSYSGUARDDRCFILE;
 
-void signalHandler( int sig );
+#ifdef HAVE_SYS_EPOLL_H
+static int EpollFD = -1;
+#endif
+static struct pollfd* PollFDs = 0;
+static EventSource** PollSources = 0;
+static int PollCount = 0;
+static int PollSize = 0;
+
+/* The sources returned by the last waitForEvents() */
+static EventSource** ReadySources = 0;
+static int ReadyCount = 0;
+
 void makeDaemon( void );
-void resetClientList( void );
 int addClient( int client );
-int delClient( int client );
+int delClient( ClientInfo* client );
 int createServerSocket( void );
+int createLocalSocket( void );
 
 /**
   This variable is set to 1 if a module requests that the daemon should
@@ -95,24 +197,40 @@ int QuitApp = 0;
 int RunAsDaemon = 0;
 
 /**
-  This pointer is used by all modules. It contains the file pointer of
+  This pointer is used by all modules. It contains the output sink of
   the currently served client. This is stdout for non-daemon mode.
  */
-FILE* CurrentClient = 0;
+_Thread_local OutputSink* CurrentSink = 0;
+
+/**
+  The per connection state of the currently served client.
+ */
+_Thread_local ClientContext* CurrentContext = 0;
 
 static int processArguments( int argc, char* argv[] )
 {
   int option;
 
   opterr = 0;
-  while ( ( option = getopt( argc, argv, "-p:f:dih" ) ) != EOF ) {
+  while ( ( option = getopt( argc, argv, "-p:f:b:s:r:dih" ) ) != EOF ) {
     switch ( tolower( option ) ) {
       case 'p':
         SocketPort = atoi( optarg );
         break;
+      case 's':
+        LocalSocketOption = optarg;
+        break;
+      case 'r':
+        SysRootOption = optarg;
+        break;
       case 'f':
         ConfigFile = strdup( optarg );
         break;
+      case 'b':
+        ListenBacklog = atoi( optarg );
+        if ( ListenBacklog <= 0 )
+          ListenBacklog = SOMAXCONN;
+        break;
       case 'd':
         RunAsDaemon = 1;
         break;
@@ -122,7 +240,7 @@ static int processArguments( int argc, char* argv[] )
       case '?':
       case 'h':
       default:
-        fprintf(stderr, "Usage: %s [-d] [-i] [-p port]\n", argv[ 0 ] );
+        fprintf(stderr, "Usage: %s [-d] [-i] [-p port] [-s socket] [-b backlog] [-r root]\n", argv[ 0 ] );
         return -1;
         break;
     }
@@ -131,16 +249,15 @@ static int processArguments( int argc, char* argv[] )
   return 0;
 }
 
-static void printWelcome( FILE* out )
+static void printWelcome( OutputSink* out )
 {
-  fprintf( out, "ksysguardd 4\n"
+  sinkPrintf( out, "ksysguardd 4\n"
            "(c) 1999, 2000, 2001, 2002 Chris Schlaeger <cs@kde.org>\n"
            "(c) 2001 Tobias Koenig <tokoe@kde.org>\n"
            "(c) 2006-2008 Greg Martyn <greg.martyn@gmail.com>\n"
            "This program is part of the KDE Project and licensed under\n"
-           "the GNU GPL version 2. See https://www.kde.org for details.\n");
-
-  fflush( out );
+           "the GNU GPL version 2. See https://www.kde.org for details.\n"
+           "Protocols: text binary\n");
 }
 
 static int createLockFile()
@@ -224,6 +341,10 @@ void makeDaemon( void )
       if ( createLockFile() < 0 )
         _exit( 1 );
 
+      /* The socket directory is usually not writable for 'nobody' */
+      if ( LocalSocketPath && ( LocalServerSource.fd = createLocalSocket() ) < 0 )
+        _exit( 1 );
+
       dropPrivileges();
 
       fd = open("/dev/null", O_RDWR, 0);
@@ -239,85 +360,352 @@ void makeDaemon( void )
   }
 }
 
-static int readCommand( int fd, char* cmdBuf, size_t len )
+/**
+  readInput appends the data available on @ref fd to @ref in.
+  @return the number of bytes read, 0 if no data is available or -1 if
+  the connection has been closed or the command line is too long.
+ */
+static ssize_t readInput( int fd, InputBuffer* in )
 {
-  unsigned int i;
-  char c;
-  for ( i = 0; i < len; ++i )
-  {
-    int result = read( fd, &c, 1 );
-    if (result < 0)
-      return -1; /* Error */
-
-    if (result == 0) {
-      if (i == 0)
-        return -1; /* Connection lost */
-
-      break; /* End of data */
+  ssize_t result;
+
+  if ( in->size - in->length < INBUFSIZE ) {
+    size_t newSize = in->size ? in->size * 2 : INBUFSIZE;
+    char* data;
+
+    if ( in->length > MAX_COMMAND_LENGTH ) {
+      log_error( "Command line too long" );
+      return -1;
+    }
+
+    if ( ( data = (char*)realloc( in->data, newSize ) ) == NULL ) {
+      log_error( "realloc() no free memory avail" );
+      return -1;
+    }
+    in->data = data;
+    in->size = newSize;
+  }
+
+  do {
+    result = read( fd, in->data + in->length, in->size - in->length );
+  } while ( result < 0 && errno == EINTR );
+
+  if ( result < 0 )
+    return ( errno == EAGAIN || errno == EWOULDBLOCK ) ? 0 : -1;
+
+  if ( result == 0 )
+    return -1; /* Connection lost */
+
+  in->length += result;
+
+  return result;
+}
+
+/**
+  executeInput runs all complete command lines in @ref in and keeps the
+  rest for later. The answers are collected in CurrentSink, the caller
+  flushes them once for the whole batch. If the sink fills up beyond its
+  high water mark the remaining commands are left in the buffer.
+  @return -1 if the client asked to disconnect, 1 if commands are left
+  because the sink is congested and 0 otherwise.
+ */
+static int executeInput( InputBuffer* in )
+{
+  char* start = in->data;
+  char* end = in->data + in->length;
+  char* newline;
+  int result = 0;
+
+  while ( !QuitApp && ( newline = memchr( start, '\n', end - start ) ) != NULL ) {
+    if ( sinkIsCongested( CurrentSink ) ) {
+      result = 1;
+      break;
+    }
+
+    *newline = '\0';
+
+    if ( RunAsDaemon && strncmp( start, "quit", 4 ) == 0 ) {
+      result = -1;
+      break;
+    }
+
+    if ( CurrentContext && CurrentContext->binary ) {
+      OutputSink* sink = CurrentSink;
+      char* answer;
+      size_t length;
+
+      CurrentSink = &AnswerSink;
+      executeCommand( start );
+      CurrentSink = sink;
+
+      if ( ( answer = sinkToString( &AnswerSink, &length ) ) != NULL ) {
+        writeBinaryAnswer( sink, answerType( start ), answer, length );
+        free( answer );
+      }
+      clearSink( &AnswerSink );
+    } else {
+      executeCommand( start );
+      output( "ksysguardd> " );
+    }
+
+    start = newline + 1;
+  }
+
+  in->length = end - start;
+  if ( in->length > 0 && start != in->data )
+    memmove( in->data, start, in->length );
+
+  return result;
+}
+
+/**
+  The poller watches all event sources. With epoll the kernel keeps the
+  interest list, so a wakeup costs O(ready descriptors) instead of
+  O(clients). poll() is used where epoll is not available and in stdin
+  mode, where we only have a handful of descriptors anyway.
+ */
+static void initPoller( int useEpoll )
+{
+#ifdef HAVE_SYS_EPOLL_H
+  if ( useEpoll ) {
+    if ( ( EpollFD = epoll_create1( EPOLL_CLOEXEC ) ) < 0 )
+      log_error( "epoll_create1() failed, falling back to poll()" );
+  }
+#else
+  (void)useEpoll;
+#endif
+}
+
+/**
+  addEventSource starts watching @ref source. @ref flags is a
+  combination of WATCH_INPUT, WATCH_OUTPUT and WATCH_EDGE. Sources that
+  are edge triggered must be drained until read() or accept() would
+  block, the others are served one request per wakeup.
+  With poll() output is only watched while enabled by watchOutput().
+ */
+static int addEventSource( EventSource* source, int flags )
+{
+#ifdef HAVE_SYS_EPOLL_H
+  if ( EpollFD >= 0 ) {
+    struct epoll_event event;
+
+    memset( &event, 0, sizeof( event ) );
+    event.events = ( flags & WATCH_INPUT ? EPOLLIN : 0 ) |
+                   ( flags & WATCH_OUTPUT ? EPOLLOUT : 0 ) |
+                   ( flags & WATCH_EDGE ? EPOLLET : 0 );
+    event.data.ptr = source;
+    if ( epoll_ctl( EpollFD, EPOLL_CTL_ADD, source->fd, &event ) < 0 ) {
+      log_error( "epoll_ctl()" );
+      return -1;
     }
 
-    if (c == '\n')
-      break; /* End of line */
+    return 0;
+  }
+#endif
+
+  if ( PollCount == PollSize ) {
+    int newSize = PollSize ? PollSize * 2 : 16;
+    struct pollfd* fds;
+    EventSource** sources;
+
+    if ( ( fds = (struct pollfd*)realloc( PollFDs, newSize * sizeof( struct pollfd ) ) ) == NULL ) {
+      log_error( "realloc() no free memory avail" );
+      return -1;
+    }
+    PollFDs = fds;
 
-    cmdBuf[ i ] = c;
+    if ( ( sources = (EventSource**)realloc( PollSources, newSize * sizeof( EventSource* ) ) ) == NULL ) {
+      log_error( "realloc() no free memory avail" );
+      return -1;
+    }
+    PollSources = sources;
+    PollSize = newSize;
   }
-  cmdBuf[i] = '\0';
 
-  return i;
+  PollFDs[ PollCount ].fd = source->fd;
+  PollFDs[ PollCount ].events = flags & WATCH_INPUT ? POLLIN : 0;
+  PollFDs[ PollCount ].revents = 0;
+  PollSources[ PollCount ] = source;
+  source->pollIndex = PollCount++;
+
+  return 0;
 }
 
-void resetClientList( void )
+/**
+  With epoll, edge triggered output events are delivered whenever the
+  socket becomes writable again. poll() is level triggered, so there we
+  only ask for them while there is pending output.
+ */
+static void watchOutput( EventSource* source, int enable )
 {
-  for (int i = 0; i < MAX_CLIENTS; i++ ) {
-    ClientList[ i ].socket = -1;
-    ClientList[ i ].out = 0;
+  if ( source->pollIndex < 0 )
+    return;
+
+  if ( enable )
+    PollFDs[ source->pollIndex ].events |= POLLOUT;
+  else
+    PollFDs[ source->pollIndex ].events &= ~POLLOUT;
+}
+
+static void removeEventSource( EventSource* source )
+{
+  int idx;
+
+  /* The source may still be waiting to be dispatched */
+  for ( idx = 0; idx < ReadyCount; ++idx )
+    if ( ReadySources[ idx ] == source )
+      ReadySources[ idx ] = NULL;
+
+#ifdef HAVE_SYS_EPOLL_H
+  if ( EpollFD >= 0 ) {
+    epoll_ctl( EpollFD, EPOLL_CTL_DEL, source->fd, NULL );
+    return;
+  }
+#endif
+
+  if ( ( idx = source->pollIndex ) < 0 )
+    return;
+
+  /* Fill the hole with the last entry to keep the array dense */
+  --PollCount;
+  if ( idx != PollCount ) {
+    PollFDs[ idx ] = PollFDs[ PollCount ];
+    PollSources[ idx ] = PollSources[ PollCount ];
+    PollSources[ idx ]->pollIndex = idx;
   }
+  source->pollIndex = -1;
 }
 
 /**
-  addClient adds a new client to the ClientList.
+  waitForEvents blocks until at least one source is ready and stores
+  up to @ref maxReady of them in @ref ready.
+  @return the number of ready sources or -1 if interrupted.
+ */
+static int waitForEvents( EventSource** ready, int maxReady )
+{
+  int count = 0;
+
+#ifdef HAVE_SYS_EPOLL_H
+  if ( EpollFD >= 0 ) {
+    struct epoll_event events[ MAX_EVENTS ];
+
+    if ( maxReady > MAX_EVENTS )
+      maxReady = MAX_EVENTS;
+    if ( ( count = epoll_wait( EpollFD, events, maxReady, -1 ) ) < 0 )
+      return -1;
+    for ( int i = 0; i < count; ++i )
+      ready[ i ] = (EventSource*)events[ i ].data.ptr;
+
+    return count;
+  }
+#endif
+
+  if ( poll( PollFDs, PollCount, -1 ) < 0 )
+    return -1;
+
+  for ( int i = 0; i < PollCount && count < maxReady; ++i ) {
+    if ( PollFDs[ i ].revents )
+      ready[ count++ ] = PollSources[ i ];
+  }
+
+  return count;
+}
+
+/**
+  addClient adds a new client to the ClientList. The list grows as
+  needed, so there is no fixed limit on the number of clients.
  */
 int addClient( int client )
 {
-  FILE* out;
+  ClientInfo* info;
 
-  for (int i = 0; i < MAX_CLIENTS; i++ ) {
-    if ( ClientList[ i ].socket == -1 ) {
-      ClientList[ i ].socket = client;
-      if ( ( out = fdopen( client, "w+" ) ) == NULL ) {
-        log_error( "fdopen()" );
-        return -1;
-      }
-      /* We use unbuffered IO */
-      fcntl( fileno( out ), F_SETFL, O_NONBLOCK );
-      ClientList[ i ].out = out;
-      printWelcome( out );
-      fprintf( out, "ksysguardd> " );
-      fflush( out );
-
-      return 0;
+  if ( ClientCount == ClientListSize ) {
+    unsigned int newSize = ClientListSize ? ClientListSize * 2 : 16;
+    ClientInfo** list;
+
+    if ( ( list = (ClientInfo**)realloc( ClientList, newSize * sizeof( ClientInfo* ) ) ) == NULL ) {
+      log_error( "realloc() no free memory avail" );
+      close( client );
+      return -1;
     }
+    ClientList = list;
+    ClientListSize = newSize;
+  }
+
+  if ( ( info = (ClientInfo*)malloc( sizeof( ClientInfo ) ) ) == NULL ) {
+    log_error( "malloc() no free memory avail" );
+    close( client );
+    return -1;
+  }
+
+  info->source.type = SOURCE_CLIENT;
+  info->source.fd = client;
+  info->source.pollIndex = -1;
+  initSink( &info->out, client, ClientHighWaterMark, ClientQueueLimit );
+  info->context.sink = &info->out;
+  info->context.sensorSets = 0;
+  info->context.subscriptions = 0;
+  info->context.binary = 0;
+  info->context.data = 0;
+  info->isAwake = 0;
+  info->nextAwake = 0;
+  info->in.data = 0;
+  info->in.length = 0;
+  info->in.size = 0;
+
+  if ( addEventSource( &info->source, WATCH_INPUT | WATCH_OUTPUT | WATCH_EDGE ) < 0 ) {
+    close( client );
+    free( info );
+    return -1;
   }
 
-  return -1;
+  info->index = ClientCount;
+  ClientList[ ClientCount++ ] = info;
+
+  printWelcome( &info->out );
+  sinkPrintf( &info->out, "ksysguardd> " );
+  if ( flushSink( &info->out ) > 0 )
+    watchOutput( &info->source, 1 );
+
+  return 0;
 }
 
 /**
   delClient removes a client from the ClientList.
  */
-int delClient( int client )
+int delClient( ClientInfo* client )
 {
-  for (int i = 0; i < MAX_CLIENTS; i++ ) {
-    if ( ClientList[i].socket == client ) {
-      fclose( ClientList[ i ].out );
-      ClientList[ i ].out = 0;
-      close( ClientList[ i ].socket );
-      ClientList[ i ].socket = -1;
-      return 0;
-    }
+  removeEventSource( &client->source );
+
+  if ( CurrentSink == &client->out )
+    CurrentSink = 0;
+  if ( CurrentContext == &client->context )
+    CurrentContext = 0;
+  clearClientContext( &client->context );
+  clearSubscriptions( &client->context );
+
+  if ( client->isAwake ) {
+    ClientInfo** pos;
+    for ( pos = &AwakeClients; *pos != client; pos = &(*pos)->nextAwake )
+      ;
+    *pos = client->nextAwake;
   }
 
-  return -1;
+  /* Send what we can, the client may only have closed its sending side */
+  flushSink( &client->out );
+  clearSink( &client->out );
+  close( client->source.fd );
+  free( client->in.data );
+
+  --ClientCount;
+  if ( client->index != ClientCount ) {
+    ClientList[ client->index ] = ClientList[ ClientCount ];
+    ClientList[ client->index ]->index = client->index;
+  }
+
+  free( client );
+
+  return 0;
 }
 
 int createServerSocket()
@@ -359,40 +747,106 @@ int createServerSocket()
     return -1;
   }
 
-  if ( listen( newSocket, 5 ) < 0 ) {
+  if ( listen( newSocket, ListenBacklog ) < 0 ) {
     log_error( "listen()" );
     return -1;
   }
 
+  /* The main loop accepts until the queue is empty, so this must not block */
+  fcntl( newSocket, F_SETFL, fcntl( newSocket, F_GETFL ) | O_NONBLOCK );
+  fcntl( newSocket, F_SETFD, FD_CLOEXEC );
+
   return newSocket;
 }
 
-static int setupSelect( fd_set* fds )
+/**
+  createLocalSocket listens on the Unix domain socket LocalSocketPath.
+  Everybody may connect, the credentials of a client are checked when
+  it is accepted.
+ */
+int createLocalSocket()
 {
-  int highestFD = ServerSocket;
-  FD_ZERO( fds );
+  int newSocket;
+  struct sockaddr_un s_un;
+  struct stat info;
+
+  if ( strlen( LocalSocketPath ) >= sizeof( s_un.sun_path ) ) {
+    log_error( "Socket path '%s' is too long", LocalSocketPath );
+    return -1;
+  }
+
+  if ( ( newSocket = socket( AF_UNIX, SOCK_STREAM, 0 ) ) < 0 ) {
+    log_error( "socket()" );
+    return -1;
+  }
+
+  memset( &s_un, 0, sizeof( struct sockaddr_un ) );
+  s_un.sun_family = AF_UNIX;
+  strcpy( s_un.sun_path, LocalSocketPath );
+
   /**
-    Fill the filedescriptor array with all relevant descriptors. If we
-    not in daemon mode we only need to watch stdin.
+    We hold the lock file, so a socket that is still there has been
+    left by a daemon that is gone.
    */
-  if ( RunAsDaemon ) {
-    int i;
-    FD_SET( ServerSocket, fds );
-
-    for ( i = 0; i < MAX_CLIENTS; i++ ) {
-      if ( ClientList[ i ].socket != -1 ) {
-        FD_SET( ClientList[ i ].socket, fds );
-        if ( highestFD < ClientList[ i ].socket )
-          highestFD = ClientList[ i ].socket;
-      }
-    }
-  } else {
-    FD_SET( STDIN_FILENO, fds );
-    if ( highestFD < STDIN_FILENO )
-      highestFD = STDIN_FILENO;
+  if ( lstat( LocalSocketPath, &info ) == 0 && S_ISSOCK( info.st_mode ) )
+    unlink( LocalSocketPath );
+
+  if ( bind( newSocket, (struct sockaddr*)&s_un, sizeof( s_un ) ) < 0 ) {
+    log_error( "Cannot bind to '%s'", LocalSocketPath );
+    close( newSocket );
+    return -1;
   }
 
-  return highestFD;
+  chmod( LocalSocketPath, 0666 );
+
+  if ( listen( newSocket, ListenBacklog ) < 0 ) {
+    log_error( "listen()" );
+    close( newSocket );
+    return -1;
+  }
+
+  fcntl( newSocket, F_SETFL, fcntl( newSocket, F_GETFL ) | O_NONBLOCK );
+  fcntl( newSocket, F_SETFD, FD_CLOEXEC );
+
+  return newSocket;
+}
+
+/**
+  Returns whether the peer of the Unix domain socket @ref fd may use
+  the daemon, see LocalSocketUsers in ksysguarddrc.
+ */
+static int localPeerAllowed( int fd )
+{
+  uid_t uid;
+
+#if defined( SO_PEERCRED )
+  struct ucred cred;
+  socklen_t length = sizeof( cred );
+
+  if ( getsockopt( fd, SOL_SOCKET, SO_PEERCRED, &cred, &length ) < 0 ) {
+    log_error( "getsockopt(SO_PEERCRED)" );
+    return 0;
+  }
+  uid = cred.uid;
+#elif defined( HAVE_GETPEEREID )
+  gid_t gid;
+
+  if ( getpeereid( fd, &uid, &gid ) < 0 ) {
+    log_error( "getpeereid()" );
+    return 0;
+  }
+#else
+  /* Without credentials only an unrestricted socket can be served */
+  (void)fd;
+  uid = (uid_t)-1;
+#endif
+
+  if ( !localSocketUserAllowed( uid ) ) {
+    log_error( "Refusing local client of user %ld", (long)uid );
+    return 0;
+  }
+
+  return 1;
 }
 
 static void checkModules()
@@ -400,57 +854,142 @@ static void checkModules()
   struct SensorModul *entry;
 
   for ( entry = SensorModulList; entry->configName != NULL; entry++ )
-    if ( entry->checkCommand != NULL && entry->available )
+    if ( entry->checkCommand != NULL && entry->available && !scheduleCheck( entry ) )
       entry->checkCommand();
 }
 
-static void handleSocketTraffic( int socketNo, const fd_set* fds )
+/**
+  The listening socket is edge triggered, so we have to take every
+  pending connection before we go back to sleep. Clients of the Unix
+  domain socket, @ref local, have to pass the credentials check.
+ */
+static void acceptClients( int socketNo, int local )
 {
-  char cmdBuf[ CMDBUFSIZE ];
-
-  if ( RunAsDaemon ) {
-    if ( FD_ISSET( socketNo, fds ) ) {
-      int clientsocket;
-      struct sockaddr addr;
-      kde_socklen_t addr_len = sizeof( struct sockaddr );
+  for ( ;; ) {
+    int clientSocket;
+
+#ifdef HAVE_ACCEPT4
+    clientSocket = accept4( socketNo, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC );
+#else
+    if ( ( clientSocket = accept( socketNo, NULL, NULL ) ) >= 0 ) {
+      fcntl( clientSocket, F_SETFL, O_NONBLOCK );
+      fcntl( clientSocket, F_SETFD, FD_CLOEXEC );
+    }
+#endif
 
-      /* a new connection */
-      if ( ( clientsocket = accept( socketNo, &addr, &addr_len ) ) < 0 ) {
+    if ( clientSocket < 0 ) {
+      if ( errno == EINTR || errno == ECONNABORTED )
+        continue;
+      if ( errno != EAGAIN && errno != EWOULDBLOCK )
         log_error( "accept()" );
-        exit( 1 );
-      } else
-        addClient( clientsocket );
+      return;
     }
 
-    for (int i = 0; i < MAX_CLIENTS; i++ ) {
-      if ( ClientList[ i ].socket != -1 ) {
-        CurrentSocket = ClientList[ i ].socket;
-        if ( FD_ISSET( ClientList[ i ].socket, fds ) ) {
-          ssize_t cnt;
-          if ( ( cnt = readCommand( CurrentSocket, cmdBuf, sizeof( cmdBuf ) - 1 ) ) <= 0 )
-            delClient( CurrentSocket );
-          else {
-            cmdBuf[ cnt ] = '\0';
-            if ( strncmp( cmdBuf, "quit", 4 ) == 0 )
-              delClient( CurrentSocket );
-            else {
-              CurrentClient = ClientList[ i ].out;
-              fflush( stdout );
-              executeCommand( cmdBuf );
-              output( "ksysguardd> " );
-              fflush( CurrentClient );
-            }
-          }
-        }
-      }
+    if ( local && !localPeerAllowed( clientSocket ) ) {
+      close( clientSocket );
+      continue;
     }
-  } else if ( FD_ISSET( STDIN_FILENO, fds ) ) {
-    if (readCommand( STDIN_FILENO, cmdBuf, sizeof( cmdBuf ) ) < 0) {
-      exit(0);
+
+    addClient( clientSocket );
+  }
+}
+
+/**
+  Client sockets are edge triggered as well. Read until the socket
+  would block, execute every complete command on the way and send all
+  answers at once. This way a client can pipeline many requests and
+  get the answers in a single round trip.
+
+  A client that does not read its answers fast enough is not served
+  until its queue has drained below the high water mark. If the queue
+  grows beyond the limit anyway, the client is dropped.
+ */
+static void handleClientTraffic( ClientInfo* client )
+{
+  int result;
+
+  CurrentSink = &client->out;
+  CurrentContext = &client->context;
+
+  for ( ;; ) {
+    if ( executeInput( &client->in ) < 0 ) {
+      delClient( client ); /* The client sent 'quit' */
+      return;
+    }
+
+    if ( sinkIsCongested( &client->out ) ) {
+      /* Try to make room, otherwise wait until the socket drains */
+      if ( flushSink( &client->out ) < 0 || sinkIsCongested( &client->out ) )
+        break;
+      continue;
+    }
+
+    if ( ( result = readInput( client->source.fd, &client->in ) ) <= 0 ) {
+      if ( result < 0 ) {
+        delClient( client );
+        return;
+      }
+      break;
     }
-    executeCommand( cmdBuf );
-    printf( "ksysguardd> " );
-    fflush( stdout );
+  }
+
+  if ( flushSink( &client->out ) < 0 || client->out.failed ) {
+    delClient( client );
+    return;
+  }
+
+  watchOutput( &client->source, client->out.pending > 0 );
+}
+
+/**
+  Writes all pending output to stdout, even if it is non-blocking.
+ */
+static void flushStdout( void )
+{
+  int result;
+
+  while ( ( result = flushSink( &StdoutSink ) ) > 0 ) {
+    struct pollfd pfd;
+    pfd.fd = STDOUT_FILENO;
+    pfd.events = POLLOUT;
+    poll( &pfd, 1, -1 );
+  }
+
+  if ( result < 0 )
+    exit( 0 );
+}
+
+static void handleStdinTraffic( void )
+{
+  /* stdin may be blocking, so only read what woke us up */
+  if ( readInput( STDIN_FILENO, &StdinBuffer ) < 0 )
+    exit( 0 );
+
+  while ( executeInput( &StdinBuffer ) > 0 )
+    flushStdout();
+  flushStdout();
+}
+
+/**
+  Sends the output that has been queued by wakeClient() during the last
+  round of events.
+ */
+static void sendAwakeClients( void )
+{
+  if ( StdinAwake ) {
+    StdinAwake = 0;
+    flushStdout();
+  }
+
+  while ( AwakeClients ) {
+    ClientInfo* client = AwakeClients;
+    AwakeClients = client->nextAwake;
+    client->isAwake = 0;
+
+    if ( flushSink( &client->out ) < 0 || client->out.failed )
+      delClient( client );
+    else
+      watchOutput( &client->source, client->out.pending > 0 );
   }
 }
 
@@ -460,6 +999,8 @@ static void initModules()
 
   /* initialize all sensors */
   initCommand();
+  initSubscriptions();
+  initStats( SensorModulList );
 
   for ( entry = SensorModulList; entry->configName != NULL; entry++ ) {
     if ( entry->initCommand != NULL && sensorAvailable( entry->configName ) ) {
@@ -475,11 +1016,14 @@ static void exitModules()
 {
   struct SensorModul *entry;
 
+  exitSampler();
+
   for ( entry = SensorModulList; entry->configName != NULL; entry++ ) {
     if ( entry->exitCommand != NULL && entry->available )
       entry->exitCommand();
   }
 
+  exitStats();
   exitCommand();
 }
 
@@ -489,6 +1033,64 @@ static void exitModules()
 ================================ public part =================================
 */
 
+void wakeClient( ClientContext* context )
+{
+  ClientInfo* client;
+
+  if ( context == &StdinContext ) {
+    StdinAwake = 1;
+    return;
+  }
+
+  client = (ClientInfo*)( (char*)context - offsetof( ClientInfo, context ) );
+  if ( client->isAwake )
+    return;
+
+  client->isAwake = 1;
+  client->nextAwake = AwakeClients;
+  AwakeClients = client;
+}
+
+void forEachClient( void (*fn)( ClientContext* context, void* data ), void* data )
+{
+  unsigned int i;
+
+  if ( !RunAsDaemon )
+    fn( &StdinContext, data );
+
+  for ( i = 0; i < ClientCount; ++i )
+    fn( &ClientList[ i ]->context, data );
+}
+
+struct EventWatch* watchFD( int fd, EventHandler handler, void* data )
+{
+  struct EventWatch* watch;
+
+  if ( ( watch = (struct EventWatch*)malloc( sizeof( struct EventWatch ) ) ) == NULL ) {
+    log_error( "malloc() no free memory avail" );
+    return NULL;
+  }
+
+  watch->source.type = SOURCE_WATCH;
+  watch->source.fd = fd;
+  watch->source.pollIndex = -1;
+  watch->handler = handler;
+  watch->data = data;
+
+  if ( addEventSource( &watch->source, WATCH_INPUT ) < 0 ) {
+    free( watch );
+    return NULL;
+  }
+
+  return watch;
+}
+
+void unwatchFD( struct EventWatch* watch )
+{
+  removeEventSource( &watch->source );
+  free( watch );
+}
+
 /*
  *  Will replace a "/" with "\/"
  *  Allocates a new string, so when calling this make sure to free the original.
@@ -536,9 +1138,11 @@ char* escapeString( char* string ) {
 
 #ifdef HAVE_SYS_INOTIFY_H
 static void setupInotify(int *mtabfd) {
+  char mtab[ PATH_MAX ];
+
   (*mtabfd) = inotify_init ();
   if ((*mtabfd) >= 0) {
-    int wd = inotify_add_watch ((*mtabfd), "/etc/mtab", IN_MODIFY | IN_CREATE | IN_DELETE);
+    int wd = inotify_add_watch ((*mtabfd), sysPath( mtab, sizeof( mtab ), "/etc/mtab" ), IN_MODIFY | IN_CREATE | IN_DELETE);
     if(wd < 0) (*mtabfd) = -1; /* error setting up inotify watch */
   }
 
@@ -546,34 +1150,60 @@ static void setupInotify(int *mtabfd) {
 #endif
 int main( int argc, char* argv[] )
 {
-  fd_set fds;
+  EventSource* ready[ MAX_EVENTS ];
 
-  printWelcome( stdout );
+  /* Writing to a client that went away must not kill us */
+  signal( SIGPIPE, SIG_IGN );
+
+  initSink( &StdoutSink, STDOUT_FILENO, 0, 0 );
+  printWelcome( &StdoutSink );
+  flushStdout();
 
   if ( processArguments( argc, argv ) < 0 )
     return -1;
 
   parseConfigFile( ConfigFile );
+  if ( LocalSocketOption ) {
+    free( LocalSocketPath );
+    LocalSocketPath = *LocalSocketOption ? strdup( LocalSocketOption ) : 0;
+  }
+  setSysRoot( SysRootOption ? SysRootOption : SysRootPath );
 
   initModules();
 
   if ( RunAsDaemon ) {
     makeDaemon();
 
-    if ( ( ServerSocket = createServerSocket() ) < 0 )
+    if ( ( ServerSource.fd = createServerSocket() ) < 0 )
+      return -1;
+
+    initPoller( 1 );
+    if ( addEventSource( &ServerSource, WATCH_INPUT | WATCH_EDGE ) < 0 )
+      return -1;
+    if ( LocalServerSource.fd >= 0 &&
+         addEventSource( &LocalServerSource, WATCH_INPUT | WATCH_EDGE ) < 0 )
       return -1;
-    resetClientList();
   } else {
-    fprintf( stdout, "ksysguardd> " );
-    fflush( stdout );
-    CurrentClient = stdout;
-    ServerSocket = 0;
+    StdoutSink.highWaterMark = ClientHighWaterMark;
+    CurrentSink = &StdoutSink;
+    CurrentContext = &StdinContext;
+    StdinContext.sink = &StdoutSink;
+    output( "ksysguardd> " );
+    flushStdout();
+
+    initPoller( 0 );
+    if ( addEventSource( &StdinSource, WATCH_INPUT ) < 0 )
+      return -1;
   }
 
+  initSampler( SensorModulList );
+
 #ifdef HAVE_SYS_INOTIFY_H
   /* Monitor mtab for changes */
-  int mtabfd = 0;
-  setupInotify(&mtabfd);
+  EventSource inotifySource = { SOURCE_INOTIFY, -1, -1 };
+  setupInotify(&inotifySource.fd);
+  if(inotifySource.fd >= 0)
+    addEventSource( &inotifySource, WATCH_INPUT );
 #endif
 
   struct timeval now;
@@ -581,32 +1211,64 @@ int main( int argc, char* argv[] )
   gettimeofday( &last, NULL );
 
   while ( !QuitApp ) {
-    int highestFD = setupSelect( &fds );
-#ifdef HAVE_SYS_INOTIFY_H
-    if(mtabfd >= 0)
-      FD_SET( mtabfd, &fds);
-    if(mtabfd > highestFD) highestFD = mtabfd;
-#endif
-
     /* wait for communication or timeouts */
-    int ret = select( highestFD + 1, &fds, NULL, NULL, NULL );
-    if(ret >= 0) {
-        gettimeofday( &now, NULL );
-        if ( now.tv_sec - last.tv_sec >= 5 ) { /* 5 second intervals */
-            /* If so, update all sensors and save current time to last. */
-            checkModules();
-            last = now;
-        }
+    int count = waitForEvents( ready, MAX_EVENTS );
+    if ( count < 0 )
+      continue;
+
+    unsigned long long roundStart = monotonicMicros();
+
+    ReadySources = ready;
+    ReadyCount = count;
+
+    gettimeofday( &now, NULL );
+    if ( now.tv_sec - last.tv_sec >= 5 ) { /* 5 second intervals */
+      /* If so, update all sensors and save current time to last. */
+      checkModules();
+      last = now;
+    }
+
+    for ( int i = 0; i < count && !QuitApp; ++i ) {
+      /* Removed by an earlier event of this round */
+      if ( ready[ i ] == NULL )
+        continue;
+
+      switch ( ready[ i ]->type ) {
+        case SOURCE_SERVER:
+          acceptClients( ready[ i ]->fd, 0 );
+          break;
+        case SOURCE_LOCAL_SERVER:
+          acceptClients( ready[ i ]->fd, 1 );
+          break;
+        case SOURCE_CLIENT:
+          handleClientTraffic( (ClientInfo*)ready[ i ] );
+          break;
+        case SOURCE_STDIN:
+          handleStdinTraffic();
+          break;
+        case SOURCE_INOTIFY:
 #ifdef HAVE_SYS_INOTIFY_H
-        if(mtabfd >= 0 && FD_ISSET(mtabfd, &fds)) {
-            close(mtabfd);
-            setupInotify(&mtabfd);
-        }
+          removeEventSource( &inotifySource );
+          close( inotifySource.fd );
+          setupInotify( &inotifySource.fd );
+          if ( inotifySource.fd >= 0 )
+            addEventSource( &inotifySource, WATCH_INPUT );
 #endif
-        handleSocketTraffic( ServerSocket, &fds );
+          break;
+        case SOURCE_WATCH:
+          ((struct EventWatch*)ready[ i ])->handler( ((struct EventWatch*)ready[ i ])->data );
+          break;
+      }
     }
+
+    ReadyCount = 0;
+    sendAwakeClients();
+
+    recordLoopRound( roundStart, monotonicMicros() );
   }
 
+  clearClientContext( &StdinContext );
+  clearSubscriptions( &StdinContext );
   exitModules();
 
   freeConfigFile();
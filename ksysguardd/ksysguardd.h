@@ -33,8 +33,65 @@
 extern int RunAsDaemon;
 extern int QuitApp;
 
-/* This pointer give you access to the client which made the request */
-extern FILE* CurrentClient;
+struct OutputSink;
+
+/* The answer to the current request has to be written into this sink.
+ * Use output() from Command.h instead of accessing it directly. Every
+ * thread has its own, modules that are sampled on a worker thread
+ * write their answers into the snapshot this way. */
+extern _Thread_local struct OutputSink* CurrentSink;
+
+struct ClientData;
+struct LatencyHistogram;
+struct SensorSet;
+struct Subscription;
+
+/* State that the commands keep for each connection. CurrentContext
+ * belongs to the client whose request is being executed. */
+typedef struct ClientContext {
+  /* The output sink of this client */
+  struct OutputSink* sink;
+
+  /* Sensor sets defined with 'defineset' */
+  struct SensorSet* sensorSets;
+
+  /* Sensors that are pushed to the client, see Subscription.h */
+  struct Subscription* subscriptions;
+
+  /* Answers are sent as binary frames, see BinaryProtocol.h */
+  int binary;
+
+  /* What the modules keep for this client, see setClientData() */
+  struct ClientData* data;
+} ClientContext;
+
+extern _Thread_local ClientContext* CurrentContext;
+
+/**
+  Output that is written to a client outside of a request, e.g. pushed
+  sensor values, is only sent after calling wakeClient().
+ */
+void wakeClient( ClientContext* context );
+
+/**
+  Calls @ref fn with @ref data for every connected client.
+ */
+void forEachClient( void (*fn)( ClientContext* context, void* data ), void* data );
+
+typedef void (*EventHandler)( void* data );
+struct EventWatch;
+
+/**
+  Lets the main loop call @ref handler with @ref data whenever @ref fd
+  is readable. The handler has to consume the event, otherwise it is
+  called again right away.
+ */
+struct EventWatch* watchFD( int fd, EventHandler handler, void* data );
+
+/**
+  Stops watching. The file descriptor is not closed.
+ */
+void unwatchFD( struct EventWatch* watch );
 
 struct SensorModul {
   const char *configName;
@@ -44,6 +101,15 @@ struct SensorModul {
   void (*checkCommand)( void );
   int available;
   unsigned long long timeCentiSeconds;
+  /* Interval in ms in which the module is sampled in the background,
+   * 0 if it is updated on demand. See Sampler.h */
+  unsigned int sampleInterval;
+  /* Incremented whenever the values of the module may have changed */
+  unsigned long generation;
+  /* The durations of the updateCommand, allocated by the first update,
+   * and the bytes it has read in total. See 'ksysguardd/stats'. */
+  struct LatencyHistogram* updateLatency;
+  unsigned long long updateBytes;
 };
 
 char* escapeString( char* string );